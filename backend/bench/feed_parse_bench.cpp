@@ -0,0 +1,469 @@
+// Frame -> normalized levels/trades throughput of every venue decoder in FeedParsers.
+//
+//   feed_parse_bench [--corpus DIR] [--ms N] [--filter TEXT]
+//
+// Each case replays one corpus file (see tools/scripts/make_feed_corpus.py) in a loop for
+// about N ms (default 1000) and reports frames/s, MB/s, ns per frame, the share spent building
+// the JSON DOM, and heap allocations per frame. Frames are parsed into a FrameArena reset per
+// frame, as in the feed loops. The "text" cases run the DOM-free depth decoders; every corpus
+// frame must decode and match the json path level for level, or the bench exits non-zero.
+
+#include "FeedParsers.hpp"
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef FEED_CORPUS_DIR
+#    define FEED_CORPUS_DIR "backend/bench/corpus"
+#endif
+
+namespace
+{
+    using json = nlohmann::json;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr double kTickSize = 0.01;
+    constexpr double kContractSize = 0.0001;
+
+    // Decodes one frame; returns the number of levels plus trades produced.
+    using JsonParser = std::function<std::size_t(const json&, dom::feed::DepthUpdate&, dom::feed::TradeVector&)>;
+    using BinaryParser =
+        std::function<std::size_t(std::string_view, dom::feed::DepthUpdate&, dom::feed::TradeVector&)>;
+    // Decodes a depth frame from its text; false when the frame is left to the json path.
+    using TextParser = std::function<bool(std::string_view, dom::feed::DepthUpdate&)>;
+
+    struct Case
+    {
+        const char* name;
+        const char* file;
+        JsonParser parseJson;     // JSON frames; the reference for parseText
+        BinaryParser parseBinary; // protobuf frames (hex in the corpus)
+        TextParser parseText;     // DOM-free decoding of the same JSON frames
+    };
+
+    std::size_t levels(const dom::feed::DepthUpdate& depth)
+    {
+        return depth.bids.size() + depth.asks.size();
+    }
+
+    const json& member(const json& j, const char* key)
+    {
+        static const json empty;
+        const auto it = j.find(key);
+        return it != j.end() ? *it : empty;
+    }
+
+    const json& paradexData(const json& j)
+    {
+        return member(member(j, "params"), "data");
+    }
+
+    std::vector<Case> cases()
+    {
+        using namespace dom::feed;
+        return {
+            {"binance depthUpdate", "binance_depth.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseBinanceDepth(j, kTickSize, d);
+                 return levels(d);
+             },
+             nullptr,
+             nullptr},
+            {"binance futures depthUpdate", "binance_futures_depth.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseBinanceDepth(j, kTickSize, d);
+                 return levels(d);
+             },
+             nullptr,
+             nullptr},
+            {"binance aggTrade", "binance_aggtrade.jsonl",
+             [](const json& j, DepthUpdate&, TradeVector&) {
+                 Trade trade;
+                 return parseBinanceAggTrade(j, trade) ? std::size_t{1} : std::size_t{0};
+             },
+             nullptr,
+             nullptr},
+            {"mexc pb aggre.depth", "mexc_depth.pbhex", nullptr,
+             [](std::string_view frame, DepthUpdate& d, TradeVector& t) {
+                 std::string_view symbol;
+                 parseMexcPush(frame.data(), frame.size(), kTickSize, d, t, symbol);
+                 return levels(d);
+             },
+             nullptr},
+            {"mexc pb aggre.deals", "mexc_deals.pbhex", nullptr,
+             [](std::string_view frame, DepthUpdate& d, TradeVector& t) {
+                 std::string_view symbol;
+                 parseMexcPush(frame.data(), frame.size(), kTickSize, d, t, symbol);
+                 return t.size();
+             },
+             nullptr},
+            {"mexc futures push.depth", "mexc_futures_depth.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseMexcFuturesDepth(member(j, "data"), kTickSize, kContractSize, d);
+                 return levels(d);
+             },
+             nullptr,
+             nullptr},
+            {"mexc futures push.deal", "mexc_futures_deal.jsonl",
+             [](const json& j, DepthUpdate&, TradeVector& t) {
+                 parseMexcFuturesDeals(member(j, "data"), kContractSize, t);
+                 return t.size();
+             },
+             nullptr,
+             nullptr},
+            {"lighter order_book", "lighter_order_book.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseLighterOrderBook(member(j, "order_book"), kTickSize, d);
+                 return levels(d);
+             },
+             nullptr,
+             nullptr},
+            {"lighter trade", "lighter_trade.jsonl",
+             [](const json& j, DepthUpdate&, TradeVector& t) {
+                 parseLighterTrades(member(j, "trades"), t);
+                 return t.size();
+             },
+             nullptr,
+             nullptr},
+            {"paradex order_book", "paradex_order_book.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseParadexOrderBook(paradexData(j), kTickSize, d);
+                 return levels(d);
+             },
+             nullptr,
+             nullptr},
+            {"paradex trades", "paradex_trades.jsonl",
+             [](const json& j, DepthUpdate&, TradeVector&) {
+                 Trade trade;
+                 return parseParadexTrade(paradexData(j), trade) ? std::size_t{1} : std::size_t{0};
+             },
+             nullptr,
+             nullptr},
+            {"uzx depth", "uzx_depth.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector& t) {
+                 double tickSize = 0.0; // detected per frame, as on a fresh connection
+                 parseUzxFrame(j, tickSize, 120, d, t);
+                 return levels(d);
+             },
+             nullptr,
+             nullptr},
+            {"uzx fills", "uzx_fills.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector& t) {
+                 double tickSize = kTickSize;
+                 parseUzxFrame(j, tickSize, 120, d, t);
+                 return t.size();
+             },
+             nullptr,
+             nullptr},
+            {"binance depth text", "binance_depth.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseBinanceDepth(j, kTickSize, d);
+                 return levels(d);
+             },
+             nullptr,
+             [](std::string_view frame, DepthUpdate& d) {
+                 std::string_view symbol;
+                 return decodeBinanceDepth(frame, kTickSize, d, symbol);
+             }},
+            {"binance futures depth text", "binance_futures_depth.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseBinanceDepth(j, kTickSize, d);
+                 return levels(d);
+             },
+             nullptr,
+             [](std::string_view frame, DepthUpdate& d) {
+                 std::string_view symbol;
+                 return decodeBinanceDepth(frame, kTickSize, d, symbol);
+             }},
+            {"mexc futures depth text", "mexc_futures_depth.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseMexcFuturesDepth(member(j, "data"), kTickSize, kContractSize, d);
+                 d.eventTimeMs = member(j, "ts").get<std::int64_t>();
+                 return levels(d);
+             },
+             nullptr,
+             [](std::string_view frame, DepthUpdate& d) {
+                 std::string_view symbol;
+                 return decodeMexcFuturesDepth(frame, kTickSize, kContractSize, d, symbol);
+             }},
+            {"lighter order_book text", "lighter_order_book.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseLighterOrderBook(member(j, "order_book"), kTickSize, d);
+                 d.snapshot = member(j, "type") == "subscribed/order_book";
+                 return levels(d);
+             },
+             nullptr,
+             [](std::string_view frame, DepthUpdate& d) {
+                 std::string_view channel;
+                 return decodeLighterOrderBook(frame, kTickSize, d, channel);
+             }},
+            {"paradex order_book text", "paradex_order_book.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector&) {
+                 parseParadexOrderBook(paradexData(j), kTickSize, d);
+                 return levels(d);
+             },
+             nullptr,
+             [](std::string_view frame, DepthUpdate& d) {
+                 std::string_view channel;
+                 return decodeParadexOrderBook(frame, kTickSize, d, channel);
+             }},
+            {"uzx depth text", "uzx_depth.jsonl",
+             [](const json& j, DepthUpdate& d, TradeVector& t) {
+                 double tickSize = kTickSize;
+                 parseUzxFrame(j, tickSize, 120, d, t);
+                 return levels(d);
+             },
+             nullptr,
+             [](std::string_view frame, DepthUpdate& d) {
+                 return decodeUzxDepth(frame, kTickSize, 120, d);
+             }},
+        };
+    }
+
+    bool decodeHex(std::string_view hex, std::string& out)
+    {
+        auto nibble = [](char c) -> int {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        };
+        if (hex.size() % 2 != 0)
+        {
+            return false;
+        }
+        out.clear();
+        out.reserve(hex.size() / 2);
+        for (std::size_t i = 0; i < hex.size(); i += 2)
+        {
+            const int hi = nibble(hex[i]);
+            const int lo = nibble(hex[i + 1]);
+            if (hi < 0 || lo < 0)
+            {
+                return false;
+            }
+            out.push_back(static_cast<char>(hi << 4 | lo));
+        }
+        return true;
+    }
+
+    bool loadFrames(const std::filesystem::path& path, bool binary, std::vector<std::string>& frames)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+        {
+            return false;
+        }
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (line.empty())
+            {
+                continue;
+            }
+            if (binary)
+            {
+                std::string bytes;
+                if (!decodeHex(line, bytes))
+                {
+                    std::cerr << "[bench] bad hex frame in " << path.string() << std::endl;
+                    return false;
+                }
+                frames.push_back(std::move(bytes));
+            }
+            else
+            {
+                frames.push_back(std::move(line));
+            }
+        }
+        return !frames.empty();
+    }
+
+    bool sameLevels(const dom::feed::LevelVector& a, const dom::feed::LevelVector& b)
+    {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+    // Every frame must take the text path and produce what the json path does.
+    int checkText(const Case& c, const std::vector<std::string>& frames)
+    {
+        int mismatches = 0;
+        for (std::size_t i = 0; i < frames.size(); ++i)
+        {
+            dom::feed::DepthUpdate text;
+            dom::feed::DepthUpdate reference;
+            dom::feed::TradeVector trades;
+            const bool decoded = c.parseText(frames[i], text);
+            c.parseJson(json::parse(frames[i]), reference, trades);
+            if (!decoded || !sameLevels(text.bids, reference.bids) || !sameLevels(text.asks, reference.asks)
+                || text.snapshot != reference.snapshot || text.eventTimeMs != reference.eventTimeMs
+                || text.firstUpdateId != reference.firstUpdateId || text.lastUpdateId != reference.lastUpdateId
+                || text.prevUpdateId != reference.prevUpdateId)
+            {
+                if (mismatches++ < 3)
+                {
+                    std::cerr << "[bench] " << c.name << ": frame " << i
+                              << (decoded ? " differs from the json path" : " not decoded") << std::endl;
+                }
+            }
+        }
+        return mismatches;
+    }
+
+    struct Result
+    {
+        std::uint64_t frames{0};
+        std::uint64_t bytes{0};
+        std::uint64_t outputs{0};
+        std::uint64_t allocs{0};
+        double seconds{0.0};
+        double domSeconds{0.0};
+    };
+
+    Result run(const Case& c, const std::vector<std::string>& frames, std::chrono::milliseconds budget)
+    {
+        dom::FrameArena arena;
+        Result r;
+        // Warm-up pass sizes the arena, then the timed loop.
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const auto start = Clock::now();
+            const auto deadline = start + (pass == 0 ? std::chrono::milliseconds(50) : budget);
+            const auto allocsBefore = dom::threadHeapAllocations();
+            Result current;
+            do
+            {
+                for (const auto& frame : frames)
+                {
+                    arena.reset();
+                    dom::feed::DepthUpdate depth(arena.resource());
+                    dom::feed::TradeVector trades(arena.resource());
+                    if (c.parseText)
+                    {
+                        c.parseText(frame, depth);
+                        current.outputs += levels(depth);
+                    }
+                    else if (c.parseBinary)
+                    {
+                        current.outputs += c.parseBinary(frame, depth, trades);
+                    }
+                    else
+                    {
+                        const json j = json::parse(frame);
+                        current.outputs += c.parseJson(j, depth, trades);
+                    }
+                    current.bytes += frame.size();
+                    ++current.frames;
+                }
+            } while (Clock::now() < deadline);
+            current.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            current.allocs = dom::threadHeapAllocations() - allocsBefore;
+            r = current;
+        }
+
+        if (c.parseJson && !c.parseText)
+        {
+            // DOM construction alone, to split the per-frame cost.
+            const auto start = Clock::now();
+            std::uint64_t n = 0;
+            std::size_t sink = 0;
+            while (n < r.frames)
+            {
+                for (const auto& frame : frames)
+                {
+                    sink += json::parse(frame).size();
+                    if (++n >= r.frames)
+                    {
+                        break;
+                    }
+                }
+            }
+            r.domSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+            if (sink == 0)
+            {
+                std::cerr << "[bench] empty frames in " << c.file << std::endl;
+            }
+        }
+        return r;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::filesystem::path corpus = FEED_CORPUS_DIR;
+    std::chrono::milliseconds budget{1000};
+    std::string filter;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--corpus" && i + 1 < argc)
+        {
+            corpus = argv[++i];
+        }
+        else if (arg == "--ms" && i + 1 < argc)
+        {
+            budget = std::chrono::milliseconds(std::max(10, std::atoi(argv[++i])));
+        }
+        else if (arg == "--filter" && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else
+        {
+            std::cerr << "usage: feed_parse_bench [--corpus DIR] [--ms N] [--filter TEXT]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::printf("%-28s %10s %9s %10s %7s %8s %11s\n",
+                "case", "frames/s", "MB/s", "ns/frame", "dom%", "out/fr", "allocs/fr");
+    int failures = 0;
+    for (const auto& c : cases())
+    {
+        if (!filter.empty() && std::string_view(c.name).find(filter) == std::string_view::npos)
+        {
+            continue;
+        }
+        std::vector<std::string> frames;
+        if (!loadFrames(corpus / c.file, static_cast<bool>(c.parseBinary), frames))
+        {
+            std::cerr << "[bench] cannot load " << (corpus / c.file).string() << std::endl;
+            ++failures;
+            continue;
+        }
+        if (c.parseText)
+        {
+            if (const int mismatches = checkText(c, frames))
+            {
+                std::cerr << "[bench] " << c.name << ": " << mismatches << " of " << frames.size()
+                          << " frames off the json path" << std::endl;
+                ++failures;
+            }
+        }
+        const Result r = run(c, frames, budget);
+        const double frames_ = static_cast<double>(r.frames);
+        std::printf("%-28s %10.0f %9.1f %10.0f %6.0f%% %8.1f %11.2f\n",
+                    c.name,
+                    frames_ / r.seconds,
+                    static_cast<double>(r.bytes) / r.seconds / (1024.0 * 1024.0),
+                    r.seconds * 1e9 / frames_,
+                    r.domSeconds > 0.0 ? 100.0 * r.domSeconds / r.seconds : 0.0,
+                    static_cast<double>(r.outputs) / frames_,
+                    static_cast<double>(r.allocs) / frames_);
+    }
+    return failures == 0 ? 0 : 1;
+}
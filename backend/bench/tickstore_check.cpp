@@ -0,0 +1,167 @@
+// Round-trip check of the TickStore block codec and day-file reader.
+//
+//   tickstore_check
+//
+// Encodes snapshot and delta blocks whose quantities span the default 1e-8 step up to values
+// far past 2^64 steps (meme-coin sized books), decodes them directly and through a day file
+// read back with TickStoreReader::bookAt, and reports every level whose quantity drifted by
+// more than one block step or became a removal. Exits non-zero on any mismatch.
+
+#include "TickStore.hpp"
+#include "TickStoreReader.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using namespace dom::tickstore;
+
+    constexpr double kTickSize = 0.00000001;
+    constexpr double kQtyStep = 1e-8; // TickRecorder::Options default
+
+    int g_failures = 0;
+
+    void fail(const char* what, std::int64_t tick, double expected, double got)
+    {
+        ++g_failures;
+        std::printf("FAIL %s tick=%lld expected=%.17g got=%.17g\n",
+                    what,
+                    static_cast<long long>(tick),
+                    expected,
+                    got);
+    }
+
+    // Within one step of the block (relative rounding for steps coarsened past the default).
+    bool matches(double expected, double got, double step)
+    {
+        if (expected <= 0.0)
+        {
+            return got == 0.0;
+        }
+        return got > 0.0 && std::abs(got - expected) <= std::max(step, expected * 1e-15);
+    }
+
+    std::vector<Event> levels(long long tsUs, const std::vector<double>& quantities, EventKind kind)
+    {
+        std::vector<Event> out;
+        std::int64_t tick = 1000;
+        for (const double qty : quantities)
+        {
+            out.push_back({tsUs, tick++, qty, kind});
+        }
+        return out;
+    }
+
+    void checkBlock(const char* name, BlockKind kind, const std::vector<Event>& events)
+    {
+        std::string bytes;
+        encodeBlock(kind, events, kTickSize, kQtyStep, bytes);
+        BlockHeader header;
+        std::vector<Event> decoded;
+        if (!decodeBlockHeader(bytes, header)
+            || !decodeBlockPayload(header, std::string_view(bytes).substr(kBlockHeaderSize), decoded)
+            || decoded.size() != events.size())
+        {
+            fail(name, -1, static_cast<double>(events.size()), static_cast<double>(decoded.size()));
+            return;
+        }
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+            if (decoded[i].tick != events[i].tick || decoded[i].kind != events[i].kind
+                || decoded[i].tsUs != events[i].tsUs || !matches(events[i].qty, decoded[i].qty, header.qtyStep))
+            {
+                fail(name, events[i].tick, events[i].qty, decoded[i].qty);
+            }
+        }
+        std::printf("%-24s %zu events, step %.3g\n", name, events.size(), header.qtyStep);
+    }
+
+    void checkDayFile(const std::vector<Event>& snapshot, const std::vector<Event>& deltas)
+    {
+        const auto path = std::filesystem::temp_directory_path() / "tickstore_check.ftd";
+        std::string bytes;
+        encodeFileHeader({"check", "BIGQTY"}, bytes);
+        double coarsestStep = 0.0;
+        for (const auto& [kind, block] : {std::pair{BlockKind::Snapshot, &snapshot}, std::pair{BlockKind::Events, &deltas}})
+        {
+            const std::size_t start = bytes.size();
+            encodeBlock(kind, *block, kTickSize, kQtyStep, bytes);
+            BlockHeader header;
+            decodeBlockHeader(std::string_view(bytes).substr(start), header);
+            coarsestStep = std::max(coarsestStep, header.qtyStep);
+        }
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+
+        dom::TickStoreReader reader;
+        dom::TickStoreReader::Book book;
+        if (!reader.open(path.string()) || !reader.bookAt(deltas.back().tsUs, book))
+        {
+            fail("day file", -1, 0.0, 0.0);
+            std::printf("  reader: %s\n", reader.error().c_str());
+            return;
+        }
+        std::map<std::int64_t, double> expected;
+        for (const auto* block : {&snapshot, &deltas})
+        {
+            for (const auto& e : *block)
+            {
+                if (e.qty > 0.0)
+                {
+                    expected[e.tick] = e.qty;
+                }
+                else
+                {
+                    expected.erase(e.tick);
+                }
+            }
+        }
+        for (const auto& [tick, qty] : expected)
+        {
+            const auto it = book.bids.find(tick);
+            const double got = it != book.bids.end() ? it->second : 0.0;
+            if (!matches(qty, got, coarsestStep))
+            {
+                fail("day file", tick, qty, got);
+            }
+        }
+        if (book.bids.size() != expected.size())
+        {
+            fail("day file levels", -1, static_cast<double>(expected.size()), static_cast<double>(book.bids.size()));
+        }
+        std::printf("%-24s %zu levels via bookAt\n", "day file", book.bids.size());
+        std::filesystem::remove(path);
+    }
+} // namespace
+
+int main()
+{
+    const std::vector<double> small = {1e-8, 0.5, 12.25, 1e6};
+    // 1.8e11 units is where 1e-8 steps overflow 64 bits.
+    const std::vector<double> large = {1e-8, 3.0, 1.7e11, 1.9e11, 4.2e12, 9.9e15, 1.5e19, 7.3e24};
+
+    checkBlock("small quantities", BlockKind::Events, levels(1, small, EventKind::BidLevel));
+    checkBlock("large quantities", BlockKind::Events, levels(1, large, EventKind::BidLevel));
+    checkBlock("large snapshot", BlockKind::Snapshot, levels(1, large, EventKind::BidLevel));
+
+    auto deltas = levels(2, {0.0, 2.5e13, 6e20}, EventKind::BidLevel); // remove, resize, resize
+    checkDayFile(levels(1, large, EventKind::BidLevel), deltas);
+
+    if (g_failures != 0)
+    {
+        std::printf("%d mismatches\n", g_failures);
+        return 1;
+    }
+    std::printf("ok\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "OrderBook.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace dom
+{
+    // Microstructure metrics kept up to date from the book's level changes.
+    //
+    // Each book side is mirrored in a sorted map with running sums over its best `bandLevels`
+    // non-empty levels, so an update costs O(log n) per changed level: a level entering the band
+    // pushes the deepest one out, a level leaving it pulls the next one in. Trades feed a rolling
+    // signed-volume window for CVD.
+    class BookAnalytics
+    {
+    public:
+        struct Snapshot
+        {
+            bool valid{false};
+            double imbalance{0.0};  // (bid - ask) / (bid + ask) inside the band, -1..1
+            double microprice{0.0}; // top-of-book size weighted
+            double depthMid{0.0};   // size-weighted price of both bands
+            double spread{0.0};
+            double cvd{0.0};        // buy - sell base volume over the rolling window
+            double bidDepth{0.0};
+            double askDepth{0.0};
+        };
+
+        BookAnalytics(std::size_t bandLevels, long long cvdWindowMs);
+
+        // Installs the update listener on `book`.
+        void attach(OrderBook& book);
+
+        void onTrade(double qty, bool buy, long long timestampMs);
+        void resetTrades();
+
+        [[nodiscard]] Snapshot snapshot(long long nowMs);
+        [[nodiscard]] std::size_t bandLevels() const { return bandLevels_; }
+        [[nodiscard]] long long cvdWindowMs() const { return cvdWindowMs_; }
+
+    private:
+        using Tick = OrderBook::Tick;
+        using Levels = std::map<Tick, double>;
+
+        struct Side
+        {
+            bool bid{true};
+            Levels levels;
+            std::size_t banded{0}; // min(bandLevels, levels.size())
+            Tick edge{0};          // deepest level in the band, when banded > 0
+            double qty{0.0};
+            double tickWeighted{0.0}; // sum(qty * tick)
+        };
+
+        void onBookUpdate(const OrderBook& book, const std::vector<OrderBook::LevelChange>& changes, bool reset);
+        void setLevel(Side& side, Tick tick, double qty);
+        void recomputeBand(Side& side);
+        void trimTrades(long long nowMs);
+
+        static void addLevel(Side& side, Tick tick, double qty);
+        static bool deeper(const Side& side, Tick a, Tick b) { return side.bid ? a < b : a > b; }
+        // Neighbouring levels away from / towards the best price; end() when there is none.
+        static Levels::iterator deeperLevel(Side& side, Levels::iterator it);
+        static Levels::iterator betterLevel(Side& side, Levels::iterator it);
+
+        const std::size_t bandLevels_;
+        const long long cvdWindowMs_;
+        std::mutex mutex_;
+        Side bids_;
+        Side asks_;
+        double tickSize_{0.0};
+        std::uint64_t updatesSinceExact_{0};
+
+        struct SignedTrade
+        {
+            long long timestampMs;
+            double signedQty;
+        };
+        std::deque<SignedTrade> trades_;
+        double cvd_{0.0};
+    };
+} // namespace dom
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "OrderBook.hpp"
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dom
+{
+    // Merges several venue books of one instrument onto a common tick grid.
+    //
+    // Venue books report their level changes through OrderBook::addUpdateListener(); every change
+    // only touches the merged level it maps to, and syncInto() pushes the touched levels into the
+    // merged OrderBook as a regular delta. Bids are rounded down and asks up onto the grid so a
+    // single venue never crosses itself after regridding.
+    class ConsolidatedBook
+    {
+    public:
+        using Tick = OrderBook::Tick;
+
+        struct Attribution
+        {
+            Tick tick{};
+            std::vector<double> bidQuantity; // indexed like venueNames()
+            std::vector<double> askQuantity;
+        };
+
+        // gridTick <= 0 selects the coarsest tick size among the venues seen so far.
+        ConsolidatedBook(std::vector<std::string> venueNames, double gridTick);
+
+        // Installs the update listener on `book`; the book must outlive this object or be detached first.
+        void attach(std::size_t venue, OrderBook& book);
+        void detach(OrderBook& book);
+
+        [[nodiscard]] const std::vector<std::string>& venueNames() const;
+        [[nodiscard]] double gridTick() const;
+
+        // Applies pending merged-level changes to `merged`. When the grid changed (a coarser venue
+        // appeared) the merged book is reloaded instead and `regridded` is set.
+        bool syncInto(OrderBook& merged, std::size_t cacheLevelsHint, bool& regridded);
+
+        // Per-venue quantities of non-empty merged levels in [minTick, maxTick].
+        [[nodiscard]] std::vector<Attribution> attribution(Tick minTick, Tick maxTick) const;
+
+    private:
+        struct Venue
+        {
+            double tickSize{0.0};
+            std::unordered_map<Tick, double> bids; // mirror of the venue book, venue ticks
+            std::unordered_map<Tick, double> asks;
+        };
+
+        struct Level
+        {
+            std::vector<double> bid; // per venue
+            std::vector<double> ask;
+        };
+
+        void onVenueUpdate(std::size_t venue,
+                           const OrderBook& book,
+                           const std::vector<OrderBook::LevelChange>& changes,
+                           bool reset);
+        void setVenueLevel(std::size_t venue, Tick venueTick, double quantity, bool bid);
+        void clearVenueLocked(std::size_t venue);
+        void rebuildLocked();
+        [[nodiscard]] Tick toGrid(Tick venueTick, double venueTickSize, bool bid) const;
+        Level& levelAt(Tick tick);
+
+        const std::vector<std::string> names_;
+        mutable std::mutex mutex_;
+        std::vector<Venue> venues_;
+        std::map<Tick, Level> levels_;
+        std::unordered_set<Tick> dirtyBids_;
+        std::unordered_set<Tick> dirtyAsks_;
+        double gridTick_{0.0};
+        bool fixedGrid_{false};
+        bool regridPending_{false};
+    };
+} // namespace dom
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "OrderBook.hpp"
+
+#include <json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Venue frame decoders: one decoded frame in, normalized levels and trades out. They hold no
+// connection state (subscriptions, sequence numbers, trade id dedup stay with the feed loops
+// in main.cpp), so the feed_parse_bench target can drive them on recorded payloads.
+namespace dom::feed
+{
+    using json = nlohmann::json;
+    using Tick = OrderBook::Tick;
+    using LevelVector = std::pmr::vector<std::pair<Tick, double>>;
+
+    // One print; quantities are in base units (futures contracts already converted).
+    struct Trade
+    {
+        double price{0.0};
+        double qty{0.0};
+        bool buy{true};
+        std::int64_t timeMs{0}; // 0 when the venue sent none
+        long long id{0};        // venue trade id where one is sent (Lighter)
+    };
+
+    using TradeVector = std::pmr::vector<Trade>;
+
+    // Levels carried by one frame; quantity 0 removes a level unless `snapshot` is set, in
+    // which case the levels replace the book.
+    struct DepthUpdate
+    {
+        explicit DepthUpdate(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : bids(resource)
+            , asks(resource)
+        {
+        }
+
+        LevelVector bids;
+        LevelVector asks;
+        bool snapshot{false};
+        std::int64_t eventTimeMs{0};
+        // Binance sequence fields (U, u, pu); 0 elsewhere.
+        long long firstUpdateId{0};
+        long long lastUpdateId{0};
+        long long prevUpdateId{0};
+    };
+
+    // Number or decimal string; 0 for anything else.
+    double jsonToDouble(const json& value);
+
+    // Snaps `price` to the tick grid using exact decimal arithmetic; false if either is unusable.
+    bool quantizeTickFromPrice(double price, double tickSize, Tick& outTick, double& outSnappedPrice);
+
+    // quantizeTickFromPrice() with a plain rounding fallback.
+    Tick tickFromPrice(double price, double tickSize);
+
+    // Binance spot / USD-M futures "depthUpdate" event.
+    void parseBinanceDepth(const json& event, double tickSize, DepthUpdate& out);
+
+    // Binance "aggTrade" event; false when price or quantity is missing.
+    bool parseBinanceAggTrade(const json& event, Trade& out);
+
+    enum class MexcPush
+    {
+        Unknown,
+        Depth, // aggre.depth body (field 313)
+        Deals, // aggre.deals body (field 314) with at least one deal
+    };
+
+    // MEXC spot protobuf PushDataV3ApiWrapper. Fields are read in place from `data`; `symbol`
+    // views the wrapper's symbol (empty when absent).
+    MexcPush parseMexcPush(const void* data,
+                           std::size_t len,
+                           double tickSize,
+                           DepthUpdate& depth,
+                           TradeVector& deals,
+                           std::string_view& symbol);
+
+    // MEXC futures "push.depth" / "push.deal" `data` members.
+    void parseMexcFuturesDepth(const json& data, double tickSize, double contractSize, DepthUpdate& out);
+    void parseMexcFuturesDeals(const json& data, double contractSize, TradeVector& out);
+
+    // Lighter `order_book` object (snapshot or update) and `trades` array.
+    void parseLighterOrderBook(const json& orderBook, double tickSize, DepthUpdate& out);
+    void parseLighterTrades(const json& trades, TradeVector& out);
+
+    // Paradex `order_book.*` and `trades.*` subscription data.
+    void parseParadexOrderBook(const json& data, double tickSize, DepthUpdate& out);
+    bool parseParadexTrade(const json& data, Trade& out);
+
+    enum class UzxFrame
+    {
+        Depth, // full book
+        Fills,
+    };
+
+    // UZX depth or fills frame. Depth frames carry the whole book (at most `maxLevelsPerSide`
+    // levels kept per side); while `tickSize` is 0 it is detected from price decimals.
+    UzxFrame parseUzxFrame(const json& frame,
+                           double& tickSize,
+                           std::size_t maxLevelsPerSide,
+                           DepthUpdate& depth,
+                           TradeVector& fills);
+
+    // Depth frames of the JSON venues decoded straight from the frame text: no DOM and no
+    // string copies, levels go into `out`'s arena. Each returns false for any other frame
+    // (acks, pings, trades, errors) and for text it does not handle (escaped strings, unusual
+    // shapes); the feed loops then parse that frame with json and the functions above, so
+    // `out` may hold partial levels and must not be reused.
+
+    // Binance "depthUpdate" event; `symbol` is its "s" member (empty when absent).
+    bool decodeBinanceDepth(std::string_view frame, double tickSize, DepthUpdate& out, std::string_view& symbol);
+
+    // MEXC futures "push.depth" frame; eventTimeMs is the frame's "ts", `symbol` its "symbol".
+    bool decodeMexcFuturesDepth(std::string_view frame,
+                                double tickSize,
+                                double contractSize,
+                                DepthUpdate& out,
+                                std::string_view& symbol);
+
+    // Lighter "subscribed/order_book" (snapshot) or "update/order_book" frame; `channel` is its
+    // "channel" member (e.g. "order_book:1").
+    bool decodeLighterOrderBook(std::string_view frame, double tickSize, DepthUpdate& out, std::string_view& channel);
+
+    // Paradex "subscription" frame on an `order_book.*` channel, named in `channel`.
+    bool decodeParadexOrderBook(std::string_view frame, double tickSize, DepthUpdate& out, std::string_view& channel);
+
+    // UZX depth frame with the book in a `data` object. False until `tickSize` is known, so
+    // the first frame goes through parseUzxFrame() and its tick detection.
+    bool decodeUzxDepth(std::string_view frame, double tickSize, std::size_t maxLevelsPerSide, DepthUpdate& out);
+} // namespace dom::feed
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace dom
+{
+    // Monotonic scratch memory for parsing one feed frame. Everything allocated from resource()
+    // is dropped at once by reset(), so a frame's level vectors cost pointer bumps instead of
+    // heap calls. A frame that outgrows the buffer spills to the heap; the next reset() grows
+    // the buffer (up to kMaxBytes) so the spill happens only while the feed warms up.
+    //
+    // One arena per feed thread; not thread-safe.
+    class FrameArena
+    {
+    public:
+        static constexpr std::size_t kInitialBytes = 64 * 1024;
+        static constexpr std::size_t kMaxBytes = 16 * 1024 * 1024;
+
+        FrameArena();
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        [[nodiscard]] std::pmr::memory_resource* resource() { return &*arena_; }
+
+        // Frees everything handed out since the previous reset.
+        void reset();
+
+        [[nodiscard]] std::size_t capacity() const { return capacity_; }
+        // Frames that needed heap memory beyond the buffer.
+        [[nodiscard]] std::uint64_t spills() const { return spills_; }
+
+    private:
+        // Heap fallback that remembers how much the current frame took from it.
+        class Overflow : public std::pmr::memory_resource
+        {
+        public:
+            std::size_t bytes{0};
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+        };
+
+        std::unique_ptr<std::byte[]> buffer_;
+        std::size_t capacity_{0};
+        Overflow overflow_;
+        std::optional<std::pmr::monotonic_buffer_resource> arena_;
+        std::uint64_t spills_{0};
+    };
+
+    // Process-wide heap allocation counters, maintained by the replaced global operator new.
+    std::uint64_t heapAllocations();
+    // Allocations made so far by the calling thread.
+    std::uint64_t threadHeapAllocations();
+} // namespace dom
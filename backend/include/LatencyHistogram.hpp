@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace dom
+{
+    // Log-linear (HDR-style) histogram for non-negative integer samples.
+    // Each power-of-two range is split into 2^kSubBucketBits linear sub-buckets, which keeps
+    // relative error around 3% over the full 64-bit range with a fixed footprint.
+    // record() is lock-free and may be called from any thread.
+    class LatencyHistogram
+    {
+    public:
+        struct Summary
+        {
+            std::uint64_t count{};
+            std::uint64_t p50{};
+            std::uint64_t p99{};
+            std::uint64_t max{};
+        };
+
+        void record(std::uint64_t value);
+
+        // Summarizes the samples recorded since the previous call and starts a new interval.
+        Summary takeInterval();
+
+    private:
+        static constexpr int kSubBucketBits = 6;
+        static constexpr int kSubBuckets = 1 << kSubBucketBits;
+        static constexpr int kHalfBuckets = kSubBuckets / 2;
+        static constexpr int kBucketCount = kSubBuckets + (64 - kSubBucketBits) * kHalfBuckets;
+
+        static int bucketIndex(std::uint64_t value);
+        static std::uint64_t bucketUpperBound(int index);
+
+        std::array<std::atomic<std::uint64_t>, kBucketCount> counts_{};
+        std::atomic<std::uint64_t> max_{0};
+    };
+} // namespace dom
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <map>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -18,6 +20,9 @@ namespace dom
     {
     public:
         using Tick = std::int64_t;
+        // Parsed (tick, quantity) updates; any contiguous container converts, including the
+        // arena-backed vectors the feed parsers fill.
+        using LevelUpdates = std::span<const std::pair<Tick, double>>;
 
         struct Row
         {
@@ -26,10 +31,27 @@ namespace dom
             double askQuantity{};
         };
 
+        // One level as reported to the update listener; quantity 0 means the level is gone.
+        struct LevelChange
+        {
+            Tick tick{};
+            double quantity{};
+            bool bid{};
+        };
+
+        // Observer for every level mutation, including cache-window pruning and the crossed-book
+        // cleanup. `reset` is set when the book was replaced (clear/loadSnapshot); `changes` then
+        // lists the complete new book.
+        using UpdateListener =
+            std::function<void(const OrderBook& book, const std::vector<LevelChange>& changes, bool reset)>;
+
         OrderBook();
 
         void clear();
 
+        void addUpdateListener(UpdateListener listener);
+        void clearUpdateListeners();
+
         // Set tick size (price step) in quote currency.
         void setTickSize(double tickSize);
 
@@ -37,13 +59,10 @@ namespace dom
         void setCacheLevelsPerSide(std::size_t levels);
 
         // Snapshot from REST depth, prices in ticks.
-        void loadSnapshot(const std::vector<std::pair<Tick, double>>& bids,
-                          const std::vector<std::pair<Tick, double>>& asks);
+        void loadSnapshot(LevelUpdates bids, LevelUpdates asks);
 
         // Incremental updates from aggre.depth stream, prices in ticks.
-        void applyDelta(const std::vector<std::pair<Tick, double>>& bids,
-                        const std::vector<std::pair<Tick, double>>& asks,
-                        std::size_t cacheLevelsHint);
+        void applyDelta(LevelUpdates bids, LevelUpdates asks, std::size_t cacheLevelsHint);
 
         [[nodiscard]] double bestBid() const;
         [[nodiscard]] double bestAsk() const;
@@ -60,6 +79,13 @@ namespace dom
                                                     Tick *outWindowMax = nullptr,
                                                     Tick *outCenter = nullptr) const;
 
+        // Non-empty cached levels with ticks in [minTick, maxTick], descending like ladderSparse().
+        // Independent of the ladder window and its center.
+        [[nodiscard]] std::vector<Row> rowsInRange(Tick minTick, Tick maxTick) const;
+
+        // Lowest and highest tick held on either side; false for an empty book.
+        bool cachedTickRange(Tick& outMinTick, Tick& outMaxTick) const;
+
         void shiftManualCenterTicks(Tick delta);
         void clearManualCenter();
 
@@ -77,9 +103,13 @@ namespace dom
         mutable bool manualCenterActive_{false};
         std::size_t cacheLevelsPerSide_{5000};
 
-        static void applySide(BookSide& side,
-                              const std::vector<std::pair<Tick, double>>& updates);
-        static void pruneOutsideWindow(BookSide& side, Tick minTick, Tick maxTick);
+        std::vector<UpdateListener> listeners_;
+        std::vector<LevelChange> changes_;
+
+        void applySide(BookSide& side, LevelUpdates updates, bool bidSide);
+        void pruneOutsideWindow(BookSide& side, Tick minTick, Tick maxTick, bool bidSide);
+        void recordChange(Tick tick, double quantity, bool bidSide);
+        void notifyListener(bool reset);
         bool resolveAutoCenterTick(Tick& outTick) const;
         void pruneToCacheWindow(Tick anchorTick);
         bool computeWindow(std::size_t levelsPerSide,
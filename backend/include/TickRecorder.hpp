@@ -0,0 +1,115 @@
+#pragma once
+
+#include "OrderBook.hpp"
+#include "TickStore.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dom
+{
+    // Records book level changes and trades into TickStore files under
+    // `<directory>/<exchange>/<SYMBOL>/<YYYYMMDD>.ftd` (UTC days).
+    //
+    // The feed path only appends to an in-memory queue; a writer thread owns the files, encodes
+    // and compresses blocks and keeps a book mirror so it can write a snapshot block every
+    // `snapshotIntervalMs` (and at the start of each file) for seeking.
+    class TickRecorder
+    {
+    public:
+        struct Options
+        {
+            std::string directory;
+            long long snapshotIntervalMs{60000};
+            long long flushIntervalMs{1000};
+            double qtyStep{1e-8};
+        };
+
+        explicit TickRecorder(Options options);
+        ~TickRecorder();
+
+        TickRecorder(const TickRecorder&) = delete;
+        TickRecorder& operator=(const TickRecorder&) = delete;
+
+        // Installs the update listener on `book`.
+        void attach(OrderBook& book);
+
+        // Following events belong to this stream; closes the current file.
+        void setStream(const std::string& exchange, const std::string& symbol);
+
+        void onTrade(double price, double qty, bool buy);
+
+        [[nodiscard]] std::uint64_t bytesWritten() const;
+
+    private:
+        using Tick = OrderBook::Tick;
+
+        enum class ItemKind : std::uint8_t
+        {
+            Bid,
+            Ask,
+            BuyTrade,
+            SellTrade,
+            Reset,       // a full book follows as Bid/Ask items, closed by ResetEnd
+            ResetEnd,
+            TickSize,    // qty carries the new tick size
+            Stream,      // next entry of streams_
+        };
+
+        struct Item
+        {
+            ItemKind kind{ItemKind::Bid};
+            Tick tick{0};
+            double qty{0.0};
+            long long tsUs{0};
+        };
+
+        void onBookUpdate(const OrderBook& book, const std::vector<OrderBook::LevelChange>& changes, bool reset);
+        void writerLoop();
+        void process(const std::vector<Item>& items);
+        void append(tickstore::EventKind kind, Tick tick, double qty, long long tsUs);
+        bool ensureFile(long long tsUs);
+        void openFile(long long day);
+        void closeFile();
+        void flushBlock();
+        void writeSnapshot(long long tsUs);
+        void writeBytes(const std::string& bytes);
+
+        const Options options_;
+
+        // Feed side.
+        std::mutex queueMutex_;
+        std::condition_variable queueCv_;
+        std::vector<Item> queue_;
+        std::deque<std::pair<std::string, std::string>> streams_;
+        double feedTickSize_{0.0};
+        bool stop_{false};
+
+        // Writer side (writer thread only).
+        std::string exchange_;
+        std::string symbol_;
+        double tickSize_{0.0};
+        long long day_{-1};
+        std::ofstream file_;
+        std::ofstream index_;
+        std::uint64_t offset_{0};
+        std::vector<tickstore::Event> block_;
+        std::map<Tick, double> bids_;
+        std::map<Tick, double> asks_;
+        bool inReset_{false};
+        long long lastSnapshotUs_{0};
+        bool openFailed_{false};
+        std::atomic<std::uint64_t> bytesWritten_{0};
+
+        std::thread writer_;
+    };
+} // namespace dom
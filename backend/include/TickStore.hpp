@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dom::tickstore
+{
+    // On-disk layout of recorded market data (one file per exchange/symbol/UTC day):
+    //
+    //   file header   "FTD1", u32 version, u16 + exchange, u16 + symbol
+    //   block*        BlockHeader + payload (LZ compressed unless it would not shrink)
+    //
+    // A payload is `count` events stored column by column: kinds (1 byte each), timestamps
+    // (zigzag varint delta from the previous event, the first from `firstTsUs`), ticks (zigzag
+    // varint delta from the previous event) and quantities (varint multiples of `qtyStep`).
+    // encodeBlock() coarsens the requested step by powers of ten for a block whose largest
+    // quantity would not fit 62 bits; the step used is the one in the block header.
+    // Snapshot blocks hold the whole book and reset it; their offsets are also appended to a
+    // sidecar "<day>.idx" file of fixed IndexEntry records so readers can seek without scanning.
+
+    constexpr std::uint32_t kFileMagic = 0x31445446;  // "FTD1"
+    constexpr std::uint32_t kBlockMagic = 0x31425446; // "FTB1"
+    constexpr std::uint32_t kVersion = 1;
+    constexpr std::size_t kBlockHeaderSize = 52;
+    constexpr std::size_t kIndexEntrySize = 16;
+
+    enum class EventKind : std::uint8_t
+    {
+        BidLevel = 0,
+        AskLevel = 1,
+        BuyTrade = 2,
+        SellTrade = 3,
+    };
+
+    enum class BlockKind : std::uint8_t
+    {
+        Events = 0,
+        Snapshot = 1,
+    };
+
+    enum class Codec : std::uint8_t
+    {
+        Raw = 0,
+        Lz = 1,
+    };
+
+    struct Event
+    {
+        long long tsUs{0};
+        std::int64_t tick{0};
+        double qty{0.0};
+        EventKind kind{EventKind::BidLevel};
+    };
+
+    struct BlockHeader
+    {
+        BlockKind kind{BlockKind::Events};
+        Codec codec{Codec::Raw};
+        std::uint32_t count{0};
+        std::uint32_t rawBytes{0};
+        std::uint32_t storedBytes{0};
+        long long firstTsUs{0};
+        long long lastTsUs{0};
+        double tickSize{0.0};
+        double qtyStep{0.0};
+    };
+
+    struct IndexEntry
+    {
+        long long tsUs{0};
+        std::uint64_t offset{0};
+    };
+
+    struct FileHeader
+    {
+        std::string exchange;
+        std::string symbol;
+    };
+
+    void encodeFileHeader(const FileHeader& header, std::string& out);
+    // Returns the header size, or 0 if `data` does not start with a valid header.
+    std::size_t decodeFileHeader(std::string_view data, FileHeader& header);
+
+    void encodeBlockHeader(const BlockHeader& header, std::string& out);
+    bool decodeBlockHeader(std::string_view data, BlockHeader& header);
+
+    void encodeIndexEntry(const IndexEntry& entry, std::string& out);
+    IndexEntry decodeIndexEntry(const unsigned char* data);
+
+    // Quantities beyond 2^62 steps are clamped; positive ones are stored as at least one step.
+    void encodeEvents(const std::vector<Event>& events, long long firstTsUs, double qtyStep, std::string& out);
+    bool decodeEvents(std::string_view data, std::uint32_t count, long long firstTsUs, double qtyStep, std::vector<Event>& out);
+
+    // LZ77 with a 64 KiB window, LZ4-style sequences (token, literals, u16 offset, match length).
+    void lzCompress(std::string_view in, std::string& out);
+    bool lzDecompress(std::string_view in, std::size_t rawSize, std::string& out);
+
+    // Encodes events into a complete block (header + payload), compressing when it pays off.
+    void encodeBlock(BlockKind kind,
+                     const std::vector<Event>& events,
+                     double tickSize,
+                     double qtyStep,
+                     std::string& out);
+    // Decodes the payload that follows `header`.
+    bool decodeBlockPayload(const BlockHeader& header, std::string_view payload, std::vector<Event>& out);
+} // namespace dom::tickstore
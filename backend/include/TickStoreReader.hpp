@@ -0,0 +1,109 @@
+#pragma once
+
+#include "TickStore.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dom
+{
+    // Read-only memory mapping of a file, viewed through one window at a time so scanning a
+    // day file never keeps more than a window of it mapped.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::string& path);
+        void close();
+
+        [[nodiscard]] bool isOpen() const { return size_ > 0; }
+        [[nodiscard]] std::uint64_t size() const { return size_; }
+
+        // Bytes [offset, offset + length), or nullptr past the end of the file. Valid until the
+        // next call (which may move the window).
+        const unsigned char* view(std::uint64_t offset, std::size_t length);
+
+    private:
+        void unmapWindow();
+
+#if defined(_WIN32)
+        void* file_{nullptr};
+        void* mapping_{nullptr};
+#else
+        int fd_{-1};
+#endif
+        std::uint64_t size_{0};
+        const unsigned char* window_{nullptr};
+        std::uint64_t windowOffset_{0};
+        std::size_t windowSize_{0};
+    };
+
+    // Random-access reader for one TickStore day file (see TickStore.hpp). Blocks are read from
+    // a mapped window of the file and the sidecar index is binary searched in place, so a
+    // lookup costs one snapshot plus at most one snapshot interval of deltas.
+    class TickStoreReader
+    {
+    public:
+        struct Book
+        {
+            double tickSize{0.0};
+            long long tsUs{0};
+            std::map<std::int64_t, double> bids;
+            std::map<std::int64_t, double> asks;
+        };
+
+        // Walks blocks in file order. Cursors share the reader's window and must not outlive it.
+        class Cursor
+        {
+        public:
+            Cursor() = default;
+
+            // Reads the next block; false at the end of the file or at a damaged block.
+            bool next(tickstore::BlockHeader& header, std::vector<tickstore::Event>& events);
+
+            [[nodiscard]] std::uint64_t offset() const { return offset_; }
+
+        private:
+            friend class TickStoreReader;
+
+            TickStoreReader* reader_{nullptr};
+            std::uint64_t offset_{0};
+            std::size_t skip_{0}; // events of the next block already consumed by bookAt()
+        };
+
+        bool open(const std::string& path);
+
+        [[nodiscard]] const tickstore::FileHeader& header() const { return header_; }
+        [[nodiscard]] const std::string& error() const { return error_; }
+
+        // Offset of the newest snapshot at or before `tsUs`, or of the first block when there
+        // is none (or no index file).
+        [[nodiscard]] std::uint64_t snapshotOffset(long long tsUs);
+
+        // Cursor on snapshotOffset(tsUs); callers scanning a range skip events before `tsUs`.
+        Cursor cursor(long long tsUs);
+
+        // Rebuilds the book as of `tsUs` (every event stamped at or before it applied). When
+        // `rest` is given it is left on the first later event. False if no snapshot precedes
+        // `tsUs`, in which case `book` holds only the deltas seen since the file start.
+        bool bookAt(long long tsUs, Book& book, Cursor* rest = nullptr);
+
+    private:
+        bool readBlock(std::uint64_t& offset, tickstore::BlockHeader& header, std::vector<tickstore::Event>& events);
+
+        MappedFile file_;
+        MappedFile index_;
+        tickstore::FileHeader header_;
+        std::uint64_t dataStart_{0};
+        std::size_t indexCount_{0};
+        std::string error_;
+    };
+} // namespace dom
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "OrderBook.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace dom
+{
+    // Tracks large resting levels ("walls") from the book's level changes.
+    //
+    // A level becomes a wall once its notional reaches `minNotional` and stops being one below 75%
+    // of it, so a wall hovering at the threshold does not flicker. Decreases are split into traded
+    // (matched against prints at that tick) and pulled. A wall that disappears and reappears on the
+    // same side within `moveTicks`/`moveWindowMs` at a similar size keeps its id and counts as moved.
+    class WallTracker
+    {
+    public:
+        using Tick = OrderBook::Tick;
+
+        struct Wall
+        {
+            std::uint64_t id{0};
+            bool bid{true};
+            Tick tick{0};
+            double qty{0.0};
+            double peakQty{0.0};
+            double added{0.0};
+            double pulled{0.0};
+            double traded{0.0};
+            int moves{0};
+            Tick movedTicks{0}; // signed distance travelled since first seen
+            long long firstSeenMs{0};
+            bool lastDecreaseTraded{false};
+        };
+
+        enum class EventKind
+        {
+            Add,
+            Update,
+            Remove,
+        };
+
+        struct Event
+        {
+            EventKind kind{EventKind::Update};
+            Wall wall;
+        };
+
+        WallTracker(double minNotional, Tick moveTicks, long long moveWindowMs);
+
+        // Installs the update listener on `book`.
+        void attach(OrderBook& book);
+
+        // Prints are mapped onto the book's tick grid, so venue and merged books both work.
+        void onTrade(double price, double qty, bool buy);
+
+        // Coalesced changes since the previous call; one event per wall.
+        std::vector<Event> drainEvents();
+
+        [[nodiscard]] double tickSize() const;
+
+    private:
+        struct Removed
+        {
+            Wall wall;
+            long long removedMs{0};
+        };
+
+        void onBookUpdate(const OrderBook& book, const std::vector<OrderBook::LevelChange>& changes, bool reset);
+        void setLevel(bool bid, Tick tick, double qty, long long nowMs);
+        void removeWall(std::uint64_t id, long long nowMs);
+        bool adoptMovedWall(bool bid, Tick tick, double qty, long long nowMs);
+        [[nodiscard]] double notional(Tick tick, double qty) const;
+
+        const double minNotional_;
+        const Tick moveTicks_;
+        const long long moveWindowMs_;
+
+        mutable std::mutex mutex_;
+        double tickSize_{0.0};
+        std::uint64_t nextId_{1};
+        std::unordered_map<std::uint64_t, Wall> walls_;
+        std::unordered_map<Tick, std::uint64_t> bidIndex_;
+        std::unordered_map<Tick, std::uint64_t> askIndex_;
+        std::unordered_map<std::uint64_t, double> pendingTraded_; // prints not yet matched to a decrease
+        std::vector<Removed> removed_;                            // move candidates, reported when they expire
+        std::vector<std::uint64_t> added_;
+        std::unordered_set<std::uint64_t> dirty_;
+    };
+} // namespace dom
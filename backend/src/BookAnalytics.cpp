@@ -0,0 +1,236 @@
+#include "BookAnalytics.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace dom
+{
+    namespace
+    {
+        // Running sums drift with floating point; rebuild them exactly now and then.
+        constexpr std::uint64_t kExactRecomputeEvery = 4096;
+    } // namespace
+
+    BookAnalytics::BookAnalytics(std::size_t bandLevels, long long cvdWindowMs)
+        : bandLevels_(std::max<std::size_t>(bandLevels, 1)),
+          cvdWindowMs_(std::max<long long>(cvdWindowMs, 1000))
+    {
+        bids_.bid = true;
+        asks_.bid = false;
+    }
+
+    void BookAnalytics::attach(OrderBook& book)
+    {
+        book.addUpdateListener([this](const OrderBook& b,
+                                      const std::vector<OrderBook::LevelChange>& changes,
+                                      bool reset) {
+            onBookUpdate(b, changes, reset);
+        });
+    }
+
+    void BookAnalytics::onTrade(double qty, bool buy, long long timestampMs)
+    {
+        if (!(qty > 0.0))
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const double signedQty = buy ? qty : -qty;
+        trades_.push_back(SignedTrade{timestampMs, signedQty});
+        cvd_ += signedQty;
+        trimTrades(timestampMs);
+    }
+
+    void BookAnalytics::resetTrades()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        trades_.clear();
+        cvd_ = 0.0;
+    }
+
+    BookAnalytics::Snapshot BookAnalytics::snapshot(long long nowMs)
+    {
+        Snapshot out;
+        std::lock_guard<std::mutex> lock(mutex_);
+        trimTrades(nowMs);
+        out.cvd = cvd_;
+        if (tickSize_ <= 0.0 || bids_.levels.empty() || asks_.levels.empty())
+        {
+            return out;
+        }
+        const auto bestBid = bids_.levels.rbegin();
+        const auto bestAsk = asks_.levels.begin();
+        const double bidPx = static_cast<double>(bestBid->first) * tickSize_;
+        const double askPx = static_cast<double>(bestAsk->first) * tickSize_;
+        const double topQty = bestBid->second + bestAsk->second;
+
+        out.valid = true;
+        out.spread = askPx - bidPx;
+        out.microprice = topQty > 0.0 ? (bidPx * bestAsk->second + askPx * bestBid->second) / topQty
+                                      : 0.5 * (bidPx + askPx);
+        out.bidDepth = bids_.qty;
+        out.askDepth = asks_.qty;
+        const double depth = bids_.qty + asks_.qty;
+        if (depth > 0.0)
+        {
+            out.imbalance = (bids_.qty - asks_.qty) / depth;
+            out.depthMid = (bids_.tickWeighted + asks_.tickWeighted) / depth * tickSize_;
+        }
+        return out;
+    }
+
+    void BookAnalytics::onBookUpdate(const OrderBook& book,
+                                     const std::vector<OrderBook::LevelChange>& changes,
+                                     bool reset)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tickSize_ = book.tickSize();
+        if (reset)
+        {
+            for (Side* side : {&bids_, &asks_})
+            {
+                side->levels.clear();
+                side->banded = 0;
+                side->qty = 0.0;
+                side->tickWeighted = 0.0;
+            }
+        }
+        for (const auto& change : changes)
+        {
+            setLevel(change.bid ? bids_ : asks_, change.tick, change.quantity);
+        }
+        updatesSinceExact_ += changes.size();
+        if (reset || updatesSinceExact_ >= kExactRecomputeEvery)
+        {
+            updatesSinceExact_ = 0;
+            recomputeBand(bids_);
+            recomputeBand(asks_);
+        }
+    }
+
+    void BookAnalytics::setLevel(Side& side, Tick tick, double qty)
+    {
+        const bool inBand = side.banded > 0 && !deeper(side, tick, side.edge);
+        auto it = side.levels.find(tick);
+        if (it != side.levels.end() && qty > 0.0)
+        {
+            if (inBand)
+            {
+                addLevel(side, tick, qty - it->second);
+            }
+            it->second = qty;
+            return;
+        }
+        if (it != side.levels.end())
+        {
+            if (!inBand)
+            {
+                side.levels.erase(it);
+                return;
+            }
+            // A banded level goes: the first level past the edge, if any, takes its place.
+            addLevel(side, tick, -it->second);
+            const auto edgeIt = tick == side.edge ? it : side.levels.find(side.edge);
+            const auto next = deeperLevel(side, edgeIt);
+            const auto shallower = betterLevel(side, edgeIt);
+            const bool refill = next != side.levels.end();
+            if (refill)
+            {
+                addLevel(side, next->first, next->second);
+                side.edge = next->first;
+            }
+            else if (tick == side.edge && shallower != side.levels.end())
+            {
+                side.edge = shallower->first;
+            }
+            side.levels.erase(it);
+            if (!refill)
+            {
+                --side.banded;
+            }
+            return;
+        }
+        if (!(qty > 0.0))
+        {
+            return;
+        }
+        it = side.levels.emplace(tick, qty).first;
+        if (side.banded < bandLevels_)
+        {
+            // Every level is in the band while the side has fewer than bandLevels_.
+            addLevel(side, tick, qty);
+            if (side.banded == 0 || deeper(side, tick, side.edge))
+            {
+                side.edge = tick;
+            }
+            ++side.banded;
+        }
+        else if (inBand)
+        {
+            // The new level pushes the deepest banded one out.
+            addLevel(side, tick, qty);
+            const auto edgeIt = side.levels.find(side.edge);
+            addLevel(side, edgeIt->first, -edgeIt->second);
+            side.edge = betterLevel(side, edgeIt)->first;
+        }
+    }
+
+    void BookAnalytics::recomputeBand(Side& side)
+    {
+        side.qty = 0.0;
+        side.tickWeighted = 0.0;
+        side.banded = 0;
+        const auto take = [&side, this](auto first, auto last) {
+            for (; first != last && side.banded < bandLevels_; ++first, ++side.banded)
+            {
+                addLevel(side, first->first, first->second);
+                side.edge = first->first;
+            }
+        };
+        if (side.bid)
+        {
+            take(side.levels.rbegin(), side.levels.rend());
+        }
+        else
+        {
+            take(side.levels.begin(), side.levels.end());
+        }
+    }
+
+    void BookAnalytics::addLevel(Side& side, Tick tick, double qty)
+    {
+        side.qty += qty;
+        side.tickWeighted += qty * static_cast<double>(tick);
+    }
+
+    BookAnalytics::Levels::iterator BookAnalytics::deeperLevel(Side& side, Levels::iterator it)
+    {
+        if (side.bid)
+        {
+            return it == side.levels.begin() ? side.levels.end() : std::prev(it);
+        }
+        return std::next(it);
+    }
+
+    BookAnalytics::Levels::iterator BookAnalytics::betterLevel(Side& side, Levels::iterator it)
+    {
+        if (side.bid)
+        {
+            return std::next(it);
+        }
+        return it == side.levels.begin() ? side.levels.end() : std::prev(it);
+    }
+
+    void BookAnalytics::trimTrades(long long nowMs)
+    {
+        while (!trades_.empty() && nowMs - trades_.front().timestampMs > cvdWindowMs_)
+        {
+            cvd_ -= trades_.front().signedQty;
+            trades_.pop_front();
+        }
+        if (trades_.empty())
+        {
+            cvd_ = 0.0;
+        }
+    }
+} // namespace dom
@@ -0,0 +1,300 @@
+#include "ConsolidatedBook.hpp"
+
+#include <cmath>
+#include <utility>
+
+namespace dom
+{
+    namespace
+    {
+        constexpr double kQtyEpsilon = 1e-12;
+
+        double sumOf(const std::vector<double>& values)
+        {
+            double total = 0.0;
+            for (double v : values)
+            {
+                total += v;
+            }
+            return total;
+        }
+    } // namespace
+
+    ConsolidatedBook::ConsolidatedBook(std::vector<std::string> venueNames, double gridTick)
+        : names_(std::move(venueNames)),
+          venues_(names_.size())
+    {
+        if (gridTick > 0.0)
+        {
+            gridTick_ = gridTick;
+            fixedGrid_ = true;
+        }
+    }
+
+    void ConsolidatedBook::attach(std::size_t venue, OrderBook& book)
+    {
+        if (venue >= venues_.size())
+        {
+            return;
+        }
+        book.addUpdateListener([this, venue](const OrderBook& b,
+                                             const std::vector<OrderBook::LevelChange>& changes,
+                                             bool reset) {
+            onVenueUpdate(venue, b, changes, reset);
+        });
+    }
+
+    void ConsolidatedBook::detach(OrderBook& book)
+    {
+        book.clearUpdateListeners();
+    }
+
+    const std::vector<std::string>& ConsolidatedBook::venueNames() const
+    {
+        return names_;
+    }
+
+    double ConsolidatedBook::gridTick() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return gridTick_;
+    }
+
+    bool ConsolidatedBook::syncInto(OrderBook& merged, std::size_t cacheLevelsHint, bool& regridded)
+    {
+        regridded = false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (gridTick_ <= 0.0)
+        {
+            return false;
+        }
+
+        if (regridPending_ || merged.tickSize() != gridTick_)
+        {
+            std::vector<std::pair<Tick, double>> bids;
+            std::vector<std::pair<Tick, double>> asks;
+            for (const auto& [tick, level] : levels_)
+            {
+                const double bid = sumOf(level.bid);
+                const double ask = sumOf(level.ask);
+                if (bid > kQtyEpsilon)
+                {
+                    bids.emplace_back(tick, bid);
+                }
+                if (ask > kQtyEpsilon)
+                {
+                    asks.emplace_back(tick, ask);
+                }
+            }
+            merged.setTickSize(gridTick_);
+            merged.loadSnapshot(bids, asks);
+            dirtyBids_.clear();
+            dirtyAsks_.clear();
+            regridPending_ = false;
+            regridded = true;
+            return true;
+        }
+
+        if (dirtyBids_.empty() && dirtyAsks_.empty())
+        {
+            return false;
+        }
+
+        std::vector<std::pair<Tick, double>> bids;
+        std::vector<std::pair<Tick, double>> asks;
+        bids.reserve(dirtyBids_.size());
+        asks.reserve(dirtyAsks_.size());
+        auto collect = [&](const std::unordered_set<Tick>& dirty,
+                           std::vector<std::pair<Tick, double>>& out,
+                           bool bid) {
+            for (Tick tick : dirty)
+            {
+                auto it = levels_.find(tick);
+                const double total = (it == levels_.end()) ? 0.0 : sumOf(bid ? it->second.bid : it->second.ask);
+                out.emplace_back(tick, total > kQtyEpsilon ? total : 0.0);
+            }
+        };
+        collect(dirtyBids_, bids, true);
+        collect(dirtyAsks_, asks, false);
+
+        // Drop merged levels no venue contributes to any more.
+        auto dropEmpty = [&](const std::unordered_set<Tick>& dirty) {
+            for (Tick tick : dirty)
+            {
+                auto it = levels_.find(tick);
+                if (it != levels_.end() && sumOf(it->second.bid) <= kQtyEpsilon
+                    && sumOf(it->second.ask) <= kQtyEpsilon)
+                {
+                    levels_.erase(it);
+                }
+            }
+        };
+        dropEmpty(dirtyBids_);
+        dropEmpty(dirtyAsks_);
+        dirtyBids_.clear();
+        dirtyAsks_.clear();
+
+        merged.applyDelta(bids, asks, cacheLevelsHint);
+        return true;
+    }
+
+    std::vector<ConsolidatedBook::Attribution> ConsolidatedBook::attribution(Tick minTick, Tick maxTick) const
+    {
+        std::vector<Attribution> out;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = levels_.lower_bound(minTick); it != levels_.end() && it->first <= maxTick; ++it)
+        {
+            const Level& level = it->second;
+            if (sumOf(level.bid) <= kQtyEpsilon && sumOf(level.ask) <= kQtyEpsilon)
+            {
+                continue;
+            }
+            out.push_back(Attribution{it->first, level.bid, level.ask});
+        }
+        return out;
+    }
+
+    void ConsolidatedBook::onVenueUpdate(std::size_t venue,
+                                         const OrderBook& book,
+                                         const std::vector<OrderBook::LevelChange>& changes,
+                                         bool reset)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Venue& v = venues_[venue];
+        if (reset)
+        {
+            clearVenueLocked(venue);
+        }
+
+        bool gridChanged = false;
+        const double tickSize = book.tickSize();
+        if (tickSize > 0.0 && tickSize != v.tickSize)
+        {
+            // Mirrored ticks are in the old units; the venue reloads its book right after a tick change.
+            clearVenueLocked(venue);
+            v.tickSize = tickSize;
+            if (!fixedGrid_ && tickSize > gridTick_)
+            {
+                gridTick_ = tickSize;
+                gridChanged = true;
+            }
+        }
+
+        for (const auto& change : changes)
+        {
+            setVenueLevel(venue, change.tick, change.quantity, change.bid);
+        }
+
+        if (gridChanged)
+        {
+            rebuildLocked();
+        }
+    }
+
+    void ConsolidatedBook::setVenueLevel(std::size_t venue, Tick venueTick, double quantity, bool bid)
+    {
+        Venue& v = venues_[venue];
+        auto& mirror = bid ? v.bids : v.asks;
+        double previous = 0.0;
+        auto it = mirror.find(venueTick);
+        if (it != mirror.end())
+        {
+            previous = it->second;
+        }
+        if (quantity > 0.0)
+        {
+            mirror[venueTick] = quantity;
+        }
+        else if (it != mirror.end())
+        {
+            mirror.erase(it);
+        }
+
+        const double delta = (quantity > 0.0 ? quantity : 0.0) - previous;
+        if (delta == 0.0 || v.tickSize <= 0.0 || gridTick_ <= 0.0)
+        {
+            return;
+        }
+        const Tick tick = toGrid(venueTick, v.tickSize, bid);
+        Level& level = levelAt(tick);
+        double& slot = bid ? level.bid[venue] : level.ask[venue];
+        slot += delta;
+        if (slot < kQtyEpsilon)
+        {
+            slot = 0.0;
+        }
+        (bid ? dirtyBids_ : dirtyAsks_).insert(tick);
+    }
+
+    void ConsolidatedBook::clearVenueLocked(std::size_t venue)
+    {
+        Venue& v = venues_[venue];
+        if (v.tickSize > 0.0 && gridTick_ > 0.0)
+        {
+            auto drop = [&](const std::unordered_map<Tick, double>& mirror, bool bid) {
+                for (const auto& [venueTick, qty] : mirror)
+                {
+                    const Tick tick = toGrid(venueTick, v.tickSize, bid);
+                    auto it = levels_.find(tick);
+                    if (it == levels_.end())
+                    {
+                        continue;
+                    }
+                    double& slot = bid ? it->second.bid[venue] : it->second.ask[venue];
+                    slot -= qty;
+                    if (slot < kQtyEpsilon)
+                    {
+                        slot = 0.0;
+                    }
+                    (bid ? dirtyBids_ : dirtyAsks_).insert(tick);
+                }
+            };
+            drop(v.bids, true);
+            drop(v.asks, false);
+        }
+        v.bids.clear();
+        v.asks.clear();
+    }
+
+    void ConsolidatedBook::rebuildLocked()
+    {
+        levels_.clear();
+        dirtyBids_.clear();
+        dirtyAsks_.clear();
+        for (std::size_t venue = 0; venue < venues_.size(); ++venue)
+        {
+            const Venue& v = venues_[venue];
+            if (v.tickSize <= 0.0)
+            {
+                continue;
+            }
+            for (const auto& [venueTick, qty] : v.bids)
+            {
+                levelAt(toGrid(venueTick, v.tickSize, true)).bid[venue] += qty;
+            }
+            for (const auto& [venueTick, qty] : v.asks)
+            {
+                levelAt(toGrid(venueTick, v.tickSize, false)).ask[venue] += qty;
+            }
+        }
+        regridPending_ = true;
+    }
+
+    OrderBook::Tick ConsolidatedBook::toGrid(Tick venueTick, double venueTickSize, bool bid) const
+    {
+        const double scaled = static_cast<double>(venueTick) * venueTickSize / gridTick_;
+        // Nudge so that prices sitting exactly on the grid are not pushed a full step away.
+        return static_cast<Tick>(bid ? std::floor(scaled + 1e-9) : std::ceil(scaled - 1e-9));
+    }
+
+    ConsolidatedBook::Level& ConsolidatedBook::levelAt(Tick tick)
+    {
+        Level& level = levels_[tick];
+        if (level.bid.size() != venues_.size())
+        {
+            level.bid.resize(venues_.size(), 0.0);
+            level.ask.resize(venues_.size(), 0.0);
+        }
+        return level;
+    }
+} // namespace dom
@@ -0,0 +1,1451 @@
+#include "FeedParsers.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace dom::feed
+{
+    namespace
+    {
+        // Minimal protobuf reader for the MEXC push messages.
+        struct ProtoReader
+        {
+            const std::uint8_t* data{};
+            std::size_t size{};
+            std::size_t pos{};
+
+            ProtoReader(const void* ptr, std::size_t len)
+                : data(static_cast<const std::uint8_t*>(ptr))
+                , size(len)
+            {
+            }
+
+            bool eof() const { return pos >= size; }
+
+            bool readVarint(std::uint64_t& out)
+            {
+                out = 0;
+                int shift = 0;
+                while (pos < size && shift < 64)
+                {
+                    std::uint8_t b = data[pos++];
+                    out |= (std::uint64_t(b & 0x7F) << shift);
+                    if ((b & 0x80) == 0)
+                    {
+                        return true;
+                    }
+                    shift += 7;
+                }
+                return false;
+            }
+
+            // `out` points into the frame buffer; nothing is copied.
+            bool readLengthDelimited(std::string_view& out)
+            {
+                std::uint64_t len = 0;
+                if (!readVarint(len) || len > size - pos)
+                {
+                    return false;
+                }
+                out = std::string_view(reinterpret_cast<const char*>(data + pos), static_cast<std::size_t>(len));
+                pos += static_cast<std::size_t>(len);
+                return true;
+            }
+
+            bool skipField(std::uint64_t key)
+            {
+                const auto wireType = key & 0x7;
+                switch (wireType)
+                {
+                case 0: // varint
+                {
+                    std::uint64_t dummy;
+                    return readVarint(dummy);
+                }
+                case 1: // 64-bit
+                    if (pos + 8 > size) return false;
+                    pos += 8;
+                    return true;
+                case 2: // length-delimited
+                {
+                    std::string_view dummy;
+                    return readLengthDelimited(dummy);
+                }
+                case 5: // 32-bit
+                    if (pos + 4 > size) return false;
+                    pos += 4;
+                    return true;
+                default:
+                    return false;
+                }
+            }
+        };
+
+        bool parseDecimal(std::string_view s, double& out)
+        {
+            const auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+            return res.ec == std::errc() && res.ptr == s.data() + s.size();
+        }
+
+        // Member lookup without the copy json::value() makes of arrays and objects.
+        const json& member(const json& object, const char* key)
+        {
+            static const json empty;
+            if (!object.is_object())
+            {
+                return empty;
+            }
+            const auto it = object.find(key);
+            return it != object.end() ? *it : empty;
+        }
+
+        long long jsonToLongLong(const json& v)
+        {
+            try
+            {
+                if (v.is_number_integer())
+                {
+                    return v.get<long long>();
+                }
+                if (v.is_number_float())
+                {
+                    const double d = v.get<double>();
+                    return std::isfinite(d) ? static_cast<long long>(std::llround(d)) : 0LL;
+                }
+                if (v.is_string())
+                {
+                    const std::string& s = v.get_ref<const std::string&>();
+                    if (s.empty())
+                    {
+                        return 0LL;
+                    }
+                    std::size_t idx = 0;
+                    const long long out = std::stoll(s, &idx, 10);
+                    return idx > 0 ? out : 0LL;
+                }
+            }
+            catch (...)
+            {
+            }
+            return 0LL;
+        }
+
+        // [[price, qty, ...], ...] rows as sent by Binance and MEXC.
+        void parseRows(const json& rows, double tickSize, double qtyScale, bool dropInvalid, LevelVector& out)
+        {
+            if (!rows.is_array())
+            {
+                return;
+            }
+            out.reserve(out.size() + rows.size());
+            for (const auto& row : rows)
+            {
+                if (!row.is_array() || row.size() < 2) continue;
+                const double price = jsonToDouble(row[0]);
+                const double qty = jsonToDouble(row[1]) * qtyScale;
+                if (dropInvalid && (price <= 0.0 || qty < 0.0)) continue;
+                out.emplace_back(tickFromPrice(price, tickSize), qty);
+            }
+        }
+
+        void parseMexcDepthItem(std::string_view buf, double tickSize, LevelVector& out)
+        {
+            ProtoReader r(buf.data(), buf.size());
+            std::string_view priceStr;
+            std::string_view qtyStr;
+            while (!r.eof())
+            {
+                std::uint64_t key = 0;
+                if (!r.readVarint(key)) break;
+                const auto field = key >> 3;
+                if ((key & 0x7) != 2)
+                {
+                    if (!r.skipField(key)) break;
+                    continue;
+                }
+                std::string_view value;
+                if (!r.readLengthDelimited(value)) break;
+                if (field == 1)
+                {
+                    priceStr = value;
+                }
+                else if (field == 2)
+                {
+                    qtyStr = value;
+                }
+            }
+
+            double price = 0.0;
+            double qty = 0.0;
+            if (!priceStr.empty() && tickSize > 0.0 && parseDecimal(priceStr, price)
+                && (qtyStr.empty() || parseDecimal(qtyStr, qty)))
+            {
+                out.emplace_back(tickFromPrice(price, tickSize), qty);
+            }
+        }
+
+        void parseMexcAggreDepth(std::string_view buf, double tickSize, DepthUpdate& out)
+        {
+            ProtoReader r(buf.data(), buf.size());
+            while (!r.eof())
+            {
+                std::uint64_t key = 0;
+                if (!r.readVarint(key)) break;
+                const auto field = key >> 3;
+                if ((key & 0x7) != 2)
+                {
+                    if (!r.skipField(key)) break;
+                    continue;
+                }
+                std::string_view msg;
+                if (!r.readLengthDelimited(msg)) break;
+                if (field == 1) // asks
+                {
+                    parseMexcDepthItem(msg, tickSize, out.asks);
+                }
+                else if (field == 2) // bids
+                {
+                    parseMexcDepthItem(msg, tickSize, out.bids);
+                }
+                // fromVersion / toVersion are not needed
+            }
+        }
+
+        void parseMexcDealItem(std::string_view buf, TradeVector& out)
+        {
+            ProtoReader r(buf.data(), buf.size());
+            std::string_view priceStr;
+            std::string_view qtyStr;
+            int tradeType = 0;
+            std::int64_t time = 0;
+            while (!r.eof())
+            {
+                std::uint64_t key = 0;
+                if (!r.readVarint(key)) break;
+                const auto field = key >> 3;
+                const auto wire = key & 0x7;
+                if (wire == 2)
+                {
+                    std::string_view value;
+                    if (!r.readLengthDelimited(value)) break;
+                    if (field == 1)
+                    {
+                        priceStr = value;
+                    }
+                    else if (field == 2)
+                    {
+                        qtyStr = value;
+                    }
+                }
+                else if (wire == 0)
+                {
+                    std::uint64_t v = 0;
+                    if (!r.readVarint(v)) break;
+                    if (field == 3)
+                    {
+                        tradeType = static_cast<int>(v);
+                    }
+                    else if (field == 4)
+                    {
+                        time = static_cast<std::int64_t>(v);
+                    }
+                }
+                else if (!r.skipField(key))
+                {
+                    break;
+                }
+            }
+
+            Trade trade;
+            if (priceStr.empty() || qtyStr.empty() || !parseDecimal(priceStr, trade.price)
+                || !parseDecimal(qtyStr, trade.qty) || trade.qty <= 0.0)
+            {
+                return;
+            }
+            trade.timeMs = time;
+            // tradeType: 1 = buy, 2 = sell
+            trade.buy = (tradeType != 2);
+            out.push_back(trade);
+        }
+
+        void parseMexcAggreDeals(std::string_view buf, TradeVector& out)
+        {
+            ProtoReader r(buf.data(), buf.size());
+            while (!r.eof())
+            {
+                std::uint64_t key = 0;
+                if (!r.readVarint(key)) break;
+                const auto field = key >> 3;
+                if ((key & 0x7) != 2)
+                {
+                    if (!r.skipField(key)) break;
+                    continue;
+                }
+                std::string_view msg;
+                if (!r.readLengthDelimited(msg)) break;
+                if (field == 1) // repeated deals
+                {
+                    parseMexcDealItem(msg, out);
+                }
+                // field 2 = eventType
+            }
+        }
+
+        // Decimals of a price string: "0.00120" -> 1e-5. 0 without a fraction.
+        double tickFromDecimals(std::string_view priceStr)
+        {
+            const auto pos = priceStr.find('.');
+            if (pos == std::string_view::npos)
+            {
+                return 0.0;
+            }
+            const int decimals = static_cast<int>(priceStr.size() - pos - 1);
+            if (decimals <= 0 || decimals > 12) return 0.0;
+            return std::pow(10.0, -decimals);
+        }
+
+        void parseUzxSide(const json& side, double& tickSize, std::size_t maxLevels, LevelVector& out)
+        {
+            if (!side.is_array())
+            {
+                return;
+            }
+            std::size_t kept = 0;
+            for (const auto& lvl : side)
+            {
+                if (!lvl.is_array() || lvl.size() < 2) continue;
+                const double price = jsonToDouble(lvl[0]);
+                const double qty = jsonToDouble(lvl[1]);
+                if (price <= 0.0 || qty <= 0.0) continue;
+                if (tickSize <= 0.0 && lvl[0].is_string())
+                {
+                    tickSize = tickFromDecimals(lvl[0].get_ref<const std::string&>());
+                }
+                if (tickSize <= 0.0) continue;
+                out.emplace_back(static_cast<Tick>(std::llround(price / tickSize)), qty);
+                if (++kept >= maxLevels)
+                {
+                    break;
+                }
+            }
+        }
+
+        void parseUzxFill(const json& fill, std::int64_t parentTs, TradeVector& out)
+        {
+            if (!fill.is_object())
+            {
+                return;
+            }
+            Trade trade;
+            trade.price = jsonToDouble(member(fill, "price"));
+            trade.qty = jsonToDouble(member(fill, "vol"));
+            if (trade.price <= 0.0 || trade.qty <= 0.0)
+            {
+                return;
+            }
+            const json& direction = member(fill, "direction");
+            trade.buy = !(direction.is_string() && direction.get_ref<const std::string&>() == "sell");
+            const json& ts = member(fill, "ts");
+            trade.timeMs = ts.is_number() ? ts.get<std::int64_t>() : parentTs;
+            out.push_back(trade);
+        }
+
+        // Fills come either directly in `data` or one level down in `data[i].data`.
+        void parseUzxFills(const json& data, std::int64_t parentTs, TradeVector& out)
+        {
+            const json& nested = member(data, "data");
+            if (nested.is_array())
+            {
+                for (const auto& fill : nested)
+                {
+                    parseUzxFill(fill, parentTs, out);
+                }
+                return;
+            }
+            parseUzxFill(data, parentTs, out);
+        }
+
+        bool isUzxFillsType(const json& type)
+        {
+            return type.is_string() && type.get_ref<const std::string&>().find("fills") != std::string::npos;
+        }
+
+        // Forward-only reader over one JSON text frame for the decode* functions. Strings and
+        // numbers come back as views into the frame. Strings carrying escapes are refused, so
+        // such a frame takes the json path, which unescapes them.
+        struct TextReader
+        {
+            struct Scalar
+            {
+                enum class Type
+                {
+                    Null,
+                    Bool,
+                    Number,
+                    String,
+                };
+
+                Type type{Type::Null};
+                std::string_view text; // number literal or string body
+                bool boolean{false};
+            };
+
+            const char* p{};
+            const char* end{};
+
+            explicit TextReader(std::string_view frame)
+                : p(frame.data())
+                , end(frame.data() + frame.size())
+            {
+            }
+
+            bool fail()
+            {
+                p = end;
+                return false;
+            }
+
+            void skipWs()
+            {
+                while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+                {
+                    ++p;
+                }
+            }
+
+            bool atEnd()
+            {
+                skipWs();
+                return p >= end;
+            }
+
+            bool consume(char c)
+            {
+                skipWs();
+                if (p < end && *p == c)
+                {
+                    ++p;
+                    return true;
+                }
+                return false;
+            }
+
+            bool peek(char c)
+            {
+                skipWs();
+                return p < end && *p == c;
+            }
+
+            bool string(std::string_view& out)
+            {
+                if (!consume('"'))
+                {
+                    return fail();
+                }
+                const void* close = std::memchr(p, '"', static_cast<std::size_t>(end - p));
+                if (!close)
+                {
+                    return fail();
+                }
+                const char* stop = static_cast<const char*>(close);
+                if (std::memchr(p, '\\', static_cast<std::size_t>(stop - p)))
+                {
+                    return fail();
+                }
+                out = std::string_view(p, static_cast<std::size_t>(stop - p));
+                p = stop + 1;
+                return true;
+            }
+
+            bool literal(std::string_view word)
+            {
+                if (static_cast<std::size_t>(end - p) < word.size() || std::memcmp(p, word.data(), word.size()) != 0)
+                {
+                    return false;
+                }
+                p += word.size();
+                return true;
+            }
+
+            bool scalar(Scalar& out)
+            {
+                skipWs();
+                if (p >= end)
+                {
+                    return fail();
+                }
+                const char c = *p;
+                if (c == '"')
+                {
+                    out.type = Scalar::Type::String;
+                    return string(out.text);
+                }
+                if (c == '-' || (c >= '0' && c <= '9'))
+                {
+                    const char* start = p;
+                    while (p < end && (*p == '-' || *p == '+' || *p == '.' || *p == 'e' || *p == 'E'
+                                       || (*p >= '0' && *p <= '9')))
+                    {
+                        ++p;
+                    }
+                    out.type = Scalar::Type::Number;
+                    out.text = std::string_view(start, static_cast<std::size_t>(p - start));
+                    return true;
+                }
+                if (literal("true"))
+                {
+                    out.type = Scalar::Type::Bool;
+                    out.boolean = true;
+                    return true;
+                }
+                if (literal("false"))
+                {
+                    out.type = Scalar::Type::Bool;
+                    out.boolean = false;
+                    return true;
+                }
+                if (literal("null"))
+                {
+                    out.type = Scalar::Type::Null;
+                    return true;
+                }
+                return fail();
+            }
+
+            bool skipString()
+            {
+                ++p; // opening quote
+                while (p < end)
+                {
+                    const char c = *p++;
+                    if (c == '\\')
+                    {
+                        ++p;
+                    }
+                    else if (c == '"')
+                    {
+                        return true;
+                    }
+                }
+                return fail();
+            }
+
+            bool skipValue()
+            {
+                skipWs();
+                if (p >= end)
+                {
+                    return fail();
+                }
+                if (*p == '"')
+                {
+                    return skipString();
+                }
+                if (*p == '{' || *p == '[')
+                {
+                    int depth = 0;
+                    while (p < end)
+                    {
+                        const char c = *p;
+                        if (c == '"')
+                        {
+                            if (!skipString())
+                            {
+                                return false;
+                            }
+                            continue;
+                        }
+                        ++p;
+                        if (c == '{' || c == '[')
+                        {
+                            ++depth;
+                        }
+                        else if ((c == '}' || c == ']') && --depth == 0)
+                        {
+                            return true;
+                        }
+                    }
+                    return fail();
+                }
+                Scalar ignored;
+                return scalar(ignored);
+            }
+
+            // member(key) consumes the member's value.
+            template <typename Fn>
+            bool object(Fn&& member)
+            {
+                if (!consume('{'))
+                {
+                    return fail();
+                }
+                if (consume('}'))
+                {
+                    return true;
+                }
+                do
+                {
+                    std::string_view key;
+                    if (!string(key) || !consume(':') || !member(key))
+                    {
+                        return fail();
+                    }
+                } while (consume(','));
+                return consume('}') || fail();
+            }
+
+            // element() consumes one element.
+            template <typename Fn>
+            bool array(Fn&& element)
+            {
+                if (!consume('['))
+                {
+                    return fail();
+                }
+                if (consume(']'))
+                {
+                    return true;
+                }
+                do
+                {
+                    if (!element())
+                    {
+                        return fail();
+                    }
+                } while (consume(','));
+                return consume(']') || fail();
+            }
+        };
+
+        using TextScalar = TextReader::Scalar;
+
+        // Leading blanks and '+' accepted, as by the std::stod / std::stoll fallbacks above.
+        std::string_view trimNumberText(std::string_view s)
+        {
+            std::size_t i = 0;
+            while (i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\n' || s[i] == '\r'))
+            {
+                ++i;
+            }
+            if (i < s.size() && s[i] == '+')
+            {
+                ++i;
+            }
+            return s.substr(i);
+        }
+
+        // jsonToDouble() for a text scalar.
+        double textToDouble(const TextScalar& v)
+        {
+            if (v.type != TextScalar::Type::Number && v.type != TextScalar::Type::String)
+            {
+                return 0.0;
+            }
+            const std::string_view s = v.type == TextScalar::Type::String ? trimNumberText(v.text) : v.text;
+            double out = 0.0;
+            const auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+            return res.ec == std::errc() && res.ptr != s.data() ? out : 0.0;
+        }
+
+        // jsonToLongLong() for a text scalar: integers as-is, other numbers rounded, strings by
+        // their leading digits.
+        long long textToLongLong(const TextScalar& v)
+        {
+            long long out = 0;
+            if (v.type == TextScalar::Type::String)
+            {
+                const std::string_view s = trimNumberText(v.text);
+                const auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+                return res.ec == std::errc() && res.ptr != s.data() ? out : 0LL;
+            }
+            if (v.type != TextScalar::Type::Number)
+            {
+                return 0LL;
+            }
+            const auto res = std::from_chars(v.text.data(), v.text.data() + v.text.size(), out);
+            if (res.ec == std::errc() && res.ptr == v.text.data() + v.text.size())
+            {
+                return out;
+            }
+            const double d = textToDouble(v);
+            return std::isfinite(d) ? static_cast<long long>(std::llround(d)) : 0LL;
+        }
+
+        template <typename Int>
+        bool readInteger(TextReader& r, Int& out)
+        {
+            TextScalar v;
+            if (!r.scalar(v))
+            {
+                return false;
+            }
+            out = static_cast<Int>(textToLongLong(v));
+            return true;
+        }
+
+        // Reads `fn(reader)` for an array value; anything else is skipped, as the DOM parsers
+        // ignore members of the wrong type.
+        template <typename Fn>
+        bool readArrayOrSkip(TextReader& r, Fn&& element)
+        {
+            if (!r.peek('['))
+            {
+                return r.skipValue();
+            }
+            return r.array(element);
+        }
+
+        // Text counterpart of parseRows(). Rows whose leading cells are not scalars are left
+        // to the json path.
+        bool readRows(TextReader& r, double tickSize, double qtyScale, bool dropInvalid, LevelVector& out)
+        {
+            return readArrayOrSkip(r, [&]() {
+                if (!r.peek('['))
+                {
+                    return r.skipValue();
+                }
+                TextScalar priceCell;
+                TextScalar qtyCell;
+                std::size_t cells = 0;
+                const bool ok = r.array([&]() {
+                    ++cells;
+                    if (cells == 1)
+                    {
+                        return r.scalar(priceCell);
+                    }
+                    if (cells == 2)
+                    {
+                        return r.scalar(qtyCell);
+                    }
+                    return r.skipValue();
+                });
+                if (!ok)
+                {
+                    return false;
+                }
+                if (cells >= 2)
+                {
+                    const double price = textToDouble(priceCell);
+                    const double qty = textToDouble(qtyCell) * qtyScale;
+                    if (!dropInvalid || (price > 0.0 && qty >= 0.0))
+                    {
+                        out.emplace_back(tickFromPrice(price, tickSize), qty);
+                    }
+                }
+                return true;
+            });
+        }
+
+        // Text counterpart of parseUzxSide() once the tick size is known.
+        bool readUzxSide(TextReader& r, double tickSize, std::size_t maxLevels, LevelVector& out)
+        {
+            std::size_t kept = 0;
+            return readArrayOrSkip(r, [&]() {
+                if (kept >= maxLevels || !r.peek('['))
+                {
+                    return r.skipValue();
+                }
+                TextScalar priceCell;
+                TextScalar qtyCell;
+                std::size_t cells = 0;
+                const bool ok = r.array([&]() {
+                    ++cells;
+                    if (cells == 1)
+                    {
+                        return r.scalar(priceCell);
+                    }
+                    if (cells == 2)
+                    {
+                        return r.scalar(qtyCell);
+                    }
+                    return r.skipValue();
+                });
+                const double price = textToDouble(priceCell);
+                const double qty = textToDouble(qtyCell);
+                if (ok && cells >= 2 && price > 0.0 && qty > 0.0)
+                {
+                    out.emplace_back(static_cast<Tick>(std::llround(price / tickSize)), qty);
+                    ++kept;
+                }
+                return ok;
+            });
+        }
+
+        // Text counterpart of parseLighterOrderBook()'s side parser.
+        bool readLighterSide(TextReader& r, double tickSize, LevelVector& out)
+        {
+            return readArrayOrSkip(r, [&]() {
+                if (!r.peek('{'))
+                {
+                    return r.skipValue();
+                }
+                TextScalar priceCell;
+                TextScalar sizeCell;
+                if (!r.object([&](std::string_view key) {
+                        if (key == "price")
+                        {
+                            return r.scalar(priceCell);
+                        }
+                        if (key == "size")
+                        {
+                            return r.scalar(sizeCell);
+                        }
+                        return r.skipValue();
+                    }))
+                {
+                    return false;
+                }
+                const double price = textToDouble(priceCell);
+                const double qty = textToDouble(sizeCell);
+                if (!(price > 0.0) || !std::isfinite(price) || !std::isfinite(qty))
+                {
+                    return true;
+                }
+                Tick tick = 0;
+                double snapped = price;
+                if (quantizeTickFromPrice(price, tickSize, tick, snapped))
+                {
+                    out.emplace_back(tick, qty);
+                }
+                return true;
+            });
+        }
+
+        // One entry of a Paradex order book `inserts` array.
+        bool readParadexInsert(TextReader& r, double tickSize, DepthUpdate& out)
+        {
+            if (!r.peek('{'))
+            {
+                return r.skipValue();
+            }
+            TextScalar side;
+            TextScalar priceCell;
+            TextScalar sizeCell;
+            if (!r.object([&](std::string_view key) {
+                    if (key == "side")
+                    {
+                        return r.scalar(side);
+                    }
+                    if (key == "price")
+                    {
+                        return r.scalar(priceCell);
+                    }
+                    if (key == "size")
+                    {
+                        return r.scalar(sizeCell);
+                    }
+                    return r.skipValue();
+                }))
+            {
+                return false;
+            }
+            if (side.type != TextScalar::Type::String)
+            {
+                return true;
+            }
+            const double price = textToDouble(priceCell);
+            const double qty = textToDouble(sizeCell);
+            if (!(price > 0.0) || !(qty >= 0.0))
+            {
+                return true;
+            }
+            if (side.text == "BUY")
+            {
+                out.bids.emplace_back(tickFromPrice(price, tickSize), qty);
+            }
+            else if (side.text == "SELL")
+            {
+                out.asks.emplace_back(tickFromPrice(price, tickSize), qty);
+            }
+            return true;
+        }
+
+        // isUzxFillsType() for a text scalar.
+        bool isUzxFillsText(const TextScalar& type)
+        {
+            return type.type == TextScalar::Type::String && type.text.find("fills") != std::string_view::npos;
+        }
+    } // namespace
+
+    double jsonToDouble(const json& value)
+    {
+        if (value.is_number_float())
+        {
+            return value.get<double>();
+        }
+        if (value.is_number_integer())
+        {
+            return static_cast<double>(value.get<std::int64_t>());
+        }
+        if (value.is_string())
+        {
+            const std::string& s = value.get_ref<const std::string&>();
+            double out = 0.0;
+            const auto res = std::from_chars(s.data(), s.data() + s.size(), out);
+            if (res.ec == std::errc() && res.ptr != s.data())
+            {
+                return out;
+            }
+            // Leading blanks or '+' are rare; let stod deal with them.
+            try
+            {
+                return std::stod(s);
+            }
+            catch (...)
+            {
+                return 0.0;
+            }
+        }
+        return 0.0;
+    }
+
+    bool quantizeTickFromPrice(double price, double tickSize, Tick& outTick, double& outSnappedPrice)
+    {
+        if (!(tickSize > 0.0) || !std::isfinite(tickSize) || !(price > 0.0) || !std::isfinite(price))
+        {
+            return false;
+        }
+
+        std::int64_t scale = 1;
+        for (int decimals = 0; decimals <= 12; ++decimals, scale *= 10)
+        {
+            const double scaledTickSizeD = tickSize * static_cast<double>(scale);
+            if (!std::isfinite(scaledTickSizeD))
+            {
+                continue;
+            }
+            const std::int64_t tickSizeScaled = static_cast<std::int64_t>(std::llround(scaledTickSizeD));
+            if (tickSizeScaled <= 0)
+            {
+                continue;
+            }
+            if (std::abs(scaledTickSizeD - static_cast<double>(tickSizeScaled)) > 1e-9)
+            {
+                continue;
+            }
+
+            const std::int64_t priceScaled = static_cast<std::int64_t>(std::llround(price * static_cast<double>(scale)));
+            std::int64_t tick = 0;
+            if (priceScaled >= 0)
+            {
+                tick = (priceScaled + tickSizeScaled / 2) / tickSizeScaled;
+            }
+            else
+            {
+                tick = -((-priceScaled + tickSizeScaled / 2) / tickSizeScaled);
+            }
+            outTick = static_cast<Tick>(tick);
+            const std::int64_t snappedScaled = tick * tickSizeScaled;
+            outSnappedPrice = static_cast<double>(snappedScaled) / static_cast<double>(scale);
+            return std::isfinite(outSnappedPrice);
+        }
+
+        return false;
+    }
+
+    Tick tickFromPrice(double price, double tickSize)
+    {
+        Tick tick = 0;
+        double snappedPrice = price;
+        if (quantizeTickFromPrice(price, tickSize, tick, snappedPrice))
+        {
+            return tick;
+        }
+        return static_cast<Tick>(std::llround(price / tickSize));
+    }
+
+    void parseBinanceDepth(const json& event, double tickSize, DepthUpdate& out)
+    {
+        out.firstUpdateId = jsonToLongLong(member(event, "U"));
+        out.lastUpdateId = jsonToLongLong(member(event, "u"));
+        out.prevUpdateId = jsonToLongLong(member(event, "pu"));
+        out.eventTimeMs = jsonToLongLong(member(event, "E"));
+        parseRows(member(event, "b"), tickSize, 1.0, false, out.bids);
+        parseRows(member(event, "a"), tickSize, 1.0, false, out.asks);
+    }
+
+    bool parseBinanceAggTrade(const json& event, Trade& out)
+    {
+        out.price = jsonToDouble(member(event, "p"));
+        out.qty = jsonToDouble(member(event, "q"));
+        const json& maker = member(event, "m");
+        out.buy = !(maker.is_boolean() && maker.get<bool>());
+        const json& tradeTime = member(event, "T");
+        out.timeMs = jsonToLongLong(tradeTime.is_null() ? member(event, "E") : tradeTime);
+        return out.price > 0.0 && out.qty > 0.0;
+    }
+
+    MexcPush parseMexcPush(const void* data,
+                           std::size_t len,
+                           double tickSize,
+                           DepthUpdate& depth,
+                           TradeVector& deals,
+                           std::string_view& symbol)
+    {
+        ProtoReader r(data, len);
+        std::string_view depthBody;
+        std::string_view dealsBody;
+        symbol = {};
+        while (!r.eof())
+        {
+            std::uint64_t key = 0;
+            if (!r.readVarint(key)) break;
+            const auto field = key >> 3;
+            if ((key & 0x7) != 2)
+            {
+                if (!r.skipField(key)) break;
+                continue;
+            }
+            std::string_view value;
+            if (!r.readLengthDelimited(value)) break;
+            if (field == 3)
+            {
+                symbol = value;
+            }
+            else if (field == 313)
+            {
+                depthBody = value;
+            }
+            else if (field == 314)
+            {
+                dealsBody = value;
+            }
+        }
+
+        if (!dealsBody.empty())
+        {
+            parseMexcAggreDeals(dealsBody, deals);
+            if (!deals.empty())
+            {
+                return MexcPush::Deals;
+            }
+        }
+        if (!depthBody.empty())
+        {
+            parseMexcAggreDepth(depthBody, tickSize, depth);
+            return MexcPush::Depth;
+        }
+        return MexcPush::Unknown;
+    }
+
+    void parseMexcFuturesDepth(const json& data, double tickSize, double contractSize, DepthUpdate& out)
+    {
+        parseRows(member(data, "bids"), tickSize, contractSize, true, out.bids);
+        parseRows(member(data, "asks"), tickSize, contractSize, true, out.asks);
+    }
+
+    void parseMexcFuturesDeals(const json& data, double contractSize, TradeVector& out)
+    {
+        if (!data.is_array())
+        {
+            return;
+        }
+        for (const auto& d : data)
+        {
+            Trade trade;
+            trade.price = jsonToDouble(member(d, "p"));
+            trade.qty = jsonToDouble(member(d, "v"));
+            if (trade.price <= 0.0 || trade.qty <= 0.0)
+            {
+                continue;
+            }
+            trade.qty *= contractSize;
+            trade.buy = jsonToLongLong(member(d, "T")) != 2;
+            trade.timeMs = jsonToLongLong(member(d, "t"));
+            out.push_back(trade);
+        }
+    }
+
+    void parseLighterOrderBook(const json& orderBook, double tickSize, DepthUpdate& out)
+    {
+        auto parseSide = [tickSize](const json& levels, LevelVector& side) {
+            if (!levels.is_array())
+            {
+                return;
+            }
+            side.reserve(levels.size());
+            for (const auto& lvl : levels)
+            {
+                if (!lvl.is_object())
+                {
+                    continue;
+                }
+                const double price = jsonToDouble(member(lvl, "price"));
+                const double qty = jsonToDouble(member(lvl, "size"));
+                if (!(price > 0.0) || !std::isfinite(price) || !std::isfinite(qty))
+                {
+                    continue;
+                }
+                Tick tick = 0;
+                double snapped = price;
+                if (!quantizeTickFromPrice(price, tickSize, tick, snapped))
+                {
+                    continue;
+                }
+                side.emplace_back(tick, qty);
+            }
+        };
+        parseSide(member(orderBook, "bids"), out.bids);
+        parseSide(member(orderBook, "asks"), out.asks);
+    }
+
+    void parseLighterTrades(const json& trades, TradeVector& out)
+    {
+        if (!trades.is_array())
+        {
+            return;
+        }
+        for (const auto& t : trades)
+        {
+            if (!t.is_object())
+            {
+                continue;
+            }
+            Trade trade;
+            trade.price = jsonToDouble(member(t, "price"));
+            trade.qty = jsonToDouble(member(t, "size"));
+            if (!(trade.price > 0.0) || !(trade.qty > 0.0) || !std::isfinite(trade.price) || !std::isfinite(trade.qty))
+            {
+                continue;
+            }
+            trade.id = jsonToLongLong(member(t, "trade_id"));
+            const json& makerAsk = member(t, "is_maker_ask");
+            trade.buy = makerAsk.is_boolean() && makerAsk.get<bool>();
+            trade.timeMs = jsonToLongLong(member(t, "timestamp"));
+            out.push_back(trade);
+        }
+    }
+
+    void parseParadexOrderBook(const json& data, double tickSize, DepthUpdate& out)
+    {
+        out.snapshot = true;
+        out.eventTimeMs = jsonToLongLong(member(data, "last_updated_at"));
+        const json& inserts = member(data, "inserts");
+        if (!inserts.is_array())
+        {
+            return;
+        }
+        out.bids.reserve(inserts.size());
+        out.asks.reserve(inserts.size());
+        for (const auto& e : inserts)
+        {
+            if (!e.is_object()) continue;
+            const json& side = member(e, "side");
+            if (!side.is_string()) continue;
+            const double price = jsonToDouble(member(e, "price"));
+            const double qty = jsonToDouble(member(e, "size"));
+            if (!(price > 0.0) || !(qty >= 0.0)) continue;
+            const std::string& s = side.get_ref<const std::string&>();
+            if (s == "BUY")
+            {
+                out.bids.emplace_back(tickFromPrice(price, tickSize), qty);
+            }
+            else if (s == "SELL")
+            {
+                out.asks.emplace_back(tickFromPrice(price, tickSize), qty);
+            }
+        }
+    }
+
+    bool parseParadexTrade(const json& data, Trade& out)
+    {
+        out.price = jsonToDouble(member(data, "price"));
+        out.qty = jsonToDouble(member(data, "size"));
+        const json& side = member(data, "side");
+        out.buy = side.is_string() && side.get_ref<const std::string&>() == "BUY";
+        out.timeMs = jsonToLongLong(member(data, "created_at"));
+        return out.price > 0.0 && out.qty > 0.0;
+    }
+
+    UzxFrame parseUzxFrame(const json& frame,
+                           double& tickSize,
+                           std::size_t maxLevelsPerSide,
+                           DepthUpdate& depth,
+                           TradeVector& fills)
+    {
+        const std::int64_t parentTs = jsonToLongLong(member(frame, "ts"));
+        const json& data = member(frame, "data");
+        if (isUzxFillsType(member(frame, "type")))
+        {
+            if (data.is_array())
+            {
+                for (const auto& entry : data)
+                {
+                    parseUzxFills(entry, parentTs, fills);
+                }
+            }
+            else if (data.is_object())
+            {
+                parseUzxFills(data, parentTs, fills);
+            }
+            return UzxFrame::Fills;
+        }
+        if (data.is_object() && isUzxFillsType(member(data, "type")))
+        {
+            parseUzxFills(data, parentTs, fills);
+            return UzxFrame::Fills;
+        }
+        if (data.is_array())
+        {
+            for (const auto& entry : data)
+            {
+                if (entry.is_object() && isUzxFillsType(member(entry, "type")))
+                {
+                    parseUzxFills(entry, parentTs, fills);
+                    return UzxFrame::Fills;
+                }
+            }
+        }
+
+        const json& book = data.is_object() ? data : frame;
+        const json& bids = member(book, "bids");
+        const json& asks = member(book, "asks");
+        depth.snapshot = true;
+        parseUzxSide(bids.is_null() ? member(book, "b") : bids, tickSize, maxLevelsPerSide, depth.bids);
+        parseUzxSide(asks.is_null() ? member(book, "a") : asks, tickSize, maxLevelsPerSide, depth.asks);
+        return UzxFrame::Depth;
+    }
+
+    bool decodeBinanceDepth(std::string_view frame, double tickSize, DepthUpdate& out, std::string_view& symbol)
+    {
+        TextReader r(frame);
+        std::string_view event;
+        bool result = false;
+        symbol = {};
+        const bool ok = r.object([&](std::string_view key) {
+            if (key == "e")
+            {
+                return r.string(event);
+            }
+            if (key == "s")
+            {
+                return r.string(symbol);
+            }
+            if (key == "E")
+            {
+                return readInteger(r, out.eventTimeMs);
+            }
+            if (key == "U")
+            {
+                return readInteger(r, out.firstUpdateId);
+            }
+            if (key == "u")
+            {
+                return readInteger(r, out.lastUpdateId);
+            }
+            if (key == "pu")
+            {
+                return readInteger(r, out.prevUpdateId);
+            }
+            if (key == "b")
+            {
+                return readRows(r, tickSize, 1.0, false, out.bids);
+            }
+            if (key == "a")
+            {
+                return readRows(r, tickSize, 1.0, false, out.asks);
+            }
+            if (key == "result")
+            {
+                result = true;
+            }
+            return r.skipValue();
+        });
+        return ok && r.atEnd() && !result && event == "depthUpdate";
+    }
+
+    bool decodeMexcFuturesDepth(std::string_view frame,
+                                double tickSize,
+                                double contractSize,
+                                DepthUpdate& out,
+                                std::string_view& symbol)
+    {
+        TextReader r(frame);
+        std::string_view channel;
+        bool haveData = false;
+        symbol = {};
+        const bool ok = r.object([&](std::string_view key) {
+            if (key == "channel")
+            {
+                return r.string(channel);
+            }
+            if (key == "symbol")
+            {
+                return r.string(symbol);
+            }
+            if (key == "ts")
+            {
+                return readInteger(r, out.eventTimeMs);
+            }
+            if (key != "data" || !r.peek('{'))
+            {
+                return r.skipValue();
+            }
+            haveData = true;
+            return r.object([&](std::string_view field) {
+                if (field == "bids")
+                {
+                    return readRows(r, tickSize, contractSize, true, out.bids);
+                }
+                if (field == "asks")
+                {
+                    return readRows(r, tickSize, contractSize, true, out.asks);
+                }
+                return r.skipValue();
+            });
+        });
+        return ok && r.atEnd() && haveData && channel == "push.depth";
+    }
+
+    bool decodeLighterOrderBook(std::string_view frame, double tickSize, DepthUpdate& out, std::string_view& channel)
+    {
+        TextReader r(frame);
+        std::string_view type;
+        bool haveBook = false;
+        channel = {};
+        const bool ok = r.object([&](std::string_view key) {
+            if (key == "type")
+            {
+                return r.string(type);
+            }
+            if (key == "channel")
+            {
+                return r.string(channel);
+            }
+            if (key != "order_book" || !r.peek('{'))
+            {
+                return r.skipValue();
+            }
+            haveBook = true;
+            return r.object([&](std::string_view field) {
+                if (field == "bids")
+                {
+                    return readLighterSide(r, tickSize, out.bids);
+                }
+                if (field == "asks")
+                {
+                    return readLighterSide(r, tickSize, out.asks);
+                }
+                return r.skipValue();
+            });
+        });
+        out.snapshot = (type == "subscribed/order_book");
+        return ok && r.atEnd() && haveBook && (out.snapshot || type == "update/order_book");
+    }
+
+    bool decodeParadexOrderBook(std::string_view frame, double tickSize, DepthUpdate& out, std::string_view& channel)
+    {
+        TextReader r(frame);
+        std::string_view method;
+        channel = {};
+        bool haveInserts = false;
+        out.snapshot = true;
+        auto readData = [&]() {
+            if (!r.peek('{'))
+            {
+                return r.skipValue();
+            }
+            return r.object([&](std::string_view key) {
+                if (key == "last_updated_at")
+                {
+                    return readInteger(r, out.eventTimeMs);
+                }
+                if (key != "inserts" || !r.peek('['))
+                {
+                    return r.skipValue();
+                }
+                haveInserts = true;
+                return r.array([&]() { return readParadexInsert(r, tickSize, out); });
+            });
+        };
+        const bool ok = r.object([&](std::string_view key) {
+            if (key == "method")
+            {
+                return r.string(method);
+            }
+            if (key != "params" || !r.peek('{'))
+            {
+                return r.skipValue();
+            }
+            return r.object([&](std::string_view field) {
+                if (field == "channel")
+                {
+                    return r.string(channel);
+                }
+                if (field == "data")
+                {
+                    return readData();
+                }
+                return r.skipValue();
+            });
+        });
+        return ok && r.atEnd() && haveInserts && method == "subscription" && channel.starts_with("order_book.");
+    }
+
+    bool decodeUzxDepth(std::string_view frame, double tickSize, std::size_t maxLevelsPerSide, DepthUpdate& out)
+    {
+        if (!(tickSize > 0.0))
+        {
+            return false; // detection from price decimals stays with parseUzxFrame()
+        }
+        TextReader r(frame);
+        bool fills = false;
+        bool control = false;
+        bool haveData = false;
+        // parseUzxFrame() prefers "bids"/"asks" over "b"/"a"; a frame carrying both takes the json path.
+        int bidKeys = 0;
+        int askKeys = 0;
+        auto readType = [&]() {
+            TextScalar type;
+            if (!r.scalar(type))
+            {
+                return false;
+            }
+            fills = fills || isUzxFillsText(type);
+            return true;
+        };
+        const bool ok = r.object([&](std::string_view key) {
+            if (key == "type")
+            {
+                return readType();
+            }
+            if (key == "ping" || key == "event")
+            {
+                control = true;
+                return r.skipValue();
+            }
+            if (key != "data" || !r.peek('{'))
+            {
+                return r.skipValue();
+            }
+            haveData = true;
+            return r.object([&](std::string_view field) {
+                if (field == "type")
+                {
+                    return readType();
+                }
+                if (field == "bids" || field == "b")
+                {
+                    ++bidKeys;
+                    return readUzxSide(r, tickSize, maxLevelsPerSide, out.bids);
+                }
+                if (field == "asks" || field == "a")
+                {
+                    ++askKeys;
+                    return readUzxSide(r, tickSize, maxLevelsPerSide, out.asks);
+                }
+                return r.skipValue();
+            });
+        });
+        if (!ok || !r.atEnd() || !haveData || fills || control || bidKeys > 1 || askKeys > 1)
+        {
+            return false;
+        }
+        out.snapshot = true;
+        return true;
+    }
+} // namespace dom::feed
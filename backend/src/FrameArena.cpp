@@ -0,0 +1,165 @@
+#include "FrameArena.hpp"
+
+#if defined(_WIN32)
+#    include <malloc.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::uint64_t> g_heapAllocations{0};
+    thread_local std::uint64_t t_heapAllocations = 0;
+
+    void countAllocation()
+    {
+        g_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        ++t_heapAllocations;
+    }
+
+    void* allocateOrThrow(std::size_t size)
+    {
+        countAllocation();
+        for (;;)
+        {
+            if (void* p = std::malloc(size ? size : 1))
+            {
+                return p;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+            {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void* allocateAlignedOrThrow(std::size_t size, std::align_val_t alignment)
+    {
+        countAllocation();
+        const auto align = static_cast<std::size_t>(alignment);
+        for (;;)
+        {
+#if defined(_WIN32)
+            void* p = _aligned_malloc(size ? size : 1, align);
+#else
+            void* p = std::aligned_alloc(align, std::max(align, (size + align - 1) / align * align));
+#endif
+            if (p)
+            {
+                return p;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+            {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void freeAligned(void* p)
+    {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+} // namespace
+
+// Counting replacements of the global allocation functions. The array and nothrow forms
+// forward to these by default, so every C++ heap allocation in the process is counted.
+void* operator new(std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return allocateAlignedOrThrow(size, alignment);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+    freeAligned(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept
+{
+    freeAligned(p);
+}
+
+namespace dom
+{
+    void* FrameArena::Overflow::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        this->bytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void FrameArena::Overflow::do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool FrameArena::Overflow::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    FrameArena::FrameArena()
+        : buffer_(std::make_unique<std::byte[]>(kInitialBytes))
+        , capacity_(kInitialBytes)
+    {
+        arena_.emplace(buffer_.get(), capacity_, &overflow_);
+    }
+
+    void FrameArena::reset()
+    {
+        if (overflow_.bytes == 0)
+        {
+            arena_->release();
+            return;
+        }
+        ++spills_;
+        const std::size_t wanted = capacity_ + overflow_.bytes;
+        arena_.reset(); // returns the spilled chunks
+        overflow_.bytes = 0;
+        if (capacity_ < kMaxBytes)
+        {
+            std::size_t grown = capacity_;
+            while (grown < wanted && grown < kMaxBytes)
+            {
+                grown *= 2;
+            }
+            capacity_ = std::min(grown, kMaxBytes);
+            buffer_ = std::make_unique<std::byte[]>(capacity_);
+        }
+        arena_.emplace(buffer_.get(), capacity_, &overflow_);
+    }
+
+    std::uint64_t heapAllocations()
+    {
+        return g_heapAllocations.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t threadHeapAllocations()
+    {
+        return t_heapAllocations;
+    }
+} // namespace dom
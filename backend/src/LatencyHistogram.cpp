@@ -0,0 +1,90 @@
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+namespace dom
+{
+    int LatencyHistogram::bucketIndex(std::uint64_t value)
+    {
+        if (value < static_cast<std::uint64_t>(kSubBuckets))
+        {
+            return static_cast<int>(value);
+        }
+        // value >> shift lands in [kSubBuckets/2, kSubBuckets).
+        const int msb = 63 - std::countl_zero(value);
+        const int shift = msb - (kSubBucketBits - 1);
+        const auto sub = static_cast<int>(value >> shift) - kHalfBuckets;
+        return kSubBuckets + (shift - 1) * kHalfBuckets + sub;
+    }
+
+    std::uint64_t LatencyHistogram::bucketUpperBound(int index)
+    {
+        if (index < kSubBuckets)
+        {
+            return static_cast<std::uint64_t>(index);
+        }
+        const int k = index - kSubBuckets;
+        const int shift = k / kHalfBuckets + 1;
+        const auto sub = static_cast<std::uint64_t>(k % kHalfBuckets + kHalfBuckets);
+        if (sub + 1 >= (std::uint64_t{1} << (64 - shift)))
+        {
+            return UINT64_MAX;
+        }
+        return ((sub + 1) << shift) - 1;
+    }
+
+    void LatencyHistogram::record(std::uint64_t value)
+    {
+        counts_[static_cast<std::size_t>(bucketIndex(value))].fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t prev = max_.load(std::memory_order_relaxed);
+        while (value > prev && !max_.compare_exchange_weak(prev, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    LatencyHistogram::Summary LatencyHistogram::takeInterval()
+    {
+        Summary out;
+        std::vector<std::uint64_t> counts(counts_.size());
+        for (std::size_t i = 0; i < counts_.size(); ++i)
+        {
+            counts[i] = counts_[i].exchange(0, std::memory_order_relaxed);
+            out.count += counts[i];
+        }
+        out.max = max_.exchange(0, std::memory_order_relaxed);
+        if (out.count == 0)
+        {
+            return out;
+        }
+
+        const std::uint64_t p50Rank = (out.count * 50 + 99) / 100;
+        const std::uint64_t p99Rank = (out.count * 99 + 99) / 100;
+        std::uint64_t seen = 0;
+        bool havePercentile50 = false;
+        for (std::size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] == 0)
+            {
+                continue;
+            }
+            seen += counts[i];
+            const auto bound = bucketUpperBound(static_cast<int>(i));
+            if (!havePercentile50 && seen >= p50Rank)
+            {
+                out.p50 = bound;
+                havePercentile50 = true;
+            }
+            if (seen >= p99Rank)
+            {
+                out.p99 = bound;
+                break;
+            }
+        }
+        // Bucket bounds overshoot by up to one sub-bucket; never report above the true max.
+        out.p50 = std::min(out.p50, out.max);
+        out.p99 = std::min(out.p99, out.max);
+        return out;
+    }
+} // namespace dom
@@ -1,6 +1,7 @@
 #include "OrderBook.hpp"
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
 
 namespace dom
@@ -14,6 +15,22 @@ namespace dom
         // tickSize_ is configured separately via setTickSize()
         centerTick_ = 0;
         hasCenter_ = false;
+        notifyListener(true);
+    }
+
+    void OrderBook::addUpdateListener(UpdateListener listener)
+    {
+        if (listener)
+        {
+            listeners_.push_back(std::move(listener));
+        }
+        changes_.clear();
+    }
+
+    void OrderBook::clearUpdateListeners()
+    {
+        listeners_.clear();
+        changes_.clear();
     }
 
     void OrderBook::setTickSize(double tickSize)
@@ -32,10 +49,12 @@ namespace dom
         cacheLevelsPerSide_ = std::min(levels, maxPerSide);
     }
 
-    void OrderBook::loadSnapshot(const std::vector<std::pair<Tick, double>>& bids,
-                                 const std::vector<std::pair<Tick, double>>& asks)
+    void OrderBook::loadSnapshot(LevelUpdates bids, LevelUpdates asks)
     {
-        clear();
+        bids_.clear();
+        asks_.clear();
+        centerTick_ = 0;
+        hasCenter_ = false;
 
         for (const auto& [tick, qty] : bids)
         {
@@ -58,23 +77,38 @@ namespace dom
         {
             pruneToCacheWindow(anchorTick);
         }
+
+        if (!listeners_.empty())
+        {
+            // Pruning above recorded removals of levels the listener never saw; report the final book instead.
+            changes_.clear();
+            for (const auto& [tick, qty] : bids_)
+            {
+                changes_.push_back(LevelChange{tick, qty, true});
+            }
+            for (const auto& [tick, qty] : asks_)
+            {
+                changes_.push_back(LevelChange{tick, qty, false});
+            }
+            notifyListener(true);
+        }
     }
 
-    void OrderBook::applyDelta(const std::vector<std::pair<Tick, double>>& bids,
-                               const std::vector<std::pair<Tick, double>>& asks,
-                               std::size_t cacheLevelsHint)
+    void OrderBook::applyDelta(LevelUpdates bids, LevelUpdates asks, std::size_t cacheLevelsHint)
     {
-        applySide(bids_, bids);
-        applySide(asks_, asks);
+        applySide(bids_, bids, true);
+        applySide(asks_, asks, false);
 
         // Чтобы не держать бесконечный хвост старых уровней, которые уже ушли
         // далеко от текущего мида, чистим карту за окном вокруг середины.
         if (tickSize_ <= 0.0 || (bids_.empty() && asks_.empty())) {
+            notifyListener(false);
             return;
         }
 
         Tick midTick = 0;
         if (!resolveAutoCenterTick(midTick)) {
+            notifyListener(false);
             return;
         }
 
@@ -91,14 +125,19 @@ namespace dom
             // Удаляем бидовые уровни, которые не могут существовать выше/на ask.
             auto badBidIt = bids_.lower_bound(askTick);
             while (badBidIt != bids_.end()) {
+                recordChange(badBidIt->first, 0.0, true);
                 badBidIt = bids_.erase(badBidIt);
             }
             // И удаляем аски, которые не могут быть ниже/на bid.
             auto badAskEnd = asks_.upper_bound(bidTick);
+            for (auto it = asks_.begin(); it != badAskEnd; ++it) {
+                recordChange(it->first, 0.0, false);
+            }
             asks_.erase(asks_.begin(), badAskEnd);
             // Сдвигаем центр при сильной чистке.
             hasCenter_ = false;
         }
+        notifyListener(false);
     }
 
     double OrderBook::bestBid() const
@@ -467,6 +506,63 @@ namespace dom
         return result;
     }
 
+    std::vector<OrderBook::Row> OrderBook::rowsInRange(Tick minTick, Tick maxTick) const
+    {
+        std::vector<Row> result;
+        if (minTick > maxTick)
+        {
+            return result;
+        }
+        // Both sides walked downwards from maxTick and merged, so rows come out in the same
+        // descending order as ladderSparse().
+        auto bid = std::make_reverse_iterator(bids_.upper_bound(maxTick));
+        auto ask = std::make_reverse_iterator(asks_.upper_bound(maxTick));
+        const auto bidEnd = std::make_reverse_iterator(bids_.lower_bound(minTick));
+        const auto askEnd = std::make_reverse_iterator(asks_.lower_bound(minTick));
+        while (bid != bidEnd || ask != askEnd)
+        {
+            const bool takeBid = bid != bidEnd && (ask == askEnd || bid->first >= ask->first);
+            const bool takeAsk = ask != askEnd && (bid == bidEnd || ask->first >= bid->first);
+            Row row{takeBid ? bid->first : ask->first, 0.0, 0.0};
+            if (takeBid)
+            {
+                row.bidQuantity = std::max(0.0, bid->second);
+                ++bid;
+            }
+            if (takeAsk)
+            {
+                row.askQuantity = std::max(0.0, ask->second);
+                ++ask;
+            }
+            if (row.bidQuantity > 0.0 || row.askQuantity > 0.0)
+            {
+                result.push_back(row);
+            }
+        }
+        return result;
+    }
+
+    bool OrderBook::cachedTickRange(Tick& outMinTick, Tick& outMaxTick) const
+    {
+        if (bids_.empty() && asks_.empty())
+        {
+            return false;
+        }
+        outMinTick = std::numeric_limits<Tick>::max();
+        outMaxTick = std::numeric_limits<Tick>::min();
+        if (!bids_.empty())
+        {
+            outMinTick = std::min(outMinTick, bids_.begin()->first);
+            outMaxTick = std::max(outMaxTick, bids_.rbegin()->first);
+        }
+        if (!asks_.empty())
+        {
+            outMinTick = std::min(outMinTick, asks_.begin()->first);
+            outMaxTick = std::max(outMaxTick, asks_.rbegin()->first);
+        }
+        return true;
+    }
+
     void OrderBook::shiftManualCenterTicks(Tick delta)
     {
         if (!manualCenterActive_)
@@ -482,7 +578,7 @@ namespace dom
         manualCenterActive_ = false;
     }
 
-    void OrderBook::applySide(BookSide& side, const std::vector<std::pair<Tick, double>>& updates)
+    void OrderBook::applySide(BookSide& side, LevelUpdates updates, bool bidSide)
     {
         for (const auto& [tick, qty] : updates)
         {
@@ -492,22 +588,25 @@ namespace dom
                 if (it != side.end())
                 {
                     side.erase(it);
+                    recordChange(tick, 0.0, bidSide);
                 }
             }
             else
             {
                 side[tick] = qty;
+                recordChange(tick, qty, bidSide);
             }
         }
     }
 
-    void OrderBook::pruneOutsideWindow(BookSide& side, Tick minTick, Tick maxTick)
+    void OrderBook::pruneOutsideWindow(BookSide& side, Tick minTick, Tick maxTick, bool bidSide)
     {
         if (side.empty()) {
             return;
         }
         auto it = side.begin();
         while (it != side.end() && it->first < minTick) {
+            recordChange(it->first, 0.0, bidSide);
             it = side.erase(it);
         }
         if (side.empty()) {
@@ -515,10 +614,35 @@ namespace dom
         }
         it = side.upper_bound(maxTick);
         while (it != side.end()) {
+            recordChange(it->first, 0.0, bidSide);
             it = side.erase(it);
         }
     }
 
+    void OrderBook::recordChange(Tick tick, double quantity, bool bidSide)
+    {
+        if (!listeners_.empty())
+        {
+            changes_.push_back(LevelChange{tick, quantity, bidSide});
+        }
+    }
+
+    void OrderBook::notifyListener(bool reset)
+    {
+        if (listeners_.empty())
+        {
+            return;
+        }
+        if (reset || !changes_.empty())
+        {
+            for (const auto& listener : listeners_)
+            {
+                listener(*this, changes_, reset);
+            }
+        }
+        changes_.clear();
+    }
+
     bool OrderBook::resolveAutoCenterTick(Tick& outTick) const
     {
         if (!bids_.empty() && !asks_.empty()) {
@@ -555,8 +679,8 @@ namespace dom
                            ? std::numeric_limits<Tick>::min()
                            : anchorTick - span;
 
-        pruneOutsideWindow(bids_, minTick, maxTick);
-        pruneOutsideWindow(asks_, minTick, maxTick);
+        pruneOutsideWindow(bids_, minTick, maxTick, true);
+        pruneOutsideWindow(asks_, minTick, maxTick, false);
     }
 
     bool OrderBook::computeWindow(std::size_t levelsPerSide,
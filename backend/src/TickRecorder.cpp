@@ -0,0 +1,386 @@
+#include "TickRecorder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+namespace dom
+{
+    namespace
+    {
+        constexpr std::size_t kBlockEvents = 16384;
+        constexpr long long kMaxBlockAgeUs = 5'000'000; // bounds what a crash can lose
+        constexpr long long kUsPerDay = 86'400'000'000LL;
+
+        long long wallClockUs()
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+
+        std::string pathComponent(const std::string& raw)
+        {
+            std::string out = raw.empty() ? std::string("unknown") : raw;
+            for (char& c : out)
+            {
+                const bool ok = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')
+                                || c == '-' || c == '_' || c == '.';
+                if (!ok)
+                {
+                    c = '_';
+                }
+            }
+            return out;
+        }
+
+        std::string dayName(long long day)
+        {
+            const std::chrono::year_month_day ymd{std::chrono::sys_days{std::chrono::days{day}}};
+            char buf[16];
+            std::snprintf(buf,
+                          sizeof(buf),
+                          "%04d%02u%02u",
+                          static_cast<int>(ymd.year()),
+                          static_cast<unsigned>(ymd.month()),
+                          static_cast<unsigned>(ymd.day()));
+            return buf;
+        }
+    } // namespace
+
+    TickRecorder::TickRecorder(Options options)
+        : options_(std::move(options))
+    {
+        writer_ = std::thread([this]() { writerLoop(); });
+    }
+
+    TickRecorder::~TickRecorder()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex_);
+            stop_ = true;
+        }
+        queueCv_.notify_one();
+        if (writer_.joinable())
+        {
+            writer_.join();
+        }
+    }
+
+    void TickRecorder::attach(OrderBook& book)
+    {
+        book.addUpdateListener([this](const OrderBook& b,
+                                      const std::vector<OrderBook::LevelChange>& changes,
+                                      bool reset) {
+            onBookUpdate(b, changes, reset);
+        });
+    }
+
+    void TickRecorder::setStream(const std::string& exchange, const std::string& symbol)
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        streams_.emplace_back(exchange, symbol);
+        queue_.push_back(Item{ItemKind::Stream, 0, 0.0, wallClockUs()});
+        feedTickSize_ = 0.0;
+    }
+
+    void TickRecorder::onTrade(double price, double qty, bool buy)
+    {
+        if (!(price > 0.0) || !(qty > 0.0))
+        {
+            return;
+        }
+        const long long ts = wallClockUs();
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (feedTickSize_ <= 0.0)
+        {
+            return;
+        }
+        const auto tick = static_cast<Tick>(std::llround(price / feedTickSize_));
+        queue_.push_back(Item{buy ? ItemKind::BuyTrade : ItemKind::SellTrade, tick, qty, ts});
+    }
+
+    std::uint64_t TickRecorder::bytesWritten() const
+    {
+        return bytesWritten_.load(std::memory_order_relaxed);
+    }
+
+    void TickRecorder::onBookUpdate(const OrderBook& book,
+                                    const std::vector<OrderBook::LevelChange>& changes,
+                                    bool reset)
+    {
+        const long long ts = wallClockUs();
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (book.tickSize() != feedTickSize_)
+        {
+            feedTickSize_ = book.tickSize();
+            queue_.push_back(Item{ItemKind::TickSize, 0, feedTickSize_, ts});
+        }
+        if (reset)
+        {
+            queue_.push_back(Item{ItemKind::Reset, 0, 0.0, ts});
+        }
+        for (const auto& change : changes)
+        {
+            queue_.push_back(Item{change.bid ? ItemKind::Bid : ItemKind::Ask, change.tick, change.quantity, ts});
+        }
+        if (reset)
+        {
+            queue_.push_back(Item{ItemKind::ResetEnd, 0, 0.0, ts});
+        }
+    }
+
+    void TickRecorder::writerLoop()
+    {
+        std::vector<Item> items;
+        for (;;)
+        {
+            bool stopping = false;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex_);
+                queueCv_.wait_for(lock, std::chrono::milliseconds(options_.flushIntervalMs), [this]() { return stop_; });
+                items.swap(queue_);
+                stopping = stop_;
+            }
+            process(items);
+            items.clear();
+
+            const long long now = wallClockUs();
+            if (!inReset_ && file_.is_open() && now - lastSnapshotUs_ >= options_.snapshotIntervalMs * 1000)
+            {
+                writeSnapshot(now);
+            }
+            else if (!block_.empty() && (stopping || now - block_.front().tsUs >= kMaxBlockAgeUs))
+            {
+                flushBlock();
+            }
+            if (file_.is_open())
+            {
+                file_.flush();
+                index_.flush();
+            }
+            if (stopping)
+            {
+                break;
+            }
+        }
+        closeFile();
+    }
+
+    void TickRecorder::process(const std::vector<Item>& items)
+    {
+        for (const auto& item : items)
+        {
+            switch (item.kind)
+            {
+            case ItemKind::Stream:
+            {
+                flushBlock();
+                closeFile();
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex_);
+                    if (!streams_.empty())
+                    {
+                        exchange_ = streams_.front().first;
+                        symbol_ = streams_.front().second;
+                        streams_.pop_front();
+                    }
+                }
+                bids_.clear();
+                asks_.clear();
+                tickSize_ = 0.0;
+                inReset_ = false;
+                day_ = -1;
+                openFailed_ = false;
+                break;
+            }
+            case ItemKind::TickSize:
+                if (item.qty != tickSize_)
+                {
+                    // Mirrored ticks are in the old units; the book reloads right after a tick change.
+                    flushBlock();
+                    tickSize_ = item.qty;
+                    bids_.clear();
+                    asks_.clear();
+                }
+                break;
+            case ItemKind::Reset:
+                flushBlock();
+                bids_.clear();
+                asks_.clear();
+                inReset_ = true;
+                break;
+            case ItemKind::ResetEnd:
+                inReset_ = false;
+                if (!ensureFile(item.tsUs))
+                {
+                    writeSnapshot(item.tsUs);
+                }
+                break;
+            case ItemKind::Bid:
+            case ItemKind::Ask:
+            {
+                auto& side = item.kind == ItemKind::Bid ? bids_ : asks_;
+                if (item.qty > 0.0)
+                {
+                    side[item.tick] = item.qty;
+                }
+                else
+                {
+                    side.erase(item.tick);
+                }
+                if (inReset_)
+                {
+                    break;
+                }
+                ensureFile(item.tsUs);
+                append(item.kind == ItemKind::Bid ? tickstore::EventKind::BidLevel : tickstore::EventKind::AskLevel,
+                       item.tick,
+                       std::max(item.qty, 0.0),
+                       item.tsUs);
+                break;
+            }
+            case ItemKind::BuyTrade:
+            case ItemKind::SellTrade:
+                ensureFile(item.tsUs);
+                append(item.kind == ItemKind::BuyTrade ? tickstore::EventKind::BuyTrade
+                                                       : tickstore::EventKind::SellTrade,
+                       item.tick,
+                       item.qty,
+                       item.tsUs);
+                break;
+            }
+        }
+    }
+
+    void TickRecorder::append(tickstore::EventKind kind, Tick tick, double qty, long long tsUs)
+    {
+        if (!file_.is_open() || tickSize_ <= 0.0)
+        {
+            return;
+        }
+        block_.push_back(tickstore::Event{tsUs, tick, qty, kind});
+        if (block_.size() >= kBlockEvents)
+        {
+            flushBlock();
+        }
+    }
+
+    // Opens the file for the day of `tsUs`; a file opened mid-stream starts with a snapshot
+    // (returns true in that case) so it can be read on its own.
+    bool TickRecorder::ensureFile(long long tsUs)
+    {
+        if (symbol_.empty())
+        {
+            return false;
+        }
+        const long long day = (tsUs >= 0 ? tsUs : tsUs - kUsPerDay + 1) / kUsPerDay;
+        if (day == day_ && (file_.is_open() || openFailed_))
+        {
+            return false;
+        }
+        flushBlock();
+        closeFile();
+        openFile(day);
+        if (file_.is_open() && !inReset_ && (!bids_.empty() || !asks_.empty()))
+        {
+            writeSnapshot(tsUs);
+            return true;
+        }
+        return false;
+    }
+
+    void TickRecorder::openFile(long long day)
+    {
+        namespace fs = std::filesystem;
+        day_ = day;
+        openFailed_ = false;
+        const fs::path dir = fs::path(options_.directory) / pathComponent(exchange_) / pathComponent(symbol_);
+        const fs::path path = dir / (dayName(day) + ".ftd");
+        std::error_code ec;
+        fs::create_directories(dir, ec);
+        const auto existing = fs::exists(path, ec) ? fs::file_size(path, ec) : 0;
+        file_.open(path, std::ios::binary | std::ios::app);
+        index_.open(fs::path(path).replace_extension(".idx"), std::ios::binary | std::ios::app);
+        if (!file_.is_open() || !index_.is_open())
+        {
+            std::cerr << "[backend] recorder: cannot open " << path.string() << std::endl;
+            closeFile();
+            openFailed_ = true;
+            return;
+        }
+        offset_ = ec ? 0 : static_cast<std::uint64_t>(existing);
+        if (offset_ == 0)
+        {
+            std::string header;
+            tickstore::encodeFileHeader(tickstore::FileHeader{exchange_, symbol_}, header);
+            writeBytes(header);
+        }
+        std::cerr << "[backend] recorder: writing " << path.string() << std::endl;
+    }
+
+    void TickRecorder::closeFile()
+    {
+        if (file_.is_open())
+        {
+            file_.close();
+        }
+        if (index_.is_open())
+        {
+            index_.close();
+        }
+        offset_ = 0;
+    }
+
+    void TickRecorder::flushBlock()
+    {
+        if (block_.empty())
+        {
+            return;
+        }
+        if (file_.is_open() && tickSize_ > 0.0)
+        {
+            std::string bytes;
+            tickstore::encodeBlock(tickstore::BlockKind::Events, block_, tickSize_, options_.qtyStep, bytes);
+            writeBytes(bytes);
+        }
+        block_.clear();
+    }
+
+    void TickRecorder::writeSnapshot(long long tsUs)
+    {
+        flushBlock();
+        lastSnapshotUs_ = tsUs;
+        if (!file_.is_open() || tickSize_ <= 0.0 || (bids_.empty() && asks_.empty()))
+        {
+            return;
+        }
+        std::vector<tickstore::Event> levels;
+        levels.reserve(bids_.size() + asks_.size());
+        for (const auto& [tick, qty] : bids_)
+        {
+            levels.push_back(tickstore::Event{tsUs, tick, qty, tickstore::EventKind::BidLevel});
+        }
+        for (const auto& [tick, qty] : asks_)
+        {
+            levels.push_back(tickstore::Event{tsUs, tick, qty, tickstore::EventKind::AskLevel});
+        }
+        std::string entry;
+        tickstore::encodeIndexEntry(tickstore::IndexEntry{tsUs, offset_}, entry);
+        std::string bytes;
+        tickstore::encodeBlock(tickstore::BlockKind::Snapshot, levels, tickSize_, options_.qtyStep, bytes);
+        writeBytes(bytes);
+        index_.write(entry.data(), static_cast<std::streamsize>(entry.size()));
+    }
+
+    void TickRecorder::writeBytes(const std::string& bytes)
+    {
+        file_.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        offset_ += bytes.size();
+        bytesWritten_.fetch_add(bytes.size(), std::memory_order_relaxed);
+    }
+} // namespace dom
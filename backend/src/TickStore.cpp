@@ -0,0 +1,500 @@
+#include "TickStore.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace dom::tickstore
+{
+    namespace
+    {
+        constexpr int kHashBits = 13;
+        constexpr std::size_t kMinMatch = 4;
+        constexpr std::size_t kMaxOffset = 65535;
+        constexpr std::size_t kTailLiterals = 5; // the last bytes are always literals
+        // Largest quantity varint written, in qtyStep units (2^62); keeps the conversion defined.
+        constexpr double kMaxQtyUnits = 4611686018427387904.0;
+
+        void putU16(std::string& out, std::uint16_t v)
+        {
+            out.push_back(static_cast<char>(v & 0xFF));
+            out.push_back(static_cast<char>((v >> 8) & 0xFF));
+        }
+
+        void putU32(std::string& out, std::uint32_t v)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+            }
+        }
+
+        void putU64(std::string& out, std::uint64_t v)
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+            }
+        }
+
+        void putF64(std::string& out, double v)
+        {
+            std::uint64_t bits = 0;
+            std::memcpy(&bits, &v, sizeof(bits));
+            putU64(out, bits);
+        }
+
+        std::uint64_t getLe(const unsigned char* p, int bytes)
+        {
+            std::uint64_t v = 0;
+            for (int i = 0; i < bytes; ++i)
+            {
+                v |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+            }
+            return v;
+        }
+
+        double getF64(const unsigned char* p)
+        {
+            const std::uint64_t bits = getLe(p, 8);
+            double v = 0.0;
+            std::memcpy(&v, &bits, sizeof(v));
+            return v;
+        }
+
+        void putVarint(std::string& out, std::uint64_t v)
+        {
+            while (v >= 0x80)
+            {
+                out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<char>(v));
+        }
+
+        bool getVarint(const unsigned char*& p, const unsigned char* end, std::uint64_t& v)
+        {
+            v = 0;
+            for (int shift = 0; shift < 64 && p < end; shift += 7)
+            {
+                const unsigned char byte = *p++;
+                v |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::uint64_t zigzag(std::int64_t v)
+        {
+            return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+        }
+
+        std::int64_t unzigzag(std::uint64_t v)
+        {
+            return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+        }
+
+        // Quantity in qtyStep units. A positive quantity never becomes 0, which reads as a removal.
+        std::uint64_t qtyUnits(double qty, double qtyStep)
+        {
+            if (!(qty > 0.0))
+            {
+                return 0;
+            }
+            const double units = std::min(qtyStep > 0.0 ? std::round(qty / qtyStep) : qty, kMaxQtyUnits);
+            return std::max<std::uint64_t>(static_cast<std::uint64_t>(units), 1);
+        }
+
+        // `qtyStep`, coarsened by powers of ten until the largest quantity of `events` fits.
+        double blockQtyStep(const std::vector<Event>& events, double qtyStep)
+        {
+            if (qtyStep <= 0.0)
+            {
+                return qtyStep;
+            }
+            double maxQty = 0.0;
+            for (const auto& e : events)
+            {
+                if (std::isfinite(e.qty))
+                {
+                    maxQty = std::max(maxQty, e.qty);
+                }
+            }
+            while (maxQty / qtyStep >= kMaxQtyUnits)
+            {
+                qtyStep *= 10.0;
+            }
+            return qtyStep;
+        }
+
+        std::uint32_t read32(const unsigned char* p)
+        {
+            std::uint32_t v = 0;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        void putLength(std::string& out, std::size_t v)
+        {
+            while (v >= 255)
+            {
+                out.push_back(static_cast<char>(255));
+                v -= 255;
+            }
+            out.push_back(static_cast<char>(v));
+        }
+
+        bool getLength(const unsigned char*& p, const unsigned char* end, std::size_t& v)
+        {
+            for (;;)
+            {
+                if (p >= end)
+                {
+                    return false;
+                }
+                const unsigned char byte = *p++;
+                v += byte;
+                if (byte != 255)
+                {
+                    return true;
+                }
+            }
+        }
+
+        void emitSequence(std::string& out,
+                          const unsigned char* literals,
+                          std::size_t literalCount,
+                          std::size_t offset,
+                          std::size_t matchLength)
+        {
+            const std::size_t matchCode = matchLength >= kMinMatch ? matchLength - kMinMatch : 0;
+            const unsigned char token = static_cast<unsigned char>((std::min<std::size_t>(literalCount, 15) << 4)
+                                                                   | std::min<std::size_t>(matchCode, 15));
+            out.push_back(static_cast<char>(token));
+            if (literalCount >= 15)
+            {
+                putLength(out, literalCount - 15);
+            }
+            out.append(reinterpret_cast<const char*>(literals), literalCount);
+            if (matchLength == 0)
+            {
+                return;
+            }
+            putU16(out, static_cast<std::uint16_t>(offset));
+            if (matchCode >= 15)
+            {
+                putLength(out, matchCode - 15);
+            }
+        }
+    } // namespace
+
+    void encodeFileHeader(const FileHeader& header, std::string& out)
+    {
+        putU32(out, kFileMagic);
+        putU32(out, kVersion);
+        const auto exchangeLen = std::min<std::size_t>(header.exchange.size(), 0xFFFF);
+        putU16(out, static_cast<std::uint16_t>(exchangeLen));
+        out.append(header.exchange, 0, exchangeLen);
+        const auto symbolLen = std::min<std::size_t>(header.symbol.size(), 0xFFFF);
+        putU16(out, static_cast<std::uint16_t>(symbolLen));
+        out.append(header.symbol, 0, symbolLen);
+    }
+
+    std::size_t decodeFileHeader(std::string_view data, FileHeader& header)
+    {
+        const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+        if (data.size() < 10 || getLe(p, 4) != kFileMagic || getLe(p + 4, 4) != kVersion)
+        {
+            return 0;
+        }
+        std::size_t pos = 8;
+        auto readString = [&](std::string& s) {
+            if (pos + 2 > data.size())
+            {
+                return false;
+            }
+            const auto len = static_cast<std::size_t>(getLe(p + pos, 2));
+            pos += 2;
+            if (pos + len > data.size())
+            {
+                return false;
+            }
+            s.assign(data.substr(pos, len));
+            pos += len;
+            return true;
+        };
+        if (!readString(header.exchange) || !readString(header.symbol))
+        {
+            return 0;
+        }
+        return pos;
+    }
+
+    void encodeBlockHeader(const BlockHeader& header, std::string& out)
+    {
+        putU32(out, kBlockMagic);
+        out.push_back(static_cast<char>(header.kind));
+        out.push_back(static_cast<char>(header.codec));
+        putU16(out, 0);
+        putU32(out, header.count);
+        putU32(out, header.rawBytes);
+        putU32(out, header.storedBytes);
+        putU64(out, static_cast<std::uint64_t>(header.firstTsUs));
+        putU64(out, static_cast<std::uint64_t>(header.lastTsUs));
+        putF64(out, header.tickSize);
+        putF64(out, header.qtyStep);
+    }
+
+    bool decodeBlockHeader(std::string_view data, BlockHeader& header)
+    {
+        if (data.size() < kBlockHeaderSize)
+        {
+            return false;
+        }
+        const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+        if (getLe(p, 4) != kBlockMagic || p[4] > static_cast<unsigned char>(BlockKind::Snapshot)
+            || p[5] > static_cast<unsigned char>(Codec::Lz))
+        {
+            return false;
+        }
+        header.kind = static_cast<BlockKind>(p[4]);
+        header.codec = static_cast<Codec>(p[5]);
+        header.count = static_cast<std::uint32_t>(getLe(p + 8, 4));
+        header.rawBytes = static_cast<std::uint32_t>(getLe(p + 12, 4));
+        header.storedBytes = static_cast<std::uint32_t>(getLe(p + 16, 4));
+        header.firstTsUs = static_cast<long long>(getLe(p + 20, 8));
+        header.lastTsUs = static_cast<long long>(getLe(p + 28, 8));
+        header.tickSize = getF64(p + 36);
+        header.qtyStep = getF64(p + 44);
+        return true;
+    }
+
+    void encodeIndexEntry(const IndexEntry& entry, std::string& out)
+    {
+        putU64(out, static_cast<std::uint64_t>(entry.tsUs));
+        putU64(out, entry.offset);
+    }
+
+    IndexEntry decodeIndexEntry(const unsigned char* data)
+    {
+        IndexEntry entry;
+        entry.tsUs = static_cast<long long>(getLe(data, 8));
+        entry.offset = getLe(data + 8, 8);
+        return entry;
+    }
+
+    void encodeEvents(const std::vector<Event>& events, long long firstTsUs, double qtyStep, std::string& out)
+    {
+        out.reserve(out.size() + events.size() * 6);
+        for (const auto& e : events)
+        {
+            out.push_back(static_cast<char>(e.kind));
+        }
+        long long prevTs = firstTsUs;
+        for (const auto& e : events)
+        {
+            putVarint(out, zigzag(e.tsUs - prevTs));
+            prevTs = e.tsUs;
+        }
+        std::int64_t prevTick = 0;
+        for (const auto& e : events)
+        {
+            putVarint(out, zigzag(e.tick - prevTick));
+            prevTick = e.tick;
+        }
+        for (const auto& e : events)
+        {
+            putVarint(out, qtyUnits(e.qty, qtyStep));
+        }
+    }
+
+    bool decodeEvents(std::string_view data,
+                      std::uint32_t count,
+                      long long firstTsUs,
+                      double qtyStep,
+                      std::vector<Event>& out)
+    {
+        if (data.size() < count)
+        {
+            return false;
+        }
+        const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+        const auto* end = p + data.size();
+        const std::size_t base = out.size();
+        out.resize(base + count);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            if (p[i] > static_cast<unsigned char>(EventKind::SellTrade))
+            {
+                return false;
+            }
+            out[base + i].kind = static_cast<EventKind>(p[i]);
+        }
+        p += count;
+        std::uint64_t v = 0;
+        long long ts = firstTsUs;
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            if (!getVarint(p, end, v))
+            {
+                return false;
+            }
+            ts += unzigzag(v);
+            out[base + i].tsUs = ts;
+        }
+        std::int64_t tick = 0;
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            if (!getVarint(p, end, v))
+            {
+                return false;
+            }
+            tick += unzigzag(v);
+            out[base + i].tick = tick;
+        }
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            if (!getVarint(p, end, v))
+            {
+                return false;
+            }
+            out[base + i].qty = qtyStep > 0.0 ? static_cast<double>(v) * qtyStep : static_cast<double>(v);
+        }
+        return p == end;
+    }
+
+    void lzCompress(std::string_view in, std::string& out)
+    {
+        const auto* src = reinterpret_cast<const unsigned char*>(in.data());
+        const std::size_t n = in.size();
+        std::size_t anchor = 0;
+        if (n > kMinMatch + kTailLiterals)
+        {
+            std::vector<std::int64_t> table(std::size_t{1} << kHashBits, -1);
+            const std::size_t limit = n - kTailLiterals;
+            std::size_t pos = 0;
+            while (pos + kMinMatch <= limit)
+            {
+                const std::uint32_t seq = read32(src + pos);
+                const std::size_t h = (seq * 2654435761u) >> (32 - kHashBits);
+                const std::int64_t candidate = table[h];
+                table[h] = static_cast<std::int64_t>(pos);
+                if (candidate >= 0 && pos - static_cast<std::size_t>(candidate) <= kMaxOffset
+                    && read32(src + candidate) == seq)
+                {
+                    const auto cand = static_cast<std::size_t>(candidate);
+                    std::size_t length = kMinMatch;
+                    while (pos + length < limit && src[cand + length] == src[pos + length])
+                    {
+                        ++length;
+                    }
+                    emitSequence(out, src + anchor, pos - anchor, pos - cand, length);
+                    pos += length;
+                    anchor = pos;
+                    continue;
+                }
+                ++pos;
+            }
+        }
+        emitSequence(out, src + anchor, n - anchor, 0, 0);
+    }
+
+    bool lzDecompress(std::string_view in, std::size_t rawSize, std::string& out)
+    {
+        const auto* p = reinterpret_cast<const unsigned char*>(in.data());
+        const auto* end = p + in.size();
+        const std::size_t base = out.size();
+        out.reserve(base + rawSize);
+        while (p < end)
+        {
+            const unsigned char token = *p++;
+            std::size_t literals = token >> 4;
+            if (literals == 15 && !getLength(p, end, literals))
+            {
+                return false;
+            }
+            if (literals > static_cast<std::size_t>(end - p) || out.size() - base + literals > rawSize)
+            {
+                return false;
+            }
+            out.append(reinterpret_cast<const char*>(p), literals);
+            p += literals;
+            if (p == end)
+            {
+                break;
+            }
+            if (end - p < 2)
+            {
+                return false;
+            }
+            const std::size_t offset = static_cast<std::size_t>(getLe(p, 2));
+            p += 2;
+            std::size_t length = token & 0x0F;
+            if (length == 15 && !getLength(p, end, length))
+            {
+                return false;
+            }
+            length += kMinMatch;
+            const std::size_t produced = out.size() - base;
+            if (offset == 0 || offset > produced || produced + length > rawSize)
+            {
+                return false;
+            }
+            // Byte by byte: the match may overlap the bytes it produces.
+            std::size_t from = out.size() - offset;
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                out.push_back(out[from + i]);
+            }
+        }
+        return out.size() - base == rawSize;
+    }
+
+    void encodeBlock(BlockKind kind,
+                     const std::vector<Event>& events,
+                     double tickSize,
+                     double qtyStep,
+                     std::string& out)
+    {
+        BlockHeader header;
+        header.kind = kind;
+        header.count = static_cast<std::uint32_t>(events.size());
+        header.firstTsUs = events.empty() ? 0 : events.front().tsUs;
+        header.lastTsUs = events.empty() ? 0 : events.back().tsUs;
+        header.tickSize = tickSize;
+        header.qtyStep = blockQtyStep(events, qtyStep);
+
+        std::string raw;
+        encodeEvents(events, header.firstTsUs, header.qtyStep, raw);
+        std::string packed;
+        lzCompress(raw, packed);
+        const bool useLz = packed.size() < raw.size();
+        header.codec = useLz ? Codec::Lz : Codec::Raw;
+        header.rawBytes = static_cast<std::uint32_t>(raw.size());
+        header.storedBytes = static_cast<std::uint32_t>(useLz ? packed.size() : raw.size());
+        encodeBlockHeader(header, out);
+        out += useLz ? packed : raw;
+    }
+
+    bool decodeBlockPayload(const BlockHeader& header, std::string_view payload, std::vector<Event>& out)
+    {
+        if (payload.size() < header.storedBytes)
+        {
+            return false;
+        }
+        payload = payload.substr(0, header.storedBytes);
+        if (header.codec == Codec::Raw)
+        {
+            return decodeEvents(payload, header.count, header.firstTsUs, header.qtyStep, out);
+        }
+        std::string raw;
+        if (!lzDecompress(payload, header.rawBytes, raw))
+        {
+            return false;
+        }
+        return decodeEvents(raw, header.count, header.firstTsUs, header.qtyStep, out);
+    }
+} // namespace dom::tickstore
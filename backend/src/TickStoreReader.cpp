@@ -0,0 +1,352 @@
+#include "TickStoreReader.hpp"
+
+#if defined(_WIN32)
+#    define WIN32_LEAN_AND_MEAN
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+
+namespace dom
+{
+    namespace
+    {
+        // Windows maps views on 64 KiB boundaries; that is also a multiple of any POSIX page.
+        constexpr std::uint64_t kViewAlign = 64 * 1024;
+        constexpr std::uint64_t kWindowBytes = 64ull * 1024 * 1024;
+    } // namespace
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+#if defined(_WIN32)
+        // Share writes: today's file may still be appended to by a recorder.
+        const std::wstring widePath = std::filesystem::path(path).wstring();
+        HANDLE file = CreateFileW(widePath.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL,
+                                  nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        file_ = file;
+        mapping_ = mapping;
+        size_ = static_cast<std::uint64_t>(size.QuadPart);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st
+        {
+        };
+        if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            ::close(fd);
+            return false;
+        }
+        fd_ = fd;
+        size_ = static_cast<std::uint64_t>(st.st_size);
+#endif
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        unmapWindow();
+#if defined(_WIN32)
+        if (mapping_)
+        {
+            CloseHandle(mapping_);
+            mapping_ = nullptr;
+        }
+        if (file_)
+        {
+            CloseHandle(file_);
+            file_ = nullptr;
+        }
+#else
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+#endif
+        size_ = 0;
+    }
+
+    const unsigned char* MappedFile::view(std::uint64_t offset, std::size_t length)
+    {
+        if (size_ == 0 || offset > size_ || length > size_ - offset)
+        {
+            return nullptr;
+        }
+        if (window_ && offset >= windowOffset_ && offset + length <= windowOffset_ + windowSize_)
+        {
+            return window_ + (offset - windowOffset_);
+        }
+        unmapWindow();
+        const std::uint64_t start = offset & ~(kViewAlign - 1);
+        const std::uint64_t end = std::min(size_, std::max(offset + length, start + kWindowBytes));
+        const auto span = static_cast<std::size_t>(end - start);
+#if defined(_WIN32)
+        void* mapped = MapViewOfFile(mapping_,
+                                     FILE_MAP_READ,
+                                     static_cast<DWORD>(start >> 32),
+                                     static_cast<DWORD>(start & 0xffffffffu),
+                                     span);
+        if (!mapped)
+        {
+            return nullptr;
+        }
+#else
+        void* mapped = ::mmap(nullptr, span, PROT_READ, MAP_SHARED, fd_, static_cast<off_t>(start));
+        if (mapped == MAP_FAILED)
+        {
+            return nullptr;
+        }
+#endif
+        window_ = static_cast<const unsigned char*>(mapped);
+        windowOffset_ = start;
+        windowSize_ = span;
+        return window_ + (offset - start);
+    }
+
+    void MappedFile::unmapWindow()
+    {
+        if (!window_)
+        {
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(window_);
+#else
+        ::munmap(const_cast<unsigned char*>(window_), windowSize_);
+#endif
+        window_ = nullptr;
+        windowOffset_ = 0;
+        windowSize_ = 0;
+    }
+
+    bool TickStoreReader::Cursor::next(tickstore::BlockHeader& header, std::vector<tickstore::Event>& events)
+    {
+        if (!reader_ || !reader_->readBlock(offset_, header, events))
+        {
+            return false;
+        }
+        if (skip_ > 0)
+        {
+            events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(std::min(skip_, events.size())));
+            skip_ = 0;
+            header.count = static_cast<std::uint32_t>(events.size());
+            if (!events.empty())
+            {
+                header.firstTsUs = events.front().tsUs;
+            }
+        }
+        return true;
+    }
+
+    bool TickStoreReader::open(const std::string& path)
+    {
+        if (!file_.open(path))
+        {
+            error_ = "cannot open " + path;
+            return false;
+        }
+        const std::size_t headLength = static_cast<std::size_t>(std::min<std::uint64_t>(file_.size(), 4096));
+        const unsigned char* head = file_.view(0, headLength);
+        dataStart_ = head ? tickstore::decodeFileHeader(
+                                std::string_view(reinterpret_cast<const char*>(head), headLength), header_)
+                          : 0;
+        if (dataStart_ == 0)
+        {
+            error_ = "not a tick data file: " + path;
+            return false;
+        }
+
+        // A missing or partially written index only costs seeking precision.
+        indexCount_ = 0;
+        if (index_.open(std::filesystem::path(path).replace_extension(".idx").string()))
+        {
+            indexCount_ = static_cast<std::size_t>(index_.size() / tickstore::kIndexEntrySize);
+        }
+        return true;
+    }
+
+    std::uint64_t TickStoreReader::snapshotOffset(long long tsUs)
+    {
+        const unsigned char* entries =
+            indexCount_ > 0 ? index_.view(0, indexCount_ * tickstore::kIndexEntrySize) : nullptr;
+        if (!entries)
+        {
+            return dataStart_;
+        }
+        // First entry stamped after `tsUs`; the one before it is the snapshot to start from.
+        std::size_t lo = 0;
+        std::size_t hi = indexCount_;
+        while (lo < hi)
+        {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (tickstore::decodeIndexEntry(entries + mid * tickstore::kIndexEntrySize).tsUs <= tsUs)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if (lo == 0)
+        {
+            return dataStart_;
+        }
+        const std::uint64_t offset = tickstore::decodeIndexEntry(entries + (lo - 1) * tickstore::kIndexEntrySize).offset;
+        return offset >= dataStart_ && offset < file_.size() ? offset : dataStart_;
+    }
+
+    TickStoreReader::Cursor TickStoreReader::cursor(long long tsUs)
+    {
+        Cursor cursor;
+        cursor.reader_ = this;
+        cursor.offset_ = snapshotOffset(tsUs);
+        return cursor;
+    }
+
+    bool TickStoreReader::bookAt(long long tsUs, Book& book, Cursor* rest)
+    {
+        book = Book{};
+        bool seeded = false;
+        std::uint64_t offset = snapshotOffset(tsUs);
+        std::uint64_t blockOffset = offset;
+        std::size_t consumed = 0;
+        tickstore::BlockHeader header;
+        std::vector<tickstore::Event> events;
+
+        auto adoptTickSize = [&book](double tickSize) {
+            if (tickSize != book.tickSize)
+            {
+                // Ticks are in the old units; a snapshot follows every tick size change.
+                book.tickSize = tickSize;
+                book.bids.clear();
+                book.asks.clear();
+            }
+        };
+
+        for (;;)
+        {
+            blockOffset = offset;
+            consumed = 0;
+            if (!readBlock(offset, header, events))
+            {
+                blockOffset = offset;
+                break;
+            }
+            if (events.empty() || events.front().tsUs > tsUs)
+            {
+                break;
+            }
+            adoptTickSize(header.tickSize);
+            if (header.kind == tickstore::BlockKind::Snapshot)
+            {
+                book.bids.clear();
+                book.asks.clear();
+                seeded = true;
+            }
+            for (; consumed < events.size() && events[consumed].tsUs <= tsUs; ++consumed)
+            {
+                const auto& e = events[consumed];
+                if (e.kind != tickstore::EventKind::BidLevel && e.kind != tickstore::EventKind::AskLevel)
+                {
+                    continue;
+                }
+                auto& side = e.kind == tickstore::EventKind::BidLevel ? book.bids : book.asks;
+                if (e.qty > 0.0)
+                {
+                    side[e.tick] = e.qty;
+                }
+                else
+                {
+                    side.erase(e.tick);
+                }
+                book.tsUs = e.tsUs;
+            }
+            if (consumed < events.size())
+            {
+                break;
+            }
+        }
+
+        if (rest)
+        {
+            rest->reader_ = this;
+            rest->offset_ = blockOffset;
+            rest->skip_ = consumed;
+        }
+        return seeded;
+    }
+
+    bool TickStoreReader::readBlock(std::uint64_t& offset,
+                                    tickstore::BlockHeader& header,
+                                    std::vector<tickstore::Event>& events)
+    {
+        events.clear();
+        const unsigned char* head = file_.view(offset, tickstore::kBlockHeaderSize);
+        if (!head)
+        {
+            return false;
+        }
+        if (!tickstore::decodeBlockHeader(
+                std::string_view(reinterpret_cast<const char*>(head), tickstore::kBlockHeaderSize), header))
+        {
+            error_ = "damaged block header";
+            return false;
+        }
+        const unsigned char* payload = file_.view(offset + tickstore::kBlockHeaderSize, header.storedBytes);
+        if (!payload)
+        {
+            // Block cut short by a crash while recording.
+            return false;
+        }
+        if (!tickstore::decodeBlockPayload(
+                header, std::string_view(reinterpret_cast<const char*>(payload), header.storedBytes), events))
+        {
+            error_ = "damaged block payload";
+            return false;
+        }
+        offset += tickstore::kBlockHeaderSize + header.storedBytes;
+        return true;
+    }
+} // namespace dom
@@ -0,0 +1,292 @@
+#include "WallTracker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+namespace dom
+{
+    namespace
+    {
+        // A wall ends below this fraction of the threshold (hysteresis against flicker).
+        constexpr double kKeepFraction = 0.75;
+
+        long long wallClockMs()
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                .count();
+        }
+    } // namespace
+
+    WallTracker::WallTracker(double minNotional, Tick moveTicks, long long moveWindowMs)
+        : minNotional_(minNotional),
+          moveTicks_(std::max<Tick>(moveTicks, 0)),
+          moveWindowMs_(std::max<long long>(moveWindowMs, 0))
+    {
+    }
+
+    void WallTracker::attach(OrderBook& book)
+    {
+        book.addUpdateListener([this](const OrderBook& b,
+                                      const std::vector<OrderBook::LevelChange>& changes,
+                                      bool reset) {
+            onBookUpdate(b, changes, reset);
+        });
+    }
+
+    double WallTracker::tickSize() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tickSize_;
+    }
+
+    void WallTracker::onTrade(double price, double qty, bool buy)
+    {
+        if (!(qty > 0.0) || !(price > 0.0))
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tickSize_ <= 0.0)
+        {
+            return;
+        }
+        const Tick tick = static_cast<Tick>(std::llround(price / tickSize_));
+        // Aggressive buys lift asks, aggressive sells hit bids.
+        const bool bidSide = !buy;
+        auto& index = bidSide ? bidIndex_ : askIndex_;
+        auto it = index.find(tick);
+        if (it != index.end())
+        {
+            Wall& w = walls_[it->second];
+            w.traded += qty;
+            // The depth update may already have arrived and been booked as a pull.
+            const double reclaim = std::min(qty, w.pulled);
+            w.pulled -= reclaim;
+            pendingTraded_[w.id] += qty - reclaim;
+            dirty_.insert(w.id);
+            return;
+        }
+        for (auto& r : removed_)
+        {
+            if (r.wall.bid == bidSide && r.wall.tick == tick)
+            {
+                // Eaten wall whose last decrease showed up before the prints.
+                r.wall.traded += qty;
+                r.wall.pulled -= std::min(qty, r.wall.pulled);
+                r.wall.lastDecreaseTraded = true;
+                return;
+            }
+        }
+    }
+
+    std::vector<WallTracker::Event> WallTracker::drainEvents()
+    {
+        const long long nowMs = wallClockMs();
+        std::vector<Event> events;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::uint64_t id : added_)
+        {
+            dirty_.erase(id);
+            auto it = walls_.find(id);
+            if (it != walls_.end())
+            {
+                events.push_back(Event{EventKind::Add, it->second});
+            }
+        }
+        added_.clear();
+        for (std::uint64_t id : dirty_)
+        {
+            auto it = walls_.find(id);
+            if (it != walls_.end())
+            {
+                events.push_back(Event{EventKind::Update, it->second});
+            }
+        }
+        dirty_.clear();
+        auto expired = std::stable_partition(removed_.begin(), removed_.end(), [&](const Removed& r) {
+            return nowMs - r.removedMs <= moveWindowMs_;
+        });
+        for (auto it = expired; it != removed_.end(); ++it)
+        {
+            events.push_back(Event{EventKind::Remove, it->wall});
+        }
+        removed_.erase(expired, removed_.end());
+        return events;
+    }
+
+    void WallTracker::onBookUpdate(const OrderBook& book,
+                                   const std::vector<OrderBook::LevelChange>& changes,
+                                   bool reset)
+    {
+        const long long nowMs = wallClockMs();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (book.tickSize() != tickSize_)
+        {
+            // Ticks are in new units: retire everything now so nothing is adopted across the switch.
+            std::vector<std::uint64_t> ids;
+            ids.reserve(walls_.size());
+            for (const auto& entry : walls_)
+            {
+                ids.push_back(entry.first);
+            }
+            for (std::uint64_t id : ids)
+            {
+                removeWall(id, nowMs);
+            }
+            for (auto& r : removed_)
+            {
+                r.removedMs = nowMs - moveWindowMs_ - 1;
+            }
+            tickSize_ = book.tickSize();
+        }
+        if (reset)
+        {
+            // Walls missing from the replacement book are gone; the rest is handled as plain updates.
+            std::unordered_map<Tick, double> bids;
+            std::unordered_map<Tick, double> asks;
+            for (const auto& change : changes)
+            {
+                (change.bid ? bids : asks)[change.tick] = change.quantity;
+            }
+            std::vector<std::pair<bool, Tick>> missing;
+            for (const auto& [id, w] : walls_)
+            {
+                const auto& side = w.bid ? bids : asks;
+                if (side.find(w.tick) == side.end())
+                {
+                    missing.emplace_back(w.bid, w.tick);
+                }
+            }
+            for (const auto& [bid, tick] : missing)
+            {
+                setLevel(bid, tick, 0.0, nowMs);
+            }
+        }
+        for (const auto& change : changes)
+        {
+            setLevel(change.bid, change.tick, change.quantity, nowMs);
+        }
+    }
+
+    void WallTracker::setLevel(bool bid, Tick tick, double qty, long long nowMs)
+    {
+        auto& index = bid ? bidIndex_ : askIndex_;
+        auto it = index.find(tick);
+        if (it != index.end())
+        {
+            Wall& w = walls_[it->second];
+            const double delta = qty - w.qty;
+            if (delta > 0.0)
+            {
+                w.added += delta;
+                w.peakQty = std::max(w.peakQty, qty);
+            }
+            else if (delta < 0.0)
+            {
+                double& pending = pendingTraded_[w.id];
+                const double matched = std::min(-delta, pending);
+                pending -= matched;
+                w.pulled += -delta - matched;
+                w.lastDecreaseTraded = matched >= -delta * 0.5;
+            }
+            w.qty = std::max(qty, 0.0);
+            if (w.qty <= 0.0 || notional(tick, w.qty) < minNotional_ * kKeepFraction)
+            {
+                removeWall(w.id, nowMs);
+            }
+            else if (delta != 0.0)
+            {
+                dirty_.insert(w.id);
+            }
+            return;
+        }
+
+        if (!(qty > 0.0) || notional(tick, qty) < minNotional_)
+        {
+            return;
+        }
+        if (adoptMovedWall(bid, tick, qty, nowMs))
+        {
+            return;
+        }
+        Wall w;
+        w.id = nextId_++;
+        w.bid = bid;
+        w.tick = tick;
+        w.qty = qty;
+        w.peakQty = qty;
+        w.firstSeenMs = nowMs;
+        index[tick] = w.id;
+        added_.push_back(w.id);
+        walls_.emplace(w.id, w);
+    }
+
+    void WallTracker::removeWall(std::uint64_t id, long long nowMs)
+    {
+        auto it = walls_.find(id);
+        if (it == walls_.end())
+        {
+            return;
+        }
+        Wall w = it->second;
+        (w.bid ? bidIndex_ : askIndex_).erase(w.tick);
+        walls_.erase(it);
+        pendingTraded_.erase(id);
+        dirty_.erase(id);
+        removed_.push_back(Removed{w, nowMs});
+    }
+
+    bool WallTracker::adoptMovedWall(bool bid, Tick tick, double qty, long long nowMs)
+    {
+        auto best = removed_.end();
+        Tick bestDistance = 0;
+        for (auto it = removed_.begin(); it != removed_.end(); ++it)
+        {
+            const Wall& w = it->wall;
+            if (w.bid != bid || nowMs - it->removedMs > moveWindowMs_ || w.lastDecreaseTraded)
+            {
+                continue;
+            }
+            const Tick distance = std::llabs(tick - w.tick);
+            if (distance == 0 || distance > moveTicks_)
+            {
+                continue;
+            }
+            // Same order re-posted at another price: compare with the size it had before leaving.
+            if (qty < w.peakQty * 0.5 || qty > w.peakQty * 2.0)
+            {
+                continue;
+            }
+            if (best == removed_.end() || distance < bestDistance)
+            {
+                best = it;
+                bestDistance = distance;
+            }
+        }
+        if (best == removed_.end())
+        {
+            return false;
+        }
+        Wall w = best->wall;
+        removed_.erase(best);
+        // Leaving the old price was a move, not a pull.
+        w.pulled = std::max(0.0, w.pulled - w.peakQty);
+        w.movedTicks += tick - w.tick;
+        w.moves += 1;
+        w.tick = tick;
+        w.qty = qty;
+        w.peakQty = std::max(w.peakQty, qty);
+        (bid ? bidIndex_ : askIndex_)[tick] = w.id;
+        dirty_.insert(w.id);
+        walls_.emplace(w.id, w);
+        return true;
+    }
+
+    double WallTracker::notional(Tick tick, double qty) const
+    {
+        return qty * static_cast<double>(tick) * tickSize_;
+    }
+} // namespace dom
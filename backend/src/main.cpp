@@ -20,13 +20,24 @@
 #    include <QWebSocket>
 #endif
 
+#include "BookAnalytics.hpp"
+#include "ConsolidatedBook.hpp"
+#include "FeedParsers.hpp"
+#include "FrameArena.hpp"
+#include "LatencyHistogram.hpp"
 #include "OrderBook.hpp"
+#include "TickRecorder.hpp"
+#include "TickStoreReader.hpp"
+#include "WallTracker.hpp"
 
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
 #include <charconv>
 #include <cstdint>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <optional>
 #include <sstream>
@@ -45,10 +56,123 @@ namespace
 {
     using namespace std::chrono_literals;
     using json = nlohmann::json;
+    using dom::feed::jsonToDouble;
+    using dom::feed::quantizeTickFromPrice;
+    using dom::feed::tickFromPrice;
 
+    // Knobs the GUI may change over the control channel without restarting the process.
+    // Seeded from Config in main(); feed loops read them on every frame.
+    struct RuntimeSettings
+    {
+        std::atomic<std::size_t> ladderLevelsPerSide{120};
+        std::atomic<std::size_t> cacheLevelsPerSide{5000};
+        std::atomic<long long> throttleMs{50};
+        // Stamped on every ladder/trades frame; the GUI drops frames older than the
+        // generation it asked for with its last reconfiguration command.
+        std::atomic<std::uint64_t> generation{0};
+
+        std::atomic<bool> symbolSwitchPending{false};
+        std::atomic<bool> controlClosed{false}; // stdin reached EOF: the GUI is gone
+        std::mutex switchMutex;
+        std::string pendingSymbol;
+        std::uint64_t pendingGeneration{0};
+    };
+
+    RuntimeSettings& runtime()
+    {
+        static RuntimeSettings r;
+        return r;
+    }
+
+    std::chrono::milliseconds runtimeThrottle()
+    {
+        return std::chrono::milliseconds(runtime().throttleMs.load(std::memory_order_relaxed));
+    }
+
+    std::size_t runtimeCacheLevels()
+    {
+        return runtime().cacheLevelsPerSide.load(std::memory_order_relaxed);
+    }
+
+    bool symbolSwitchPending()
+    {
+        return runtime().symbolSwitchPending.load(std::memory_order_acquire);
+    }
+
+    bool peekSymbolSwitch(std::string& symbolOut)
+    {
+        auto& rt = runtime();
+        std::lock_guard<std::mutex> lock(rt.switchMutex);
+        if (!rt.symbolSwitchPending.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        symbolOut = rt.pendingSymbol;
+        return true;
+    }
+
+    bool takeSymbolSwitch(std::string& symbolOut, std::uint64_t& generationOut)
+    {
+        auto& rt = runtime();
+        std::lock_guard<std::mutex> lock(rt.switchMutex);
+        if (!rt.symbolSwitchPending.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        symbolOut = rt.pendingSymbol;
+        generationOut = rt.pendingGeneration;
+        rt.symbolSwitchPending.store(false, std::memory_order_release);
+        return true;
+    }
+
+    // takeSymbolSwitch() for a feed that prepared `symbol` on its open socket; leaves the request
+    // pending and fails when a newer one replaced it meanwhile.
+    bool takeSymbolSwitchFor(const std::string& symbol, std::uint64_t& generationOut)
+    {
+        auto& rt = runtime();
+        std::lock_guard<std::mutex> lock(rt.switchMutex);
+        if (!rt.symbolSwitchPending.load(std::memory_order_acquire) || rt.pendingSymbol != symbol)
+        {
+            return false;
+        }
+        generationOut = rt.pendingGeneration;
+        rt.symbolSwitchPending.store(false, std::memory_order_release);
+        return true;
+    }
+
+    // Lines are tagged so the writer can drop superseded ones under backpressure. Everything but
+    // Other is replaced by a later line of its kind (a full ladder, the next stats interval or
+    // analytics snapshot, newer prints); Other lines (pages, wall events, acks) are never dropped.
+    enum class StdoutLineKind
+    {
+        Other,
+        LadderFull,
+        LadderDelta,
+        Stats,
+        Analytics,
+        Trades
+    };
+
+    // Producers (feed threads, control thread, heartbeat) push lines onto a lock-free list;
+    // a single writer thread swaps the whole list out, drops superseded ladder frames and
+    // does one large write per batch. A slow GUI pipe therefore only stalls the writer thread,
+    // never a WS receive loop. While the writer is stuck in a write, queued bytes are capped at
+    // kCapFactor * backlogBytes: past that, droppable lines are refused at the producer.
     class StdoutBatchWriter
     {
     public:
+        struct Stats
+        {
+            std::uint64_t queuedLines{0};
+            std::uint64_t queuedBytes{0};
+            std::uint64_t writes{0};
+            std::uint64_t bytesWritten{0};
+            std::uint64_t coalesced{0}; // ladder frames superseded by a later full frame in the same batch
+            std::uint64_t dropped{0};   // lines dropped because the pipe was backed up
+        };
+
+        static constexpr std::size_t kCapFactor = 4;
+
         StdoutBatchWriter()
         {
             const char* ms = std::getenv("BACKEND_STDOUT_FLUSH_MS");
@@ -75,45 +199,316 @@ namespace
                 {
                 }
             }
+            const char* backlog = std::getenv("BACKEND_STDOUT_BACKLOG_BYTES");
+            if (backlog && *backlog)
+            {
+                try
+                {
+                    const int v = std::max(0, std::stoi(backlog));
+                    backlogBytes = static_cast<std::size_t>(std::clamp(v, 64 * 1024, 64 * 1024 * 1024));
+                }
+                catch (...)
+                {
+                }
+            }
+            capBytes = backlogBytes * kCapFactor;
+            writer = std::thread([this]() { run(); });
         }
 
-        void writeLine(const std::string& line)
+        ~StdoutBatchWriter()
         {
-            const auto now = std::chrono::steady_clock::now();
-            std::lock_guard<std::mutex> lock(mu);
-            buf.append(line);
-            buf.push_back('\n');
-            if (flushInterval.count() == 0 || buf.size() >= flushBytes || now - lastFlush >= flushInterval)
+            stopping.store(true, std::memory_order_release);
+            wake();
+            if (writer.joinable())
             {
-                flushLocked();
-                lastFlush = now;
+                writer.join();
+            }
+            for (Node* n = freeNodes.exchange(nullptr, std::memory_order_acquire); n;)
+            {
+                Node* next = n->next;
+                delete n;
+                n = next;
+            }
+        }
+
+        StdoutBatchWriter(const StdoutBatchWriter&) = delete;
+        StdoutBatchWriter& operator=(const StdoutBatchWriter&) = delete;
+
+        void writeLine(std::string line, StdoutLineKind kind = StdoutLineKind::Other)
+        {
+            if (kind != StdoutLineKind::Other && queuedBytes.load(std::memory_order_relaxed) >= capBytes)
+            {
+                if (kind == StdoutLineKind::LadderFull || kind == StdoutLineKind::LadderDelta)
+                {
+                    // The emitter's next frame is a full ladder, which replaces this one.
+                    ladderResync.store(true, std::memory_order_release);
+                }
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            Node* node = takeNode();
+            node->line = std::move(line);
+            node->kind = kind;
+            queuedLines.fetch_add(1, std::memory_order_relaxed);
+            queuedBytes.fetch_add(node->line.size() + 1, std::memory_order_relaxed);
+            Node* head = pending.load(std::memory_order_relaxed);
+            do
+            {
+                node->next = head;
+            } while (!pending.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+            if (head == nullptr)
+            {
+                // List was empty: the writer may be parked.
+                wake();
             }
         }
 
         void flush()
         {
-            std::lock_guard<std::mutex> lock(mu);
-            flushLocked();
-            lastFlush = std::chrono::steady_clock::now();
+            flushRequested.store(true, std::memory_order_release);
+            wake();
+        }
+
+        // Set when ladder deltas were dropped; the next emitted ladder must be a full frame.
+        bool consumeLadderResync()
+        {
+            return ladderResync.exchange(false, std::memory_order_acq_rel);
+        }
+
+        Stats stats() const
+        {
+            Stats s;
+            s.queuedLines = queuedLines.load(std::memory_order_relaxed);
+            s.queuedBytes = queuedBytes.load(std::memory_order_relaxed);
+            s.writes = writes.load(std::memory_order_relaxed);
+            s.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+            s.coalesced = coalesced.load(std::memory_order_relaxed);
+            s.dropped = dropped.load(std::memory_order_relaxed);
+            return s;
         }
 
     private:
-        void flushLocked()
+        struct Node
+        {
+            std::string line;
+            StdoutLineKind kind{StdoutLineKind::Other};
+            Node* next{nullptr};
+        };
+
+        // Nodes a producer thread took off the free list and has not used yet.
+        struct NodeCache
+        {
+            Node* head{nullptr};
+
+            ~NodeCache()
+            {
+                while (head)
+                {
+                    Node* next = head->next;
+                    delete head;
+                    head = next;
+                }
+            }
+        };
+
+        // Written nodes go back on a free list. A producer takes the whole list at once into a
+        // thread-local cache, so there is no pop that could race with another producer's.
+        Node* takeNode()
+        {
+            thread_local NodeCache cache;
+            if (!cache.head)
+            {
+                cache.head = freeNodes.exchange(nullptr, std::memory_order_acquire);
+            }
+            if (Node* n = cache.head)
+            {
+                cache.head = n->next;
+                n->next = nullptr;
+                return n;
+            }
+            return new Node;
+        }
+
+        // Writer thread only. The line buffers are released here rather than on the next
+        // producer's move-assign, which keeps the free off the feed threads.
+        void recycle(const std::vector<Node*>& nodes)
         {
-            if (buf.empty())
+            if (nodes.empty())
             {
                 return;
             }
-            std::cout.write(buf.data(), static_cast<std::streamsize>(buf.size()));
-            std::cout.flush();
-            buf.clear();
+            for (std::size_t i = 0; i < nodes.size(); ++i)
+            {
+                std::string().swap(nodes[i]->line);
+                nodes[i]->next = i + 1 < nodes.size() ? nodes[i + 1] : nullptr;
+            }
+            Node* last = nodes.back();
+            Node* head = freeNodes.load(std::memory_order_relaxed);
+            do
+            {
+                last->next = head;
+            } while (!freeNodes.compare_exchange_weak(
+                head, nodes.front(), std::memory_order_release, std::memory_order_relaxed));
         }
 
-        std::mutex mu;
-        std::string buf;
+        void wake()
+        {
+            wakeSeq.fetch_add(1, std::memory_order_release);
+            wakeSeq.notify_one();
+        }
+
+        // Takes everything queued so far, oldest first.
+        void takePending(std::vector<Node*>& out)
+        {
+            Node* list = pending.exchange(nullptr, std::memory_order_acquire);
+            const std::size_t base = out.size();
+            for (; list; list = list->next)
+            {
+                out.push_back(list);
+            }
+            std::reverse(out.begin() + static_cast<std::ptrdiff_t>(base), out.end());
+        }
+
+        void run()
+        {
+            std::vector<Node*> batch;
+            std::string buf;
+            for (;;)
+            {
+                const auto seq = wakeSeq.load(std::memory_order_acquire);
+                takePending(batch);
+                if (batch.empty())
+                {
+                    if (stopping.load(std::memory_order_acquire))
+                    {
+                        break;
+                    }
+                    wakeSeq.wait(seq, std::memory_order_acquire);
+                    continue;
+                }
+
+                // Give producers a moment to fill the batch unless it is already large.
+                if (flushInterval.count() > 0 && !stopping.load(std::memory_order_acquire)
+                    && !flushRequested.exchange(false, std::memory_order_acq_rel)
+                    && queuedBytes.load(std::memory_order_relaxed) < flushBytes)
+                {
+                    const auto due = lastWrite + flushInterval;
+                    if (std::chrono::steady_clock::now() < due)
+                    {
+                        std::this_thread::sleep_until(due);
+                        takePending(batch);
+                    }
+                }
+
+                // Bytes still waiting after a write means the pipe could not keep up.
+                const bool backedUp = queuedBytes.load(std::memory_order_relaxed) >= backlogBytes;
+                std::size_t lastFull = batch.size();
+                for (std::size_t i = batch.size(); i-- > 0;)
+                {
+                    if (batch[i]->kind == StdoutLineKind::LadderFull)
+                    {
+                        lastFull = i;
+                        break;
+                    }
+                }
+
+                buf.clear();
+                std::uint64_t lineBytes = 0;
+                std::uint64_t coalescedNow = 0;
+                std::uint64_t droppedNow = 0;
+                for (std::size_t i = 0; i < batch.size(); ++i)
+                {
+                    Node* n = batch[i];
+                    lineBytes += n->line.size() + 1;
+                    bool keep = true;
+                    if (n->kind == StdoutLineKind::LadderFull)
+                    {
+                        if (lastFull != batch.size() && i < lastFull)
+                        {
+                            keep = false;
+                            ++coalescedNow;
+                        }
+                        else
+                        {
+                            awaitingFull = false;
+                        }
+                    }
+                    else if (n->kind == StdoutLineKind::LadderDelta)
+                    {
+                        if (lastFull != batch.size() && i < lastFull)
+                        {
+                            keep = false;
+                            ++coalescedNow;
+                        }
+                        else if (awaitingFull)
+                        {
+                            keep = false;
+                            ++droppedNow;
+                        }
+                        else if (backedUp)
+                        {
+                            // The GUI is behind: stop sending incremental frames and ask the
+                            // emitter for a fresh full ladder once the pipe drains.
+                            awaitingFull = true;
+                            ladderResync.store(true, std::memory_order_release);
+                            keep = false;
+                            ++droppedNow;
+                        }
+                    }
+                    if (keep)
+                    {
+                        buf.append(n->line);
+                        buf.push_back('\n');
+                    }
+                }
+                queuedLines.fetch_sub(batch.size(), std::memory_order_relaxed);
+                queuedBytes.fetch_sub(lineBytes, std::memory_order_relaxed);
+                recycle(batch);
+                batch.clear();
+                if (coalescedNow)
+                {
+                    coalesced.fetch_add(coalescedNow, std::memory_order_relaxed);
+                }
+                if (droppedNow)
+                {
+                    dropped.fetch_add(droppedNow, std::memory_order_relaxed);
+                }
+                if (awaitingFull)
+                {
+                    // Re-arm in case the emitter consumed the flag before these frames were dropped.
+                    ladderResync.store(true, std::memory_order_release);
+                }
+
+                if (!buf.empty())
+                {
+                    std::cout.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+                    std::cout.flush();
+                    writes.fetch_add(1, std::memory_order_relaxed);
+                    bytesWritten.fetch_add(buf.size(), std::memory_order_relaxed);
+                }
+                lastWrite = std::chrono::steady_clock::now();
+            }
+        }
+
+        std::atomic<Node*> pending{nullptr};
+        std::atomic<Node*> freeNodes{nullptr};
+        std::atomic<std::uint32_t> wakeSeq{0};
+        std::atomic<bool> stopping{false};
+        std::atomic<bool> flushRequested{false};
+        std::atomic<bool> ladderResync{false};
+        std::atomic<std::uint64_t> queuedLines{0};
+        std::atomic<std::uint64_t> queuedBytes{0};
+        std::atomic<std::uint64_t> writes{0};
+        std::atomic<std::uint64_t> bytesWritten{0};
+        std::atomic<std::uint64_t> coalesced{0};
+        std::atomic<std::uint64_t> dropped{0};
+        bool awaitingFull{false}; // writer thread only
         std::chrono::milliseconds flushInterval{8};
         std::size_t flushBytes{16 * 1024};
-        std::chrono::steady_clock::time_point lastFlush{std::chrono::steady_clock::now()};
+        std::size_t backlogBytes{4 * 1024 * 1024};
+        std::size_t capBytes{kCapFactor * 4 * 1024 * 1024};
+        std::chrono::steady_clock::time_point lastWrite{std::chrono::steady_clock::now()};
+        std::thread writer;
     };
 
     static StdoutBatchWriter& stdoutWriter()
@@ -122,6 +517,13 @@ namespace
         return w;
     }
 
+    // Opt-in microstructure analytics on the streamed book (--analytics-levels / BACKEND_ANALYTICS_LEVELS).
+    dom::BookAnalytics* g_analytics = nullptr;
+    // Opt-in liquidity-wall tracking (--wall-notional / BACKEND_WALL_NOTIONAL).
+    dom::WallTracker* g_walls = nullptr;
+    // Opt-in tick-data recorder (--record <dir> / BACKEND_RECORD_DIR).
+    dom::TickRecorder* g_recorder = nullptr;
+
     class TradeBatcher
     {
     public:
@@ -152,6 +554,55 @@ namespace
                 {
                 }
             }
+            const char* agg = std::getenv("BACKEND_TRADE_AGG_MS");
+            if (agg && *agg)
+            {
+                try
+                {
+                    setAggregateWindow(std::chrono::milliseconds(std::stoi(agg)));
+                }
+                catch (...)
+                {
+                }
+            }
+            // Row layout ({"events":[{...}]}) is kept for debugging / older consumers.
+            columnar = !std::getenv("BACKEND_TRADE_BATCH_ROWS");
+            // Construct the writer first so it outlives the flusher at exit.
+            stdoutWriter();
+            flusher = std::thread([this]() { runFlusher(); });
+        }
+
+        ~TradeBatcher()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mu);
+                stopping = true;
+            }
+            wakeFlusher.notify_one();
+            if (flusher.joinable())
+            {
+                flusher.join();
+            }
+        }
+
+        TradeBatcher(const TradeBatcher&) = delete;
+        TradeBatcher& operator=(const TradeBatcher&) = delete;
+
+        // Merge consecutive same-side fills at the same price that arrive within `window`
+        // (exchange timestamps) into one print. 0 disables aggregation. The newest print is held
+        // back from batch flushes until `window` has passed since it opened, so windows longer
+        // than the batch interval still merge; capped at 5 s.
+        void setAggregateWindow(std::chrono::milliseconds window)
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            aggregateWindowMs = std::clamp<long long>(window.count(), 0, 5000);
+        }
+
+        // Re-quantize incoming prints onto another tick grid (consolidated book); 0 keeps venue ticks.
+        void setTickGrid(double tickSize)
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            tickGrid = tickSize > 0.0 ? tickSize : 0.0;
         }
 
         void add(const std::string& symbol, json&& trade)
@@ -159,54 +610,277 @@ namespace
             if (!enabled)
             {
                 // Fallback: emit one-per-line.
-                stdoutWriter().writeLine(trade.dump());
+                stdoutWriter().writeLine(trade.dump(), StdoutLineKind::Trades);
+                return;
+            }
+            PendingTrade t;
+            if (!decode(trade, t))
+            {
                 return;
             }
+            if (g_analytics)
+            {
+                // Local receive time: the CVD window must not depend on exchange clock skew.
+                g_analytics->onTrade(t.qty,
+                                     t.buy,
+                                     std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+            }
+            if (g_walls)
+            {
+                g_walls->onTrade(t.price, t.qty, t.buy);
+            }
+            if (g_recorder)
+            {
+                g_recorder->onTrade(t.price, t.qty, t.buy);
+            }
             const auto now = std::chrono::steady_clock::now();
             std::lock_guard<std::mutex> lock(mu);
             if (this->symbol.empty())
             {
                 this->symbol = symbol;
             }
-            // Keep payload compact: symbol on top-level.
-            trade.erase("symbol");
-            batch.push_back(std::move(trade));
+            if (tickGrid > 0.0)
+            {
+                t.hasTick = true;
+                t.tick = static_cast<dom::OrderBook::Tick>(std::llround(t.price / tickGrid));
+            }
+            const bool wasEmpty = batch.empty();
+            if (!batch.empty() && canMerge(batch.back(), t))
+            {
+                PendingTrade& last = batch.back();
+                last.qty += t.qty;
+                last.fills += t.fills;
+                last.timestamp = std::max(last.timestamp, t.timestamp);
+            }
+            else
+            {
+                t.openedAt = now;
+                batch.push_back(t);
+            }
             if (flushInterval.count() == 0 || batch.size() >= flushMax || now - lastFlush >= flushInterval)
             {
-                flushLocked();
+                flushLocked(now, false);
                 lastFlush = now;
             }
+            if (wasEmpty && !batch.empty())
+            {
+                wakeFlusher.notify_one();
+            }
         }
 
         void flush()
         {
             std::lock_guard<std::mutex> lock(mu);
-            flushLocked();
-            lastFlush = std::chrono::steady_clock::now();
+            const auto now = std::chrono::steady_clock::now();
+            flushLocked(now, true);
+            lastFlush = now;
+        }
+
+        // Flush prints of the previous symbol before frames start carrying a new generation.
+        void switchSymbol(const std::string& next)
+        {
+            std::lock_guard<std::mutex> lock(mu);
+            const auto now = std::chrono::steady_clock::now();
+            flushLocked(now, true);
+            symbol = next;
+            lastFlush = now;
         }
 
     private:
-        void flushLocked()
+        struct PendingTrade
+        {
+            bool hasTick{false};
+            dom::OrderBook::Tick tick{0};
+            double price{0.0};
+            double qty{0.0};
+            bool buy{true};
+            long long timestamp{0};
+            std::uint32_t fills{1};
+            std::chrono::steady_clock::time_point openedAt{}; // local arrival of the first fill
+        };
+
+        static bool decode(const json& trade, PendingTrade& out)
+        {
+            const auto priceIt = trade.find("price");
+            const auto qtyIt = trade.find("qty");
+            if (priceIt == trade.end() || !priceIt->is_number() || qtyIt == trade.end() || !qtyIt->is_number())
+            {
+                return false;
+            }
+            out.price = priceIt->get<double>();
+            out.qty = qtyIt->get<double>();
+            const auto tickIt = trade.find("tick");
+            if (tickIt != trade.end() && tickIt->is_number_integer())
+            {
+                out.hasTick = true;
+                out.tick = tickIt->get<dom::OrderBook::Tick>();
+            }
+            const auto sideIt = trade.find("side");
+            out.buy = !(sideIt != trade.end() && sideIt->is_string() && sideIt->get_ref<const std::string&>() == "sell");
+            const auto tsIt = trade.find("timestamp");
+            if (tsIt != trade.end() && tsIt->is_number())
+            {
+                out.timestamp = tsIt->get<long long>();
+            }
+            return std::isfinite(out.price) && std::isfinite(out.qty);
+        }
+
+        bool canMerge(const PendingTrade& a, const PendingTrade& b) const
+        {
+            if (aggregateWindowMs <= 0 || a.buy != b.buy || a.hasTick != b.hasTick)
+            {
+                return false;
+            }
+            if (a.hasTick ? (a.tick != b.tick) : (a.price != b.price))
+            {
+                return false;
+            }
+            // Missing exchange timestamps: rely on the local hold window alone.
+            if (a.timestamp <= 0 || b.timestamp <= 0)
+            {
+                return true;
+            }
+            return std::llabs(b.timestamp - a.timestamp) <= aggregateWindowMs;
+        }
+
+        // Sends prints that are due after a quiet spell: the batch interval has passed, or the
+        // held aggregate's window has.
+        void runFlusher()
+        {
+            std::unique_lock<std::mutex> lock(mu);
+            while (!stopping)
+            {
+                if (batch.empty())
+                {
+                    wakeFlusher.wait(lock);
+                    continue;
+                }
+                auto due = lastFlush + flushInterval;
+                if (batch.size() == 1 && holdsOpenAggregate(due))
+                {
+                    due = batch.back().openedAt + std::chrono::milliseconds(aggregateWindowMs);
+                }
+                if (wakeFlusher.wait_until(lock, due) == std::cv_status::no_timeout)
+                {
+                    continue;
+                }
+                const auto now = std::chrono::steady_clock::now();
+                if (!batch.empty() && now >= due)
+                {
+                    const std::size_t before = batch.size();
+                    flushLocked(now, false);
+                    if (batch.size() != before)
+                    {
+                        lastFlush = now;
+                    }
+                }
+            }
+        }
+
+        // The newest print may still absorb fills at `now`.
+        bool holdsOpenAggregate(std::chrono::steady_clock::time_point now) const
+        {
+            return aggregateWindowMs > 0 && !batch.empty()
+                   && now - batch.back().openedAt < std::chrono::milliseconds(aggregateWindowMs);
+        }
+
+        // Emits the batch; unless `all`, an aggregate whose window is still open stays behind.
+        void flushLocked(std::chrono::steady_clock::time_point now, bool all)
         {
+            std::optional<PendingTrade> held;
+            if (!all && holdsOpenAggregate(now))
+            {
+                held = batch.back();
+                batch.pop_back();
+            }
             if (batch.empty())
             {
+                if (held)
+                {
+                    batch.push_back(*held);
+                }
                 return;
             }
             json out;
             out["type"] = "trades";
             out["symbol"] = symbol;
-            out["events"] = std::move(batch);
-            batch = json::array();
-            stdoutWriter().writeLine(out.dump());
-        }
-
-        std::mutex mu;
-        bool enabled{true};
-        std::string symbol;
-        json batch = json::array();
+            out["gen"] = runtime().generation.load(std::memory_order_relaxed);
+            if (columnar)
+            {
+                // Parallel arrays: one entry per (possibly aggregated) print.
+                // tick == 0 means "unknown" (no tick size yet), price is always present.
+                json ticks = json::array();
+                json prices = json::array();
+                json qtys = json::array();
+                json sides = json::array();
+                json times = json::array();
+                json fills = json::array();
+                bool anyAggregated = false;
+                for (const auto& t : batch)
+                {
+                    ticks.push_back(t.hasTick ? t.tick : 0);
+                    prices.push_back(t.price);
+                    qtys.push_back(t.qty);
+                    sides.push_back(t.buy ? 1 : 0);
+                    times.push_back(t.timestamp);
+                    fills.push_back(t.fills);
+                    anyAggregated = anyAggregated || t.fills > 1;
+                }
+                out["tick"] = std::move(ticks);
+                out["price"] = std::move(prices);
+                out["qty"] = std::move(qtys);
+                out["side"] = std::move(sides);
+                out["ts"] = std::move(times);
+                if (anyAggregated)
+                {
+                    out["fills"] = std::move(fills);
+                }
+            }
+            else
+            {
+                json events = json::array();
+                for (const auto& t : batch)
+                {
+                    json e;
+                    if (t.hasTick)
+                    {
+                        e["tick"] = t.tick;
+                    }
+                    e["price"] = t.price;
+                    e["qty"] = t.qty;
+                    e["side"] = t.buy ? "buy" : "sell";
+                    e["timestamp"] = t.timestamp;
+                    if (t.fills > 1)
+                    {
+                        e["fills"] = t.fills;
+                    }
+                    events.push_back(std::move(e));
+                }
+                out["events"] = std::move(events);
+            }
+            batch.clear();
+            if (held)
+            {
+                batch.push_back(*held);
+            }
+            stdoutWriter().writeLine(out.dump(), StdoutLineKind::Trades);
+        }
+
+        std::mutex mu;
+        bool enabled{true};
+        bool columnar{true};
+        std::string symbol;
+        std::vector<PendingTrade> batch;
+        long long aggregateWindowMs{0};
+        double tickGrid{0.0};
         std::chrono::milliseconds flushInterval{16};
         std::size_t flushMax{64};
         std::chrono::steady_clock::time_point lastFlush{std::chrono::steady_clock::now()};
+        std::condition_variable wakeFlusher;
+        bool stopping{false};
+        std::thread flusher;
     };
 
     static TradeBatcher& tradeBatcher()
@@ -215,6 +889,126 @@ namespace
         return b;
     }
 
+    // Per-stage measurements behind the periodic {"type":"stats"} message.
+    struct BackendTelemetry
+    {
+        std::atomic<std::uint64_t> frames{0};
+        std::atomic<std::uint64_t> bytes{0};
+        dom::LatencyHistogram framesPerSec;
+        dom::LatencyHistogram bytesPerSec;
+        dom::LatencyHistogram parseUs;
+        dom::LatencyHistogram applyUs;
+        dom::LatencyHistogram emitUs;
+        dom::LatencyHistogram stdoutQueueLines;
+        dom::LatencyHistogram feedLatencyMs;
+        dom::LatencyHistogram allocsPerSec;
+        // Heap allocations from receipt to book update of a depth frame. The text decoders keep
+        // this at 0 once the arena is warm; frames that fall back to json count their DOM, and
+        // proxied (Qt) connections add the UTF-8 copy of each QString frame.
+        dom::LatencyHistogram frameAllocs;
+        std::atomic<std::uint64_t> arenaSpills{0};
+        // Event time (ms since epoch) of the newest exchange update not yet emitted.
+        std::atomic<long long> pendingExchangeTsMs{0};
+    };
+
+    static BackendTelemetry& telemetry()
+    {
+        static BackendTelemetry t;
+        return t;
+    }
+
+    // Receive time of the frame currently being handled by this feed thread.
+    thread_local std::chrono::steady_clock::time_point t_frameStart{};
+    // This thread's heap allocation count when that frame arrived.
+    thread_local std::uint64_t t_frameAllocStart = 0;
+
+    // Parse scratch of the frame this feed thread is handling; released when the next frame
+    // arrives, so arena-backed containers must not outlive the receive loop iteration.
+    static dom::FrameArena& frameArena()
+    {
+        thread_local dom::FrameArena arena;
+        return arena;
+    }
+
+    using dom::feed::LevelVector;
+
+    // Empty containers allocating from the current frame's arena.
+    LevelVector frameLevels()
+    {
+        return LevelVector(frameArena().resource());
+    }
+
+    dom::feed::DepthUpdate frameDepth()
+    {
+        return dom::feed::DepthUpdate(frameArena().resource());
+    }
+
+    dom::feed::TradeVector frameTrades()
+    {
+        return dom::feed::TradeVector(frameArena().resource());
+    }
+
+    std::uint64_t elapsedMicros(std::chrono::steady_clock::time_point since)
+    {
+        const auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - since)
+                            .count();
+        return static_cast<std::uint64_t>(std::max<long long>(0, us));
+    }
+
+    void noteFrameReceived(std::size_t bytes)
+    {
+        auto& t = telemetry();
+        t.frames.fetch_add(1, std::memory_order_relaxed);
+        t.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        auto& arena = frameArena();
+        const auto spills = arena.spills();
+        arena.reset();
+        if (arena.spills() != spills)
+        {
+            t.arenaSpills.fetch_add(1, std::memory_order_relaxed);
+        }
+        t_frameAllocStart = dom::threadHeapAllocations();
+        t_frameStart = std::chrono::steady_clock::now();
+    }
+
+    void noteExchangeTime(long long eventTimeMs)
+    {
+        if (eventTimeMs > 0)
+        {
+            telemetry().pendingExchangeTsMs.store(eventTimeMs, std::memory_order_relaxed);
+        }
+    }
+
+    // Parse time = receive -> first book mutation of that frame.
+    void noteFrameParsed()
+    {
+        if (t_frameStart.time_since_epoch().count() == 0)
+        {
+            return;
+        }
+        auto& t = telemetry();
+        t.parseUs.record(elapsedMicros(t_frameStart));
+        t.frameAllocs.record(dom::threadHeapAllocations() - t_frameAllocStart);
+        t_frameStart = {};
+    }
+
+    void applyDeltaTimed(dom::OrderBook& book, dom::OrderBook::LevelUpdates bids, dom::OrderBook::LevelUpdates asks)
+    {
+        noteFrameParsed();
+        const auto start = std::chrono::steady_clock::now();
+        book.applyDelta(bids, asks, runtimeCacheLevels());
+        telemetry().applyUs.record(elapsedMicros(start));
+    }
+
+    void loadSnapshotTimed(dom::OrderBook& book, dom::OrderBook::LevelUpdates bids, dom::OrderBook::LevelUpdates asks)
+    {
+        noteFrameParsed();
+        const auto start = std::chrono::steady_clock::now();
+        book.loadSnapshot(bids, asks);
+        telemetry().applyUs.record(elapsedMicros(start));
+    }
+
     struct Config
     {
         std::string symbol{"BIOUSDT"};
@@ -227,6 +1021,16 @@ namespace
         std::chrono::milliseconds throttle{50};
         std::size_t snapshotDepth{500};
         std::size_t cacheLevelsPerSide{5000};
+        int tradeAggregateMs{-1};       // -1: keep BACKEND_TRADE_AGG_MS / default (off)
+        std::vector<std::string> consolidateVenues; // venue[:symbol] list; non-empty = consolidated book mode
+        double consolidateGridTick{0.0};            // 0: coarsest venue tick
+        std::size_t analyticsLevels{0};             // analytics band in price levels per side; 0 = off
+        double wallNotional{0.0};                   // wall threshold in quote currency; 0 = off
+        std::string recordDir;                      // tick-data recorder root; empty = off
+        std::string replayPath;                     // recorded day file to stream instead of an exchange
+        bool standby{false};                        // start idle; the first "subscribe" picks the symbol
+        long long replayFromMs{0};                  // replay start (epoch ms); 0 = beginning of the file
+        double replaySpeed{1.0};                    // replay speed factor; 0 = as fast as possible
         double futuresContractSize{1.0}; // MEXC futures qty is in contracts; multiply by this to get base qty
         int mexcStreamIntervalMs{100};  // MEXC spot protobuf WS interval (ms)
         int mexcSpotPollMs{250};        // MEXC spot REST polling interval (fallback)
@@ -478,6 +1282,82 @@ namespace
         }
     }
 
+    // Exchange-specific defaults; also applied to every venue of a consolidated book.
+    void normalizeExchangeConfig(Config& cfg, bool snapshotDepthSet)
+    {
+        const std::size_t kMaxSnapshotDepth =
+            (cfg.exchange == "binance" || cfg.exchange == "binance_futures") ? 1000 : 5000;
+
+        if (!snapshotDepthSet || cfg.snapshotDepth == 0)
+        {
+            if (cfg.exchange == "binance" || cfg.exchange == "binance_futures")
+            {
+                cfg.snapshotDepth = 1000;
+            }
+            else if (cfg.exchange == "mexc" || cfg.exchange == "mexc_futures")
+            {
+                cfg.snapshotDepth = 200;
+            }
+            else
+            {
+                cfg.snapshotDepth = 500;
+            }
+        }
+        // Ensure the initial REST snapshot is "good enough" to show a usable ladder quickly.
+        // Note: ladderLevelsPerSide can be very large (user can zoom out), but fetching an equally
+        // huge REST snapshot is expensive and often unnecessary — the WS stream will fill depth
+        // progressively. Cap the minimum snapshot to keep startup responsive.
+        const std::size_t minSnapshot =
+            std::min(std::max<std::size_t>(std::min<std::size_t>(cfg.ladderLevelsPerSide * 2, 1000), 50),
+                     kMaxSnapshotDepth);
+        if (cfg.snapshotDepth < minSnapshot)
+        {
+            cfg.snapshotDepth = minSnapshot;
+        }
+        if (cfg.snapshotDepth > kMaxSnapshotDepth)
+        {
+            cfg.snapshotDepth = kMaxSnapshotDepth;
+        }
+
+        // Normalize MEXC spot stream interval to supported values.
+        // Note: `spot@public.aggre.*.v3.api.pb` is allowed only at 100ms; other intervals are blocked.
+        if (cfg.exchange == "mexc")
+        {
+            // MEXC spot JSON WS supports a small set of fixed intervals; keep 100ms by default.
+            cfg.mexcStreamIntervalMs = 100;
+            if (cfg.mexcSpotPollMs < 50) cfg.mexcSpotPollMs = 50;
+            if (cfg.mexcSpotPollMs > 2000) cfg.mexcSpotPollMs = 2000;
+            if (cfg.mexcSpotMode != "pbws" && cfg.mexcSpotMode != "rest")
+            {
+                cfg.mexcSpotMode = "pbws";
+            }
+        }
+
+        if (cfg.exchange == "paradex")
+        {
+            if (cfg.symbol == "BIOUSDT")
+            {
+                cfg.symbol = "ETH-USD-PERP";
+            }
+            if (cfg.paradexEnv != "prod" && cfg.paradexEnv != "testnet")
+            {
+                cfg.paradexEnv = "prod";
+            }
+            if (cfg.paradexFeedType != "snapshot" && cfg.paradexFeedType != "deltas" && cfg.paradexFeedType != "interactive")
+            {
+                cfg.paradexFeedType = "snapshot";
+            }
+            if (cfg.paradexRefreshRate != "50ms" && cfg.paradexRefreshRate != "100ms")
+            {
+                cfg.paradexRefreshRate = "100ms";
+            }
+            if (cfg.snapshotDepth == 0)
+            {
+                cfg.snapshotDepth = 15;
+            }
+        }
+    }
+
     Config parseArgs(int argc, char** argv)
     {
         Config cfg;
@@ -498,6 +1378,10 @@ namespace
             {
                 cfg.symbol = value("--symbol");
             }
+            else if (arg == "--standby")
+            {
+                cfg.standby = true;
+            }
             else if (arg == "--endpoint")
             {
                 cfg.endpoint = value("--endpoint");
@@ -569,94 +1453,69 @@ namespace
             {
                 cfg.cacheLevelsPerSide = std::stoul(value("--cache-levels"));
             }
-        }
-
-        constexpr std::size_t kMinCacheLevels = 5000;
-        const std::size_t kMaxSnapshotDepth =
-            (cfg.exchange == "binance" || cfg.exchange == "binance_futures") ? 1000 : 5000;
-
-        cfg.cacheLevelsPerSide = std::max(cfg.cacheLevelsPerSide, kMinCacheLevels);
-
-        if (!snapshotDepthSet || cfg.snapshotDepth == 0)
-        {
-            if (cfg.exchange == "binance" || cfg.exchange == "binance_futures")
+            else if (arg == "--trade-agg-ms")
             {
-                cfg.snapshotDepth = 1000;
+                cfg.tradeAggregateMs = std::stoi(value("--trade-agg-ms"));
             }
-            else if (cfg.exchange == "mexc" || cfg.exchange == "mexc_futures")
+            else if (arg == "--consolidate")
             {
-                cfg.snapshotDepth = 200;
+                std::stringstream list(value("--consolidate"));
+                std::string venue;
+                while (std::getline(list, venue, ','))
+                {
+                    venue = trimAscii(venue);
+                    if (!venue.empty())
+                    {
+                        cfg.consolidateVenues.push_back(venue);
+                    }
+                }
             }
-            else
+            else if (arg == "--grid-tick")
             {
-                cfg.snapshotDepth = 500;
+                cfg.consolidateGridTick = std::stod(value("--grid-tick"));
             }
-        }
-        // Ensure the initial REST snapshot is "good enough" to show a usable ladder quickly.
-        // Note: ladderLevelsPerSide can be very large (user can zoom out), but fetching an equally
-        // huge REST snapshot is expensive and often unnecessary — the WS stream will fill depth
-        // progressively. Cap the minimum snapshot to keep startup responsive.
-        const std::size_t minSnapshot =
-            std::min(std::max<std::size_t>(std::min<std::size_t>(cfg.ladderLevelsPerSide * 2, 1000), 50),
-                     kMaxSnapshotDepth);
-        if (cfg.snapshotDepth < minSnapshot)
-        {
-            cfg.snapshotDepth = minSnapshot;
-        }
-        if (cfg.snapshotDepth > kMaxSnapshotDepth)
-        {
-            cfg.snapshotDepth = kMaxSnapshotDepth;
-        }
-
-        if (cfg.forceNoProxy)
-        {
-            cfg.proxy.clear();
-            cfg.winProxy.clear();
-            cfg.proxyUser.clear();
-            cfg.proxyPass.clear();
-        }
-        else
-        {
-            finalizeProxy(cfg);
-        }
-
-        // Normalize MEXC spot stream interval to supported values.
-        // Note: `spot@public.aggre.*.v3.api.pb` is allowed only at 100ms; other intervals are blocked.
-        if (cfg.exchange == "mexc")
-        {
-            // MEXC spot JSON WS supports a small set of fixed intervals; keep 100ms by default.
-            cfg.mexcStreamIntervalMs = 100;
-            if (cfg.mexcSpotPollMs < 50) cfg.mexcSpotPollMs = 50;
-            if (cfg.mexcSpotPollMs > 2000) cfg.mexcSpotPollMs = 2000;
-            if (cfg.mexcSpotMode != "pbws" && cfg.mexcSpotMode != "rest")
+            else if (arg == "--analytics-levels")
             {
-                cfg.mexcSpotMode = "pbws";
+                cfg.analyticsLevels = std::stoul(value("--analytics-levels"));
             }
-        }
-
-        if (cfg.exchange == "paradex")
-        {
-            if (cfg.symbol == "BIOUSDT")
+            else if (arg == "--wall-notional")
             {
-                cfg.symbol = "ETH-USD-PERP";
+                cfg.wallNotional = std::stod(value("--wall-notional"));
             }
-            if (cfg.paradexEnv != "prod" && cfg.paradexEnv != "testnet")
+            else if (arg == "--record")
             {
-                cfg.paradexEnv = "prod";
+                cfg.recordDir = value("--record");
             }
-            if (cfg.paradexFeedType != "snapshot" && cfg.paradexFeedType != "deltas" && cfg.paradexFeedType != "interactive")
+            else if (arg == "--replay")
             {
-                cfg.paradexFeedType = "snapshot";
+                cfg.replayPath = value("--replay");
             }
-            if (cfg.paradexRefreshRate != "50ms" && cfg.paradexRefreshRate != "100ms")
+            else if (arg == "--from")
             {
-                cfg.paradexRefreshRate = "100ms";
+                cfg.replayFromMs = std::stoll(value("--from"));
             }
-            if (cfg.snapshotDepth == 0)
+            else if (arg == "--speed")
             {
-                cfg.snapshotDepth = 15;
+                const std::string speed = toLowerAscii(value("--speed"));
+                cfg.replaySpeed = (speed == "max") ? 0.0 : std::max(0.001, std::stod(speed));
             }
         }
+
+        constexpr std::size_t kMinCacheLevels = 5000;
+        cfg.cacheLevelsPerSide = std::max(cfg.cacheLevelsPerSide, kMinCacheLevels);
+        normalizeExchangeConfig(cfg, snapshotDepthSet);
+
+        if (cfg.forceNoProxy)
+        {
+            cfg.proxy.clear();
+            cfg.winProxy.clear();
+            cfg.proxyUser.clear();
+            cfg.proxyPass.clear();
+        }
+        else
+        {
+            finalizeProxy(cfg);
+        }
         return cfg;
     }
 
@@ -665,8 +1524,6 @@ namespace
                                        const std::string& host,
                                        const std::string& path,
                                        bool secure);
-    double jsonToDouble(const json& value);
-    dom::OrderBook::Tick tickFromPrice(double price, double tickSize);
     void emitLadder(const Config& config,
                     const dom::OrderBook& book,
                     double bestBid,
@@ -676,8 +1533,8 @@ namespace
 
     bool fetchMexcSpotDepthSnapshot(const Config& cfg,
                                     double tickSize,
-                                    std::vector<std::pair<dom::OrderBook::Tick, double>>& bids,
-                                    std::vector<std::pair<dom::OrderBook::Tick, double>>& asks)
+                                    LevelVector& bids,
+                                    LevelVector& asks)
     {
         if (tickSize <= 0.0)
         {
@@ -706,7 +1563,7 @@ namespace
         }
 
         auto parseSide = [tickSize](const json& arr,
-                                    std::vector<std::pair<dom::OrderBook::Tick, double>>& out) {
+                                    LevelVector& out) {
             out.clear();
             if (!arr.is_array()) return;
             for (const auto& e : arr)
@@ -787,8 +1644,8 @@ namespace
 
     bool fetchParadexOrderBookSnapshot(const Config& cfg,
                                        double tickSize,
-                                       std::vector<std::pair<dom::OrderBook::Tick, double>>& bids,
-                                       std::vector<std::pair<dom::OrderBook::Tick, double>>& asks)
+                                       LevelVector& bids,
+                                       LevelVector& asks)
     {
         bids.clear();
         asks.clear();
@@ -820,7 +1677,7 @@ namespace
         }
 
         auto parseSide = [&](const json& arr,
-                             std::vector<std::pair<dom::OrderBook::Tick, double>>& out) {
+                             LevelVector& out) {
             out.clear();
             if (!arr.is_array()) return;
             for (const auto& e : arr)
@@ -849,7 +1706,7 @@ namespace
         return true;
     }
 
-    [[noreturn]] void runMexcSpotPolling(const Config& config, dom::OrderBook& book)
+    void runMexcSpotPolling(const Config& config, dom::OrderBook& book)
     {
         const double tickSize = book.tickSize();
         if (!(tickSize > 0.0))
@@ -861,17 +1718,22 @@ namespace
                   << " every " << config.mexcSpotPollMs << "ms" << std::endl;
 
         auto lastEmit = std::chrono::steady_clock::now();
-        std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-        std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
+        LevelVector bids;
+        LevelVector asks;
 
         for (;;)
         {
+            if (symbolSwitchPending())
+            {
+                std::cerr << "[backend] leaving MEXC polling for symbol switch" << std::endl;
+                return;
+            }
             if (fetchMexcSpotDepthSnapshot(config, tickSize, bids, asks))
             {
                 const auto now = std::chrono::steady_clock::now();
                 std::lock_guard<std::mutex> lock(g_bookMutex);
-                book.loadSnapshot(bids, asks);
-                if (now - lastEmit >= config.throttle)
+                loadSnapshotTimed(book, bids, asks);
+                if (now - lastEmit >= runtimeThrottle())
                 {
                     lastEmit = now;
                     const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -911,125 +1773,37 @@ namespace
 
     struct BinanceDepthSnapshot
     {
-        std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-        std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
+        LevelVector bids;
+        LevelVector asks;
         long long lastUpdateId = 0;
     };
 
-    double jsonToDouble(const json &value)
+    std::string winhttpError(const char* where)
     {
-        if (value.is_number_float())
+        DWORD error = GetLastError();
+        LPWSTR buffer = nullptr;
+        DWORD len =
+            FormatMessageW(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM |
+                               FORMAT_MESSAGE_IGNORE_INSERTS,
+                           nullptr,
+                           error,
+                           0,
+                           reinterpret_cast<LPWSTR>(&buffer),
+                           0,
+                           nullptr);
+        std::string msg = where;
+        msg += ": ";
+        if (len && buffer)
         {
-            return value.get<double>();
+            int outLen = WideCharToMultiByte(CP_UTF8, 0, buffer, len, nullptr, 0, nullptr, nullptr);
+            std::string utf8(outLen, '\0');
+            WideCharToMultiByte(CP_UTF8, 0, buffer, len, utf8.data(), outLen, nullptr, nullptr);
+            msg += utf8;
+            LocalFree(buffer);
         }
-        if (value.is_number_integer())
+        else
         {
-            return static_cast<double>(value.get<std::int64_t>());
-        }
-        if (value.is_string())
-        {
-            try
-            {
-                return std::stod(value.get<std::string>());
-            }
-            catch (...)
-            {
-                return 0.0;
-            }
-        }
-        return 0.0;
-    }
-
-    bool quantizeTickFromPrice(double price,
-                               double tickSize,
-                               dom::OrderBook::Tick &outTick,
-                               double &outSnappedPrice)
-    {
-        if (!(tickSize > 0.0) || !std::isfinite(tickSize) || !(price > 0.0) || !std::isfinite(price))
-        {
-            return false;
-        }
-
-        auto pow10i = [](int exp) -> std::int64_t {
-            std::int64_t v = 1;
-            for (int i = 0; i < exp; ++i) v *= 10;
-            return v;
-        };
-
-        for (int decimals = 0; decimals <= 12; ++decimals)
-        {
-            const std::int64_t scale = pow10i(decimals);
-            const double scaledTickSizeD = tickSize * static_cast<double>(scale);
-            if (!std::isfinite(scaledTickSizeD))
-            {
-                continue;
-            }
-            const std::int64_t tickSizeScaled = static_cast<std::int64_t>(std::llround(scaledTickSizeD));
-            if (tickSizeScaled <= 0)
-            {
-                continue;
-            }
-            if (std::abs(scaledTickSizeD - static_cast<double>(tickSizeScaled)) > 1e-9)
-            {
-                continue;
-            }
-
-            const std::int64_t priceScaled = static_cast<std::int64_t>(std::llround(price * static_cast<double>(scale)));
-            std::int64_t tick = 0;
-            if (priceScaled >= 0)
-            {
-                tick = (priceScaled + tickSizeScaled / 2) / tickSizeScaled;
-            }
-            else
-            {
-                tick = -((-priceScaled + tickSizeScaled / 2) / tickSizeScaled);
-            }
-            outTick = static_cast<dom::OrderBook::Tick>(tick);
-            const std::int64_t snappedScaled = tick * tickSizeScaled;
-            outSnappedPrice = static_cast<double>(snappedScaled) / static_cast<double>(scale);
-            return std::isfinite(outSnappedPrice);
-        }
-
-        return false;
-    }
-
-    dom::OrderBook::Tick tickFromPrice(double price, double tickSize)
-    {
-        dom::OrderBook::Tick tick = 0;
-        double snappedPrice = price;
-        if (quantizeTickFromPrice(price, tickSize, tick, snappedPrice))
-        {
-            return tick;
-        }
-        return static_cast<dom::OrderBook::Tick>(std::llround(price / tickSize));
-    }
-
-    std::string winhttpError(const char* where)
-    {
-        DWORD error = GetLastError();
-        LPWSTR buffer = nullptr;
-        DWORD len =
-            FormatMessageW(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM |
-                               FORMAT_MESSAGE_IGNORE_INSERTS,
-                           nullptr,
-                           error,
-                           0,
-                           reinterpret_cast<LPWSTR>(&buffer),
-                           0,
-                           nullptr);
-        std::string msg = where;
-        msg += ": ";
-        if (len && buffer)
-        {
-            int outLen = WideCharToMultiByte(CP_UTF8, 0, buffer, len, nullptr, 0, nullptr, nullptr);
-            std::string utf8(outLen, '\0');
-            WideCharToMultiByte(CP_UTF8, 0, buffer, len, utf8.data(), outLen, nullptr, nullptr);
-            msg += utf8;
-            LocalFree(buffer);
-        }
-        else
-        {
-            msg += "unknown error";
+            msg += "unknown error";
         }
         return msg;
     }
@@ -1262,6 +2036,158 @@ namespace
                     double bestAsk,
                     std::int64_t ts);
 
+    // Book stage of a venue feed. The feed thread parses a frame and pushes its levels here; a
+    // thread of its own applies them under g_bookMutex and captures throttled ladder frames for
+    // the emit thread, so a contended book lock never holds up socket reads. One producer (the
+    // feed thread) and one consumer: the ring is lock-free and its slots keep their capacity,
+    // so steady-state pushes do not allocate.
+    class BookPipeline
+    {
+    public:
+        // `exchangeTimestamps`: stamp ladder frames with the batch's event time when it has one.
+        BookPipeline(const Config& config, dom::OrderBook& book, bool exchangeTimestamps = false)
+            : config_(config)
+            , book_(book)
+            , exchangeTimestamps_(exchangeTimestamps)
+            , slots_(kSlots)
+        {
+            worker_ = std::thread([this]() { run(); });
+        }
+
+        // Applies everything pushed so far before the book thread exits.
+        ~BookPipeline()
+        {
+            drain();
+            stopping_.store(true, std::memory_order_release);
+            signal_.fetch_add(1, std::memory_order_release);
+            signal_.notify_one();
+            if (worker_.joinable())
+            {
+                worker_.join();
+            }
+        }
+
+        BookPipeline(const BookPipeline&) = delete;
+        BookPipeline& operator=(const BookPipeline&) = delete;
+
+        // Queues one frame's levels: a snapshot replaces the book, anything else is a delta.
+        // `tickSize` > 0 sets the book's tick size first (venues that detect it from prices).
+        // Waits, without dropping the frame, while the book thread is kSlots frames behind.
+        void push(const dom::feed::DepthUpdate& depth, bool snapshot, double tickSize = 0.0)
+        {
+            noteFrameParsed();
+            while (pushed_ - consumed_.load(std::memory_order_acquire) >= kSlots)
+            {
+                std::this_thread::yield();
+            }
+            Batch& slot = slots_[pushed_ % kSlots];
+            slot.bids.assign(depth.bids.begin(), depth.bids.end());
+            slot.asks.assign(depth.asks.begin(), depth.asks.end());
+            slot.snapshot = snapshot;
+            slot.eventTimeMs = depth.eventTimeMs;
+            slot.tickSize = tickSize;
+            ++pushed_;
+            published_.store(pushed_, std::memory_order_release);
+            signal_.fetch_add(1, std::memory_order_release);
+            signal_.notify_one();
+        }
+
+        // Returns once the book thread has applied everything pushed so far.
+        void drain()
+        {
+            while (consumed_.load(std::memory_order_acquire) != pushed_)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // Symbol switch on the feed thread: applies what the old symbol queued, then stamps
+        // further frames with `config` and lets the next batch emit right away.
+        void retarget(const Config& config)
+        {
+            drain();
+            config_ = config;
+            lastEmit_ = {};
+        }
+
+    private:
+        static constexpr std::uint64_t kSlots = 256;
+
+        struct Batch
+        {
+            std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
+            std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
+            bool snapshot{false};
+            std::int64_t eventTimeMs{0};
+            double tickSize{0.0};
+        };
+
+        void run()
+        {
+            std::uint64_t next = 0;
+            for (;;)
+            {
+                const auto seen = signal_.load(std::memory_order_acquire);
+                if (next == published_.load(std::memory_order_acquire))
+                {
+                    if (stopping_.load(std::memory_order_acquire))
+                    {
+                        return;
+                    }
+                    signal_.wait(seen, std::memory_order_acquire);
+                    continue;
+                }
+                apply(slots_[next % kSlots]);
+                ++next;
+                consumed_.store(next, std::memory_order_release);
+            }
+        }
+
+        void apply(const Batch& batch)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            if (batch.tickSize > 0.0 && batch.tickSize != book_.tickSize())
+            {
+                book_.setTickSize(batch.tickSize);
+            }
+            if (batch.snapshot)
+            {
+                loadSnapshotTimed(book_, batch.bids, batch.asks);
+            }
+            else
+            {
+                applyDeltaTimed(book_, batch.bids, batch.asks);
+            }
+            if (now - lastEmit_ >= runtimeThrottle())
+            {
+                lastEmit_ = now;
+                std::int64_t ts = exchangeTimestamps_ ? batch.eventTimeMs : 0;
+                if (ts <= 0)
+                {
+                    ts = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+                }
+                emitLadder(config_, book_, book_.bestBid(), book_.bestAsk(), ts);
+            }
+        }
+
+        // Written by the feed thread only while the book thread is drained (retarget).
+        Config config_;
+        std::chrono::steady_clock::time_point lastEmit_{};
+        dom::OrderBook& book_;
+        const bool exchangeTimestamps_;
+
+        std::vector<Batch> slots_;
+        std::uint64_t pushed_{0}; // feed thread's copy of published_
+        std::atomic<std::uint64_t> published_{0};
+        std::atomic<std::uint64_t> consumed_{0};
+        std::atomic<std::uint32_t> signal_{0}; // bumped per push and on stop; the book thread waits on it
+        std::atomic<bool> stopping_{false};
+        std::thread worker_;
+    };
+
     bool parseIntStrict(std::string_view s, int &out)
     {
         if (s.empty())
@@ -1612,8 +2538,32 @@ namespace
         return false;
     }
 
-    bool runLighterWebSocket(const Config &config, dom::OrderBook &book, int marketId)
+    void loadSwitchedSymbolLocked(const Config& config,
+                                  dom::OrderBook& book,
+                                  std::uint64_t generation,
+                                  double tickSize,
+                                  const LevelVector& bids,
+                                  const LevelVector& asks);
+
+    // Order book / trade frames name their market in "channel" ("order_book:1"); frames still in
+    // flight for a market the feed switched away from are dropped.
+    bool lighterChannelIs(std::string_view channel, const std::string &marketKey)
+    {
+        const auto sep = channel.find(':');
+        return sep == std::string_view::npos || channel.substr(sep + 1) == marketKey;
+    }
+
+    std::string lighterChannelMessage(const char *type, const char *stream, int marketId)
+    {
+        return json({{"type", type}, {"channel", std::string(stream) + "/" + std::to_string(marketId)}}).dump();
+    }
+
+    bool runLighterWebSocket(const Config &baseConfig, dom::OrderBook &book, int marketId)
     {
+        // Mutable copy: a `subscribe` control command re-targets this socket to another market.
+        Config config = baseConfig;
+        std::string marketKey = std::to_string(marketId);
+        BookPipeline pipeline(config, book);
 #if defined(ORDERBOOK_BACKEND_QT)
         if (shouldUseQtSocks5(config))
         {
@@ -1630,167 +2580,112 @@ namespace
             const QUrl url(QStringLiteral("wss://mainnet.zklighter.elliot.ai/stream"));
             std::cerr << "[backend] lighter: using Qt WebSocket (proxy)\n";
 
-            const std::string subscribeBookStr =
-                json({{"type", "subscribe"}, {"channel", "order_book/" + std::to_string(marketId)}}).dump();
-            const std::string subscribeTradeStr =
-                json({{"type", "subscribe"}, {"channel", "trade/" + std::to_string(marketId)}}).dump();
+            const std::string subscribeBookStr = lighterChannelMessage("subscribe", "order_book", marketId);
+            const std::string subscribeTradeStr = lighterChannelMessage("subscribe", "trade", marketId);
 
             bool subscribedBook = false;
             bool subscribedTrade = false;
             long long lastTradeId = 0;
-            auto lastEmit = std::chrono::steady_clock::now();
-
-            auto parseSide = [&](const json &levels) {
-                std::vector<std::pair<dom::OrderBook::Tick, double>> out;
-                if (!levels.is_array())
-                {
-                    return out;
-                }
-                out.reserve(levels.size());
-                const double tickSize = book.tickSize();
-                for (const auto &lvl : levels)
-                {
-                    if (!lvl.is_object())
-                    {
-                        continue;
-                    }
-                    const double price = jsonToDouble(lvl.value("price", json(0.0)));
-                    const double qty = jsonToDouble(lvl.value("size", json(0.0)));
-                    if (!(price > 0.0) || !std::isfinite(price) || !std::isfinite(qty))
-                    {
-                        continue;
-                    }
-                    dom::OrderBook::Tick tick = 0;
-                    double snapped = price;
-                    if (!quantizeTickFromPrice(price, tickSize, tick, snapped))
-                    {
-                        continue;
-                    }
-                    out.emplace_back(tick, qty);
-                }
-                return out;
-            };
 
             auto applyBookUpdate = [&](const json &orderBook, bool snapshot) {
                 if (!orderBook.is_object())
                 {
                     return;
                 }
-                const auto bids = parseSide(orderBook.value("bids", json::array()));
-                const auto asks = parseSide(orderBook.value("asks", json::array()));
-                if (snapshot)
-                {
-                    std::lock_guard<std::mutex> lock(g_bookMutex);
-                    book.loadSnapshot(bids, asks);
-                }
-                else
-                {
-                    std::lock_guard<std::mutex> lock(g_bookMutex);
-                    book.applyDelta(bids, asks, config.cacheLevelsPerSide);
-                }
-                const auto now = std::chrono::steady_clock::now();
-                if (now - lastEmit >= config.throttle)
-                {
-                    lastEmit = now;
-                    const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                           std::chrono::system_clock::now().time_since_epoch())
-                                           .count();
-                    emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
-                }
+                auto depth = frameDepth();
+                dom::feed::parseLighterOrderBook(orderBook, book.tickSize(), depth);
+                pipeline.push(depth, snapshot);
             };
 
             auto emitTradeBatch = [&](const json &arr) {
-                if (!arr.is_array())
-                {
-                    return;
-                }
-                auto toLongLong = [](const json &v) -> long long {
-                    try
-                    {
-                        if (v.is_number_integer())
-                        {
-                            return v.get<long long>();
-                        }
-                        if (v.is_number_float())
-                        {
-                            const double d = v.get<double>();
-                            if (std::isfinite(d))
-                            {
-                                return static_cast<long long>(std::llround(d));
-                            }
-                            return 0LL;
-                        }
-                        if (v.is_string())
-                        {
-                            const std::string s = v.get<std::string>();
-                            if (s.empty())
-                            {
-                                return 0LL;
-                            }
-                            std::size_t idx = 0;
-                            const long long out = std::stoll(s, &idx, 10);
-                            return idx > 0 ? out : 0LL;
-                        }
-                    }
-                    catch (...)
-                    {
-                    }
-                    return 0LL;
-                };
                 const double tickSize = book.tickSize();
                 if (!(tickSize > 0.0) || !std::isfinite(tickSize))
                 {
                     return;
                 }
-                for (const auto &tIn : arr)
+                auto trades = frameTrades();
+                dom::feed::parseLighterTrades(arr, trades);
+                for (const auto &trade : trades)
                 {
-                    if (!tIn.is_object())
-                    {
-                        continue;
-                    }
-                    const long long tradeId = toLongLong(tIn.value("trade_id", json(0LL)));
-                    if (tradeId > 0 && tradeId <= lastTradeId)
-                    {
-                        continue;
-                    }
-                    const double price = jsonToDouble(tIn.value("price", json(0.0)));
-                    const double size = jsonToDouble(tIn.value("size", json(0.0)));
-                    if (!(price > 0.0) || !(size > 0.0) || !std::isfinite(price) || !std::isfinite(size))
+                    if (trade.id > 0 && trade.id <= lastTradeId)
                     {
                         continue;
                     }
-                    const bool isMakerAsk = tIn.value("is_maker_ask", false);
-                    const bool buy = isMakerAsk;
-                    const long long ts = toLongLong(tIn.value("timestamp", json(0LL)));
-
+                    // is_maker_ask: the maker sold, so the taker (the print's direction) bought.
                     json out;
                     out["type"] = "trade";
                     out["symbol"] = config.symbol;
                     dom::OrderBook::Tick tick = 0;
-                    double snapped = price;
-                    if (quantizeTickFromPrice(price, tickSize, tick, snapped))
+                    double snapped = trade.price;
+                    if (quantizeTickFromPrice(trade.price, tickSize, tick, snapped))
                     {
                         out["tick"] = tick;
                         out["price"] = snapped;
                     }
                     else
                     {
-                        out["price"] = price;
+                        out["price"] = trade.price;
                     }
-                    out["qty"] = size;
-                    out["side"] = buy ? "buy" : "sell";
-                    if (ts > 0)
+                    out["qty"] = trade.qty;
+                    out["side"] = trade.buy ? "buy" : "sell";
+                    if (trade.timeMs > 0)
                     {
-                        out["timestamp"] = ts;
+                        out["timestamp"] = trade.timeMs;
                     }
-                    stdoutWriter().writeLine(out.dump());
-                    if (tradeId > 0)
+                    tradeBatcher().add(config.symbol, std::move(out));
+                    if (trade.id > 0)
                     {
-                        lastTradeId = std::max(lastTradeId, tradeId);
+                        lastTradeId = std::max(lastTradeId, trade.id);
                     }
                 }
             };
 
+            auto sendChannels = [&](const char *type, int id) {
+                const qint64 bookSent = ws.sendTextMessage(
+                    QString::fromStdString(lighterChannelMessage(type, "order_book", id)));
+                const qint64 tradeSent =
+                    ws.sendTextMessage(QString::fromStdString(lighterChannelMessage(type, "trade", id)));
+                return bookSent > 0 && tradeSent > 0;
+            };
+
+            // Re-target the open socket to the new market; its book arrives as the next
+            // "subscribed/order_book". On failure main() redoes the full startup.
+            auto switchSymbolInPlace = [&]() -> bool {
+                std::string nextSymbol;
+                if (!peekSymbolSwitch(nextSymbol))
+                {
+                    return true;
+                }
+                Config next = config;
+                next.symbol = nextSymbol;
+                int nextMarketId = -1;
+                double nextTickSize = 0.0;
+                if (!fetchLighterMarketInfo(next, nextMarketId, nextTickSize))
+                {
+                    return false;
+                }
+                std::cerr << "[backend] lighter switching market " << marketId << " -> " << nextMarketId
+                          << " on open socket\n";
+                if (!sendChannels("unsubscribe", marketId) || !sendChannels("subscribe", nextMarketId))
+                {
+                    return false;
+                }
+                std::uint64_t generation = 0;
+                if (!takeSymbolSwitchFor(next.symbol, generation))
+                {
+                    // Superseded while we were fetching: restore the channels, the newer request runs next.
+                    return sendChannels("unsubscribe", nextMarketId) && sendChannels("subscribe", marketId);
+                }
+                config = next;
+                marketId = nextMarketId;
+                marketKey = std::to_string(marketId);
+                lastTradeId = 0;
+                pipeline.retarget(config);
+                std::lock_guard<std::mutex> lock(g_bookMutex);
+                loadSwitchedSymbolLocked(config, book, generation, nextTickSize, {}, {});
+                return true;
+            };
+
             QEventLoop loop;
             QTimer watchdog;
             watchdog.setSingleShot(false);
@@ -1800,6 +2695,25 @@ namespace
                 ws.abort();
                 loop.quit();
             });
+            QTimer switchPoll;
+            switchPoll.start(100);
+            // The market lookup runs a nested event loop (httpGetQt); don't re-enter the switch from it.
+            bool switching = false;
+            QObject::connect(&switchPoll, &QTimer::timeout, &loop, [&]() {
+                if (switching || !symbolSwitchPending() || !subscribedBook)
+                {
+                    return;
+                }
+                switching = true;
+                const bool switched = switchSymbolInPlace();
+                switching = false;
+                if (!switched)
+                {
+                    std::cerr << "[backend] leaving Lighter stream for symbol switch\n";
+                    ws.close();
+                    loop.quit();
+                }
+            });
 
             QObject::connect(&ws, &QWebSocket::connected, &loop, [&]() {
                 std::cerr << "[backend] connected to Lighter ws (Qt)\n";
@@ -1819,10 +2733,24 @@ namespace
 
             QObject::connect(&ws, &QWebSocket::textMessageReceived, &loop, [&](const QString &msg) {
                 watchdog.start(20000);
+                noteFrameReceived(static_cast<std::size_t>(msg.size()));
+                const std::string text = msg.toStdString();
+                {
+                    auto depth = frameDepth();
+                    std::string_view channel;
+                    if (dom::feed::decodeLighterOrderBook(text, book.tickSize(), depth, channel))
+                    {
+                        if (lighterChannelIs(channel, marketKey))
+                        {
+                            pipeline.push(depth, depth.snapshot);
+                        }
+                        return;
+                    }
+                }
                 json j;
                 try
                 {
-                    j = json::parse(msg.toStdString());
+                    j = json::parse(text);
                 }
                 catch (const std::exception &ex)
                 {
@@ -1852,6 +2780,10 @@ namespace
                     }
                     return;
                 }
+                if (!lighterChannelIs(j.value("channel", std::string()), marketKey))
+                {
+                    return;
+                }
                 if (typeStr == "subscribed/order_book")
                 {
                     applyBookUpdate(j.value("order_book", json::object()), true);
@@ -1940,172 +2872,130 @@ namespace
 
         std::cerr << "[backend] connected to Lighter ws" << std::endl;
 
-        const std::string subscribeBookStr =
-            json({{"type", "subscribe"}, {"channel", "order_book/" + std::to_string(marketId)}}).dump();
-        const std::string subscribeTradeStr =
-            json({{"type", "subscribe"}, {"channel", "trade/" + std::to_string(marketId)}}).dump();
+        const std::string subscribeBookStr = lighterChannelMessage("subscribe", "order_book", marketId);
+        const std::string subscribeTradeStr = lighterChannelMessage("subscribe", "trade", marketId);
 
         std::vector<unsigned char> buffer(256 * 1024);
         std::string fragmentBuffer;
+        std::string assembled; // reassembled fragments, kept across frames for its capacity
         bool subscribedBook = false;
         bool subscribedTrade = false;
         long long lastTradeId = 0;
-        auto lastEmit = std::chrono::steady_clock::now();
 
-        auto parseSide = [&](const json &levels) {
-            std::vector<std::pair<dom::OrderBook::Tick, double>> out;
-            if (!levels.is_array())
+        auto applyBookUpdate = [&](const json &orderBook, bool snapshot) {
+            if (!orderBook.is_object())
             {
-                return out;
+                return;
             }
-            out.reserve(levels.size());
+            auto depth = frameDepth();
+            dom::feed::parseLighterOrderBook(orderBook, book.tickSize(), depth);
+            pipeline.push(depth, snapshot);
+        };
+
+        auto emitTradeBatch = [&](const json &arr) {
             const double tickSize = book.tickSize();
-            for (const auto &lvl : levels)
+            if (!(tickSize > 0.0) || !std::isfinite(tickSize))
+            {
+                return;
+            }
+            auto trades = frameTrades();
+            dom::feed::parseLighterTrades(arr, trades);
+            for (const auto &trade : trades)
             {
-                if (!lvl.is_object())
+                if (trade.id > 0 && trade.id <= lastTradeId)
                 {
                     continue;
                 }
-                const double price = jsonToDouble(lvl.value("price", json(0.0)));
-                const double qty = jsonToDouble(lvl.value("size", json(0.0)));
-                if (!(price > 0.0) || !std::isfinite(price) || !std::isfinite(qty))
+                // is_maker_ask: the maker sold, so the taker (the print's direction) bought.
+                json out;
+                out["type"] = "trade";
+                out["symbol"] = config.symbol;
+                dom::OrderBook::Tick tick = 0;
+                double snapped = trade.price;
+                if (quantizeTickFromPrice(trade.price, tickSize, tick, snapped))
                 {
-                    continue;
+                    out["tick"] = tick;
+                    out["price"] = snapped;
                 }
-                dom::OrderBook::Tick tick = 0;
-                double snapped = price;
-                if (!quantizeTickFromPrice(price, tickSize, tick, snapped))
+                else
                 {
-                    continue;
+                    out["price"] = trade.price;
+                }
+                out["qty"] = trade.qty;
+                out["side"] = trade.buy ? "buy" : "sell";
+                if (trade.timeMs > 0)
+                {
+                    out["timestamp"] = trade.timeMs;
+                }
+                tradeBatcher().add(config.symbol, std::move(out));
+                if (trade.id > 0)
+                {
+                    lastTradeId = std::max(lastTradeId, trade.id);
                 }
-                out.emplace_back(tick, qty);
             }
-            return out;
         };
 
-        auto applyBookUpdate = [&](const json &orderBook, bool snapshot) {
-            if (!orderBook.is_object())
-            {
-                return;
-            }
-            const auto bids = parseSide(orderBook.value("bids", json::array()));
-            const auto asks = parseSide(orderBook.value("asks", json::array()));
-            if (snapshot)
-            {
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                book.loadSnapshot(bids, asks);
-            }
-            else
+        auto sendChannels = [&](const char *type, int id) {
+            for (const char *stream : {"order_book", "trade"})
             {
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                book.applyDelta(bids, asks, config.cacheLevelsPerSide);
-            }
-            const auto now = std::chrono::steady_clock::now();
-            if (now - lastEmit >= config.throttle)
-            {
-                lastEmit = now;
-                const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       std::chrono::system_clock::now().time_since_epoch())
-                                       .count();
-                emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
+                const std::string payload = lighterChannelMessage(type, stream, id);
+                if (WinHttpWebSocketSend(rawSocket,
+                                         WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
+                                         (void *)payload.data(),
+                                         static_cast<DWORD>(payload.size())) != S_OK)
+                {
+                    return false;
+                }
             }
+            return true;
         };
 
-        auto emitTradeBatch = [&](const json &arr) {
-            if (!arr.is_array())
+        // Re-target the open socket to the new market; its book arrives as the next
+        // "subscribed/order_book". On failure the caller drops the socket and main() redoes the
+        // full startup.
+        auto switchSymbolInPlace = [&]() -> bool {
+            std::string nextSymbol;
+            if (!peekSymbolSwitch(nextSymbol))
             {
-                return;
+                return true;
             }
-            auto toLongLong = [](const json &v) -> long long {
-                try
-                {
-                    if (v.is_number_integer())
-                    {
-                        return v.get<long long>();
-                    }
-                    if (v.is_number_float())
-                    {
-                        const double d = v.get<double>();
-                        if (std::isfinite(d))
-                        {
-                            return static_cast<long long>(std::llround(d));
-                        }
-                        return 0LL;
-                    }
-                    if (v.is_string())
-                    {
-                        const std::string s = v.get<std::string>();
-                        if (s.empty())
-                        {
-                            return 0LL;
-                        }
-                        std::size_t idx = 0;
-                        const long long out = std::stoll(s, &idx, 10);
-                        return idx > 0 ? out : 0LL;
-                    }
-                }
-                catch (...)
-                {
-                }
-                return 0LL;
-            };
-            const double tickSize = book.tickSize();
-            if (!(tickSize > 0.0) || !std::isfinite(tickSize))
+            Config next = config;
+            next.symbol = nextSymbol;
+            int nextMarketId = -1;
+            double nextTickSize = 0.0;
+            if (!fetchLighterMarketInfo(next, nextMarketId, nextTickSize))
             {
-                return;
+                return false;
             }
-            for (const auto &tIn : arr)
+            std::cerr << "[backend] lighter switching market " << marketId << " -> " << nextMarketId
+                      << " on open socket" << std::endl;
+            if (!sendChannels("unsubscribe", marketId) || !sendChannels("subscribe", nextMarketId))
             {
-                if (!tIn.is_object())
-                {
-                    continue;
-                }
-                const long long tradeId = toLongLong(tIn.value("trade_id", json(0LL)));
-                if (tradeId > 0 && tradeId <= lastTradeId)
-                {
-                    continue;
-                }
-                const double price = jsonToDouble(tIn.value("price", json(0.0)));
-                const double size = jsonToDouble(tIn.value("size", json(0.0)));
-                if (!(price > 0.0) || !(size > 0.0) || !std::isfinite(price) || !std::isfinite(size))
-                {
-                    continue;
-                }
-                const bool isMakerAsk = tIn.value("is_maker_ask", false);
-                // If maker is ask (sell), taker is buy; use taker direction for prints.
-                const bool buy = isMakerAsk;
-                const long long ts = toLongLong(tIn.value("timestamp", json(0LL)));
-
-                json out;
-                out["type"] = "trade";
-                out["symbol"] = config.symbol;
-                dom::OrderBook::Tick tick = 0;
-                double snapped = price;
-                if (quantizeTickFromPrice(price, tickSize, tick, snapped))
-                {
-                    out["tick"] = tick;
-                    out["price"] = snapped;
-                }
-                else
-                {
-                    out["price"] = price;
-                }
-                out["qty"] = size;
-                out["side"] = buy ? "buy" : "sell";
-                if (ts > 0)
-                {
-                    out["timestamp"] = ts;
-                }
-                stdoutWriter().writeLine(out.dump());
-                if (tradeId > 0)
-                {
-                    lastTradeId = std::max(lastTradeId, tradeId);
-                }
+                return false;
+            }
+            std::uint64_t generation = 0;
+            if (!takeSymbolSwitchFor(next.symbol, generation))
+            {
+                // Superseded while we were fetching: restore the channels, the newer request runs next frame.
+                return sendChannels("unsubscribe", nextMarketId) && sendChannels("subscribe", marketId);
             }
+            config = next;
+            marketId = nextMarketId;
+            marketKey = std::to_string(marketId);
+            lastTradeId = 0;
+            pipeline.retarget(config);
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            loadSwitchedSymbolLocked(config, book, generation, nextTickSize, {}, {});
+            return true;
         };
 
         for (;;)
         {
+            if (symbolSwitchPending() && subscribedBook && !switchSymbolInPlace())
+            {
+                std::cerr << "[backend] leaving Lighter stream for symbol switch" << std::endl;
+                break;
+            }
             DWORD received = 0;
             WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
             HRESULT hr =
@@ -2115,6 +3005,7 @@ namespace
                 std::cerr << "[backend] Lighter WS receive failed: " << std::hex << hr << std::dec << std::endl;
                 break;
             }
+            noteFrameReceived(received);
             if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
             {
                 std::cerr << "[backend] Lighter WS closed by server\n";
@@ -2143,15 +3034,27 @@ namespace
                 continue;
             }
 
-            std::string message;
+            std::string_view message = chunk;
             if (!fragmentBuffer.empty())
             {
                 fragmentBuffer.append(chunk.data(), chunk.size());
-                message.swap(fragmentBuffer);
+                assembled.swap(fragmentBuffer);
+                fragmentBuffer.clear();
+                message = assembled;
             }
-            else
+
+            // Order book frames are decoded from the text; everything else goes through json.
             {
-                message.assign(chunk);
+                auto depth = frameDepth();
+                std::string_view channel;
+                if (dom::feed::decodeLighterOrderBook(message, book.tickSize(), depth, channel))
+                {
+                    if (lighterChannelIs(channel, marketKey))
+                    {
+                        pipeline.push(depth, depth.snapshot);
+                    }
+                    continue;
+                }
             }
 
             json j;
@@ -2199,6 +3102,11 @@ namespace
                 continue;
             }
 
+            if (!lighterChannelIs(j.value("channel", std::string()), marketKey))
+            {
+                continue;
+            }
+
             if (typeStr == "subscribed/order_book")
             {
                 applyBookUpdate(j.value("order_book", json::object()), true);
@@ -2297,9 +3205,8 @@ namespace
         return tickSizeOut > 0.0;
     }
 
-    bool fetchSnapshot(const Config& cfg, dom::OrderBook& book)
+    bool fetchSnapshot(const Config& cfg, double tickSize, LevelVector& bids, LevelVector& asks)
     {
-        const double tickSize = book.tickSize();
         if (tickSize <= 0.0)
         {
             std::cerr << "[backend] fetchSnapshot: tickSize is not set" << std::endl;
@@ -2326,11 +3233,8 @@ namespace
             return false;
         }
 
-        std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-        std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
-
         auto parseSide = [tickSize](const json& arr,
-                                    std::vector<std::pair<dom::OrderBook::Tick, double>>& out) {
+                                    LevelVector& out) {
             out.clear();
             for (const auto& e : arr)
             {
@@ -2344,7 +3248,6 @@ namespace
 
         parseSide(j["bids"], bids);
         parseSide(j["asks"], asks);
-        book.loadSnapshot(bids, asks);
 
         std::cerr << "[backend] snapshot loaded: bids=" << bids.size() << " asks=" << asks.size() << std::endl;
         return true;
@@ -2400,9 +3303,12 @@ namespace
         return tickSizeOut > 0.0;
     }
 
-    bool fetchFuturesSnapshot(const Config &cfg, dom::OrderBook &book, double contractSize)
+    bool fetchFuturesSnapshot(const Config &cfg,
+                              double tickSize,
+                              double contractSize,
+                              LevelVector &bids,
+                              LevelVector &asks)
     {
-        const double tickSize = book.tickSize();
         if (tickSize <= 0.0)
         {
             std::cerr << "[backend] futures snapshot: tickSize missing" << std::endl;
@@ -2435,9 +3341,7 @@ namespace
             std::cerr << "[backend] futures snapshot: invalid payload" << std::endl;
             return false;
         }
-        std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-        std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
-        auto parseSide = [&](const json &side, std::vector<std::pair<dom::OrderBook::Tick,double>> &out) {
+        auto parseSide = [&](const json &side, LevelVector &out) {
             out.clear();
             if (!side.is_array())
             {
@@ -2461,444 +3365,442 @@ namespace
         };
         parseSide(data.value("bids", json::array()), bids);
         parseSide(data.value("asks", json::array()), asks);
-        book.loadSnapshot(bids, asks);
         std::cerr << "[backend] futures snapshot loaded: bids=" << bids.size()
                   << " asks=" << asks.size() << std::endl;
         return true;
     }
 
-    // --- минимальный парсер protobuf под нужные сообщения ---
+    void emitLadder(const Config& config,
+                    const dom::OrderBook& book,
+                    double bestBid,
+                    double bestAsk,
+                    std::int64_t ts);
 
-    struct ProtoReader
-    {
-        const std::uint8_t* data{};
-        std::size_t size{};
-        std::size_t pos{};
+    std::mutex g_bookMutex;
+    std::atomic<bool> g_bookReady{false};
+    dom::OrderBook* g_bookPtr = nullptr;
+    Config g_activeConfig;
+    // Window of the last captured ladder frame (see emitLadder).
+    dom::OrderBook::Tick g_lastWindowMinTick = 0;
+    dom::OrderBook::Tick g_lastWindowMaxTick = 0;
+    bool g_haveLastLadder = false;
+    bool g_forceFullLadder = false;
+    // Id of the newest control command applied (stored under g_bookMutex). Ladder frames
+    // captured after it echo it as "ack", so the GUI can tell which request a frame answers.
+    std::atomic<std::uint64_t> g_controlAck{0};
+    // Consolidated mode: the merged book is the only one that reaches stdout; venue books stay private.
+    const dom::OrderBook* g_mergedBook = nullptr;
 
-        ProtoReader() = default;
-        ProtoReader(const void* ptr, std::size_t len)
-            : data(static_cast<const std::uint8_t*>(ptr))
-            , size(len)
-            , pos(0)
-        {
-        }
+    json histogramJson(dom::LatencyHistogram& h)
+    {
+        const auto sum = h.takeInterval();
+        json out;
+        out["n"] = sum.count;
+        out["p50"] = sum.p50;
+        out["p99"] = sum.p99;
+        out["max"] = sum.max;
+        return out;
+    }
 
-        bool eof() const { return pos >= size; }
+    void emitStats(std::chrono::milliseconds interval)
+    {
+        auto& t = telemetry();
+        const auto w = stdoutWriter().stats();
+        json stats;
+        stats["type"] = "stats";
+        stats["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                 std::chrono::system_clock::now().time_since_epoch())
+                                 .count();
+        stats["intervalMs"] = interval.count();
+        stats["framesPerSec"] = histogramJson(t.framesPerSec);
+        stats["bytesPerSec"] = histogramJson(t.bytesPerSec);
+        stats["parseUs"] = histogramJson(t.parseUs);
+        stats["applyUs"] = histogramJson(t.applyUs);
+        stats["emitUs"] = histogramJson(t.emitUs);
+        stats["stdoutQueue"] = histogramJson(t.stdoutQueueLines);
+        stats["feedLatencyMs"] = histogramJson(t.feedLatencyMs);
+        stats["allocsPerSec"] = histogramJson(t.allocsPerSec);
+        stats["frameAllocs"] = histogramJson(t.frameAllocs);
+        stats["arenaSpills"] = t.arenaSpills.exchange(0, std::memory_order_relaxed);
+        json out;
+        out["queuedLines"] = w.queuedLines;
+        out["queuedBytes"] = w.queuedBytes;
+        out["writes"] = w.writes;
+        out["bytes"] = w.bytesWritten;
+        out["coalesced"] = w.coalesced;
+        out["dropped"] = w.dropped;
+        stats["stdout"] = std::move(out);
+        stdoutWriter().writeLine(stats.dump(), StdoutLineKind::Stats);
+    }
 
-        bool readVarint(std::uint64_t& out)
+    void statsThread()
+    {
+        // Rates and queue depth are sampled every 100ms so their histograms show bursts
+        // within the reporting interval, not just the interval average.
+        std::chrono::milliseconds interval{1000};
+        const char* ms = std::getenv("BACKEND_STATS_MS");
+        if (ms && *ms)
         {
-            out = 0;
-            int shift = 0;
-            while (pos < size && shift < 64)
+            try
             {
-                std::uint8_t b = data[pos++];
-                out |= (std::uint64_t(b & 0x7F) << shift);
-                if ((b & 0x80) == 0)
+                const int v = std::stoi(ms);
+                if (v <= 0)
                 {
-                    return true;
+                    return;
                 }
-                shift += 7;
+                interval = std::chrono::milliseconds(std::clamp(v, 250, 60000));
             }
-            return false;
-        }
-
-        bool readBytes(std::size_t n, std::string& out)
-        {
-            if (pos + n > size)
+            catch (...)
             {
-                return false;
             }
-            out.assign(reinterpret_cast<const char*>(data + pos), n);
-            pos += n;
-            return true;
         }
-
-        bool readLengthDelimited(std::string& out)
+        constexpr auto kSample = std::chrono::milliseconds(100);
+        auto& t = telemetry();
+        std::uint64_t lastFrames = t.frames.load();
+        std::uint64_t lastBytes = t.bytes.load();
+        std::uint64_t lastAllocs = dom::heapAllocations();
+        auto lastSample = std::chrono::steady_clock::now();
+        auto lastEmit = lastSample;
+        for (;;)
         {
-            std::uint64_t len = 0;
-            if (!readVarint(len))
+            std::this_thread::sleep_for(kSample);
+            const auto now = std::chrono::steady_clock::now();
+            const double seconds = std::chrono::duration<double>(now - lastSample).count();
+            lastSample = now;
+            const std::uint64_t frames = t.frames.load(std::memory_order_relaxed);
+            const std::uint64_t bytes = t.bytes.load(std::memory_order_relaxed);
+            const std::uint64_t allocs = dom::heapAllocations();
+            if (seconds > 0.0)
+            {
+                t.framesPerSec.record(static_cast<std::uint64_t>(std::llround((frames - lastFrames) / seconds)));
+                t.bytesPerSec.record(static_cast<std::uint64_t>(std::llround((bytes - lastBytes) / seconds)));
+                t.allocsPerSec.record(static_cast<std::uint64_t>(std::llround((allocs - lastAllocs) / seconds)));
+            }
+            lastFrames = frames;
+            lastBytes = bytes;
+            lastAllocs = allocs;
+            t.stdoutQueueLines.record(stdoutWriter().stats().queuedLines);
+            if (now - lastEmit >= interval)
             {
-                return false;
+                lastEmit = now;
+                emitStats(interval);
             }
-            return readBytes(static_cast<std::size_t>(len), out);
         }
+    }
 
-        bool skipField(std::uint64_t key)
+    void heartbeatThread()
+    {
+        using namespace std::chrono_literals;
+        // Keep the GUI watchdog alive even when a WS connection is idle (WinHTTP receive blocks).
+        for (;;)
         {
-            const auto wireType = key & 0x7;
-            switch (wireType)
-            {
-            case 0: // varint
+            std::this_thread::sleep_for(5s);
+            if (!g_bookReady.load())
             {
-                std::uint64_t dummy;
-                return readVarint(dummy);
+                continue;
             }
-            case 1: // 64-bit
-                if (pos + 8 > size) return false;
-                pos += 8;
-                return true;
-            case 2: // length-delimited
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            if (!g_bookPtr)
             {
-                std::uint64_t len = 0;
-                if (!readVarint(len) || pos + len > size)
-                {
-                    return false;
-                }
-                pos += static_cast<std::size_t>(len);
-                return true;
-            }
-            case 5: // 32-bit
-                if (pos + 4 > size) return false;
-                pos += 4;
-                return true;
-            default:
-                return false;
+                continue;
             }
+            json hb;
+            hb["type"] = "hb";
+            hb["symbol"] = g_activeConfig.symbol;
+            hb["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::system_clock::now().time_since_epoch())
+                                  .count();
+            hb["bestBid"] = g_bookPtr->bestBid();
+            hb["bestAsk"] = g_bookPtr->bestAsk();
+            stdoutWriter().writeLine(hb.dump());
         }
-    };
+    }
 
-    void parseDepthItem(const std::string& buf,
-                        double tickSize,
-                        std::vector<std::pair<dom::OrderBook::Tick, double>>& out)
+    void emitCurrentLadderLocked()
     {
-        ProtoReader r(buf.data(), buf.size());
-        std::string priceStr;
-        std::string qtyStr;
-        while (!r.eof())
-        {
-            std::uint64_t key = 0;
-            if (!r.readVarint(key)) break;
-            const auto field = key >> 3;
-            if ((key & 0x7) != 2)
-            {
-                if (!r.skipField(key)) break;
-                continue;
-            }
+        const double bestBid = g_bookPtr->bestBid();
+        const double bestAsk = g_bookPtr->bestAsk();
+        const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+        emitLadder(g_activeConfig, *g_bookPtr, bestBid, bestAsk, nowMs);
+    }
 
-            std::string value;
-            if (!r.readLengthDelimited(value)) break;
+    void emitCurrentLadder()
+    {
+        if (!g_bookReady.load()) return;
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        if (!g_bookPtr) return;
+        emitCurrentLadderLocked();
+    }
 
-            if (field == 1)
-            {
-                priceStr = value;
-            }
-            else if (field == 2)
-            {
-                qtyStr = value;
-            }
+    // Make `book` the one control commands and heartbeats act on. In consolidated mode main
+    // publishes the merged book once and the venue feeds keep theirs private.
+    void publishActiveBook(const Config& cfg, dom::OrderBook& book)
+    {
+        if (g_mergedBook)
+        {
+            return;
         }
-
-        if (!priceStr.empty() && tickSize > 0.0)
         {
-            double price = std::stod(priceStr);
-            double qty = qtyStr.empty() ? 0.0 : std::stod(qtyStr);
-            const auto tick = tickFromPrice(price, tickSize);
-            out.emplace_back(tick, qty);
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            g_bookPtr = &book;
+            g_activeConfig = cfg;
         }
+        g_bookReady.store(true);
     }
 
-    void parseAggreDepth(const std::string& buf,
-                         double tickSize,
-                         std::vector<std::pair<dom::OrderBook::Tick, double>>& asks,
-                         std::vector<std::pair<dom::OrderBook::Tick, double>>& bids)
+    // Optional "id" of a control command; 0 when the sender did not number it.
+    std::uint64_t controlId(const json& cmd)
     {
-        ProtoReader r(buf.data(), buf.size());
-        while (!r.eof())
+        const auto it = cmd.find("id");
+        if (it != cmd.end() && it->is_number_unsigned())
         {
-            std::uint64_t key = 0;
-            if (!r.readVarint(key)) break;
-            const auto field = key >> 3;
-            if ((key & 0x7) != 2)
-            {
-                if (!r.skipField(key)) break;
-                continue;
-            }
-
-            std::string msg;
-            if (!r.readLengthDelimited(msg)) break;
-
-            if (field == 1) // asks
-            {
-                parseDepthItem(msg, tickSize, asks);
-            }
-            else if (field == 2) // bids
-            {
-                parseDepthItem(msg, tickSize, bids);
-            }
-            // fromVersion / toVersion мы игнорируем
+            return it->get<std::uint64_t>();
         }
+        return 0;
     }
 
-    struct PublicAggreDeal
+    // Called with g_bookMutex held, after command `id` took effect and before any frame
+    // reflecting it is captured. Ids only grow; unnumbered commands leave the ack alone.
+    void acknowledgeControlLocked(std::uint64_t id)
     {
-        double price{};
-        double quantity{};
-        bool buy{};
-        std::int64_t time{};
-    };
+        if (id > g_controlAck.load(std::memory_order_relaxed))
+        {
+            g_controlAck.store(id, std::memory_order_relaxed);
+        }
+    }
 
-    void parseAggreDealItem(const std::string& buf,
-                            std::vector<PublicAggreDeal>& out)
+    void applyShiftAndEmit(dom::OrderBook::Tick delta, std::uint64_t id)
     {
-        ProtoReader r(buf.data(), buf.size());
-        std::string priceStr;
-        std::string qtyStr;
-        int tradeType = 0;
-        std::int64_t time = 0;
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        if (!g_bookReady.load() || !g_bookPtr)
+        {
+            acknowledgeControlLocked(id);
+            return;
+        }
+        g_bookPtr->shiftManualCenterTicks(delta);
+        acknowledgeControlLocked(id);
+        emitCurrentLadderLocked();
+    }
+
+    // Widest span one "range" command answers; matches the dense ladder cap.
+    constexpr dom::OrderBook::Tick kMaxRangePageTicks = 40000;
 
-        while (!r.eof())
+    // {"cmd":"range","from":A,"to":B} -> one "ladder_page" with the cached levels in [A, B].
+    // Served straight from the book without moving the ladder window, so the GUI can browse
+    // depth far from the mid while the live window stays small.
+    void emitRangePage(const json& cmd)
+    {
+        if (!g_bookReady.load())
+        {
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            acknowledgeControlLocked(controlId(cmd));
+            return;
+        }
+        auto fromTick = static_cast<dom::OrderBook::Tick>(cmd.value("from", 0LL));
+        auto toTick = static_cast<dom::OrderBook::Tick>(cmd.value("to", 0LL));
+        if (fromTick > toTick)
+        {
+            std::swap(fromTick, toTick);
+        }
+        if (toTick - fromTick >= kMaxRangePageTicks)
         {
-            std::uint64_t key = 0;
-            if (!r.readVarint(key)) break;
-            const auto field = key >> 3;
-            const auto wire = key & 0x7;
+            toTick = fromTick + kMaxRangePageTicks - 1;
+        }
 
-            if (wire == 2)
-            {
-                std::string value;
-                if (!r.readLengthDelimited(value)) break;
-                if (field == 1)
-                {
-                    priceStr = value;
-                }
-                else if (field == 2)
-                {
-                    qtyStr = value;
-                }
-            }
-            else if (wire == 0)
-            {
-                std::uint64_t v = 0;
-                if (!r.readVarint(v)) break;
-                if (field == 3)
-                {
-                    tradeType = static_cast<int>(v);
-                }
-                else if (field == 4)
-                {
-                    time = static_cast<std::int64_t>(v);
-                }
-            }
-            else
+        std::vector<dom::OrderBook::Row> rows;
+        dom::OrderBook::Tick bookMin = 0;
+        dom::OrderBook::Tick bookMax = 0;
+        bool haveBook = false;
+        double tickSize = 0.0;
+        {
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            if (!g_bookPtr)
             {
-                if (!r.skipField(key)) break;
+                acknowledgeControlLocked(controlId(cmd));
+                return;
             }
+            rows = g_bookPtr->rowsInRange(fromTick, toTick);
+            haveBook = g_bookPtr->cachedTickRange(bookMin, bookMax);
+            tickSize = g_bookPtr->tickSize();
         }
 
-        if (!priceStr.empty())
+        json out;
+        out["type"] = "ladder_page";
+        if (cmd.contains("id"))
         {
-            double price = std::stod(priceStr);
-            double qty = qtyStr.empty() ? 0.0 : std::stod(qtyStr);
-            if (qty <= 0.0) return;
-
-            PublicAggreDeal d;
-            d.price = price;
-            d.quantity = qty;
-            d.time = time;
-            // tradeType: 1/2 — точное значение зависит от биржи; считаем 1=buy,2=sell
-            d.buy = (tradeType != 2);
-            out.push_back(d);
+            out["id"] = cmd["id"];
         }
-    }
-
-    void parseAggreDeals(const std::string& buf,
-                         std::vector<PublicAggreDeal>& out)
-    {
-        ProtoReader r(buf.data(), buf.size());
-        while (!r.eof())
+        out["from"] = fromTick;
+        out["to"] = toTick;
+        // Levels beyond the cached span are unknown rather than empty.
+        out["bookMinTick"] = haveBook ? bookMin : 0;
+        out["bookMaxTick"] = haveBook ? bookMax : 0;
+        out["tickSize"] = tickSize;
+        out["gen"] = runtime().generation.load(std::memory_order_relaxed);
+        json rowsJson = json::array();
+        for (const auto& row : rows)
         {
-            std::uint64_t key = 0;
-            if (!r.readVarint(key)) break;
-            const auto field = key >> 3;
-            if ((key & 0x7) != 2)
+            json r;
+            r["tick"] = row.tick;
+            if (row.bidQuantity > 0.0)
             {
-                if (!r.skipField(key)) break;
-                continue;
+                r["bid"] = row.bidQuantity;
             }
-
-            std::string msg;
-            if (!r.readLengthDelimited(msg)) break;
-
-            if (field == 1) // repeated deals
+            if (row.askQuantity > 0.0)
             {
-                parseAggreDealItem(msg, out);
+                r["ask"] = row.askQuantity;
             }
-            // field 2 = eventType (string) — игнорируем
+            rowsJson.push_back(std::move(r));
         }
+        out["rows"] = std::move(rowsJson);
+        stdoutWriter().writeLine(out.dump());
+
+        // Acknowledged only once the page is queued, so no frame echoing the id can overtake it.
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        acknowledgeControlLocked(controlId(cmd));
     }
 
-    bool parsePushWrapper(const void* data,
-                          std::size_t len,
-                          std::string& channelOut,
-                          double tickSize,
-                          std::vector<std::pair<dom::OrderBook::Tick, double>>& asks,
-                          std::vector<std::pair<dom::OrderBook::Tick, double>>& bids)
+    void resetLadderDiffLocked()
     {
-        ProtoReader r(data, len);
-        std::string depthBody;
+        g_haveLastLadder = false;
+        g_forceFullLadder = true;
+    }
 
-        while (!r.eof())
-        {
-            std::uint64_t key = 0;
-            if (!r.readVarint(key)) break;
-            const auto field = key >> 3;
-
-            if ((key & 0x7) != 2)
-            {
-                if (!r.skipField(key)) break;
-                continue;
-            }
-
-            std::string value;
-            if (!r.readLengthDelimited(value)) break;
-
-            if (field == 1)
-            {
-                channelOut = value;
-            }
-            else if (field == 313)
-            {
-                depthBody = std::move(value);
-            }
-        }
-
-        if (depthBody.empty())
+    std::uint64_t nextGeneration(const json& cmd)
+    {
+        const auto it = cmd.find("gen");
+        if (it != cmd.end() && it->is_number_unsigned())
         {
-            return false;
+            return it->get<std::uint64_t>();
         }
-
-        asks.clear();
-        bids.clear();
-        parseAggreDepth(depthBody, tickSize, asks, bids);
-        return true;
+        return runtime().generation.load() + 1;
     }
 
-    bool parseDealsFromWrapper(const void* data,
-                               std::size_t len,
-                               std::string& channelOut,
-                               std::vector<PublicAggreDeal>& deals)
+    // Called with g_bookMutex held, once the feed is ready to stream `config.symbol`.
+    void beginSymbolSwitchLocked(const Config& config, dom::OrderBook& book, std::uint64_t generation)
     {
-        ProtoReader r(data, len);
-        std::string dealsBody;
-
-        while (!r.eof())
+        if (g_analytics)
         {
-            std::uint64_t key = 0;
-            if (!r.readVarint(key)) break;
-            const auto field = key >> 3;
-
-            if ((key & 0x7) != 2)
-            {
-                if (!r.skipField(key)) break;
-                continue;
-            }
-
-            std::string value;
-            if (!r.readLengthDelimited(value)) break;
-
-            if (field == 1)
-            {
-                channelOut = value;
-            }
-            else if (field == 314)
-            {
-                dealsBody = std::move(value);
-            }
+            g_analytics->resetTrades();
         }
-
-        if (dealsBody.empty())
+        tradeBatcher().switchSymbol(config.symbol);
+        if (g_recorder)
         {
-            return false;
+            g_recorder->setStream(config.exchange, config.symbol);
         }
-
-        deals.clear();
-        parseAggreDeals(dealsBody, deals);
-        return !deals.empty();
+        runtime().generation.store(generation);
+        book.clear();
+        book.clearManualCenter();
+        book.setTickSize(0.0);
+        g_activeConfig.symbol = config.symbol;
+        resetLadderDiffLocked();
     }
 
-    void emitLadder(const Config& config,
-                    const dom::OrderBook& book,
-                    double bestBid,
-                    double bestAsk,
-                    std::int64_t ts);
-
-    std::mutex g_bookMutex;
-    std::atomic<bool> g_bookReady{false};
-    dom::OrderBook* g_bookPtr = nullptr;
-    Config g_activeConfig;
-    std::vector<dom::OrderBook::Row> g_lastLadderRows;
-    dom::OrderBook::Tick g_lastWindowMinTick = 0;
-    dom::OrderBook::Tick g_lastWindowMaxTick = 0;
-    bool g_haveLastLadder = false;
-    bool g_forceFullLadder = false;
-
-    void heartbeatThread()
+    // Called with g_bookMutex held by a feed that re-subscribed its open socket to
+    // `config.symbol`: starts the switch and loads the new book, emitting it when it has both sides.
+    void loadSwitchedSymbolLocked(const Config& config,
+                                  dom::OrderBook& book,
+                                  std::uint64_t generation,
+                                  double tickSize,
+                                  const LevelVector& bids,
+                                  const LevelVector& asks)
     {
-        using namespace std::chrono_literals;
-        // Keep the GUI watchdog alive even when a WS connection is idle (WinHTTP receive blocks).
-        for (;;)
+        beginSymbolSwitchLocked(config, book, generation);
+        book.setTickSize(tickSize);
+        book.loadSnapshot(bids, asks);
+        if (book.bestBid() > 0.0 && book.bestAsk() > 0.0)
         {
-            std::this_thread::sleep_for(5s);
-            if (!g_bookReady.load())
-            {
-                continue;
-            }
-            std::lock_guard<std::mutex> lock(g_bookMutex);
-            if (!g_bookPtr)
-            {
-                continue;
-            }
-            json hb;
-            hb["type"] = "hb";
-            hb["symbol"] = g_activeConfig.symbol;
-            hb["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                  std::chrono::system_clock::now().time_since_epoch())
-                                  .count();
-            hb["bestBid"] = g_bookPtr->bestBid();
-            hb["bestAsk"] = g_bookPtr->bestAsk();
-            stdoutWriter().writeLine(hb.dump());
+            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+            emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
         }
     }
 
-    void emitCurrentLadderLocked()
+    void applyLevelsAndEmit(const json& cmd)
     {
-        const double bestBid = g_bookPtr->bestBid();
-        const double bestAsk = g_bookPtr->bestAsk();
-        const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                               std::chrono::system_clock::now().time_since_epoch())
-                               .count();
-        emitLadder(g_activeConfig, *g_bookPtr, bestBid, bestAsk, nowMs);
+        auto& rt = runtime();
+        const std::uint64_t generation = nextGeneration(cmd);
+        // With a symbol switch queued the switch itself starts the new generation;
+        // emitting now would stamp the old symbol's book with it.
+        const bool switching = symbolSwitchPending();
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        const auto ladderIt = cmd.find("ladderLevels");
+        if (ladderIt != cmd.end() && ladderIt->is_number_unsigned())
+        {
+            const auto levels = std::max<std::size_t>(1, ladderIt->get<std::size_t>());
+            rt.ladderLevelsPerSide.store(levels);
+            g_activeConfig.ladderLevelsPerSide = levels;
+        }
+        const auto cacheIt = cmd.find("cacheLevels");
+        if (cacheIt != cmd.end() && cacheIt->is_number_unsigned())
+        {
+            const auto levels = std::max<std::size_t>(5000, cacheIt->get<std::size_t>());
+            rt.cacheLevelsPerSide.store(levels);
+            g_activeConfig.cacheLevelsPerSide = levels;
+            if (g_bookPtr)
+            {
+                g_bookPtr->setCacheLevelsPerSide(levels);
+            }
+        }
+        acknowledgeControlLocked(controlId(cmd));
+        if (switching)
+        {
+            return;
+        }
+        rt.generation.store(generation);
+        resetLadderDiffLocked();
+        if (g_bookReady.load() && g_bookPtr)
+        {
+            emitCurrentLadderLocked();
+        }
     }
 
-    void emitCurrentLadder()
+    void requestSymbolSwitch(const json& cmd)
     {
-        if (!g_bookReady.load()) return;
-        std::lock_guard<std::mutex> lock(g_bookMutex);
-        if (!g_bookPtr) return;
-        emitCurrentLadderLocked();
+        const std::string symbol = trimAscii(cmd.value("symbol", std::string()));
+        if (symbol.empty())
+        {
+            return;
+        }
+        if (g_mergedBook)
+        {
+            std::cerr << "[backend] subscribe ignored in consolidated mode" << std::endl;
+            return;
+        }
+        auto& rt = runtime();
+        std::lock_guard<std::mutex> lock(rt.switchMutex);
+        rt.pendingSymbol = symbol;
+        rt.pendingGeneration = nextGeneration(cmd);
+        rt.symbolSwitchPending.store(true, std::memory_order_release);
+        std::cerr << "[backend] symbol switch requested: " << symbol << std::endl;
     }
 
-    void applyShiftAndEmit(dom::OrderBook::Tick delta)
+    void clearManualCenterAndEmit(std::uint64_t id)
     {
-        if (!g_bookReady.load()) return;
         std::lock_guard<std::mutex> lock(g_bookMutex);
-        if (!g_bookPtr) return;
-        g_bookPtr->shiftManualCenterTicks(delta);
+        acknowledgeControlLocked(id);
+        if (!g_bookReady.load() || !g_bookPtr) return;
+        resetLadderDiffLocked();
+        g_bookPtr->clearManualCenter();
         emitCurrentLadderLocked();
     }
 
-    void clearManualCenterAndEmit()
+    void forceFullAndEmit(std::uint64_t id)
     {
-        if (!g_bookReady.load()) return;
         std::lock_guard<std::mutex> lock(g_bookMutex);
-        if (!g_bookPtr) return;
-        g_lastLadderRows.clear();
-        g_haveLastLadder = false;
-        g_forceFullLadder = true;
-        g_bookPtr->clearManualCenter();
+        acknowledgeControlLocked(id);
+        if (!g_bookReady.load() || !g_bookPtr) return;
+        resetLadderDiffLocked();
         emitCurrentLadderLocked();
     }
 
+    // Control input is one JSON command per line. A command may carry a numeric "id"
+    // (increasing per sender); ladder frames then echo the newest applied id as "ack" and
+    // "ladder_page" replies echo their own, so requests can be pipelined without guessing
+    // which frame answers which.
     void controlReaderThread()
     {
         std::string line;
@@ -2909,25 +3811,43 @@ namespace
             {
                 const auto j = json::parse(line);
                 const std::string cmd = j.value("cmd", std::string());
+                const std::uint64_t id = controlId(j);
                 if (cmd == "shift")
                 {
                     const double ticks = j.value("ticks", 0.0);
                     const auto delta = static_cast<dom::OrderBook::Tick>(std::llround(ticks));
-                    applyShiftAndEmit(delta);
+                    applyShiftAndEmit(delta, id);
                 }
                 else if (cmd == "center_auto")
                 {
-                    clearManualCenterAndEmit();
+                    clearManualCenterAndEmit(id);
                 }
                 else if (cmd == "force_full")
                 {
-                    if (!g_bookReady.load()) continue;
+                    forceFullAndEmit(id);
+                }
+                else if (cmd == "set_levels")
+                {
+                    applyLevelsAndEmit(j);
+                }
+                else if (cmd == "range")
+                {
+                    emitRangePage(j);
+                }
+                else
+                {
+                    if (cmd == "set_throttle")
+                    {
+                        const long long ms = j.value("ms", runtime().throttleMs.load());
+                        runtime().throttleMs.store(std::clamp<long long>(ms, 0, 5000));
+                    }
+                    else if (cmd == "subscribe")
+                    {
+                        // The switch itself is tracked by "gen"; the id only orders it.
+                        requestSymbolSwitch(j);
+                    }
                     std::lock_guard<std::mutex> lock(g_bookMutex);
-                    if (!g_bookPtr) continue;
-                    g_lastLadderRows.clear();
-                    g_haveLastLadder = false;
-                    g_forceFullLadder = true;
-                    emitCurrentLadderLocked();
+                    acknowledgeControlLocked(id);
                 }
             }
             catch (const std::exception& ex)
@@ -2935,98 +3855,277 @@ namespace
                 std::cerr << "[backend] control input error: " << ex.what() << std::endl;
             }
         }
+        runtime().controlClosed.store(true, std::memory_order_release);
     }
 
-    void emitLadder(const Config& config,
-                    const dom::OrderBook& book,
-                    double bestBid,
-                    double bestAsk,
-                    std::int64_t ts)
+    void emitAnalytics(dom::BookAnalytics& analytics, std::int64_t ts)
     {
-        dom::OrderBook::Tick winMin = 0;
-        dom::OrderBook::Tick winMax = 0;
-        dom::OrderBook::Tick centerTick = 0;
-        // Ladder emission must reflect what's actually visible. `cacheLevelsPerSide` is just
-        // storage capacity and can be much larger; using it here can generate massive JSON
-        // payloads (and stall/crash the GUI pipe), causing LadderClient restarts.
-        const std::size_t ladderLevels =
-            std::max<std::size_t>(config.ladderLevelsPerSide, 1);
-        auto rowsSparse = book.ladderSparse(ladderLevels, &winMin, &winMax, &centerTick);
-        const double tickSize = book.tickSize();
+        const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+        const auto snap = analytics.snapshot(nowMs);
+        if (!snap.valid)
+        {
+            return;
+        }
+        json out;
+        out["type"] = "analytics";
+        out["timestamp"] = ts;
+        out["gen"] = runtime().generation.load(std::memory_order_relaxed);
+        out["levels"] = analytics.bandLevels();
+        out["imbalance"] = snap.imbalance;
+        out["microprice"] = snap.microprice;
+        out["depthMid"] = snap.depthMid;
+        out["spread"] = snap.spread;
+        out["bidDepth"] = snap.bidDepth;
+        out["askDepth"] = snap.askDepth;
+        out["cvd"] = snap.cvd;
+        out["cvdWindowMs"] = analytics.cvdWindowMs();
+        stdoutWriter().writeLine(out.dump(), StdoutLineKind::Analytics);
+    }
 
-        auto enrich = [&](json &out) {
-            out["symbol"] = config.symbol;
+    void emitReplayStatus(const Config& cfg, long long positionUs, bool done)
+    {
+        json out;
+        out["type"] = "replay";
+        out["file"] = cfg.replayPath;
+        out["speed"] = cfg.replaySpeed > 0.0 ? json(cfg.replaySpeed) : json("max");
+        out["positionMs"] = positionUs / 1000;
+        out["done"] = done;
+        stdoutWriter().writeLine(out.dump());
+    }
+
+    // One line per wall event; the tracker already coalesced changes since the previous frame.
+    void emitWallEvents(dom::WallTracker& walls, std::int64_t ts)
+    {
+        const auto events = walls.drainEvents();
+        if (events.empty())
+        {
+            return;
+        }
+        const double tickSize = walls.tickSize();
+        const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+        const auto gen = runtime().generation.load(std::memory_order_relaxed);
+        for (const auto& event : events)
+        {
+            const auto& w = event.wall;
+            const double price = static_cast<double>(w.tick) * tickSize;
+            json out;
+            switch (event.kind)
+            {
+            case dom::WallTracker::EventKind::Add:
+                out["type"] = "wall_add";
+                break;
+            case dom::WallTracker::EventKind::Update:
+                out["type"] = "wall_update";
+                break;
+            case dom::WallTracker::EventKind::Remove:
+                out["type"] = "wall_remove";
+                out["reason"] = w.lastDecreaseTraded ? "traded" : "pulled";
+                break;
+            }
             out["timestamp"] = ts;
-            out["bestBid"] = bestBid;
-            out["bestAsk"] = bestAsk;
-            out["tickSize"] = tickSize;
-            out["windowMinTick"] = winMin;
-            out["windowMaxTick"] = winMax;
-            out["centerTick"] = centerTick;
+            out["gen"] = gen;
+            out["id"] = w.id;
+            out["side"] = w.bid ? "bid" : "ask";
+            out["tick"] = w.tick;
+            out["price"] = price;
+            out["qty"] = w.qty;
+            out["notional"] = w.qty * price;
+            out["ageMs"] = std::max<long long>(0, nowMs - w.firstSeenMs);
+            out["added"] = w.added;
+            out["pulled"] = w.pulled;
+            out["traded"] = w.traded;
+            out["moves"] = w.moves;
+            out["movedTicks"] = w.movedTicks;
+            stdoutWriter().writeLine(out.dump());
+        }
+    }
+
+    // Ladder frames are captured under g_bookMutex by whichever thread changed the book and
+    // serialized here, on a thread of their own: diffing and JSON building never run on a feed
+    // thread or lengthen the book lock, so a slow emit cannot hold up socket reads. Only the
+    // newest capture is kept; every frame carries the whole window and the diff is taken
+    // against the last frame actually written.
+    class LadderEmitter
+    {
+    public:
+        struct Frame
+        {
+            std::string symbol;
+            std::int64_t ts{0};
+            double bestBid{0.0};
+            double bestAsk{0.0};
+            double tickSize{0.0};
+            dom::OrderBook::Tick windowMinTick{0};
+            dom::OrderBook::Tick windowMaxTick{0};
+            dom::OrderBook::Tick centerTick{0};
+            std::uint64_t generation{0};
+            std::uint64_t ack{0}; // g_controlAck at capture
+            bool forceFull{false};
+            std::vector<dom::OrderBook::Row> rows;
         };
 
-        const bool needFull = !g_haveLastLadder || g_forceFullLadder;
-        if (needFull)
+        LadderEmitter()
+        {
+            // Constructed first so they outlive the emit thread at exit.
+            stdoutWriter();
+            telemetry();
+            worker = std::thread([this]() { run(); });
+        }
+
+        ~LadderEmitter()
         {
-            json out;
-            out["type"] = "ladder";
-            out["sparse"] = true;
-            json rows = json::array();
-            for (const auto &row : rowsSparse)
             {
-                json r;
-                r["tick"] = row.tick;
-                if (row.bidQuantity > 0.0) {
-                    r["bid"] = row.bidQuantity;
-                }
-                if (row.askQuantity > 0.0) {
-                    r["ask"] = row.askQuantity;
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            cv.notify_one();
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+
+        LadderEmitter(const LadderEmitter&) = delete;
+        LadderEmitter& operator=(const LadderEmitter&) = delete;
+
+        void submit(Frame frame)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (hasPending)
+                {
+                    // The superseded frame may have been the one owed as a full resync.
+                    frame.forceFull = frame.forceFull || pending.forceFull;
                 }
-                rows.push_back(std::move(r));
+                pending = std::move(frame);
+                hasPending = true;
             }
-            out["rows"] = std::move(rows);
-            enrich(out);
-            stdoutWriter().writeLine(out.dump());
-            g_haveLastLadder = true;
-            g_forceFullLadder = false;
+            cv.notify_one();
         }
-        else
+
+    private:
+        void run()
         {
-            json updates = json::array();
-            json removals = json::array();
+            Frame frame;
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [this]() { return hasPending || stopping; });
+                    if (!hasPending)
+                    {
+                        break;
+                    }
+                    frame = std::move(pending);
+                    hasPending = false;
+                }
+                write(frame);
+            }
+        }
 
-            const auto prevCount = static_cast<std::ptrdiff_t>(g_lastLadderRows.size());
-            const auto currCount = static_cast<std::ptrdiff_t>(rowsSparse.size());
+        void write(Frame& frame)
+        {
+            const auto emitStart = std::chrono::steady_clock::now();
+            auto enrich = [&](json &out) {
+                out["symbol"] = frame.symbol;
+                out["timestamp"] = frame.ts;
+                out["bestBid"] = frame.bestBid;
+                out["bestAsk"] = frame.bestAsk;
+                out["tickSize"] = frame.tickSize;
+                out["windowMinTick"] = frame.windowMinTick;
+                out["windowMaxTick"] = frame.windowMaxTick;
+                out["centerTick"] = frame.centerTick;
+                out["gen"] = frame.generation;
+                out["ack"] = frame.ack;
+            };
 
-            std::ptrdiff_t i = 0;
-            std::ptrdiff_t j = 0;
-            while (i < currCount && j < prevCount)
+            const bool writerResync = stdoutWriter().consumeLadderResync();
+            if (!haveLast || frame.forceFull || writerResync)
+            {
+                json out;
+                out["type"] = "ladder";
+                out["sparse"] = true;
+                json rows = json::array();
+                for (const auto &row : frame.rows)
+                {
+                    json r;
+                    r["tick"] = row.tick;
+                    if (row.bidQuantity > 0.0) {
+                        r["bid"] = row.bidQuantity;
+                    }
+                    if (row.askQuantity > 0.0) {
+                        r["ask"] = row.askQuantity;
+                    }
+                    rows.push_back(std::move(r));
+                }
+                out["rows"] = std::move(rows);
+                enrich(out);
+                stdoutWriter().writeLine(out.dump(), StdoutLineKind::LadderFull);
+                haveLast = true;
+            }
+            else
             {
-                const auto &cur = rowsSparse[static_cast<std::size_t>(i)];
-                const auto &prev = g_lastLadderRows[static_cast<std::size_t>(j)];
-                if (cur.tick == prev.tick)
+                json updates = json::array();
+                json removals = json::array();
+
+                const auto prevCount = static_cast<std::ptrdiff_t>(lastRows.size());
+                const auto currCount = static_cast<std::ptrdiff_t>(frame.rows.size());
+
+                std::ptrdiff_t i = 0;
+                std::ptrdiff_t j = 0;
+                while (i < currCount && j < prevCount)
                 {
-                    const bool bidChanged = (std::abs(prev.bidQuantity - cur.bidQuantity) > 1e-9);
-                    const bool askChanged = (std::abs(prev.askQuantity - cur.askQuantity) > 1e-9);
-                    if (bidChanged || askChanged)
+                    const auto &cur = frame.rows[static_cast<std::size_t>(i)];
+                    const auto &prev = lastRows[static_cast<std::size_t>(j)];
+                    if (cur.tick == prev.tick)
+                    {
+                        const bool bidChanged = (std::abs(prev.bidQuantity - cur.bidQuantity) > 1e-9);
+                        const bool askChanged = (std::abs(prev.askQuantity - cur.askQuantity) > 1e-9);
+                        if (bidChanged || askChanged)
+                        {
+                            json u;
+                            u["tick"] = cur.tick;
+                            if (bidChanged) {
+                                // Include zeros: we must be able to clear one side while keeping the other.
+                                u["bid"] = cur.bidQuantity;
+                            }
+                            if (askChanged) {
+                                u["ask"] = cur.askQuantity;
+                            }
+                            updates.push_back(std::move(u));
+                        }
+                        ++i;
+                        ++j;
+                    }
+                    else if (cur.tick > prev.tick)
                     {
+                        // New tick appears in current window.
                         json u;
                         u["tick"] = cur.tick;
-                        if (bidChanged) {
-                            // Include zeros: we must be able to clear one side while keeping the other.
+                        if (cur.bidQuantity > 0.0) {
                             u["bid"] = cur.bidQuantity;
                         }
-                        if (askChanged) {
+                        if (cur.askQuantity > 0.0) {
                             u["ask"] = cur.askQuantity;
                         }
                         updates.push_back(std::move(u));
+                        ++i;
+                    }
+                    else
+                    {
+                        // Tick removed from the current window (or became empty).
+                        removals.push_back(prev.tick);
+                        ++j;
                     }
-                    ++i;
-                    ++j;
                 }
-                else if (cur.tick > prev.tick)
+
+                for (; i < currCount; ++i)
                 {
-                    // New tick appears in current window.
+                    const auto &cur = frame.rows[static_cast<std::size_t>(i)];
                     json u;
                     u["tick"] = cur.tick;
                     if (cur.bidQuantity > 0.0) {
@@ -3036,55 +4135,113 @@ namespace
                         u["ask"] = cur.askQuantity;
                     }
                     updates.push_back(std::move(u));
-                    ++i;
                 }
-                else
+                for (; j < prevCount; ++j)
                 {
-                    // Tick removed from the current window (or became empty).
+                    const auto &prev = lastRows[static_cast<std::size_t>(j)];
                     removals.push_back(prev.tick);
-                    ++j;
+                }
+                // An unchanged frame is still written when it answers a command (e.g. a zero shift).
+                if (!updates.empty() || !removals.empty()
+                    || frame.windowMinTick != lastWindowMinTick || frame.windowMaxTick != lastWindowMaxTick
+                    || frame.ack != lastAck)
+                {
+                    json out;
+                    out["type"] = "ladder_delta";
+                    out["sparse"] = true;
+                    out["updates"] = std::move(updates);
+                    out["removals"] = std::move(removals);
+                    enrich(out);
+                    stdoutWriter().writeLine(out.dump(), StdoutLineKind::LadderDelta);
                 }
             }
 
-            for (; i < currCount; ++i)
+            lastRows = std::move(frame.rows);
+            lastWindowMinTick = frame.windowMinTick;
+            lastWindowMaxTick = frame.windowMaxTick;
+            lastAck = frame.ack;
+
+            if (g_analytics)
             {
-                const auto &cur = rowsSparse[static_cast<std::size_t>(i)];
-                json u;
-                u["tick"] = cur.tick;
-                if (cur.bidQuantity > 0.0) {
-                    u["bid"] = cur.bidQuantity;
-                }
-                if (cur.askQuantity > 0.0) {
-                    u["ask"] = cur.askQuantity;
-                }
-                updates.push_back(std::move(u));
+                emitAnalytics(*g_analytics, frame.ts);
             }
-            for (; j < prevCount; ++j)
+            if (g_walls)
             {
-                const auto &prev = g_lastLadderRows[static_cast<std::size_t>(j)];
-                removals.push_back(prev.tick);
+                emitWallEvents(*g_walls, frame.ts);
             }
-            if (!updates.empty() || !removals.empty()
-                || winMin != g_lastWindowMinTick || winMax != g_lastWindowMaxTick)
+
+            auto& t = telemetry();
+            t.emitUs.record(elapsedMicros(emitStart));
+            const long long exchangeTs = t.pendingExchangeTsMs.exchange(0, std::memory_order_relaxed);
+            if (exchangeTs > 0)
             {
-                json out;
-                out["type"] = "ladder_delta";
-                out["sparse"] = true;
-                out["updates"] = std::move(updates);
-                out["removals"] = std::move(removals);
-                enrich(out);
-                stdoutWriter().writeLine(out.dump());
+                const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::system_clock::now().time_since_epoch())
+                                       .count();
+                t.feedLatencyMs.record(static_cast<std::uint64_t>(std::max<long long>(0, nowMs - exchangeTs)));
             }
         }
 
-        g_lastLadderRows = std::move(rowsSparse);
-        g_lastWindowMinTick = winMin;
-        g_lastWindowMaxTick = winMax;
+        std::mutex mutex;
+        std::condition_variable cv;
+        Frame pending;
+        bool hasPending{false};
+        bool stopping{false};
+
+        // Emit thread only.
+        std::vector<dom::OrderBook::Row> lastRows;
+        dom::OrderBook::Tick lastWindowMinTick{0};
+        dom::OrderBook::Tick lastWindowMaxTick{0};
+        std::uint64_t lastAck{0};
+        bool haveLast{false};
+
+        std::thread worker;
+    };
+
+    static LadderEmitter& ladderEmitter()
+    {
+        static LadderEmitter e;
+        return e;
+    }
+
+    // Captures the ladder window of `book` for the emit thread. Callers hold g_bookMutex.
+    void emitLadder(const Config& config,
+                    const dom::OrderBook& book,
+                    double bestBid,
+                    double bestAsk,
+                    std::int64_t ts)
+    {
+        if (g_mergedBook && &book != g_mergedBook)
+        {
+            return;
+        }
+        LadderEmitter::Frame frame;
+        // Ladder emission must reflect what's actually visible. `cacheLevelsPerSide` is just
+        // storage capacity and can be much larger; using it here can generate massive JSON
+        // payloads (and stall/crash the GUI pipe), causing LadderClient restarts.
+        const std::size_t ladderLevels =
+            std::max<std::size_t>(runtime().ladderLevelsPerSide.load(std::memory_order_relaxed), 1);
+        frame.rows = book.ladderSparse(ladderLevels, &frame.windowMinTick, &frame.windowMaxTick, &frame.centerTick);
+        frame.symbol = config.symbol;
+        frame.ts = ts;
+        frame.bestBid = bestBid;
+        frame.bestAsk = bestAsk;
+        frame.tickSize = book.tickSize();
+        frame.generation = runtime().generation.load(std::memory_order_relaxed);
+        frame.ack = g_controlAck.load(std::memory_order_relaxed);
+        frame.forceFull = !g_haveLastLadder || g_forceFullLadder;
+        g_haveLastLadder = true;
+        g_forceFullLadder = false;
+        g_lastWindowMinTick = frame.windowMinTick;
+        g_lastWindowMaxTick = frame.windowMaxTick;
+        ladderEmitter().submit(std::move(frame));
     }
 
     // Legacy MEXC spot protobuf WS implementation (kept for reference / debugging).
-    bool runWebSocket(const Config& config, dom::OrderBook& book)
+    bool runWebSocket(const Config& baseConfig, dom::OrderBook& book)
     {
+        // Mutable copy: a `subscribe` control command re-targets this socket to another symbol.
+        Config config = baseConfig;
         WinHttpHandle session = openSession(config);
         if (!session.valid())
         {
@@ -3152,28 +4309,34 @@ namespace
         std::cerr << "[backend] connected to Mexc ws" << std::endl;
 
         // Подписка на aggre.depth и aggre.deals
-        std::ostringstream depthChannel;
-        depthChannel << "spot@public.aggre.depth.v3.api.pb@" << config.mexcStreamIntervalMs << "ms@" << config.symbol;
-        // Aggre deals channel also requires an interval suffix (10ms/100ms); without it
-        // the server replies with "Blocked" and sends no trades.
-        std::ostringstream dealsChannel;
-        dealsChannel << "spot@public.aggre.deals.v3.api.pb@" << config.mexcStreamIntervalMs << "ms@" << config.symbol;
-        json sub = {{"method", "SUBSCRIPTION"},
-                    {"params", json::array({depthChannel.str(), dealsChannel.str()})}};
-        const std::string subStr = sub.dump();
+        auto sendChannels = [&](const char* method, const std::string& symbol) {
+            std::ostringstream depthChannel;
+            depthChannel << "spot@public.aggre.depth.v3.api.pb@" << config.mexcStreamIntervalMs << "ms@" << symbol;
+            // Aggre deals channel also requires an interval suffix (10ms/100ms); without it
+            // the server replies with "Blocked" and sends no trades.
+            std::ostringstream dealsChannel;
+            dealsChannel << "spot@public.aggre.deals.v3.api.pb@" << config.mexcStreamIntervalMs << "ms@" << symbol;
+            json msg = {{"method", method},
+                        {"params", json::array({depthChannel.str(), dealsChannel.str()})}};
+            const std::string payload = msg.dump();
+            if (WinHttpWebSocketSend(rawSocket,
+                                     WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
+                                     (void*) payload.data(),
+                                     static_cast<DWORD>(payload.size())) != S_OK)
+            {
+                std::cerr << "[backend] failed to send " << method << std::endl;
+                return false;
+            }
+            std::cerr << "[backend] sent " << payload << std::endl;
+            return true;
+        };
 
-        if (WinHttpWebSocketSend(rawSocket,
-                                 WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
-                                 (void*) subStr.data(),
-                                 static_cast<DWORD>(subStr.size())) != S_OK)
+        if (!sendChannels("SUBSCRIPTION", config.symbol))
         {
-            std::cerr << "[backend] failed to send SUBSCRIPTION" << std::endl;
             WinHttpCloseHandle(rawSocket);
             return false;
         }
 
-        std::cerr << "[backend] sent " << subStr << std::endl;
-
         // MEXC spot public streams are protobuf and can exceed 64KB; using a larger receive buffer
         // reduces fragmentation and prevents decode stalls/crashes behind some proxies.
         std::vector<unsigned char> buffer(256 * 1024);
@@ -3182,10 +4345,55 @@ namespace
         std::string textBuffer;
         textBuffer.reserve(16 * 1024);
         std::uint64_t unknownBinaryFrames = 0;
-        auto lastEmit = std::chrono::steady_clock::now();
+        BookPipeline pipeline(config, book);
+        // Pushes name their symbol; ones still in flight for the previous symbol are dropped.
+        std::string symbolUpper = upperAscii(config.symbol);
+
+        // Re-target the open socket: swap channel subscriptions, then load the new book.
+        // On failure the caller drops the socket and main() redoes the full startup.
+        auto switchSymbolInPlace = [&]() -> bool {
+            std::string nextSymbol;
+            if (!peekSymbolSwitch(nextSymbol))
+            {
+                return true;
+            }
+            Config next = config;
+            next.symbol = nextSymbol;
+            std::cerr << "[backend] mexc switching " << config.symbol << " -> " << nextSymbol << " on open socket"
+                      << std::endl;
+            if (!sendChannels("UNSUBSCRIPTION", config.symbol) || !sendChannels("SUBSCRIPTION", nextSymbol))
+            {
+                return false;
+            }
+            double nextTickSize = 0.0;
+            LevelVector bids;
+            LevelVector asks;
+            if (!fetchExchangeInfo(next, nextTickSize) || !fetchSnapshot(next, nextTickSize, bids, asks))
+            {
+                std::cerr << "[backend] mexc switch: metadata/snapshot failed for " << nextSymbol << std::endl;
+                return false;
+            }
+            std::uint64_t generation = 0;
+            if (!takeSymbolSwitchFor(next.symbol, generation))
+            {
+                // Superseded while we were fetching: restore the channels, the newer request runs next frame.
+                return sendChannels("UNSUBSCRIPTION", next.symbol) && sendChannels("SUBSCRIPTION", config.symbol);
+            }
+            config = next;
+            symbolUpper = upperAscii(config.symbol);
+            pipeline.retarget(config);
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            loadSwitchedSymbolLocked(config, book, generation, nextTickSize, bids, asks);
+            return true;
+        };
 
         for (;;)
         {
+            if (symbolSwitchPending() && !switchSymbolInPlace())
+            {
+                std::cerr << "[backend] leaving MEXC stream for symbol switch" << std::endl;
+                break;
+            }
             DWORD received = 0;
             WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
             HRESULT hr =
@@ -3195,6 +4403,7 @@ namespace
                 std::cerr << "[backend] WebSocket receive failed: " << std::hex << hr << std::dec << std::endl;
                 break;
             }
+            noteFrameReceived(received);
 
             if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
             {
@@ -3280,10 +4489,8 @@ namespace
                         continue;
                     }
 
-                    std::string channelName;
-                    std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
-                    std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-                    std::vector<PublicAggreDeal> deals;
+                    auto depth = frameDepth();
+                    auto deals = frameTrades();
 
                     const unsigned char* payloadPtr = buffer.data();
                     std::size_t payloadSize = static_cast<std::size_t>(received);
@@ -3294,8 +4501,15 @@ namespace
                         payloadSize = binBuffer.size();
                     }
 
-                    // Try trades first
-                    if (parseDealsFromWrapper(payloadPtr, payloadSize, channelName, deals))
+                    std::string_view pushSymbol;
+                    const auto push =
+                        dom::feed::parseMexcPush(payloadPtr, payloadSize, tickSize, depth, deals, pushSymbol);
+                    if (push != dom::feed::MexcPush::Unknown && !pushSymbol.empty() && pushSymbol != symbolUpper)
+                    {
+                        binBuffer.clear();
+                        continue;
+                    }
+                    if (push == dom::feed::MexcPush::Deals)
                     {
                         for (const auto& d : deals)
                         {
@@ -3313,29 +4527,18 @@ namespace
                             {
                                 t["price"] = d.price;
                             }
-                            t["qty"] = d.quantity;
+                            t["qty"] = d.qty;
                             t["side"] = d.buy ? "buy" : "sell";
-                            t["timestamp"] = d.time;
+                            t["timestamp"] = d.timeMs;
                             tradeBatcher().add(config.symbol, std::move(t));
                         }
                         binBuffer.clear();
                         continue;
                     }
 
-                    // Depth updates
-                    if (parsePushWrapper(payloadPtr, payloadSize, channelName, tickSize, asks, bids))
+                    if (push == dom::feed::MexcPush::Depth)
                     {
-                        const auto now = std::chrono::steady_clock::now();
-                        std::lock_guard<std::mutex> lock(g_bookMutex);
-                        book.applyDelta(bids, asks, config.cacheLevelsPerSide);
-                        if (now - lastEmit >= config.throttle)
-                        {
-                            lastEmit = now;
-                            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                                   std::chrono::system_clock::now().time_since_epoch())
-                                                   .count();
-                            emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
-                        }
+                        pipeline.push(depth, false);
                     }
                     else
                     {
@@ -3454,7 +4657,7 @@ namespace
         textBuffer.reserve(16 * 1024);
         auto lastEmit = std::chrono::steady_clock::now();
 
-        auto parseSide = [&](const json& side, std::vector<std::pair<dom::OrderBook::Tick, double>>& out) {
+        auto parseSide = [&](const json& side, LevelVector& out) {
             out.clear();
             if (!side.is_array())
             {
@@ -3509,15 +4712,15 @@ namespace
                 const json asksSide = data.contains("asks") ? data["asks"]
                                    : data.contains("a") ? data["a"]
                                                         : json::array();
-                std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-                std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
+                auto bids = frameLevels();
+                auto asks = frameLevels();
                 parseSide(bidsSide, bids);
                 parseSide(asksSide, asks);
 
                 const auto now = std::chrono::steady_clock::now();
                 std::lock_guard<std::mutex> lock(g_bookMutex);
-                book.applyDelta(bids, asks, config.cacheLevelsPerSide);
-                if (now - lastEmit >= config.throttle)
+                applyDeltaTimed(book, bids, asks);
+                if (now - lastEmit >= runtimeThrottle())
                 {
                     lastEmit = now;
                     const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -3599,6 +4802,11 @@ namespace
 
         for (;;)
         {
+            if (symbolSwitchPending())
+            {
+                std::cerr << "[backend] leaving MEXC stream for symbol switch" << std::endl;
+                break;
+            }
             DWORD received = 0;
             WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
             HRESULT hr =
@@ -3608,6 +4816,7 @@ namespace
                 std::cerr << "[backend] WebSocket receive failed: " << std::hex << hr << std::dec << std::endl;
                 break;
             }
+            noteFrameReceived(received);
 
             if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
             {
@@ -3678,8 +4887,11 @@ namespace
         return true;
     }
 
-    bool runMexcFuturesWebSocket(const Config &config, dom::OrderBook &book)
+    bool runMexcFuturesWebSocket(const Config &baseConfig, dom::OrderBook &book)
     {
+        // Mutable copy: a `subscribe` control command re-targets this socket to another symbol,
+        // and reconnects subscribe to whichever symbol is current.
+        Config config = baseConfig;
         WinHttpHandle session = openSession(config);
         if (!session.valid())
         {
@@ -3690,6 +4902,7 @@ namespace
         const std::wstring host = L"contract.mexc.com";
         const std::wstring path = L"/edge";
         std::vector<unsigned char> buffer(128 * 1024);
+        BookPipeline pipeline(config, book);
 
         for (;;)
         {
@@ -3764,21 +4977,29 @@ namespace
                 std::max(50, static_cast<int>(
                                  std::max<std::size_t>(config.ladderLevelsPerSide,
                                                        config.cacheLevelsPerSide)));
-            json depthSub = {{"method","sub.depth"},
-                             {"param", {{"symbol", config.symbol},
-                                        {"limit", depthLimit}}}};
-            json dealSub = {{"method","sub.deal"}, {"param", {{"symbol", config.symbol}}}};
-            sendJson(depthSub);
-            sendJson(dealSub);
-
-            std::atomic<bool> running{true};
+            auto sendStreams = [&](const char *depthMethod, const char *dealMethod, const std::string &symbol) {
+                json depthMsg = {{"method", depthMethod},
+                                 {"param", {{"symbol", symbol},
+                                            {"limit", depthLimit}}}};
+                json dealMsg = {{"method", dealMethod}, {"param", {{"symbol", symbol}}}};
+                return sendJson(depthMsg) && sendJson(dealMsg);
+            };
+            sendStreams("sub.depth", "sub.deal", config.symbol);
+
+            // Keepalive; stopped through the condition variable so leaving the stream (symbol
+            // switch, reconnect) does not wait out the ping interval.
+            std::mutex pingMutex;
+            std::condition_variable pingWake;
+            bool running = true;
             std::thread pingThread([&]() {
-                while (running.load())
+                for (;;)
                 {
-                    std::this_thread::sleep_for(45s);
-                    if (!running.load())
                     {
-                        break;
+                        std::unique_lock<std::mutex> lock(pingMutex);
+                        if (pingWake.wait_for(lock, 45s, [&]() { return !running; }))
+                        {
+                            break;
+                        }
                     }
                     json ping = {{"method","ping"}};
                     if (!sendJson(ping))
@@ -3789,13 +5010,73 @@ namespace
                 }
             });
 
-            auto lastEmit = std::chrono::steady_clock::now();
             bool shouldReconnect = false;
             std::string textBuffer;
             textBuffer.reserve(64 * 1024);
+            std::string assembled; // reassembled fragments, kept across frames for its capacity
+
+            auto contractSize = [&]() {
+                return config.futuresContractSize > 0.0 ? config.futuresContractSize : 1.0;
+            };
+            auto applyDepth = [&](const dom::feed::DepthUpdate &depth) {
+                if (depth.bids.empty() && depth.asks.empty())
+                {
+                    return;
+                }
+                noteExchangeTime(depth.eventTimeMs);
+                pipeline.push(depth, false);
+            };
+
+            // Re-target the open socket: swap depth/deal subscriptions, then load the new book.
+            // On failure the caller drops the socket and main() redoes the full startup.
+            auto switchSymbolInPlace = [&]() -> bool {
+                std::string nextSymbol;
+                if (!peekSymbolSwitch(nextSymbol))
+                {
+                    return true;
+                }
+                Config next = config;
+                next.symbol = nextSymbol;
+                std::cerr << "[backend] mexc futures switching " << config.symbol << " -> " << nextSymbol
+                          << " on open socket" << std::endl;
+                if (!sendStreams("unsub.depth", "unsub.deal", config.symbol) ||
+                    !sendStreams("sub.depth", "sub.deal", nextSymbol))
+                {
+                    return false;
+                }
+                double nextTickSize = 0.0;
+                double nextContractSize = 1.0;
+                LevelVector bids;
+                LevelVector asks;
+                if (!fetchFuturesContractInfo(next, nextTickSize, nextContractSize) ||
+                    !fetchFuturesSnapshot(next, nextTickSize, nextContractSize, bids, asks))
+                {
+                    std::cerr << "[backend] mexc futures switch: metadata/snapshot failed for " << nextSymbol
+                              << std::endl;
+                    return false;
+                }
+                std::uint64_t generation = 0;
+                if (!takeSymbolSwitchFor(next.symbol, generation))
+                {
+                    // Superseded while we were fetching: restore the streams, the newer request runs next frame.
+                    return sendStreams("unsub.depth", "unsub.deal", next.symbol) &&
+                           sendStreams("sub.depth", "sub.deal", config.symbol);
+                }
+                next.futuresContractSize = nextContractSize;
+                config = next;
+                pipeline.retarget(config);
+                std::lock_guard<std::mutex> lock(g_bookMutex);
+                loadSwitchedSymbolLocked(config, book, generation, nextTickSize, bids, asks);
+                return true;
+            };
 
             while (true)
             {
+                if (symbolSwitchPending() && !switchSymbolInPlace())
+                {
+                    std::cerr << "[backend] leaving MEXC futures stream for symbol switch" << std::endl;
+                    break;
+                }
                 DWORD received = 0;
                 WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
                 HRESULT hr = WinHttpWebSocketReceive(rawSocket,
@@ -3809,6 +5090,7 @@ namespace
                     shouldReconnect = true;
                     break;
                 }
+                noteFrameReceived(received);
                 if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
                 {
                     std::cerr << "[backend] futures WS closed by server" << std::endl;
@@ -3837,17 +5119,32 @@ namespace
                     continue;
                 }
 
-                std::string text;
+                std::string_view text(reinterpret_cast<const char*>(buffer.data()), received);
                 if (!textBuffer.empty())
                 {
-                    textBuffer.append(reinterpret_cast<const char*>(buffer.data()), received);
-                    text.swap(textBuffer);
+                    textBuffer.append(text.data(), text.size());
+                    assembled.swap(textBuffer);
                     textBuffer.clear();
+                    text = assembled;
                 }
-                else
+
+                // push.depth frames are decoded from the text; everything else goes through json.
+                // Pushes still in flight for a previous symbol are dropped.
                 {
-                    text.assign(reinterpret_cast<const char*>(buffer.data()), received);
+                    const double tickSize = book.tickSize();
+                    auto depth = frameDepth();
+                    std::string_view frameSymbol;
+                    if (tickSize > 0.0 &&
+                        dom::feed::decodeMexcFuturesDepth(text, tickSize, contractSize(), depth, frameSymbol))
+                    {
+                        if (frameSymbol.empty() || frameSymbol == config.symbol)
+                        {
+                            applyDepth(depth);
+                        }
+                        continue;
+                    }
                 }
+
                 json message;
                 try
                 {
@@ -3892,76 +5189,39 @@ namespace
                     shouldReconnect = true;
                     break;
                 }
+                const std::string pushSymbol = message.value("symbol", std::string());
+                if (!pushSymbol.empty() && pushSymbol != config.symbol)
+                {
+                    continue;
+                }
                 if (channel == "push.depth")
                 {
-                    const json data = message.value("data", json::object());
+                    const auto dataIt = message.find("data");
                     const double tickSize = book.tickSize();
-                    if (tickSize <= 0.0 || !data.is_object())
+                    if (tickSize <= 0.0 || dataIt == message.end() || !dataIt->is_object())
                     {
                         continue;
                     }
-                    const double contractSize = config.futuresContractSize > 0.0 ? config.futuresContractSize : 1.0;
-                    std::vector<std::pair<dom::OrderBook::Tick,double>> bids;
-                    std::vector<std::pair<dom::OrderBook::Tick,double>> asks;
-                    auto parseSide = [&](const json &side,
-                                         std::vector<std::pair<dom::OrderBook::Tick,double>> &out) {
-                        out.clear();
-                        if (!side.is_array())
-                        {
-                            return;
-                        }
-                        for (const auto &row : side)
-                        {
-                            if (row.is_array() && !row.empty())
-                            {
-                                const double price = row.size() > 0 ? jsonToDouble(row[0]) : 0.0;
-                                double qty = row.size() > 1 ? jsonToDouble(row[1]) : 0.0;
-                                if (price <= 0.0 || qty < 0.0)
-                                {
-                                    continue;
-                                }
-                                qty *= contractSize;
-                                const auto tick = tickFromPrice(price, tickSize);
-                                out.emplace_back(tick, qty);
-                            }
-                        }
-                    };
-                    parseSide(data.value("bids", json::array()), bids);
-                    parseSide(data.value("asks", json::array()), asks);
-                    if (!bids.empty() || !asks.empty())
-                    {
-                        std::lock_guard<std::mutex> lock(g_bookMutex);
-                        book.applyDelta(bids, asks, config.cacheLevelsPerSide);
-                        const auto now = std::chrono::steady_clock::now();
-                        if (now - lastEmit >= config.throttle)
-                        {
-                            lastEmit = now;
-                            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                                   std::chrono::system_clock::now().time_since_epoch())
-                                                   .count();
-                            emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
-                        }
-                    }
+                    auto depth = frameDepth();
+                    dom::feed::parseMexcFuturesDepth(*dataIt, tickSize, contractSize(), depth);
+                    depth.eventTimeMs = message.value("ts", 0LL);
+                    applyDepth(depth);
                     continue;
                 }
                 if (channel == "push.deal")
                 {
-                    const json deals = message.value("data", json::array());
-                    if (!deals.is_array())
+                    const auto dataIt = message.find("data");
+                    if (dataIt == message.end() || !dataIt->is_array())
                     {
                         continue;
                     }
                     const double tickSize = book.tickSize();
-                    const double contractSize = config.futuresContractSize > 0.0 ? config.futuresContractSize : 1.0;
+                    auto deals = frameTrades();
+                    dom::feed::parseMexcFuturesDeals(*dataIt, contractSize(), deals);
                     for (const auto &d : deals)
                     {
-                        const double price = jsonToDouble(d.value("p", json(0.0)));
-                        double qty = jsonToDouble(d.value("v", json(0.0)));
-                        if (price <= 0.0 || qty <= 0.0)
-                        {
-                            continue;
-                        }
-                        qty *= contractSize;
+                        const double price = d.price;
+                        const double qty = d.qty;
                         json t;
                         t["type"] = "trade";
                         t["symbol"] = config.symbol;
@@ -3977,16 +5237,19 @@ namespace
                             t["price"] = price;
                         }
                         t["qty"] = qty;
-                        const int sideCode = d.value("T", 1);
-                        t["side"] = (sideCode == 2) ? "sell" : "buy";
-                        t["timestamp"] = d.value("t", 0);
+                        t["side"] = d.buy ? "buy" : "sell";
+                        t["timestamp"] = d.timeMs;
                         tradeBatcher().add(config.symbol, std::move(t));
                     }
                     continue;
                 }
             }
 
-            running.store(false);
+            {
+                std::lock_guard<std::mutex> lock(pingMutex);
+                running = false;
+            }
+            pingWake.notify_one();
             if (pingThread.joinable())
             {
                 pingThread.join();
@@ -4026,7 +5289,7 @@ bool fetchUzxSnapshot(const Config& config, dom::OrderBook& book, double& tickSi
         return false;
     }
 
-    auto parseBookSide = [](const json& arr, std::vector<std::pair<dom::OrderBook::Tick, double>>& out, double tickSize) {
+    auto parseBookSide = [](const json& arr, LevelVector& out, double tickSize) {
         out.clear();
         for (const auto& lvl : arr)
         {
@@ -4149,8 +5412,8 @@ bool fetchUzxSnapshot(const Config& config, dom::OrderBook& book, double& tickSi
     }
     book.setTickSize(tickSizeOut);
 
-    std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-    std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
+    LevelVector bids;
+    LevelVector asks;
     parseBookSide(bidsArr, bids, tickSizeOut);
     parseBookSide(asksArr, asks, tickSizeOut);
     book.loadSnapshot(bids, asks);
@@ -4309,7 +5572,7 @@ bool fetchBinanceSnapshotSpot(const Config &cfg, double tickSize, BinanceDepthSn
     }
 
     auto parseSide = [tickSize](const json &arr,
-                                std::vector<std::pair<dom::OrderBook::Tick, double>> &out) {
+                                LevelVector &out) {
         out.clear();
         if (!arr.is_array())
         {
@@ -4366,7 +5629,7 @@ bool fetchBinanceSnapshotFutures(const Config &cfg, double tickSize, BinanceDept
     }
 
     auto parseSide = [tickSize](const json &arr,
-                                std::vector<std::pair<dom::OrderBook::Tick, double>> &out) {
+                                LevelVector &out) {
         out.clear();
         if (!arr.is_array())
         {
@@ -4392,8 +5655,10 @@ bool fetchBinanceSnapshotFutures(const Config &cfg, double tickSize, BinanceDept
     return out.lastUpdateId > 0;
 }
 
-bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool futures, long long snapshotLastUpdateId)
+bool runBinanceWebSocket(const Config &baseConfig, dom::OrderBook &book, bool futures, long long snapshotLastUpdateId)
 {
+    // Mutable copy: a `subscribe` control command re-targets this socket to another symbol.
+    Config config = baseConfig;
     WinHttpHandle session = openSession(config);
     if (!session.valid())
     {
@@ -4405,13 +5670,15 @@ bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool future
     const INTERNET_PORT port = futures ? INTERNET_DEFAULT_HTTPS_PORT : 9443;
     const std::wstring path = L"/ws";
 
-    const std::string symbolLower = [&]() {
-        std::string s = normalizeBinanceSymbol(config.symbol);
+    auto lowerStreamSymbol = [](const std::string &symbol) {
+        std::string s = normalizeBinanceSymbol(symbol);
         std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) {
             return static_cast<char>(std::tolower(c));
         });
         return s;
-    }();
+    };
+    std::string symbolLower = lowerStreamSymbol(config.symbol);
+    std::string symbolUpper = normalizeBinanceSymbol(config.symbol);
 
     auto lastUpdateId = snapshotLastUpdateId;
     bool synced = false;
@@ -4528,10 +5795,136 @@ bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool future
 
         std::vector<unsigned char> buffer(256 * 1024);
         std::string fragmentBuffer;
+        std::string assembled; // reassembled fragments, kept across frames for its capacity
         auto lastEmit = std::chrono::steady_clock::now();
 
+        auto sendStreams = [&](const char *method, const std::string &lower, int id) {
+            json msg = {{"method", method},
+                        {"params", json::array({lower + "@depth@100ms", lower + "@aggTrade"})},
+                        {"id", id}};
+            const std::string payload = msg.dump();
+            return WinHttpWebSocketSend(rawSocket,
+                                        WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
+                                        (void *)payload.data(),
+                                        static_cast<DWORD>(payload.size())) == S_OK;
+        };
+
+        // Re-target the open socket: swap stream subscriptions, then load the new book.
+        // On failure the caller drops the socket and main() redoes the full startup.
+        auto switchSymbolInPlace = [&]() -> bool {
+            std::string nextSymbol;
+            if (!peekSymbolSwitch(nextSymbol))
+            {
+                return true;
+            }
+            Config next = config;
+            next.symbol = nextSymbol;
+            const std::string nextLower = lowerStreamSymbol(nextSymbol);
+            std::cerr << "[backend] binance switching " << symbolUpper << " -> " << normalizeBinanceSymbol(nextSymbol)
+                      << " on open socket" << std::endl;
+            if (!sendStreams("UNSUBSCRIBE", symbolLower, 2) || !sendStreams("SUBSCRIBE", nextLower, 3))
+            {
+                return false;
+            }
+            double nextTickSize = 0.0;
+            const bool tickOk = futures ? fetchBinanceExchangeInfoFutures(next, nextTickSize)
+                                        : fetchBinanceExchangeInfoSpot(next, nextTickSize);
+            BinanceDepthSnapshot snap;
+            const bool snapOk = tickOk && (futures ? fetchBinanceSnapshotFutures(next, nextTickSize, snap)
+                                                   : fetchBinanceSnapshotSpot(next, nextTickSize, snap));
+            if (!snapOk)
+            {
+                std::cerr << "[backend] binance switch: metadata/snapshot failed for " << nextSymbol << std::endl;
+                return false;
+            }
+            std::uint64_t generation = 0;
+            if (!takeSymbolSwitchFor(next.symbol, generation))
+            {
+                // Superseded while we were fetching: restore the streams, the newer request runs next frame.
+                return sendStreams("UNSUBSCRIBE", nextLower, 4) && sendStreams("SUBSCRIBE", symbolLower, 5);
+            }
+            config = next;
+            symbolLower = nextLower;
+            symbolUpper = normalizeBinanceSymbol(config.symbol);
+            lastUpdateId = snap.lastUpdateId;
+            synced = false;
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            loadSwitchedSymbolLocked(config, book, generation, nextTickSize, snap.bids, snap.asks);
+            lastEmit = std::chrono::steady_clock::now();
+            return true;
+        };
+
+        // Applies one depthUpdate, keeping the stream in sequence with the REST snapshot.
+        auto applyDepth = [&](const dom::feed::DepthUpdate &depth) {
+            const long long U = depth.firstUpdateId;
+            const long long u = depth.lastUpdateId;
+            if (lastUpdateId > 0 && (U <= 0 || u <= 0))
+            {
+                return;
+            }
+
+            if (lastUpdateId > 0 && !synced)
+            {
+                // Drop events that are completely before our snapshot.
+                if (u <= lastUpdateId)
+                {
+                    return;
+                }
+                // First applied event must satisfy: U <= lastUpdateId+1 <= u
+                if (!(U <= lastUpdateId + 1 && u >= lastUpdateId + 1))
+                {
+                    resyncSnapshot();
+                    return;
+                }
+                synced = true;
+            }
+            else if (lastUpdateId > 0 && synced)
+            {
+                if (futures)
+                {
+                    if (depth.prevUpdateId != lastUpdateId)
+                    {
+                        resyncSnapshot();
+                        return;
+                    }
+                }
+                else
+                {
+                    if (U != lastUpdateId + 1)
+                    {
+                        // Missed updates; force snapshot resync.
+                        resyncSnapshot();
+                        return;
+                    }
+                }
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            noteExchangeTime(depth.eventTimeMs);
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            applyDeltaTimed(book, depth.bids, depth.asks);
+            if (lastUpdateId > 0 && u > 0)
+            {
+                lastUpdateId = u;
+            }
+            if (now - lastEmit >= runtimeThrottle())
+            {
+                lastEmit = now;
+                const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::system_clock::now().time_since_epoch())
+                                       .count();
+                emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
+            }
+        };
+
         for (;;)
         {
+            if (symbolSwitchPending() && !switchSymbolInPlace())
+            {
+                WinHttpWebSocketClose(rawSocket, WINHTTP_WEB_SOCKET_SUCCESS_CLOSE_STATUS, nullptr, 0);
+                WinHttpCloseHandle(rawSocket);
+                return true;
+            }
             DWORD received = 0;
             WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
             HRESULT hr = WinHttpWebSocketReceive(rawSocket,
@@ -4544,6 +5937,7 @@ bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool future
                 std::cerr << "[backend] Binance WS receive failed" << std::endl;
                 break;
             }
+            noteFrameReceived(received);
             if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
             {
                 std::cerr << "[backend] Binance WS closed" << std::endl;
@@ -4559,10 +5953,10 @@ bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool future
                 continue;
             }
 
-            const std::string text(reinterpret_cast<char *>(buffer.data()), received);
+            const std::string_view chunk(reinterpret_cast<const char *>(buffer.data()), received);
             if (type == WINHTTP_WEB_SOCKET_UTF8_FRAGMENT_BUFFER_TYPE)
             {
-                fragmentBuffer.append(text);
+                fragmentBuffer.append(chunk.data(), chunk.size());
                 // Safety: avoid unbounded growth if we keep getting garbage fragments.
                 if (fragmentBuffer.size() > (1024 * 1024))
                 {
@@ -4571,21 +5965,35 @@ bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool future
                 continue;
             }
 
-            std::string fullText;
+            std::string_view frame = chunk;
             if (!fragmentBuffer.empty())
             {
-                fragmentBuffer.append(text);
-                fullText.swap(fragmentBuffer);
+                fragmentBuffer.append(chunk.data(), chunk.size());
+                assembled.swap(fragmentBuffer);
                 fragmentBuffer.clear();
+                frame = assembled;
             }
-            else
+
+            // Depth events are decoded from the text; acks and trades go through json.
             {
-                fullText = text;
+                const double tickSize = book.tickSize();
+                auto depth = frameDepth();
+                std::string_view frameSymbol;
+                if (tickSize > 0.0 && dom::feed::decodeBinanceDepth(frame, tickSize, depth, frameSymbol))
+                {
+                    // Symbol check: in-flight frames of the previous symbol right after a switch.
+                    if (frameSymbol.empty() || frameSymbol == symbolUpper)
+                    {
+                        applyDepth(depth);
+                    }
+                    continue;
+                }
             }
+
             json j;
             try
             {
-                j = json::parse(fullText);
+                j = json::parse(frame);
             }
             catch (...)
             {
@@ -4596,6 +6004,11 @@ bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool future
                 continue;
             }
             const std::string event = j.value("e", std::string());
+            if (j.value("s", symbolUpper) != symbolUpper)
+            {
+                // In-flight frames of the previous symbol right after a switch.
+                continue;
+            }
             if (event == "depthUpdate")
             {
                 const double tickSize = book.tickSize();
@@ -4604,87 +6017,9 @@ bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool future
                     continue;
                 }
 
-                const long long U = j.value("U", 0LL);
-                const long long u = j.value("u", 0LL);
-                if (lastUpdateId > 0 && (U <= 0 || u <= 0))
-                {
-                    continue;
-                }
-
-                if (lastUpdateId > 0 && !synced)
-                {
-                    // Drop events that are completely before our snapshot.
-                    if (u <= lastUpdateId)
-                    {
-                        continue;
-                    }
-                    // First applied event must satisfy: U <= lastUpdateId+1 <= u
-                    if (!(U <= lastUpdateId + 1 && u >= lastUpdateId + 1))
-                    {
-                        resyncSnapshot();
-                        continue;
-                    }
-                    synced = true;
-                }
-                else if (lastUpdateId > 0 && synced)
-                {
-                    if (futures)
-                    {
-                        const long long pu = j.value("pu", 0LL);
-                        if (pu != lastUpdateId)
-                        {
-                            resyncSnapshot();
-                            continue;
-                        }
-                    }
-                    else
-                    {
-                        if (U != lastUpdateId + 1)
-                        {
-                            // Missed updates; force snapshot resync.
-                            resyncSnapshot();
-                            continue;
-                        }
-                    }
-                }
-
-                std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-                std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
-                auto parseSide = [tickSize](const json &arr,
-                                            std::vector<std::pair<dom::OrderBook::Tick, double>> &out) {
-                    out.clear();
-                    if (!arr.is_array())
-                    {
-                        return;
-                    }
-                    out.reserve(arr.size());
-                    for (const auto &e : arr)
-                    {
-                        if (!e.is_array() || e.size() < 2) continue;
-                        const double price = jsonToDouble(e[0]);
-                        const double qty = jsonToDouble(e[1]);
-                        const auto tick = tickFromPrice(price, tickSize);
-                        out.emplace_back(tick, qty);
-                    }
-                };
-                parseSide(j.value("b", json::array()), bids);
-                parseSide(j.value("a", json::array()), asks);
-
-                const auto now = std::chrono::steady_clock::now();
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                book.applyDelta(bids, asks, config.cacheLevelsPerSide);
-                if (lastUpdateId > 0 && u > 0)
-                {
-                    lastUpdateId = u;
-                }
-                if (now - lastEmit >= config.throttle)
-                {
-                    lastEmit = now;
-                    const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                           std::chrono::system_clock::now().time_since_epoch())
-                                           .count();
-                    emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
-                }
+                auto depth = frameDepth();
+                dom::feed::parseBinanceDepth(j, tickSize, depth);
+                applyDepth(depth);
             }
             else if (event == "aggTrade")
             {
@@ -4693,11 +6028,15 @@ bool runBinanceWebSocket(const Config &config, dom::OrderBook &book, bool future
                 {
                     continue;
                 }
-                const double price = jsonToDouble(j.value("p", json(0.0)));
-                const double qty = jsonToDouble(j.value("q", json(0.0)));
-                const bool buyerIsMaker = j.value("m", false);
-                const bool buy = !buyerIsMaker;
-                const auto ts = j.value("T", j.value("E", 0LL));
+                dom::feed::Trade trade;
+                if (!dom::feed::parseBinanceAggTrade(j, trade))
+                {
+                    continue;
+                }
+                const double price = trade.price;
+                const double qty = trade.qty;
+                const bool buy = trade.buy;
+                const auto ts = trade.timeMs;
                 json t;
                 t["type"] = "trade";
                 t["symbol"] = config.symbol;
@@ -4851,6 +6190,7 @@ bool runUzxWebSocket(const Config& config, dom::OrderBook& book, double tickSize
             const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                                    std::chrono::system_clock::now().time_since_epoch())
                                    .count();
+            std::lock_guard<std::mutex> lock(g_bookMutex);
             emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
         }
     }
@@ -4886,69 +6226,21 @@ bool runUzxWebSocket(const Config& config, dom::OrderBook& book, double tickSize
     sendSub(fillsSubScoped);
 
     std::vector<unsigned char> buffer(256 * 1024);
-    auto lastEmit = std::chrono::steady_clock::now();
-
-    auto detectTick = [](std::string_view priceStr) -> double {
-        auto pos = priceStr.find('.');
-        if (pos == std::string_view::npos)
-        {
-            return 0.0;
-        }
-        const int decimals = static_cast<int>(priceStr.size() - pos - 1);
-        if (decimals <= 0 || decimals > 12) return 0.0;
-        return std::pow(10.0, -decimals);
-    };
-
-    auto parseNumber = [](const json& value) -> double {
-        if (value.is_string())
-        {
-            return std::atof(value.get<std::string>().c_str());
-        }
-        if (value.is_number())
-        {
-            return value.get<double>();
-        }
-        return 0.0;
-    };
+    BookPipeline pipeline(config, book);
 
     const std::size_t maxLevelsPerSide =
         std::max<std::size_t>(1, config.ladderLevelsPerSide);
-    auto parseSide = [&](const json& side, double& dynamicTickSize) {
-        std::vector<std::pair<dom::OrderBook::Tick, double>> out;
-        if (!side.is_array()) return out;
-        std::size_t kept = 0;
-        for (const auto& lvl : side)
-        {
-            if (!lvl.is_array() || lvl.size() < 2) continue;
-            const std::string priceStr =
-                lvl[0].is_string() ? lvl[0].get<std::string>() : std::string();
-            const double price = parseNumber(lvl[0]);
-            const double qty = parseNumber(lvl[1]);
-            if (price <= 0.0 || qty <= 0.0) continue;
-            if (dynamicTickSize <= 0.0)
-            {
-                double detected = detectTick(priceStr);
-                if (detected > 0.0)
-                {
-                    dynamicTickSize = detected;
-                    book.setTickSize(dynamicTickSize);
-                }
-            }
-            if (dynamicTickSize <= 0.0) continue;
-            const auto tick = static_cast<dom::OrderBook::Tick>(std::llround(price / dynamicTickSize));
-            out.emplace_back(tick, qty);
-            if (++kept >= maxLevelsPerSide)
-            {
-                break;
-            }
-        }
-        return out;
-    };
-
     std::string fragmentBuffer;
+    std::string assembled; // reassembled fragments, kept across frames for its capacity
+
 
     for (;;)
     {
+        if (symbolSwitchPending())
+        {
+            std::cerr << "[backend] leaving UZX stream for symbol switch" << std::endl;
+            break;
+        }
         DWORD received = 0;
         WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
         HRESULT hr =
@@ -4958,6 +6250,7 @@ bool runUzxWebSocket(const Config& config, dom::OrderBook& book, double tickSize
             std::cerr << "[backend] UZX ws receive failed: " << std::hex << hr << std::dec << std::endl;
             break;
         }
+        noteFrameReceived(received);
         if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
         {
             std::cerr << "[backend] UZX ws closed by server\n";
@@ -4985,15 +6278,13 @@ bool runUzxWebSocket(const Config& config, dom::OrderBook& book, double tickSize
             continue;
         }
 
-        std::string message;
+        std::string_view message = chunk;
         if (!fragmentBuffer.empty())
         {
             fragmentBuffer.append(chunk.data(), chunk.size());
-            message.swap(fragmentBuffer);
-        }
-        else
-        {
-            message.assign(chunk);
+            assembled.swap(fragmentBuffer);
+            fragmentBuffer.clear();
+            message = assembled;
         }
 
         if (message.empty())
@@ -5001,7 +6292,18 @@ bool runUzxWebSocket(const Config& config, dom::OrderBook& book, double tickSize
             continue;
         }
 
-        auto processJson = [&](const std::string& text) {
+        // Depth frames are decoded from the text once the tick size is known; the first one
+        // (tick size detection), fills, pings and acks go through json.
+        {
+            auto depth = frameDepth();
+            if (dom::feed::decodeUzxDepth(message, tickSize, maxLevelsPerSide, depth))
+            {
+                pipeline.push(depth, true);
+                continue;
+            }
+        }
+
+        auto processJson = [&](std::string_view text) {
             static const bool debugUzx = []() {
                 const char* v = std::getenv("BACKEND_DEBUG_UZX");
                 return v && *v && std::string(v) != "0";
@@ -5031,125 +6333,32 @@ bool runUzxWebSocket(const Config& config, dom::OrderBook& book, double tickSize
                                      static_cast<DWORD>(pongStr.size()));
                 return;
             }
-            auto isFillsType = [](const std::string &t) {
-                return t.find("fills") != std::string::npos;
-            };
-            auto emitFill = [&](const json &fill, long long parentTs) {
-                if (!fill.is_object()) {
-                    return;
-                }
-                const double price = parseNumber(fill.value("price", json(0.0)));
-                const double qtyBase = parseNumber(fill.value("vol", json(0.0)));
-                if (price <= 0.0 || qtyBase <= 0.0) {
-                    return;
-                }
-                json t;
-                t["type"] = "trade";
-                t["symbol"] = config.symbol;
-                dom::OrderBook::Tick tick = 0;
-                double snappedPrice = price;
-                if (quantizeTickFromPrice(price, tickSize, tick, snappedPrice)) {
-                    t["tick"] = tick;
-                    t["price"] = snappedPrice;
-                } else {
-                    t["price"] = price;
-                }
-                t["qty"] = qtyBase;
-                const std::string side = fill.value("direction", std::string("buy"));
-                t["side"] = (side == "sell") ? "sell" : "buy";
-                const long long ts = fill.value("ts", parentTs);
-                t["timestamp"] = ts;
-                tradeBatcher().add(config.symbol, std::move(t));
-            };
-            const std::string topType = j.value("type", std::string());
-            if (isFillsType(topType)) {
-                const long long parentTs = j.value("ts", 0LL);
-                const json data = j.value("data", json::object());
-                if (data.is_array()) {
-                    for (const auto &entry : data) {
-                        if (entry.is_object() && entry.contains("data")) {
-                            const json nested = entry.value("data", json::array());
-                            if (nested.is_array()) {
-                                for (const auto &fill : nested) {
-                                    emitFill(fill, parentTs);
-                                }
-                                continue;
-                            }
-                        }
-                        emitFill(entry, parentTs);
-                    }
-                } else if (data.is_object()) {
-                    if (data.contains("data") && data.value("data", json::array()).is_array()) {
-                        for (const auto &fill : data.value("data", json::array())) {
-                            emitFill(fill, parentTs);
-                        }
+            auto depth = frameDepth();
+            auto fills = frameTrades();
+            if (dom::feed::parseUzxFrame(j, tickSize, maxLevelsPerSide, depth, fills) == dom::feed::UzxFrame::Fills)
+            {
+                for (const auto &fill : fills)
+                {
+                    json t;
+                    t["type"] = "trade";
+                    t["symbol"] = config.symbol;
+                    dom::OrderBook::Tick tick = 0;
+                    double snappedPrice = fill.price;
+                    if (quantizeTickFromPrice(fill.price, tickSize, tick, snappedPrice)) {
+                        t["tick"] = tick;
+                        t["price"] = snappedPrice;
                     } else {
-                        emitFill(data, parentTs);
-                    }
-                }
-                return;
-            }
-            const json maybeData = j.value("data", json::object());
-            if (maybeData.is_object() && isFillsType(maybeData.value("type", std::string()))) {
-                const long long parentTs = j.value("ts", 0LL);
-                const json nested = maybeData.value("data", json::array());
-                if (nested.is_array()) {
-                    for (const auto &fill : nested) {
-                        emitFill(fill, parentTs);
+                        t["price"] = fill.price;
                     }
-                } else {
-                    emitFill(maybeData, parentTs);
+                    t["qty"] = fill.qty;
+                    t["side"] = fill.buy ? "buy" : "sell";
+                    t["timestamp"] = fill.timeMs;
+                    tradeBatcher().add(config.symbol, std::move(t));
                 }
                 return;
             }
-            if (maybeData.is_array()) {
-                const long long parentTs = j.value("ts", 0LL);
-                for (const auto &entry : maybeData) {
-                    if (entry.is_object() && isFillsType(entry.value("type", std::string()))) {
-                        const json nested = entry.value("data", json::array());
-                        if (nested.is_array()) {
-                            for (const auto &fill : nested) {
-                                emitFill(fill, parentTs);
-                            }
-                        } else {
-                            emitFill(entry, parentTs);
-                        }
-                        return;
-                    }
-                }
-            }
-            const json* dataPtr = nullptr;
-            const auto dataIt = j.find("data");
-            if (dataIt != j.end() && dataIt->is_object())
-            {
-                dataPtr = &(*dataIt);
-            }
-            const json& data = dataPtr ? *dataPtr : j;
-            const json bidsSide = data.contains("bids") ? data["bids"]
-                               : data.contains("b") ? data["b"]
-                                                    : json::array();
-            const json asksSide = data.contains("asks") ? data["asks"]
-                               : data.contains("a") ? data["a"]
-                                                    : json::array();
-            const auto bids = parseSide(bidsSide, tickSize);
-            const auto asks = parseSide(asksSide, tickSize);
-            if (book.tickSize() <= 0.0 && tickSize > 0.0)
-            {
-                book.setTickSize(tickSize);
-            }
-            {
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                book.loadSnapshot(bids, asks);
-                const auto now = std::chrono::steady_clock::now();
-                if (now - lastEmit >= config.throttle)
-                {
-                    lastEmit = now;
-                    const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                           std::chrono::system_clock::now().time_since_epoch())
-                                           .count();
-                    emitLadder(config, book, book.bestBid(), book.bestAsk(), nowMs);
-                }
-            }
+            // A tick size first detected from the depth prices reaches the book with the frame.
+            pipeline.push(depth, true, tickSize);
         };
 
         try
@@ -5166,9 +6375,24 @@ bool runUzxWebSocket(const Config& config, dom::OrderBook& book, double tickSize
     return true;
 }
 
+// Paradex channels name their market second ("order_book.BTC-USD-PERP.snapshot@15@50ms",
+// "trades.BTC-USD-PERP"); frames still in flight for a market the feed left are dropped.
+bool paradexChannelIs(std::string_view channel, const std::string& symbol)
+{
+    const auto start = channel.find('.');
+    if (start == std::string_view::npos)
+    {
+        return true;
+    }
+    const auto market = channel.substr(start + 1, channel.find('.', start + 1) - start - 1);
+    return market == symbol;
+}
+
 #if defined(ORDERBOOK_BACKEND_QT)
-bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
+bool runParadexWebSocketQt(const Config& baseConfig, dom::OrderBook& book)
 {
+    // Mutable copy: a `subscribe` control command re-targets this socket to another market.
+    Config config = baseConfig;
     if (!shouldUseQtSocks5(config))
     {
         return false;
@@ -5189,9 +6413,9 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
     // Paradex order book channels support a maximum depth of 15 levels.
     // Avoid probing other depths (200/100/...) to reduce connect spam and latency.
     static constexpr std::size_t kParadexBookDepth = 15;
-    auto makeBookChannel = [&](std::size_t depth) {
+    auto makeBookChannel = [&](const std::string& symbol, std::size_t depth) {
         std::string ch =
-            "order_book." + config.symbol + "." + config.paradexFeedType + "@" + std::to_string(depth) + "@" +
+            "order_book." + symbol + "." + config.paradexFeedType + "@" + std::to_string(depth) + "@" +
             config.paradexRefreshRate;
         if (!config.paradexPriceTick.empty())
         {
@@ -5199,14 +6423,66 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
         }
         return ch;
     };
-    std::string bookChannel = makeBookChannel(kParadexBookDepth);
-    const std::string tradesChannel = "trades." + config.symbol;
+    std::string bookChannel = makeBookChannel(config.symbol, kParadexBookDepth);
+    std::string tradesChannel = "trades." + config.symbol;
 
     QWebSocket ws;
     ws.setProxy(proxy);
 
     bool gotAnyData = false;
     bool gotAnyBook = false;
+    bool subscribed = false;
+
+    auto sendRpc = [&](const char* method, const std::string& ch, int id) {
+        json msg = {{"id", id}, {"jsonrpc", "2.0"}, {"method", method}, {"params", {{"channel", ch}}}};
+        return ws.sendTextMessage(QString::fromStdString(msg.dump())) > 0;
+    };
+    BookPipeline pipeline(config, book, true);
+
+    // Re-target the open socket: swap channel subscriptions, then load the new book.
+    // On failure main() redoes the full startup.
+    auto switchSymbolInPlace = [&]() -> bool {
+        std::string nextSymbol;
+        if (!peekSymbolSwitch(nextSymbol))
+        {
+            return true;
+        }
+        Config next = config;
+        next.symbol = nextSymbol;
+        const std::string nextBookChannel = makeBookChannel(next.symbol, kParadexBookDepth);
+        const std::string nextTradesChannel = "trades." + next.symbol;
+        std::cerr << "[backend] paradex switching " << config.symbol << " -> " << nextSymbol << " on open socket\n";
+        if (!sendRpc("unsubscribe", bookChannel, 3) || !sendRpc("unsubscribe", tradesChannel, 4) ||
+            !sendRpc("subscribe", nextBookChannel, 5) || !sendRpc("subscribe", nextTradesChannel, 6))
+        {
+            return false;
+        }
+        double nextTickSize = 0.0;
+        if (!fetchParadexMarketInfo(next, nextTickSize))
+        {
+            return false;
+        }
+        LevelVector bids;
+        LevelVector asks;
+        if (!fetchParadexOrderBookSnapshot(next, nextTickSize, bids, asks))
+        {
+            std::cerr << "[backend] paradex switch: snapshot failed, waiting for the stream\n";
+        }
+        std::uint64_t generation = 0;
+        if (!takeSymbolSwitchFor(next.symbol, generation))
+        {
+            // Superseded while we were fetching: restore the channels, the newer request runs next.
+            return sendRpc("unsubscribe", nextBookChannel, 7) && sendRpc("unsubscribe", nextTradesChannel, 8) &&
+                   sendRpc("subscribe", bookChannel, 9) && sendRpc("subscribe", tradesChannel, 10);
+        }
+        config = next;
+        bookChannel = nextBookChannel;
+        tradesChannel = nextTradesChannel;
+        pipeline.retarget(config);
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        loadSwitchedSymbolLocked(config, book, generation, nextTickSize, bids, asks);
+        return true;
+    };
 
     QEventLoop loop;
     QTimer watchdog;
@@ -5216,15 +6492,22 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
         ws.close();
         loop.quit();
     });
+    QTimer switchPoll;
+    switchPoll.start(100);
+    QObject::connect(&switchPoll, &QTimer::timeout, &loop, [&]() {
+        if (symbolSwitchPending() && subscribed && !switchSymbolInPlace())
+        {
+            std::cerr << "[backend] leaving Paradex stream for symbol switch\n";
+            ws.close();
+            loop.quit();
+        }
+    });
 
     QObject::connect(&ws, &QWebSocket::connected, &loop, [&]() {
         watchdog.start(20000);
-        auto sendSub = [&](const std::string& ch, int id) {
-            json sub = {{"id", id}, {"jsonrpc", "2.0"}, {"method", "subscribe"}, {"params", {{"channel", ch}}}};
-            ws.sendTextMessage(QString::fromStdString(sub.dump()));
-        };
-        sendSub(bookChannel, 1);
-        sendSub(tradesChannel, 2);
+        sendRpc("subscribe", bookChannel, 1);
+        sendRpc("subscribe", tradesChannel, 2);
+        subscribed = true;
         std::cerr << "[backend] paradex subscribed (Qt): " << bookChannel << " | " << tradesChannel << "\n";
     });
 
@@ -5249,15 +6532,33 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
         tradeBatcher().add(config.symbol, std::move(t));
     };
 
-    auto lastEmit = std::chrono::steady_clock::now();
+    auto applyBook = [&](const dom::feed::DepthUpdate& depth) {
+        noteExchangeTime(depth.eventTimeMs);
+        pipeline.push(depth, true);
+    };
 
     QObject::connect(&ws, &QWebSocket::textMessageReceived, &loop, [&](const QString& msg) {
         watchdog.start(20000);
+        noteFrameReceived(static_cast<std::size_t>(msg.size()));
         gotAnyData = true;
+        const std::string text = msg.toStdString();
+        {
+            auto depth = frameDepth();
+            std::string_view channel;
+            if (dom::feed::decodeParadexOrderBook(text, book.tickSize(), depth, channel))
+            {
+                gotAnyBook = true;
+                if (paradexChannelIs(channel, config.symbol))
+                {
+                    applyBook(depth);
+                }
+                return;
+            }
+        }
         json j;
         try
         {
-            j = json::parse(msg.toStdString());
+            j = json::parse(text);
         }
         catch (...)
         {
@@ -5271,83 +6572,39 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
         const json params = j.value("params", json::object());
         const std::string channel = params.value("channel", std::string());
         const json data = params.value("data", json::object());
-        if (!data.is_object())
+        if (!data.is_object() || !paradexChannelIs(channel, config.symbol))
         {
             return;
         }
 
         if (channel.rfind("order_book.", 0) == 0)
         {
-            const json arr = data.value("inserts", json::array());
-            if (!arr.is_array())
+            const auto insertsIt = data.find("inserts");
+            if (insertsIt == data.end() || !insertsIt->is_array())
             {
                 return;
             }
             gotAnyBook = true;
-            std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-            std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
-            bids.reserve(arr.size());
-            asks.reserve(arr.size());
-            const double tickSize = book.tickSize();
-            for (const auto& e : arr)
-            {
-                if (!e.is_object()) continue;
-                const std::string side = e.value("side", std::string());
-                const std::string p = e.value("price", std::string());
-                const std::string s = e.value("size", std::string());
-                double price = 0.0;
-                double qty = 0.0;
-                try
-                {
-                    price = std::stod(p);
-                    qty = std::stod(s);
-                }
-                catch (...)
-                {
-                    continue;
-                }
-                if (!(price > 0.0) || !(qty >= 0.0)) continue;
-                const auto tick = tickFromPrice(price, tickSize);
-                if (side == "BUY") bids.emplace_back(tick, qty);
-                else if (side == "SELL") asks.emplace_back(tick, qty);
-            }
-
-            const auto now = std::chrono::steady_clock::now();
-            std::lock_guard<std::mutex> lock(g_bookMutex);
-            book.loadSnapshot(bids, asks);
-            if (now - lastEmit >= config.throttle)
-            {
-                lastEmit = now;
-                std::int64_t ts = data.value("last_updated_at", 0LL);
-                if (ts <= 0)
-                {
-                    ts = std::chrono::duration_cast<std::chrono::milliseconds>(
-                             std::chrono::system_clock::now().time_since_epoch())
-                             .count();
-                }
-                emitLadder(config, book, book.bestBid(), book.bestAsk(), ts);
-            }
+            auto depth = frameDepth();
+            dom::feed::parseParadexOrderBook(data, book.tickSize(), depth);
+            applyBook(depth);
             return;
         }
 
         if (channel.rfind("trades.", 0) == 0)
         {
-            const double price = data.contains("price") ? jsonToDouble(data["price"]) : 0.0;
-            const double qty = data.contains("size") ? jsonToDouble(data["size"]) : 0.0;
-            if (!(price > 0.0) || !(qty > 0.0))
+            dom::feed::Trade trade;
+            if (!dom::feed::parseParadexTrade(data, trade))
             {
                 return;
             }
-            const std::string side = data.value("side", std::string());
-            const bool isBuy = (side == "BUY");
-            std::int64_t ts = data.value("created_at", 0LL);
-            if (ts <= 0)
+            if (trade.timeMs <= 0)
             {
-                ts = std::chrono::duration_cast<std::chrono::milliseconds>(
-                         std::chrono::system_clock::now().time_since_epoch())
-                         .count();
+                trade.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
             }
-            emitTrade(price, qty, isBuy, ts);
+            emitTrade(trade.price, trade.qty, trade.buy, trade.timeMs);
         }
     });
 
@@ -5356,6 +6613,10 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
     watchdog.start(12000);
     ws.open(url);
     loop.exec();
+    if (symbolSwitchPending())
+    {
+        return true;
+    }
     // If Qt path couldn't receive any data, allow falling back to WinHTTP.
     // This helps when the user selected SOCKS5 but the proxy endpoint is actually an HTTP CONNECT proxy.
     if (!gotAnyData || !gotAnyBook)
@@ -5367,11 +6628,19 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
 }
 #endif
 
-[[noreturn]] void runParadexWebSocket(const Config& config, dom::OrderBook& book)
+// Symbol switches re-subscribe on the open socket; returns only when one could not be done there,
+// so main() redoes the startup. A stream that ends on its own is fatal.
+void runParadexWebSocket(const Config& baseConfig, dom::OrderBook& book)
 {
+    // Mutable copy: a `subscribe` control command re-targets this socket to another market.
+    Config config = baseConfig;
 #if defined(ORDERBOOK_BACKEND_QT)
     if (runParadexWebSocketQt(config, book))
     {
+        if (symbolSwitchPending())
+        {
+            return;
+        }
         throw std::runtime_error("paradex ws exited (qt)");
     }
 #endif
@@ -5436,9 +6705,9 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
 
     // Paradex order book channels support a maximum depth of 15 levels.
     static constexpr std::size_t kParadexBookDepth = 15;
-    auto makeBookChannel = [&](std::size_t depth) {
+    auto makeBookChannel = [&](const std::string& symbol, std::size_t depth) {
         std::string ch =
-            "order_book." + config.symbol + "." + config.paradexFeedType + "@" + std::to_string(depth) + "@" +
+            "order_book." + symbol + "." + config.paradexFeedType + "@" + std::to_string(depth) + "@" +
             config.paradexRefreshRate;
         if (!config.paradexPriceTick.empty())
         {
@@ -5446,25 +6715,31 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
         }
         return ch;
     };
-    std::string bookChannel = makeBookChannel(kParadexBookDepth);
-    const std::string tradesChannel = "trades." + config.symbol;
-
-    auto sendSub = [&](const std::string& ch, int id) {
-        json sub = {{"id", id}, {"jsonrpc", "2.0"}, {"method", "subscribe"}, {"params", {{"channel", ch}}}};
-        const std::string subStr = sub.dump();
-        WinHttpWebSocketSend(rawSocket,
-                             WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
-                             (void*)subStr.data(),
-                             static_cast<DWORD>(subStr.size()));
+    std::string bookChannel = makeBookChannel(config.symbol, kParadexBookDepth);
+    std::string tradesChannel = "trades." + config.symbol;
+
+    auto sendRpc = [&](const char* method, const std::string& ch, int id) {
+        json msg = {{"id", id}, {"jsonrpc", "2.0"}, {"method", method}, {"params", {{"channel", ch}}}};
+        const std::string payload = msg.dump();
+        return WinHttpWebSocketSend(rawSocket,
+                                    WINHTTP_WEB_SOCKET_UTF8_MESSAGE_BUFFER_TYPE,
+                                    (void*)payload.data(),
+                                    static_cast<DWORD>(payload.size())) == S_OK;
     };
-    sendSub(bookChannel, 1);
-    sendSub(tradesChannel, 2);
+    sendRpc("subscribe", bookChannel, 1);
+    sendRpc("subscribe", tradesChannel, 2);
     std::cerr << "[backend] paradex subscribed: " << bookChannel << " | " << tradesChannel << "\n";
 
     std::vector<unsigned char> buffer(256 * 1024);
     std::string textBuffer;
     textBuffer.reserve(16 * 1024);
-    auto lastEmit = std::chrono::steady_clock::now();
+    std::string assembled; // reassembled fragments, kept across frames for its capacity
+    BookPipeline pipeline(config, book, true);
+
+    auto applyBook = [&](const dom::feed::DepthUpdate& depth) {
+        noteExchangeTime(depth.eventTimeMs);
+        pipeline.push(depth, true);
+    };
 
     auto emitTrade = [&](double price, double qty, bool isBuy, std::int64_t ts) {
         json t;
@@ -5477,8 +6752,59 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
         tradeBatcher().add(config.symbol, std::move(t));
     };
 
+    // Re-target the open socket: swap channel subscriptions, then load the new book.
+    // On failure the caller drops the socket and main() redoes the full startup.
+    auto switchSymbolInPlace = [&]() -> bool {
+        std::string nextSymbol;
+        if (!peekSymbolSwitch(nextSymbol))
+        {
+            return true;
+        }
+        Config next = config;
+        next.symbol = nextSymbol;
+        const std::string nextBookChannel = makeBookChannel(next.symbol, kParadexBookDepth);
+        const std::string nextTradesChannel = "trades." + next.symbol;
+        std::cerr << "[backend] paradex switching " << config.symbol << " -> " << nextSymbol << " on open socket"
+                  << std::endl;
+        if (!sendRpc("unsubscribe", bookChannel, 3) || !sendRpc("unsubscribe", tradesChannel, 4) ||
+            !sendRpc("subscribe", nextBookChannel, 5) || !sendRpc("subscribe", nextTradesChannel, 6))
+        {
+            return false;
+        }
+        double nextTickSize = 0.0;
+        if (!fetchParadexMarketInfo(next, nextTickSize))
+        {
+            return false;
+        }
+        LevelVector bids;
+        LevelVector asks;
+        if (!fetchParadexOrderBookSnapshot(next, nextTickSize, bids, asks))
+        {
+            std::cerr << "[backend] paradex switch: snapshot failed, waiting for the stream\n";
+        }
+        std::uint64_t generation = 0;
+        if (!takeSymbolSwitchFor(next.symbol, generation))
+        {
+            // Superseded while we were fetching: restore the channels, the newer request runs next frame.
+            return sendRpc("unsubscribe", nextBookChannel, 7) && sendRpc("unsubscribe", nextTradesChannel, 8) &&
+                   sendRpc("subscribe", bookChannel, 9) && sendRpc("subscribe", tradesChannel, 10);
+        }
+        config = next;
+        bookChannel = nextBookChannel;
+        tradesChannel = nextTradesChannel;
+        pipeline.retarget(config);
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        loadSwitchedSymbolLocked(config, book, generation, nextTickSize, bids, asks);
+        return true;
+    };
+
     for (;;)
     {
+        if (symbolSwitchPending() && !switchSymbolInPlace())
+        {
+            std::cerr << "[backend] leaving Paradex stream for symbol switch" << std::endl;
+            break;
+        }
         DWORD received = 0;
         WINHTTP_WEB_SOCKET_BUFFER_TYPE type;
         HRESULT hr =
@@ -5488,6 +6814,7 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
             std::cerr << "[backend] paradex ws receive failed: " << std::hex << hr << std::dec << "\n";
             break;
         }
+        noteFrameReceived(received);
         if (type == WINHTTP_WEB_SOCKET_CLOSE_BUFFER_TYPE)
         {
             std::cerr << "[backend] paradex ws closed by server\n";
@@ -5515,16 +6842,27 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
             continue;
         }
 
-        std::string text;
+        std::string_view text(reinterpret_cast<const char*>(buffer.data()), received);
         if (!textBuffer.empty())
         {
-            textBuffer.append(reinterpret_cast<const char*>(buffer.data()), received);
-            text.swap(textBuffer);
+            textBuffer.append(text.data(), text.size());
+            assembled.swap(textBuffer);
             textBuffer.clear();
+            text = assembled;
         }
-        else
+
+        // Order book frames are decoded from the text; everything else goes through json.
         {
-            text.assign(reinterpret_cast<const char*>(buffer.data()), received);
+            auto depth = frameDepth();
+            std::string_view channel;
+            if (dom::feed::decodeParadexOrderBook(text, book.tickSize(), depth, channel))
+            {
+                if (paradexChannelIs(channel, config.symbol))
+                {
+                    applyBook(depth);
+                }
+                continue;
+            }
         }
 
         json j;
@@ -5545,298 +6883,762 @@ bool runParadexWebSocketQt(const Config& config, dom::OrderBook& book)
         const json params = j.value("params", json::object());
         const std::string channel = params.value("channel", std::string());
         const json data = params.value("data", json::object());
-        if (!data.is_object())
+        if (!data.is_object() || !paradexChannelIs(channel, config.symbol))
         {
             continue;
         }
 
         if (channel.rfind("order_book.", 0) == 0)
         {
-            const json arr = data.value("inserts", json::array());
-            if (!arr.is_array())
+            const auto insertsIt = data.find("inserts");
+            if (insertsIt == data.end() || !insertsIt->is_array())
             {
                 continue;
             }
-            std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-            std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
-            bids.reserve(arr.size());
-            asks.reserve(arr.size());
-            const double tickSize = book.tickSize();
-            for (const auto& e : arr)
-            {
-                if (!e.is_object()) continue;
-                const std::string side = e.value("side", std::string());
-                const std::string p = e.value("price", std::string());
-                const std::string s = e.value("size", std::string());
-                double price = 0.0;
-                double qty = 0.0;
-                try
-                {
-                    price = std::stod(p);
-                    qty = std::stod(s);
-                }
-                catch (...)
-                {
-                    continue;
-                }
-                if (!(price > 0.0) || !(qty >= 0.0)) continue;
-                const auto tick = tickFromPrice(price, tickSize);
-                if (side == "BUY") bids.emplace_back(tick, qty);
-                else if (side == "SELL") asks.emplace_back(tick, qty);
-            }
-
-            const auto now = std::chrono::steady_clock::now();
-            std::lock_guard<std::mutex> lock(g_bookMutex);
-            book.loadSnapshot(bids, asks);
-            if (now - lastEmit >= config.throttle)
-            {
-                lastEmit = now;
-                std::int64_t ts = data.value("last_updated_at", 0LL);
-                if (ts <= 0)
-                {
-                    ts = std::chrono::duration_cast<std::chrono::milliseconds>(
-                             std::chrono::system_clock::now().time_since_epoch())
-                             .count();
-                }
-                emitLadder(config, book, book.bestBid(), book.bestAsk(), ts);
-            }
+            auto depth = frameDepth();
+            dom::feed::parseParadexOrderBook(data, book.tickSize(), depth);
+            applyBook(depth);
             continue;
         }
 
         if (channel.rfind("trades.", 0) == 0)
         {
-            const double price = data.contains("price") ? jsonToDouble(data["price"]) : 0.0;
-            const double qty = data.contains("size") ? jsonToDouble(data["size"]) : 0.0;
-            if (!(price > 0.0) || !(qty > 0.0))
+            dom::feed::Trade trade;
+            if (!dom::feed::parseParadexTrade(data, trade))
             {
                 continue;
             }
-            const std::string side = data.value("side", std::string());
-            const bool isBuy = (side == "BUY");
-            std::int64_t ts = data.value("created_at", 0LL);
-            if (ts <= 0)
+            if (trade.timeMs <= 0)
             {
-                ts = std::chrono::duration_cast<std::chrono::milliseconds>(
-                         std::chrono::system_clock::now().time_since_epoch())
-                         .count();
+                trade.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
             }
-            emitTrade(price, qty, isBuy, ts);
+            emitTrade(trade.price, trade.qty, trade.buy, trade.timeMs);
         }
     }
 
     WinHttpCloseHandle(rawSocket);
+    if (symbolSwitchPending())
+    {
+        return;
+    }
     throw std::runtime_error("paradex ws closed");
 }
 
-int main(int argc, char** argv)
+// Resolves market metadata, loads the initial book and runs the venue stream for `cfg.symbol`.
+// Returns when the stream ends (disconnect, fatal error or a pending symbol switch).
+int runExchange(Config& cfg, dom::OrderBook& book)
 {
-#if defined(ORDERBOOK_BACKEND_QT)
-    QCoreApplication qtApp(argc, argv);
-#endif
-    try
+    if (cfg.exchange == "mexc")
     {
-        auto cfg = parseArgs(argc, argv);
-        std::cerr << "[backend] protocol=2 tickQuant=scaled" << std::endl;
-        if (!cfg.winProxy.empty())
+        std::cerr << "[backend] starting MEXC spot depth for " << cfg.symbol << std::endl;
+        double tickSize = 0.0;
+        if (!fetchExchangeInfo(cfg, tickSize))
         {
-            std::cerr << "[backend] proxy enabled: type=" << cfg.proxyType
-                      << " auth=" << (cfg.proxyUser.empty() ? "0" : "1") << std::endl;
+            std::cerr << "[backend] failed to determine tick size, exiting" << std::endl;
+            return 1;
         }
-        dom::OrderBook book;
-        book.setCacheLevelsPerSide(cfg.cacheLevelsPerSide);
-        std::thread(heartbeatThread).detach();
-        std::thread(controlReaderThread).detach();
+        book.setTickSize(tickSize);
 
-        if (cfg.exchange == "mexc")
+        LevelVector bids;
+        LevelVector asks;
+        if (fetchSnapshot(cfg, tickSize, bids, asks))
         {
-            std::cerr << "[backend] starting MEXC spot depth for " << cfg.symbol << std::endl;
-            double tickSize = 0.0;
-            if (!fetchExchangeInfo(cfg, tickSize))
-            {
-                std::cerr << "[backend] failed to determine tick size, exiting" << std::endl;
-                return 1;
-            }
-            book.setTickSize(tickSize);
-
-            if (!fetchSnapshot(cfg, book))
-            {
-                std::cerr << "[backend] snapshot failed, continuing with empty book" << std::endl;
-            }
-            if (book.tickSize() > 0.0 && book.bestBid() > 0.0 && book.bestAsk() > 0.0)
-            {
-                const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       std::chrono::system_clock::now().time_since_epoch())
-                                       .count();
-                emitLadder(cfg, book, book.bestBid(), book.bestAsk(), nowMs);
-            }
-            {
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                g_bookPtr = &book;
-                g_activeConfig = cfg;
-            }
-            g_bookReady.store(true);
-            if (cfg.mexcSpotMode == "rest")
-            {
-                runMexcSpotPolling(cfg, book);
-            }
-            else
-            {
-                // Default: protobuf WebSocket market streams (the official MEXC spot WS is protobuf-only).
-                // REST polling remains as a fallback mode for problematic networks.
-                runWebSocket(cfg, book);
-            }
-            return 0;
+            book.loadSnapshot(bids, asks);
         }
-        else if (cfg.exchange == "mexc_futures")
+        else
         {
-            std::cerr << "[backend] starting MEXC futures depth for " << cfg.symbol << std::endl;
-            double tickSize = 0.0;
-            double contractSize = 1.0;
-            if (!fetchFuturesContractInfo(cfg, tickSize, contractSize))
-            {
-                std::cerr << "[backend] failed to determine futures tick size, exiting" << std::endl;
-                return 1;
-            }
-            cfg.futuresContractSize = contractSize;
-            book.setTickSize(tickSize);
-            if (!fetchFuturesSnapshot(cfg, book, contractSize))
-            {
-                std::cerr << "[backend] futures snapshot failed, continuing with empty book" << std::endl;
-            }
-            if (book.tickSize() > 0.0 && book.bestBid() > 0.0 && book.bestAsk() > 0.0)
-            {
-                const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       std::chrono::system_clock::now().time_since_epoch())
-                                       .count();
-                emitLadder(cfg, book, book.bestBid(), book.bestAsk(), nowMs);
-            }
-            {
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                g_bookPtr = &book;
-                g_activeConfig = cfg;
+            std::cerr << "[backend] snapshot failed, continuing with empty book" << std::endl;
+        }
+        if (book.tickSize() > 0.0 && book.bestBid() > 0.0 && book.bestAsk() > 0.0)
+        {
+            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            emitLadder(cfg, book, book.bestBid(), book.bestAsk(), nowMs);
+        }
+        publishActiveBook(cfg, book);
+        if (cfg.mexcSpotMode == "rest")
+        {
+            runMexcSpotPolling(cfg, book);
+        }
+        else
+        {
+            // Default: protobuf WebSocket market streams (the official MEXC spot WS is protobuf-only).
+            // REST polling remains as a fallback mode for problematic networks.
+            runWebSocket(cfg, book);
+        }
+        return 0;
+    }
+    else if (cfg.exchange == "mexc_futures")
+    {
+        std::cerr << "[backend] starting MEXC futures depth for " << cfg.symbol << std::endl;
+        double tickSize = 0.0;
+        double contractSize = 1.0;
+        if (!fetchFuturesContractInfo(cfg, tickSize, contractSize))
+        {
+            std::cerr << "[backend] failed to determine futures tick size, exiting" << std::endl;
+            return 1;
+        }
+        cfg.futuresContractSize = contractSize;
+        book.setTickSize(tickSize);
+        LevelVector bids;
+        LevelVector asks;
+        if (fetchFuturesSnapshot(cfg, tickSize, contractSize, bids, asks))
+        {
+            book.loadSnapshot(bids, asks);
+        }
+        else
+        {
+            std::cerr << "[backend] futures snapshot failed, continuing with empty book" << std::endl;
+        }
+        if (book.tickSize() > 0.0 && book.bestBid() > 0.0 && book.bestAsk() > 0.0)
+        {
+            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            emitLadder(cfg, book, book.bestBid(), book.bestAsk(), nowMs);
+        }
+        publishActiveBook(cfg, book);
+        runMexcFuturesWebSocket(cfg, book);
+    }
+    else if (cfg.exchange == "binance" || cfg.exchange == "binance_futures")
+    {
+        const bool futures = cfg.exchange == "binance_futures";
+        std::cerr << "[backend] starting Binance " << (futures ? "futures" : "spot")
+                  << " depth for " << cfg.symbol << std::endl;
+        double tickSize = 0.0;
+        const bool tickOk = futures ? fetchBinanceExchangeInfoFutures(cfg, tickSize)
+                                    : fetchBinanceExchangeInfoSpot(cfg, tickSize);
+        if (!tickOk)
+        {
+            std::cerr << "[backend] failed to determine tick size, exiting" << std::endl;
+            return 1;
+        }
+        book.setTickSize(tickSize);
+        BinanceDepthSnapshot snap;
+        const bool snapshotOk =
+            futures ? fetchBinanceSnapshotFutures(cfg, tickSize, snap)
+                    : fetchBinanceSnapshotSpot(cfg, tickSize, snap);
+        if (!snapshotOk)
+        {
+            std::cerr << "[backend] snapshot failed, continuing with empty book" << std::endl;
+        }
+        else
+        {
+            book.loadSnapshot(snap.bids, snap.asks);
+        }
+        if (book.tickSize() > 0.0 && book.bestBid() > 0.0 && book.bestAsk() > 0.0)
+        {
+            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            emitLadder(cfg, book, book.bestBid(), book.bestAsk(), nowMs);
+        }
+        publishActiveBook(cfg, book);
+        runBinanceWebSocket(cfg, book, futures, snap.lastUpdateId);
+    }
+    else if (cfg.exchange == "lighter")
+    {
+        std::cerr << "[backend] starting Lighter depth for " << cfg.symbol << std::endl;
+        int marketId = -1;
+        double tickSize = 0.0;
+        int attempts = 0;
+        while (!fetchLighterMarketInfo(cfg, marketId, tickSize))
+        {
+            attempts++;
+            const int capped = std::min(attempts, 8);
+            const int delayMs = std::min(30000, 350 * (1 << capped));
+            std::cerr << "[backend] lighter: failed to resolve market_id/tickSize (attempt "
+                      << attempts << "), retrying in " << delayMs << "ms" << std::endl;
+            std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+        }
+        if (tickSize > 0.0 && book.tickSize() <= 0.0)
+        {
+            book.setTickSize(tickSize);
+        }
+        publishActiveBook(cfg, book);
+        runLighterWebSocket(cfg, book, marketId);
+    }
+    else if (cfg.exchange == "paradex")
+    {
+        std::cerr << "[backend] starting Paradex depth for " << cfg.symbol << std::endl;
+        double tickSize = 0.0;
+        if (!fetchParadexMarketInfo(cfg, tickSize))
+        {
+            std::cerr << "[backend] paradex: failed to determine tick size, exiting\n";
+            return 1;
+        }
+        book.setTickSize(tickSize);
+
+        LevelVector bids;
+        LevelVector asks;
+        if (fetchParadexOrderBookSnapshot(cfg, tickSize, bids, asks))
+        {
+            book.loadSnapshot(bids, asks);
+        }
+        else
+        {
+            std::cerr << "[backend] paradex snapshot failed, continuing with empty book\n";
+        }
+        if (book.tickSize() > 0.0 && book.bestBid() > 0.0 && book.bestAsk() > 0.0)
+        {
+            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            emitLadder(cfg, book, book.bestBid(), book.bestAsk(), nowMs);
+        }
+        publishActiveBook(cfg, book);
+        runParadexWebSocket(cfg, book);
+    }
+    else
+    {
+        const bool isSwap = cfg.exchange == "uzxswap";
+        std::cerr << "[backend] starting UZX " << (isSwap ? "swap" : "spot") << " depth for " << cfg.symbol
+                  << std::endl;
+        double tickSize = 0.0;
+        publishActiveBook(cfg, book);
+        runUzxWebSocket(cfg, book, tickSize, isSwap);
+    }
+    return 0;
+}
+
+// Venue symbol for a consolidated book: explicit "venue:SYMBOL", else derived from the base asset.
+std::string consolidatedVenueSymbol(const std::string& venue, const std::string& symbol)
+{
+    std::string key = alnumUpperKey(symbol);
+    if (key.size() > 4 && key.ends_with("PERP"))
+    {
+        key.resize(key.size() - 4);
+    }
+    const std::string base = stripQuoteSuffix(key);
+    if (venue == "mexc_futures")
+    {
+        return base + "_USDT";
+    }
+    if (venue == "lighter")
+    {
+        return base;
+    }
+    if (venue == "paradex")
+    {
+        return base + "-USD-PERP";
+    }
+    if (venue == "uzxspot")
+    {
+        return base + "-USDT";
+    }
+    return base + "USDT";
+}
+
+void emitVenueDepthLocked(const Config& cfg, const dom::ConsolidatedBook& consolidated)
+{
+    const auto rows = consolidated.attribution(g_lastWindowMinTick, g_lastWindowMaxTick);
+    json out;
+    out["type"] = "venue_depth";
+    out["symbol"] = cfg.symbol;
+    out["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    out["gen"] = runtime().generation.load(std::memory_order_relaxed);
+    out["tickSize"] = consolidated.gridTick();
+    out["venues"] = consolidated.venueNames();
+    // Columnar like "trades": bid/ask hold one per-venue array per tick.
+    json ticks = json::array();
+    json bids = json::array();
+    json asks = json::array();
+    for (const auto& row : rows)
+    {
+        ticks.push_back(row.tick);
+        bids.push_back(row.bidQuantity);
+        asks.push_back(row.askQuantity);
+    }
+    out["tick"] = std::move(ticks);
+    out["bid"] = std::move(bids);
+    out["ask"] = std::move(asks);
+    stdoutWriter().writeLine(out.dump());
+}
+
+// One process, several venues of the same instrument: every venue runs its usual feed on its own
+// thread and book, and the merged book is streamed as the only ladder.
+int runConsolidated(const Config& cfg)
+{
+    std::vector<std::string> names;
+    std::vector<Config> venueConfigs;
+    for (const auto& entry : cfg.consolidateVenues)
+    {
+        Config venueCfg = cfg;
+        const auto colon = entry.find(':');
+        venueCfg.exchange = toLowerAscii(trimAscii(entry.substr(0, colon)));
+        venueCfg.symbol = (colon == std::string::npos) ? consolidatedVenueSymbol(venueCfg.exchange, cfg.symbol)
+                                                       : trimAscii(entry.substr(colon + 1));
+        venueCfg.snapshotDepth = 0;
+        venueCfg.consolidateVenues.clear();
+        normalizeExchangeConfig(venueCfg, false);
+        names.push_back(venueCfg.exchange);
+        venueConfigs.push_back(std::move(venueCfg));
+        std::cerr << "[backend] consolidated venue " << names.back() << " symbol=" << venueConfigs.back().symbol
+                  << std::endl;
+    }
+    if (venueConfigs.empty())
+    {
+        std::cerr << "[backend] --consolidate needs at least one venue" << std::endl;
+        return 1;
+    }
+
+    dom::ConsolidatedBook consolidated(names, cfg.consolidateGridTick);
+    dom::OrderBook merged;
+    merged.setCacheLevelsPerSide(cfg.cacheLevelsPerSide);
+    if (g_analytics)
+    {
+        g_analytics->attach(merged);
+    }
+    if (g_walls)
+    {
+        g_walls->attach(merged);
+    }
+    if (g_recorder)
+    {
+        g_recorder->setStream("consolidated", cfg.symbol);
+        g_recorder->attach(merged);
+    }
+    std::vector<dom::OrderBook> books(venueConfigs.size());
+    {
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        g_bookPtr = &merged;
+        g_activeConfig = cfg;
+        g_mergedBook = &merged;
+    }
+    tradeBatcher().switchSymbol(cfg.symbol);
+
+    for (std::size_t i = 0; i < venueConfigs.size(); ++i)
+    {
+        books[i].setCacheLevelsPerSide(cfg.cacheLevelsPerSide);
+        consolidated.attach(i, books[i]);
+        std::thread([&venueCfg = venueConfigs[i], &book = books[i]]() {
+            for (;;)
+            {
+                const int rc = runExchange(venueCfg, book);
+                std::cerr << "[backend] consolidated venue " << venueCfg.exchange << " stopped (rc=" << rc
+                          << "), restarting" << std::endl;
+                std::this_thread::sleep_for(std::chrono::seconds(2));
             }
+        }).detach();
+    }
+
+    std::chrono::milliseconds attributionInterval{500};
+    if (const char* ms = std::getenv("BACKEND_VENUE_DEPTH_MS"); ms && *ms)
+    {
+        try
+        {
+            attributionInterval = std::chrono::milliseconds(std::clamp(std::stoi(ms), 100, 10000));
+        }
+        catch (...)
+        {
+        }
+    }
+
+    auto lastAttribution = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        std::this_thread::sleep_for(runtimeThrottle());
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        bool regridded = false;
+        const bool changed = consolidated.syncInto(merged, runtimeCacheLevels(), regridded);
+        if (regridded)
+        {
+            std::cerr << "[backend] consolidated grid tick=" << merged.tickSize() << std::endl;
+            tradeBatcher().setTickGrid(merged.tickSize());
+            g_forceFullLadder = true;
             g_bookReady.store(true);
-            runMexcFuturesWebSocket(cfg, book);
         }
-        else if (cfg.exchange == "binance" || cfg.exchange == "binance_futures")
+        if (changed && (merged.bestBid() > 0.0 || merged.bestAsk() > 0.0))
+        {
+            const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                   std::chrono::system_clock::now().time_since_epoch())
+                                   .count();
+            emitLadder(cfg, merged, merged.bestBid(), merged.bestAsk(), nowMs);
+        }
+        const auto now = std::chrono::steady_clock::now();
+        if (g_haveLastLadder && now - lastAttribution >= attributionInterval)
+        {
+            lastAttribution = now;
+            emitVenueDepthLocked(cfg, consolidated);
+        }
+    }
+}
+
+// Streams a recorded day file through the live emit path (same ladder/ladder_delta/trades
+// messages), paced by the recorded timestamps divided by --speed.
+int runReplay(Config& cfg, dom::OrderBook& book)
+{
+    dom::TickStoreReader reader;
+    if (!reader.open(cfg.replayPath))
+    {
+        std::cerr << "[backend] replay: " << reader.error() << std::endl;
+        return 1;
+    }
+    cfg.exchange = reader.header().exchange;
+    cfg.symbol = reader.header().symbol;
+    std::cerr << "[backend] replay " << cfg.replayPath << " (" << cfg.exchange << " " << cfg.symbol
+              << ") speed=" << (cfg.replaySpeed > 0.0 ? std::to_string(cfg.replaySpeed) : std::string("max"))
+              << std::endl;
+    tradeBatcher().switchSymbol(cfg.symbol);
+
+    const long long fromUs = cfg.replayFromMs * 1000;
+
+    auto wallMs = []() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    };
+    dom::tickstore::BlockHeader header;
+    std::vector<dom::tickstore::Event> events;
+    LevelVector bids;
+    LevelVector asks;
+    bool published = false;
+    bool paced = false;
+    long long dataStartUs = 0;
+    long long positionUs = 0;
+    std::uint64_t replayed = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+    auto lastEmit = wallStart;
+    auto lastStatus = wallStart;
+
+    // Start from the book as of `fromUs` (nearest snapshot plus the deltas after it) rather
+    // than streaming everything before the start position through the book.
+    dom::TickStoreReader::Book start;
+    dom::TickStoreReader::Cursor cursor;
+    if (reader.bookAt(fromUs, start, &cursor))
+    {
+        bids.assign(start.bids.begin(), start.bids.end());
+        asks.assign(start.asks.begin(), start.asks.end());
+        {
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            book.setTickSize(start.tickSize);
+            loadSnapshotTimed(book, bids, asks);
+        }
+        publishActiveBook(cfg, book);
+        published = true;
+        positionUs = start.tsUs;
+    }
+    else
+    {
+        cursor = reader.cursor(fromUs);
+    }
+
+    while (cursor.next(header, events))
+    {
+        if (events.empty())
+        {
+            continue;
+        }
+        if (header.tickSize != book.tickSize())
+        {
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            book.setTickSize(header.tickSize);
+        }
+        if (header.kind == dom::tickstore::BlockKind::Snapshot)
         {
-            const bool futures = cfg.exchange == "binance_futures";
-            std::cerr << "[backend] starting Binance " << (futures ? "futures" : "spot")
-                      << " depth for " << cfg.symbol << std::endl;
-            double tickSize = 0.0;
-            const bool tickOk = futures ? fetchBinanceExchangeInfoFutures(cfg, tickSize)
-                                        : fetchBinanceExchangeInfoSpot(cfg, tickSize);
-            if (!tickOk)
+            bids.clear();
+            asks.clear();
+            for (const auto& e : events)
             {
-                std::cerr << "[backend] failed to determine tick size, exiting" << std::endl;
-                return 1;
+                (e.kind == dom::tickstore::EventKind::BidLevel ? bids : asks).emplace_back(e.tick, e.qty);
             }
-            book.setTickSize(tickSize);
-            BinanceDepthSnapshot snap;
-            const bool snapshotOk =
-                futures ? fetchBinanceSnapshotFutures(cfg, tickSize, snap)
-                        : fetchBinanceSnapshotSpot(cfg, tickSize, snap);
-            if (!snapshotOk)
             {
-                std::cerr << "[backend] snapshot failed, continuing with empty book" << std::endl;
+                std::lock_guard<std::mutex> lock(g_bookMutex);
+                loadSnapshotTimed(book, bids, asks);
             }
-            else
+            if (!published)
             {
-                book.loadSnapshot(snap.bids, snap.asks);
+                publishActiveBook(cfg, book);
+                published = true;
             }
-            if (book.tickSize() > 0.0 && book.bestBid() > 0.0 && book.bestAsk() > 0.0)
+            continue;
+        }
+
+        // Events stamped with the same time came from one book update; apply them as one frame.
+        std::size_t i = 0;
+        while (i < events.size())
+        {
+            const long long ts = events[i].tsUs;
+            const bool live = ts >= fromUs;
+            if (live && !paced)
             {
-                const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       std::chrono::system_clock::now().time_since_epoch())
-                                       .count();
-                emitLadder(cfg, book, book.bestBid(), book.bestAsk(), nowMs);
+                paced = true;
+                dataStartUs = ts;
+                wallStart = std::chrono::steady_clock::now();
+                std::lock_guard<std::mutex> lock(g_bookMutex);
+                g_forceFullLadder = true;
+            }
+            else if (live && cfg.replaySpeed > 0.0)
+            {
+                const auto offset = std::chrono::microseconds(
+                    static_cast<long long>(static_cast<double>(ts - dataStartUs) / cfg.replaySpeed));
+                std::this_thread::sleep_until(wallStart + offset);
+            }
+            bids.clear();
+            asks.clear();
+            std::size_t j = i;
+            for (; j < events.size() && events[j].tsUs == ts; ++j)
+            {
+                const auto& e = events[j];
+                switch (e.kind)
+                {
+                case dom::tickstore::EventKind::BidLevel:
+                    bids.emplace_back(e.tick, e.qty);
+                    break;
+                case dom::tickstore::EventKind::AskLevel:
+                    asks.emplace_back(e.tick, e.qty);
+                    break;
+                case dom::tickstore::EventKind::BuyTrade:
+                case dom::tickstore::EventKind::SellTrade:
+                    if (live)
+                    {
+                        json trade;
+                        trade["type"] = "trade";
+                        trade["symbol"] = cfg.symbol;
+                        trade["tick"] = e.tick;
+                        trade["price"] = static_cast<double>(e.tick) * header.tickSize;
+                        trade["qty"] = e.qty;
+                        trade["side"] = e.kind == dom::tickstore::EventKind::BuyTrade ? "buy" : "sell";
+                        trade["timestamp"] = e.tsUs / 1000;
+                        tradeBatcher().add(cfg.symbol, std::move(trade));
+                    }
+                    break;
+                }
             }
+            if (!bids.empty() || !asks.empty())
             {
                 std::lock_guard<std::mutex> lock(g_bookMutex);
-                g_bookPtr = &book;
-                g_activeConfig = cfg;
+                applyDeltaTimed(book, bids, asks);
+            }
+            replayed += j - i;
+            positionUs = ts;
+            i = j;
+            if (!live)
+            {
+                continue;
+            }
+            const auto now = std::chrono::steady_clock::now();
+            if (now - lastEmit >= runtimeThrottle())
+            {
+                lastEmit = now;
+                std::lock_guard<std::mutex> lock(g_bookMutex);
+                emitLadder(cfg, book, book.bestBid(), book.bestAsk(), wallMs());
+            }
+            if (now - lastStatus >= std::chrono::seconds(1))
+            {
+                lastStatus = now;
+                emitReplayStatus(cfg, positionUs, false);
             }
-            g_bookReady.store(true);
-            runBinanceWebSocket(cfg, book, futures, snap.lastUpdateId);
         }
-        else if (cfg.exchange == "lighter")
+    }
+
+    if (!reader.error().empty())
+    {
+        std::cerr << "[backend] replay: " << reader.error() << std::endl;
+    }
+    if (!published)
+    {
+        publishActiveBook(cfg, book);
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_bookMutex);
+        emitLadder(cfg, book, book.bestBid(), book.bestAsk(), wallMs());
+    }
+    tradeBatcher().flush();
+    emitReplayStatus(cfg, positionUs, true);
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    std::cerr << "[backend] replay done: " << replayed << " events in " << seconds << " s ("
+              << (seconds > 0.0 ? static_cast<double>(replayed) / seconds : 0.0) << " events/s)" << std::endl;
+
+    // Keep serving the last book (and the control channel) like a quiet live session.
+    for (;;)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+}
+
+int main(int argc, char** argv)
+{
+#if defined(ORDERBOOK_BACKEND_QT)
+    QCoreApplication qtApp(argc, argv);
+#endif
+    try
+    {
+        auto cfg = parseArgs(argc, argv);
+        std::cerr << "[backend] protocol=2 tickQuant=scaled" << std::endl;
+        if (!cfg.winProxy.empty())
+        {
+            std::cerr << "[backend] proxy enabled: type=" << cfg.proxyType
+                      << " auth=" << (cfg.proxyUser.empty() ? "0" : "1") << std::endl;
+        }
+        if (cfg.tradeAggregateMs >= 0)
         {
-            std::cerr << "[backend] starting Lighter depth for " << cfg.symbol << std::endl;
-            int marketId = -1;
-            double tickSize = 0.0;
-            int attempts = 0;
-            while (!fetchLighterMarketInfo(cfg, marketId, tickSize))
+            tradeBatcher().setAggregateWindow(std::chrono::milliseconds(cfg.tradeAggregateMs));
+        }
+        runtime().ladderLevelsPerSide.store(cfg.ladderLevelsPerSide);
+        runtime().cacheLevelsPerSide.store(cfg.cacheLevelsPerSide);
+        runtime().throttleMs.store(cfg.throttle.count());
+        std::size_t analyticsLevels = cfg.analyticsLevels;
+        long long cvdWindowMs = 60000;
+        try
+        {
+            if (const char* v = std::getenv("BACKEND_ANALYTICS_LEVELS"); v && *v && analyticsLevels == 0)
             {
-                attempts++;
-                const int capped = std::min(attempts, 8);
-                const int delayMs = std::min(30000, 350 * (1 << capped));
-                std::cerr << "[backend] lighter: failed to resolve market_id/tickSize (attempt "
-                          << attempts << "), retrying in " << delayMs << "ms" << std::endl;
-                std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+                analyticsLevels = static_cast<std::size_t>(std::max(0, std::stoi(v)));
             }
-            if (tickSize > 0.0 && book.tickSize() <= 0.0)
+            if (const char* v = std::getenv("BACKEND_ANALYTICS_CVD_MS"); v && *v)
             {
-                book.setTickSize(tickSize);
+                cvdWindowMs = std::clamp<long long>(std::stoll(v), 1000, 3600000);
             }
+        }
+        catch (...)
+        {
+        }
+        std::unique_ptr<dom::BookAnalytics> analytics;
+        if (analyticsLevels > 0)
+        {
+            analytics = std::make_unique<dom::BookAnalytics>(std::min<std::size_t>(analyticsLevels, 1000), cvdWindowMs);
+            g_analytics = analytics.get();
+        }
+        double wallNotional = cfg.wallNotional;
+        long long wallMoveTicks = 10;
+        long long wallMoveMs = 1000;
+        try
+        {
+            if (const char* v = std::getenv("BACKEND_WALL_NOTIONAL"); v && *v && wallNotional <= 0.0)
             {
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                g_bookPtr = &book;
-                g_activeConfig = cfg;
+                wallNotional = std::stod(v);
             }
-            g_bookReady.store(true);
-            runLighterWebSocket(cfg, book, marketId);
+            if (const char* v = std::getenv("BACKEND_WALL_MOVE_TICKS"); v && *v)
+            {
+                wallMoveTicks = std::clamp<long long>(std::stoll(v), 0, 1000);
+            }
+            if (const char* v = std::getenv("BACKEND_WALL_MOVE_MS"); v && *v)
+            {
+                wallMoveMs = std::clamp<long long>(std::stoll(v), 0, 60000);
+            }
+        }
+        catch (...)
+        {
         }
-        else if (cfg.exchange == "paradex")
+        std::unique_ptr<dom::WallTracker> walls;
+        if (wallNotional > 0.0)
         {
-            std::cerr << "[backend] starting Paradex depth for " << cfg.symbol << std::endl;
-            double tickSize = 0.0;
-            if (!fetchParadexMarketInfo(cfg, tickSize))
+            walls = std::make_unique<dom::WallTracker>(wallNotional,
+                                                       static_cast<dom::OrderBook::Tick>(wallMoveTicks),
+                                                       wallMoveMs);
+            g_walls = walls.get();
+        }
+        dom::TickRecorder::Options recordOptions;
+        recordOptions.directory = cfg.recordDir;
+        try
+        {
+            if (const char* v = std::getenv("BACKEND_RECORD_DIR"); v && *v && recordOptions.directory.empty())
             {
-                std::cerr << "[backend] paradex: failed to determine tick size, exiting\n";
-                return 1;
+                recordOptions.directory = v;
             }
-            book.setTickSize(tickSize);
-
-            std::vector<std::pair<dom::OrderBook::Tick, double>> bids;
-            std::vector<std::pair<dom::OrderBook::Tick, double>> asks;
-            if (fetchParadexOrderBookSnapshot(cfg, tickSize, bids, asks))
+            if (const char* v = std::getenv("BACKEND_RECORD_SNAPSHOT_S"); v && *v)
             {
-                book.loadSnapshot(bids, asks);
+                recordOptions.snapshotIntervalMs = std::clamp<long long>(std::stoll(v), 1, 3600) * 1000;
             }
-            else
+            if (const char* v = std::getenv("BACKEND_RECORD_FLUSH_MS"); v && *v)
             {
-                std::cerr << "[backend] paradex snapshot failed, continuing with empty book\n";
+                recordOptions.flushIntervalMs = std::clamp<long long>(std::stoll(v), 50, 10000);
             }
-            if (book.tickSize() > 0.0 && book.bestBid() > 0.0 && book.bestAsk() > 0.0)
+            if (const char* v = std::getenv("BACKEND_RECORD_QTY_STEP"); v && *v)
             {
-                const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                       std::chrono::system_clock::now().time_since_epoch())
-                                       .count();
-                emitLadder(cfg, book, book.bestBid(), book.bestAsk(), nowMs);
+                recordOptions.qtyStep = std::clamp(std::stod(v), 1e-12, 1.0);
             }
+        }
+        catch (...)
+        {
+        }
+        std::unique_ptr<dom::TickRecorder> recorder;
+        if (!recordOptions.directory.empty())
+        {
+            recorder = std::make_unique<dom::TickRecorder>(recordOptions);
+            g_recorder = recorder.get();
+            std::cerr << "[backend] recording to " << recordOptions.directory << std::endl;
+        }
+
+        dom::OrderBook book;
+        book.setCacheLevelsPerSide(cfg.cacheLevelsPerSide);
+        if (analytics)
+        {
+            analytics->attach(book);
+        }
+        if (walls)
+        {
+            walls->attach(book);
+        }
+        if (recorder && cfg.consolidateVenues.empty() && cfg.replayPath.empty())
+        {
+            recorder->setStream(cfg.exchange, cfg.symbol);
+            recorder->attach(book);
+        }
+        std::thread(heartbeatThread).detach();
+        std::thread(statsThread).detach();
+        std::thread(controlReaderThread).detach();
+
+        if (!cfg.replayPath.empty())
+        {
+            return runReplay(cfg, book);
+        }
+        if (!cfg.consolidateVenues.empty())
+        {
+            return runConsolidated(cfg);
+        }
+
+        if (cfg.standby)
+        {
+            // Pre-spawned by the GUI's process pool: startup is paid for, the symbol comes later.
+            std::cerr << "[backend] standby: waiting for subscribe" << std::endl;
+            std::string firstSymbol;
+            std::uint64_t generation = 0;
+            while (!takeSymbolSwitch(firstSymbol, generation))
             {
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                g_bookPtr = &book;
-                g_activeConfig = cfg;
+                if (runtime().controlClosed.load(std::memory_order_acquire))
+                {
+                    return 0;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
             }
-            g_bookReady.store(true);
-            runParadexWebSocket(cfg, book);
+            std::cerr << "[backend] standby -> " << firstSymbol << std::endl;
+            cfg.symbol = firstSymbol;
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            beginSymbolSwitchLocked(cfg, book, generation);
         }
-        else
+
+        for (;;)
         {
-            const bool isSwap = cfg.exchange == "uzxswap";
-            std::cerr << "[backend] starting UZX " << (isSwap ? "swap" : "spot") << " depth for " << cfg.symbol
-                      << std::endl;
-            double tickSize = 0.0;
+            const int rc = runExchange(cfg, book);
+            if (!symbolSwitchPending())
             {
-                std::lock_guard<std::mutex> lock(g_bookMutex);
-                g_bookPtr = &book;
-                g_activeConfig = cfg;
+                return rc;
             }
-            g_bookReady.store(true);
-            runUzxWebSocket(cfg, book, tickSize, isSwap);
+            // Stop control commands from emitting the old book while we switch.
+            g_bookReady.store(false);
+            std::string nextSymbol;
+            std::uint64_t generation = 0;
+            if (!takeSymbolSwitch(nextSymbol, generation))
+            {
+                return rc;
+            }
+            std::cerr << "[backend] switching symbol " << cfg.symbol << " -> " << nextSymbol << std::endl;
+            cfg.symbol = nextSymbol;
+            std::lock_guard<std::mutex> lock(g_bookMutex);
+            beginSymbolSwitchLocked(cfg, book, generation);
         }
-        return 0;
     }
     catch (const std::exception& ex)
     {
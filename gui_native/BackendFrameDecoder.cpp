@@ -0,0 +1,589 @@
+#include "BackendFrameDecoder.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <system_error>
+
+namespace {
+
+using Scalar = BackendFrameDecoder::Scalar;
+
+class Reader {
+public:
+    Reader(const char *begin, const char *end)
+        : m_p(begin), m_end(end)
+    {
+    }
+
+    bool fail()
+    {
+        m_p = m_end;
+        return false;
+    }
+
+    bool atEnd()
+    {
+        skipWs();
+        return m_p >= m_end;
+    }
+
+    bool consume(char c)
+    {
+        skipWs();
+        if (m_p < m_end && *m_p == c) {
+            ++m_p;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c)
+    {
+        skipWs();
+        return m_p < m_end && *m_p == c;
+    }
+
+    // Strings carrying escapes are not decoded; the line then goes to the DOM parser.
+    bool string(std::string_view &out)
+    {
+        if (!consume('"')) {
+            return fail();
+        }
+        const void *close = std::memchr(m_p, '"', static_cast<std::size_t>(m_end - m_p));
+        if (!close) {
+            return fail();
+        }
+        const char *stop = static_cast<const char *>(close);
+        if (std::memchr(m_p, '\\', static_cast<std::size_t>(stop - m_p))) {
+            return fail();
+        }
+        out = std::string_view(m_p, static_cast<std::size_t>(stop - m_p));
+        m_p = stop + 1;
+        return true;
+    }
+
+    bool scalar(Scalar &out)
+    {
+        skipWs();
+        if (m_p >= m_end) {
+            return fail();
+        }
+        const char c = *m_p;
+        if (c == '"') {
+            out.type = Scalar::Type::String;
+            return string(out.text);
+        }
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            return number(out);
+        }
+        if (literal("true")) {
+            out.type = Scalar::Type::Bool;
+            out.boolean = true;
+            return true;
+        }
+        if (literal("false")) {
+            out.type = Scalar::Type::Bool;
+            out.boolean = false;
+            return true;
+        }
+        if (literal("null")) {
+            out.type = Scalar::Type::Null;
+            return true;
+        }
+        return fail();
+    }
+
+    bool skipValue()
+    {
+        skipWs();
+        if (m_p >= m_end) {
+            return fail();
+        }
+        if (*m_p == '"') {
+            return skipString();
+        }
+        if (*m_p == '{' || *m_p == '[') {
+            int depth = 0;
+            while (m_p < m_end) {
+                const char c = *m_p;
+                if (c == '"') {
+                    if (!skipString()) {
+                        return false;
+                    }
+                    continue;
+                }
+                ++m_p;
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if ((c == '}' || c == ']') && --depth == 0) {
+                    return true;
+                }
+            }
+            return fail();
+        }
+        Scalar ignored;
+        return scalar(ignored);
+    }
+
+    // member(key) consumes the member's value.
+    template <typename Fn>
+    bool object(Fn &&member)
+    {
+        if (!consume('{')) {
+            return fail();
+        }
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            std::string_view key;
+            if (!string(key) || !consume(':') || !member(key)) {
+                return fail();
+            }
+        } while (consume(','));
+        return consume('}') || fail();
+    }
+
+    // element() consumes one element.
+    template <typename Fn>
+    bool array(Fn &&element)
+    {
+        if (!consume('[')) {
+            return fail();
+        }
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            if (!element()) {
+                return fail();
+            }
+        } while (consume(','));
+        return consume(']') || fail();
+    }
+
+    bool scalarArray(std::vector<Scalar> &out)
+    {
+        out.clear();
+        return array([&]() {
+            Scalar v;
+            if (!scalar(v)) {
+                return false;
+            }
+            out.push_back(v);
+            return true;
+        });
+    }
+
+private:
+    void skipWs()
+    {
+        while (m_p < m_end && (*m_p == ' ' || *m_p == '\t' || *m_p == '\n' || *m_p == '\r')) {
+            ++m_p;
+        }
+    }
+
+    bool literal(const char *word)
+    {
+        const std::size_t n = std::strlen(word);
+        if (static_cast<std::size_t>(m_end - m_p) < n || std::memcmp(m_p, word, n) != 0) {
+            return false;
+        }
+        m_p += n;
+        return true;
+    }
+
+    bool skipString()
+    {
+        ++m_p; // opening quote
+        while (m_p < m_end) {
+            const char c = *m_p++;
+            if (c == '\\') {
+                ++m_p;
+            } else if (c == '"') {
+                return true;
+            }
+        }
+        return fail();
+    }
+
+    bool number(Scalar &out)
+    {
+        const char *start = m_p;
+        const char *q = m_p;
+        auto digits = [&]() {
+            const char *from = q;
+            while (q < m_end && *q >= '0' && *q <= '9') {
+                ++q;
+            }
+            return q != from;
+        };
+        if (*q == '-') {
+            ++q;
+        }
+        if (!digits()) {
+            return fail();
+        }
+        bool integral = true;
+        if (q < m_end && *q == '.') {
+            integral = false;
+            ++q;
+            if (!digits()) {
+                return fail();
+            }
+        }
+        if (q < m_end && (*q == 'e' || *q == 'E')) {
+            integral = false;
+            ++q;
+            if (q < m_end && (*q == '+' || *q == '-')) {
+                ++q;
+            }
+            if (!digits()) {
+                return fail();
+            }
+        }
+        if (integral) {
+            long long v = 0;
+            const auto r = std::from_chars(start, q, v);
+            if (r.ec == std::errc() && r.ptr == q) {
+                out.type = Scalar::Type::Integer;
+                out.integer = static_cast<qint64>(v);
+                m_p = q;
+                return true;
+            }
+            // Out of 64-bit range: keep it as a double, as the DOM parser would.
+        }
+        double d = 0.0;
+        const auto r = std::from_chars(start, q, d);
+        if (r.ec != std::errc() || r.ptr != q) {
+            return fail();
+        }
+        out.type = Scalar::Type::Float;
+        out.real = d;
+        m_p = q;
+        return true;
+    }
+
+    const char *m_p;
+    const char *m_end;
+};
+
+// Same rules as parseTickValue() on the DOM path.
+bool tickFromScalar(const Scalar &v, qint64 &out)
+{
+    switch (v.type) {
+    case Scalar::Type::Integer:
+        out = v.integer;
+        return true;
+    case Scalar::Type::Float:
+        if (!std::isfinite(v.real)) {
+            return false;
+        }
+        out = static_cast<qint64>(std::llround(v.real));
+        return true;
+    case Scalar::Type::String: {
+        const char *p = v.text.data();
+        const char *end = p + v.text.size();
+        while (p < end && std::isspace(static_cast<unsigned char>(*p))) {
+            ++p;
+        }
+        if (p < end && *p == '+') {
+            ++p;
+        }
+        long long parsed = 0;
+        const auto r = std::from_chars(p, end, parsed);
+        if (r.ec != std::errc() || r.ptr == p) {
+            return false;
+        }
+        out = static_cast<qint64>(parsed);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+// j.value(key, qint64(0)) on the DOM path: integers as-is, floats truncated.
+qint64 integerOr0(const Scalar &v)
+{
+    if (v.type == Scalar::Type::Integer) {
+        return v.integer;
+    }
+    if (v.type == Scalar::Type::Float && std::isfinite(v.real)) {
+        return static_cast<qint64>(v.real);
+    }
+    return 0;
+}
+
+// Members the DOM path reads with a typed default must have that type when present.
+bool numberOrMissing(const Scalar &v)
+{
+    return v.type == Scalar::Type::Missing || v.isNumber();
+}
+
+bool readNumber(Reader &r, bool &has, double &out)
+{
+    Scalar v;
+    if (!r.scalar(v) || !v.isNumber()) {
+        return false;
+    }
+    has = true;
+    out = v.number();
+    return true;
+}
+
+bool readRow(Reader &r, ParsedLadderRow &row)
+{
+    return r.object([&](std::string_view key) {
+        if (key == "tick") {
+            Scalar v;
+            if (!r.scalar(v)) {
+                return false;
+            }
+            qint64 tick = 0;
+            if (tickFromScalar(v, tick)) {
+                row.tick = tick;
+            }
+            return true;
+        }
+        if (key == "bid") {
+            return readNumber(r, row.hasBid, row.bid);
+        }
+        if (key == "ask") {
+            return readNumber(r, row.hasAsk, row.ask);
+        }
+        return r.skipValue();
+    });
+}
+
+// One element of a "trades" events array, or the members of a single "trade" line.
+struct TradeFields {
+    Scalar price;
+    Scalar qty;
+    Scalar side;
+    Scalar tick;
+
+    bool member(Reader &r, std::string_view key)
+    {
+        Scalar *slot = key == "price" ? &price
+                       : key == "qty" ? &qty
+                       : key == "side" ? &side
+                       : key == "tick" ? &tick
+                                       : nullptr;
+        return slot ? r.scalar(*slot) : r.skipValue();
+    }
+
+    bool toEvent(ParsedTradeEvent &ev) const
+    {
+        if (!numberOrMissing(price) || !numberOrMissing(qty)
+            || (side.type != Scalar::Type::Missing && side.type != Scalar::Type::String)) {
+            return false;
+        }
+        ev.price = price.isNumber() ? price.number() : 0.0;
+        ev.qtyBase = qty.isNumber() ? qty.number() : 0.0;
+        ev.buy = side.text != "sell";
+        qint64 t = 0;
+        if (tickFromScalar(tick, t)) {
+            ev.tick = t;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+BackendFrameDecoder::Kind BackendFrameDecoder::decode(const char *begin,
+                                                      const char *end,
+                                                      ParsedLadderFull &full,
+                                                      ParsedLadderDelta &delta,
+                                                      QVector<ParsedTradeEvent> &trades)
+{
+    Reader r(begin, end);
+    std::string_view type;
+    Scalar gen;
+    Scalar ack;
+    Scalar bestBid;
+    Scalar bestAsk;
+    Scalar tickSize;
+    Scalar windowMinTick;
+    Scalar windowMaxTick;
+    Scalar centerTick;
+    Scalar timestamp;
+    TradeFields single;
+    QVector<ParsedLadderRow> rows;
+    QVector<qint64> removals;
+    QVector<ParsedTradeEvent> events;
+    bool eventsOk = true;
+    bool priceColumn = false;
+    bool qtyColumn = false;
+    m_tickColumn.clear();
+    m_sideColumn.clear();
+
+    auto column = [&](std::vector<Scalar> &out, Scalar &scalar, bool *isColumn) {
+        if (r.peek('[')) {
+            if (isColumn) {
+                *isColumn = true;
+            }
+            return r.scalarArray(out);
+        }
+        return r.scalar(scalar);
+    };
+
+    const bool ok = r.object([&](std::string_view key) {
+        if (key == "type") {
+            return r.string(type);
+        }
+        if (key == "rows" || key == "updates") {
+            return r.array([&]() {
+                ParsedLadderRow row;
+                if (!readRow(r, row)) {
+                    return false;
+                }
+                rows.push_back(row);
+                return true;
+            });
+        }
+        if (key == "removals") {
+            return r.array([&]() {
+                Scalar v;
+                if (!r.scalar(v)) {
+                    return false;
+                }
+                if (v.type == Scalar::Type::Integer) {
+                    removals.push_back(v.integer);
+                }
+                return true;
+            });
+        }
+        if (key == "events") {
+            return r.array([&]() {
+                if (!r.peek('{')) {
+                    return r.skipValue();
+                }
+                TradeFields fields;
+                if (!r.object([&](std::string_view k) { return fields.member(r, k); })) {
+                    return false;
+                }
+                ParsedTradeEvent ev;
+                eventsOk = eventsOk && fields.toEvent(ev);
+                events.push_back(ev);
+                return true;
+            });
+        }
+        if (key == "price") {
+            return column(m_priceColumn, single.price, &priceColumn);
+        }
+        if (key == "qty") {
+            return column(m_qtyColumn, single.qty, &qtyColumn);
+        }
+        if (key == "tick") {
+            return column(m_tickColumn, single.tick, nullptr);
+        }
+        if (key == "side") {
+            return column(m_sideColumn, single.side, nullptr);
+        }
+        Scalar *slot = key == "gen"             ? &gen
+                       : key == "ack"           ? &ack
+                       : key == "bestBid"       ? &bestBid
+                       : key == "bestAsk"       ? &bestAsk
+                       : key == "tickSize"      ? &tickSize
+                       : key == "windowMinTick" ? &windowMinTick
+                       : key == "windowMaxTick" ? &windowMaxTick
+                       : key == "centerTick"    ? &centerTick
+                       : key == "timestamp"     ? &timestamp
+                                                : nullptr;
+        if (slot) {
+            return (r.peek('[') || r.peek('{')) ? r.skipValue() : r.scalar(*slot);
+        }
+        return r.skipValue();
+    }) && r.atEnd();
+    if (!ok) {
+        return Kind::Other;
+    }
+
+    const quint64 generation =
+        (gen.type == Scalar::Type::Integer && gen.integer >= 0) ? static_cast<quint64>(gen.integer) : 0;
+
+    if (type == "ladder" || type == "ladder_delta") {
+        if (!numberOrMissing(bestBid) || !numberOrMissing(bestAsk) || !numberOrMissing(tickSize)
+            || !numberOrMissing(ack) || !numberOrMissing(windowMinTick) || !numberOrMissing(windowMaxTick)
+            || !numberOrMissing(centerTick)) {
+            return Kind::Other;
+        }
+        auto fillHeader = [&](auto &out) {
+            out.generation = generation;
+            out.ack = static_cast<quint64>(integerOr0(ack));
+            out.bestBid = bestBid.isNumber() ? bestBid.number() : 0.0;
+            out.bestAsk = bestAsk.isNumber() ? bestAsk.number() : 0.0;
+            out.tickSize = tickSize.isNumber() ? tickSize.number() : 0.0;
+            out.windowMinTick = integerOr0(windowMinTick);
+            out.windowMaxTick = integerOr0(windowMaxTick);
+            out.centerTick = integerOr0(centerTick);
+            if (timestamp.type == Scalar::Type::Integer) {
+                out.timestampMs = timestamp.integer;
+            }
+        };
+        if (type == "ladder") {
+            fillHeader(full);
+            full.rows = std::move(rows);
+            return Kind::Ladder;
+        }
+        fillHeader(delta);
+        delta.updates = std::move(rows);
+        delta.removals = std::move(removals);
+        return Kind::LadderDelta;
+    }
+
+    if (type == "trade") {
+        ParsedTradeEvent ev;
+        if (!single.toEvent(ev)) {
+            return Kind::Other;
+        }
+        trades.push_back(ev);
+        return Kind::Trades;
+    }
+
+    if (type == "trades") {
+        if (priceColumn && qtyColumn) {
+            // Columnar batch: parallel arrays, one entry per (possibly aggregated) print.
+            const std::size_t n = std::min(m_priceColumn.size(), m_qtyColumn.size());
+            trades.reserve(trades.size() + static_cast<int>(n));
+            for (std::size_t i = 0; i < n; ++i) {
+                const Scalar &p = m_priceColumn[i];
+                const Scalar &q = m_qtyColumn[i];
+                if (!p.isNumber() || !q.isNumber()) {
+                    continue;
+                }
+                ParsedTradeEvent ev;
+                ev.generation = generation;
+                ev.price = p.number();
+                ev.qtyBase = q.number();
+                if (i < m_sideColumn.size()) {
+                    const Scalar &s = m_sideColumn[i];
+                    ev.buy = s.isNumber() ? (static_cast<int>(s.number()) != 0)
+                                          : (s.type == Scalar::Type::String && s.text != "sell");
+                }
+                qint64 tick = 0;
+                if (i < m_tickColumn.size() && tickFromScalar(m_tickColumn[i], tick)) {
+                    ev.tick = tick;
+                }
+                trades.push_back(ev);
+            }
+            return Kind::Trades;
+        }
+        if (!eventsOk) {
+            return Kind::Other;
+        }
+        trades.reserve(trades.size() + events.size());
+        for (ParsedTradeEvent &ev : events) {
+            ev.generation = generation;
+            trades.push_back(ev);
+        }
+        return Kind::Trades;
+    }
+
+    return Kind::Other;
+}
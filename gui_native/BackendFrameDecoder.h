@@ -0,0 +1,97 @@
+// Direct decoding of the high-rate backend lines into the structs LadderClient consumes.
+
+#pragma once
+
+#include <QMetaType>
+#include <QVector>
+#include <QtGlobal>
+
+#include <string_view>
+#include <vector>
+
+struct ParsedLadderRow {
+    qint64 tick = 0;
+    bool hasBid = false;
+    double bid = 0.0;
+    bool hasAsk = false;
+    double ask = 0.0;
+};
+Q_DECLARE_METATYPE(ParsedLadderRow)
+
+struct ParsedTradeEvent {
+    double price = 0.0;
+    double qtyBase = 0.0;
+    bool buy = true;
+    qint64 tick = 0; // 0 means "unknown"
+    quint64 generation = 0;
+};
+Q_DECLARE_METATYPE(ParsedTradeEvent)
+
+struct ParsedLadderFull {
+    double bestBid = 0.0;
+    double bestAsk = 0.0;
+    double tickSize = 0.0;
+    qint64 windowMinTick = 0;
+    qint64 windowMaxTick = 0;
+    qint64 centerTick = 0;
+    qint64 timestampMs = 0; // 0 means "missing"
+    quint64 generation = 0; // backend reconfiguration generation ("gen")
+    quint64 ack = 0;        // newest control command id applied before capture ("ack")
+    QVector<ParsedLadderRow> rows;
+};
+Q_DECLARE_METATYPE(ParsedLadderFull)
+
+struct ParsedLadderDelta {
+    double bestBid = 0.0;
+    double bestAsk = 0.0;
+    double tickSize = 0.0;
+    qint64 windowMinTick = 0;
+    qint64 windowMaxTick = 0;
+    qint64 centerTick = 0;
+    qint64 timestampMs = 0; // 0 means "missing"
+    quint64 generation = 0; // backend reconfiguration generation ("gen")
+    quint64 ack = 0;        // newest control command id applied before capture ("ack")
+    QVector<ParsedLadderRow> updates;
+    QVector<qint64> removals;
+};
+Q_DECLARE_METATYPE(ParsedLadderDelta)
+
+// Single-pass decoder for "ladder", "ladder_delta", "trade" and "trades" lines: members are
+// read straight off the bytes into the structs above, with no JSON DOM in between. The
+// backend writes keys sorted, so "type" only shows up after the payload; every known member
+// is captured on the way and the type picks the result at the end.
+//
+// Any other type, or a line whose shape doesn't match (escaped strings, unexpected value
+// kinds), yields Kind::Other with the outputs untouched and is left to the DOM parser.
+// Structure is checked only as far as decoding needs; the backend is the only writer.
+class BackendFrameDecoder {
+public:
+    enum class Kind { Other, Ladder, LadderDelta, Trades };
+
+    // Trades are appended to `trades`; `full` / `delta` are written for their kinds only.
+    Kind decode(const char *begin,
+                const char *end,
+                ParsedLadderFull &full,
+                ParsedLadderDelta &delta,
+                QVector<ParsedTradeEvent> &trades);
+
+    // One scalar JSON value as written, kept for members whose meaning depends on the type.
+    struct Scalar {
+        enum class Type { Missing, Integer, Float, String, Bool, Null };
+        Type type = Type::Missing;
+        qint64 integer = 0;
+        double real = 0.0;
+        bool boolean = false;
+        std::string_view text;
+
+        bool isNumber() const { return type == Type::Integer || type == Type::Float; }
+        double number() const { return type == Type::Integer ? static_cast<double>(integer) : real; }
+    };
+
+private:
+    // Reused between lines so steady-state decoding keeps its capacity.
+    std::vector<Scalar> m_tickColumn;
+    std::vector<Scalar> m_priceColumn;
+    std::vector<Scalar> m_qtyColumn;
+    std::vector<Scalar> m_sideColumn;
+};
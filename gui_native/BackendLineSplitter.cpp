@@ -0,0 +1,79 @@
+#include "BackendLineSplitter.h"
+
+#include <cstring>
+#include <utility>
+
+namespace {
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+} // namespace
+
+void BackendLineSplitter::append(const QByteArray &chunk)
+{
+    const char *data = chunk.constData();
+    const int size = chunk.size();
+    int start = 0;
+    int chunkIndex = -1;
+    while (start < size) {
+        const void *hit = std::memchr(data + start, '\n', static_cast<std::size_t>(size - start));
+        if (!hit) {
+            break;
+        }
+        const int end = static_cast<int>(static_cast<const char *>(hit) - data);
+        if (!m_partial.isEmpty()) {
+            // The head of this line came with an earlier read; this is the only copy made.
+            m_partial.append(data + start, end - start);
+            QByteArray joined;
+            joined.swap(m_partial);
+            int joinedIndex = -1;
+            addLine(joined, joinedIndex, 0, joined.size());
+        } else {
+            addLine(chunk, chunkIndex, start, end - start);
+        }
+        start = end + 1;
+    }
+    if (start < size) {
+        if (start == 0 && m_partial.isEmpty()) {
+            m_partial = chunk; // shared, not copied
+        } else {
+            m_partial.append(data + start, size - start);
+        }
+    }
+}
+
+BackendLineBatch BackendLineSplitter::takeBatch()
+{
+    BackendLineBatch out;
+    std::swap(out, m_batch);
+    return out;
+}
+
+void BackendLineSplitter::clear()
+{
+    m_partial.clear();
+    m_batch = BackendLineBatch();
+}
+
+void BackendLineSplitter::addLine(const QByteArray &chunk, int &chunkIndex, int offset, int size)
+{
+    const char *data = chunk.constData();
+    while (size > 0 && isBlank(data[offset])) {
+        ++offset;
+        --size;
+    }
+    while (size > 0 && isBlank(data[offset + size - 1])) {
+        --size;
+    }
+    if (size == 0) {
+        return;
+    }
+    if (chunkIndex < 0) {
+        chunkIndex = m_batch.chunks.size();
+        m_batch.chunks.push_back(chunk);
+    }
+    m_batch.lines.push_back({chunkIndex, offset, size});
+}
@@ -0,0 +1,48 @@
+// Splits backend stdout into JSON lines without copying them out of the pipe reads.
+
+#pragma once
+
+#include <QByteArray>
+#include <QMetaType>
+#include <QVector>
+
+// Lines handed to the parse worker: the pipe reads they live in plus one span per line.
+// QByteArray is implicitly shared, so queuing a batch to another thread copies no payload.
+struct BackendLineBatch {
+    struct Span {
+        int chunk = 0;
+        int offset = 0;
+        int size = 0;
+    };
+
+    QVector<QByteArray> chunks;
+    QVector<Span> lines;
+
+    bool isEmpty() const { return lines.isEmpty(); }
+    int size() const { return lines.size(); }
+    const char *lineData(int i) const
+    {
+        const Span &s = lines[i];
+        return chunks[s.chunk].constData() + s.offset;
+    }
+    int lineSize(int i) const { return lines[i].size; }
+};
+Q_DECLARE_METATYPE(BackendLineBatch)
+
+// Each pipe read goes through append(); complete non-blank lines collect in a pending batch
+// until takeBatch(). Lines are sliced in place, except one straddling two reads, which is
+// joined into its own buffer. Nothing is ever removed from the front of a buffer.
+class BackendLineSplitter {
+public:
+    void append(const QByteArray &chunk);
+    bool hasLines() const { return !m_batch.isEmpty(); }
+    BackendLineBatch takeBatch();
+    // Drops pending lines and the unfinished tail (backend restarted).
+    void clear();
+
+private:
+    void addLine(const QByteArray &chunk, int &chunkIndex, int offset, int size);
+
+    QByteArray m_partial; // bytes after the last newline, waiting for the rest of their line
+    BackendLineBatch m_batch;
+};
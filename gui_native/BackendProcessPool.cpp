@@ -0,0 +1,115 @@
+#include "BackendProcessPool.h"
+
+#include <QCoreApplication>
+#include <QProcess>
+#include <QTimer>
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Idle backends across all argument sets; the oldest is stopped to make room.
+constexpr int kMaxIdle = 4;
+// Delay before a taken or newly wanted backend is replaced, so it starts after the one in use.
+constexpr int kPrimeDelayMs = 3000;
+
+} // namespace
+
+BackendProcessPool &BackendProcessPool::instance()
+{
+    static BackendProcessPool *pool = new BackendProcessPool(QCoreApplication::instance());
+    return *pool;
+}
+
+BackendProcessPool::BackendProcessPool(QObject *parent)
+    : QObject(parent)
+{
+    if (qEnvironmentVariableIsSet("FUSION_BACKEND_POOL")) {
+        m_perKey = std::clamp(qEnvironmentVariableIntValue("FUSION_BACKEND_POOL"), 0, kMaxIdle);
+    }
+}
+
+QString BackendProcessPool::keyFor(const QString &program, const QStringList &args)
+{
+    return program + QLatin1Char('\n') + args.join(QLatin1Char('\n'));
+}
+
+QProcess *BackendProcessPool::take(const QString &program, const QStringList &args)
+{
+    if (m_perKey <= 0) {
+        return nullptr;
+    }
+    const QString key = keyFor(program, args);
+    for (int i = 0; i < m_idle.size(); ++i) {
+        if (m_idle[i].key != key || m_idle[i].process->state() != QProcess::Running) {
+            continue;
+        }
+        QProcess *process = m_idle[i].process;
+        m_idle.removeAt(i);
+        disconnect(process, nullptr, this, nullptr);
+        process->setParent(nullptr);
+        prime(program, args);
+        return process;
+    }
+    return nullptr;
+}
+
+void BackendProcessPool::prime(const QString &program, const QStringList &args)
+{
+    if (m_perKey <= 0) {
+        return;
+    }
+    QTimer::singleShot(kPrimeDelayMs, this, [this, program, args]() { fill(program, args); });
+}
+
+void BackendProcessPool::fill(const QString &program, const QStringList &args)
+{
+    const QString key = keyFor(program, args);
+    int count = 0;
+    for (const Idle &idle : std::as_const(m_idle)) {
+        if (idle.key == key) {
+            ++count;
+        }
+    }
+    for (; count < m_perKey; ++count) {
+        if (m_idle.size() >= kMaxIdle) {
+            drop(m_idle.front().process);
+        }
+        spawn(program, args, key);
+    }
+}
+
+void BackendProcessPool::spawn(const QString &program, const QStringList &args, const QString &key)
+{
+    auto *process = new QProcess(this);
+    process->setProgram(program);
+    process->setArguments(args + QStringList{QStringLiteral("--standby")});
+    process->setWorkingDirectory(QCoreApplication::applicationDirPath());
+    process->setProcessChannelMode(QProcess::SeparateChannels);
+    // Nothing is read from an idle backend; keep its pipes from filling up.
+    connect(process, &QProcess::readyReadStandardOutput, this, [process]() { process->readAllStandardOutput(); });
+    connect(process, &QProcess::readyReadStandardError, this, [process]() { process->readAllStandardError(); });
+    connect(process,
+            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this,
+            [this, process]() { drop(process); });
+    m_idle.push_back({key, process});
+    process->start();
+}
+
+void BackendProcessPool::drop(QProcess *process)
+{
+    const auto it = std::find_if(m_idle.begin(), m_idle.end(), [process](const Idle &idle) {
+        return idle.process == process;
+    });
+    if (it == m_idle.end()) {
+        return;
+    }
+    m_idle.erase(it);
+    disconnect(process, nullptr, this, nullptr);
+    if (process->state() != QProcess::NotRunning) {
+        process->kill();
+    }
+    process->deleteLater();
+}
@@ -0,0 +1,43 @@
+// Pre-spawned idle backend processes, handed to LadderClient on respawn.
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QProcess;
+
+// A fresh backend pays process creation, DLL loading and runtime setup before it can even
+// open its exchange connection. The pool keeps a few backends started with --standby (all
+// arguments but the symbol), waiting on stdin; LadderClient takes one whose arguments match
+// and only has to send "subscribe". Taken processes are replaced a little later, so a warm one
+// never competes with the startup it is about to speed up.
+//
+// FUSION_BACKEND_POOL sets the idle backends kept per argument set (default 1, 0 = off).
+class BackendProcessPool : public QObject {
+public:
+    static BackendProcessPool &instance();
+
+    // A running standby backend for `program` + `args`, or nullptr. Ownership passes to the
+    // caller; every connection the pool made to it is gone.
+    QProcess *take(const QString &program, const QStringList &args);
+    // Schedules idle backends for `program` + `args` up to the per-set count.
+    void prime(const QString &program, const QStringList &args);
+
+private:
+    struct Idle {
+        QString key;
+        QProcess *process = nullptr;
+    };
+
+    explicit BackendProcessPool(QObject *parent);
+    static QString keyFor(const QString &program, const QStringList &args);
+    void fill(const QString &program, const QStringList &args);
+    void spawn(const QString &program, const QStringList &args, const QString &key);
+    void drop(QProcess *process);
+
+    int m_perKey = 1;
+    QVector<Idle> m_idle; // oldest first
+};
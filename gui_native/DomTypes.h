@@ -2,6 +2,8 @@
 
 #include <QColor>
 #include <QMetaType>
+#include <QVector>
+#include <QtGlobal>
 
 struct VolumeHighlightRule {
     double threshold = 0.0; // notional in USDT
@@ -10,3 +12,32 @@ struct VolumeHighlightRule {
 
 Q_DECLARE_METATYPE(VolumeHighlightRule)
 Q_DECLARE_METATYPE(QVector<VolumeHighlightRule>)
+
+struct DomLevel {
+    qint64 tick = 0;
+    double price = 0.0;
+    double bidQty = 0.0;
+    double askQty = 0.0;
+};
+
+struct DomSnapshot {
+    QVector<DomLevel> levels;
+    double bestBid = 0.0;
+    double bestAsk = 0.0;
+    double tickSize = 0.0;
+    qint64 minTick = 0; // inclusive (bucketized)
+    qint64 maxTick = 0; // inclusive (bucketized)
+    qint64 compression = 1; // ticks per row used to build levels
+};
+
+// What changed in a DomSnapshot since the previous one pulled from the same LadderClient
+// (see LadderClient::snapshotDeltaForRange). A steady book only sends the rows it touched.
+struct DomSnapshotDelta {
+    bool full = true;     // `snapshot` is complete; otherwise its levels are empty
+    DomSnapshot snapshot; // best prices, tick size and bounds are always current
+    int rowCount = 0;     // rows of the resulting ladder
+    // Incremental only: rows the window moved up by, so new levels[i] is old levels[i - shiftRows].
+    int shiftRows = 0;
+    QVector<int> indices;     // changed rows, top-down like DomSnapshot::levels
+    QVector<DomLevel> levels; // their new values
+};
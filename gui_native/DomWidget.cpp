@@ -369,7 +369,58 @@ void DomWidget::updateSnapshot(const DomSnapshot &snapshot)
 {
     m_pendingSnapshot = snapshot;
     m_hasPendingSnapshot = true;
+    scheduleSnapshotApply();
+}
+
+bool DomWidget::updateSnapshot(const DomSnapshotDelta &delta)
+{
+    if (delta.full) {
+        updateSnapshot(delta.snapshot);
+        return true;
+    }
+    // Patch whichever snapshot is shown next; a pending full one is still recomputed as a whole.
+    DomSnapshot &target = m_hasPendingSnapshot ? m_pendingSnapshot : m_snapshot;
+    const DomSnapshot &next = delta.snapshot;
+    const qint64 compression = std::max<qint64>(1, next.compression);
+    if (target.levels.size() != delta.rowCount || target.compression != next.compression
+        || std::abs(target.tickSize - next.tickSize) > 1e-12
+        || target.maxTick != next.maxTick - delta.shiftRows * compression
+        || std::abs(delta.shiftRows) >= delta.rowCount) {
+        return false;
+    }
+
+    auto &levels = target.levels;
+    if (delta.shiftRows > 0) {
+        std::move_backward(levels.begin(), levels.end() - delta.shiftRows, levels.end());
+    } else if (delta.shiftRows < 0) {
+        std::move(levels.begin() - delta.shiftRows, levels.end(), levels.begin());
+    }
+    for (int i = 0; i < delta.indices.size(); ++i) {
+        levels[delta.indices[i]] = delta.levels[i];
+    }
+    target.bestBid = next.bestBid;
+    target.bestAsk = next.bestAsk;
+    target.minTick = next.minTick;
+    target.maxTick = next.maxTick;
+
+    if (!m_hasPendingSnapshot) {
+        // A shift moves the layout and rebuilds every row anyway; otherwise only these rows.
+        if (delta.shiftRows == 0 && !delta.levels.isEmpty()) {
+            QVector<qint64> ticks;
+            ticks.reserve(delta.levels.size());
+            for (const DomLevel &lvl : delta.levels) {
+                ticks.push_back(lvl.tick);
+            }
+            notifyBucketTicksUpdated(ticks);
+        }
+        m_snapshotPatched = true;
+    }
+    scheduleSnapshotApply();
+    return true;
+}
 
+void DomWidget::scheduleSnapshotApply()
+{
     if (m_snapshotUpdateScheduled) {
         return;
     }
@@ -380,14 +431,18 @@ void DomWidget::updateSnapshot(const DomSnapshot &snapshot)
 void DomWidget::applyPendingSnapshot()
 {
     m_snapshotUpdateScheduled = false;
-    if (!m_hasPendingSnapshot) {
+    if (m_hasPendingSnapshot) {
+        m_hasPendingSnapshot = false;
+        // Moved, not copied: deltas patch m_snapshot in place and must not detach it.
+        m_snapshot = std::move(m_pendingSnapshot);
+        m_pendingSnapshot = DomSnapshot();
+        // Force a full per-row recompute for this snapshot. This avoids any chance of stale
+        // GPU incremental rows "sticking" during volatility when deltas are out-of-order.
+        m_forceFullRecalc = true;
+    } else if (!m_snapshotPatched) {
         return;
     }
-    m_hasPendingSnapshot = false;
-    m_snapshot = m_pendingSnapshot;
-    // Force a full per-row recompute for this snapshot. This avoids any chance of stale
-    // GPU incremental rows "sticking" during volatility when deltas are out-of-order.
-    m_forceFullRecalc = true;
+    m_snapshotPatched = false;
 
     const int rows = m_snapshot.levels.size();
     const int rowHeight = m_rowHeight;
@@ -1223,6 +1278,56 @@ void DomWidget::setPriceTextMarkers(const QVector<PriceTextMarker> &markers)
     update();
 }
 
+void DomWidget::setWallMarkers(const QVector<WallMarker> &walls)
+{
+    m_wallMarkers = walls;
+    // Only rows whose wall state changed are marked dirty; the ladder itself is not rescanned.
+    QSet<qint64> changed;
+    rebucketWallMarkers(std::max<qint64>(1, m_snapshot.compression), &changed);
+    if (changed.isEmpty()) {
+        return;
+    }
+    for (qint64 t : std::as_const(changed)) {
+        m_dirtyBucketTicks.insert(t);
+    }
+    if (m_quickWidget && m_quickReady) {
+        scheduleQuickSnapshotUpdate();
+    }
+    update();
+}
+
+void DomWidget::rebucketWallMarkers(qint64 compression, QSet<qint64> *changedBuckets)
+{
+    QHash<qint64, WallMarker> next;
+    next.reserve(m_wallMarkers.size());
+    for (const auto &wall : m_wallMarkers) {
+        const qint64 bucket =
+            wall.bid ? floorBucketTick(wall.tick, compression) : ceilBucketTick(wall.tick, compression);
+        auto it = next.find(bucket);
+        if (it == next.end()) {
+            next.insert(bucket, wall);
+        } else if (wall.firstSeenMs > 0 && wall.firstSeenMs < it->firstSeenMs) {
+            *it = wall;
+        }
+    }
+    if (changedBuckets) {
+        for (auto it = next.cbegin(); it != next.cend(); ++it) {
+            const auto prev = m_cachedWallsByTick.constFind(it.key());
+            if (prev == m_cachedWallsByTick.cend() || prev->bid != it->bid
+                || prev->firstSeenMs != it->firstSeenMs) {
+                changedBuckets->insert(it.key());
+            }
+        }
+        for (auto it = m_cachedWallsByTick.cbegin(); it != m_cachedWallsByTick.cend(); ++it) {
+            if (!next.contains(it.key())) {
+                changedBuckets->insert(it.key());
+            }
+        }
+    }
+    m_cachedWallsByTick = std::move(next);
+    m_cachedWallsCompression = compression;
+}
+
 void DomWidget::notifyBucketTicksUpdated(const QVector<qint64> &bucketTicks)
 {
     if (bucketTicks.isEmpty()) {
@@ -1581,6 +1686,11 @@ void DomWidget::updateQuickSnapshot()
             && (m_cachedLayoutMinTick == m_snapshot.minTick)
             && (m_cachedLayoutMaxTick == m_snapshot.maxTick);
 
+        if (m_cachedWallsCompression != compression) {
+            rebucketWallMarkers(compression, nullptr);
+        }
+        const qint64 frameNowMs = m_cachedWallsByTick.isEmpty() ? 0 : QDateTime::currentMSecsSinceEpoch();
+
         auto computeRow = [&](const DomLevel &lvl, const DomLevelsModel::Row *reuse) -> DomLevelsModel::Row {
             DomLevelsModel::Row row;
             double bidQty = lvl.bidQty;
@@ -1652,6 +1762,17 @@ void DomWidget::updateQuickSnapshot()
                 priceColor = rowColor;
                 priceColor.setAlpha((isBestBidRow || isBestAskRow) ? 120 : 40);
             }
+            if (lvl.tick != 0 && !m_cachedWallsByTick.isEmpty()) {
+                const auto wallIt = m_cachedWallsByTick.constFind(lvl.tick);
+                if (wallIt != m_cachedWallsByTick.constEnd()) {
+                    // Persistent wall marker on the price cell; older walls read stronger.
+                    const qint64 ageMs =
+                        wallIt->firstSeenMs > 0 ? std::max<qint64>(0, frameNowMs - wallIt->firstSeenMs) : 0;
+                    QColor wallColor = wallIt->bid ? m_style.bid : m_style.ask;
+                    wallColor.setAlpha(90 + static_cast<int>(std::min<qint64>(ageMs, 60000) * 110 / 60000));
+                    priceColor = wallColor;
+                }
+            }
 
             double dominantQty = 0.0;
             bool volumeIsBid = false;
@@ -21,23 +21,6 @@ class QQuickItem;
 class QFrame;
 class QLabel;
 
-struct DomLevel {
-    qint64 tick = 0;
-    double price = 0.0;
-    double bidQty = 0.0;
-    double askQty = 0.0;
-};
-
-struct DomSnapshot {
-    QVector<DomLevel> levels;
-    double bestBid = 0.0;
-    double bestAsk = 0.0;
-    double tickSize = 0.0;
-    qint64 minTick = 0; // inclusive (bucketized)
-    qint64 maxTick = 0; // inclusive (bucketized)
-    qint64 compression = 1; // ticks per row used to build levels
-};
-
 struct DomStyle {
     QColor background = QColor("#202020");
     QColor text = QColor("#f0f0f0");
@@ -67,9 +50,26 @@ public:
         QColor textColor = QColor("#ffffff");
     };
 
+    // Backend-tracked liquidity wall ("wall_*" events); tick is the raw book tick.
+    struct WallMarker
+    {
+        quint64 id = 0;
+        qint64 tick = 0;
+        bool bid = true;
+        double qty = 0.0;
+        double added = 0.0;
+        double pulled = 0.0;
+        double traded = 0.0;
+        int moves = 0;
+        qint64 firstSeenMs = 0;
+    };
+
     explicit DomWidget(QWidget *parent = nullptr);
 
     void updateSnapshot(const DomSnapshot &snapshot);
+    // False when the delta doesn't continue the snapshot shown (e.g. a fresh widget); the
+    // caller then has to send a full one.
+    bool updateSnapshot(const DomSnapshotDelta &delta);
     void refreshFontProperties();
     void setStyle(const DomStyle &style);
     void centerToSpread();
@@ -84,6 +84,7 @@ public:
     void setLocalOrders(const QVector<LocalOrderMarker> &orders);
     void setHighlightPrices(const QVector<double> &prices);
     void setPriceTextMarkers(const QVector<PriceTextMarker> &markers);
+    void setWallMarkers(const QVector<WallMarker> &walls);
     void setActionOverlayText(const QString &text);
     Q_INVOKABLE void handleRowClick(int row, int button, double price, double bidQty, double askQty);
     Q_INVOKABLE void handleRowClickIndex(int row, int button);
@@ -112,6 +113,7 @@ private:
     DomSnapshot m_snapshot;
     DomSnapshot m_pendingSnapshot;
     bool m_hasPendingSnapshot = false;
+    bool m_snapshotPatched = false; // m_snapshot took a delta that is not on screen yet
     bool m_snapshotUpdateScheduled = false;
     DomStyle m_style;
     QVector<VolumeHighlightRule> m_volumeRules;
@@ -170,12 +172,18 @@ private:
     qint64 m_cachedHighlightCompression = 1;
     double m_cachedHighlightTickSize = 0.0;
 
+    QVector<WallMarker> m_wallMarkers;
+    QHash<qint64, WallMarker> m_cachedWallsByTick; // bucket tick -> oldest wall in it
+    qint64 m_cachedWallsCompression = 0;
+    void rebucketWallMarkers(qint64 compression, QSet<qint64> *changedBuckets);
+
     void updateHoverInfo(int row);
     double cumulativeNotionalForRow(int row) const;
     int rowForPrice(double price) const;
     void ensureQuickInitialized();
     void syncQuickProperties();
     void updateQuickOverlayProperties();
+    void scheduleSnapshotApply();
     void applyPendingSnapshot();
     void updateQuickSnapshot();
     void scheduleQuickSnapshotUpdate();
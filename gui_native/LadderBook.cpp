@@ -0,0 +1,428 @@
+#include "LadderBook.h"
+
+#include <cmath>
+
+namespace {
+
+constexpr double kEps = 1e-9;
+// Room left on each side when storage is re-anchored, so a drifting book does not
+// re-anchor on every new best price.
+constexpr qint64 kMinHeadroomTicks = 1024;
+
+double cleanQty(double v)
+{
+    if (!std::isfinite(v) || v < kEps) {
+        return 0.0;
+    }
+    return v;
+}
+
+bool hasLiquidity(const LadderBook::Entry &e)
+{
+    return e.bidQty > 0.0 || e.askQty > 0.0;
+}
+
+} // namespace
+
+LadderBook::LadderBook()
+{
+    m_grids.reserve(kPyramidFactors.size() + kMaxExtraGrids);
+    for (qint64 factor : kPyramidFactors) {
+        Grid grid;
+        grid.compression = factor;
+        m_grids.push_back(std::move(grid));
+    }
+}
+
+qint64 LadderBook::floorBucket(qint64 tick, qint64 compression)
+{
+    compression = std::max<qint64>(1, compression);
+    if (compression == 1) {
+        return tick;
+    }
+    if (tick >= 0) {
+        return (tick / compression) * compression;
+    }
+    const qint64 absTick = -tick;
+    const qint64 buckets = (absTick + compression - 1) / compression;
+    return -buckets * compression;
+}
+
+qint64 LadderBook::ceilBucket(qint64 tick, qint64 compression)
+{
+    compression = std::max<qint64>(1, compression);
+    if (compression == 1) {
+        return tick;
+    }
+    if (tick >= 0) {
+        return ((tick + compression - 1) / compression) * compression;
+    }
+    const qint64 absTick = -tick;
+    const qint64 buckets = absTick / compression;
+    return -buckets * compression;
+}
+
+void LadderBook::clear()
+{
+    // Keep the storage: the next snapshot usually lands in the same span. Buckets are wiped
+    // even when no level is left, since rounding can leave residue in their sums.
+    if (m_levelCount > 0) {
+        std::fill(m_levels.begin() + static_cast<std::ptrdiff_t>(m_lowTick - m_baseTick),
+                  m_levels.begin() + static_cast<std::ptrdiff_t>(m_highTick - m_baseTick + 1),
+                  Entry{});
+    }
+    for (Grid &grid : m_grids) {
+        std::fill(grid.buckets.begin(), grid.buckets.end(), Entry{});
+        grid.sanitized = false;
+        grid.bestBid = kNoBucket;
+        grid.bestAsk = kNoBucket;
+    }
+    m_levelCount = 0;
+    m_lowTick = 0;
+    m_highTick = 0;
+}
+
+qint64 LadderBook::firstTick() const
+{
+    for (qint64 t = m_lowTick; m_levelCount > 0 && t <= m_highTick; ++t) {
+        if (hasLiquidity(m_levels[static_cast<std::size_t>(t - m_baseTick)])) {
+            return t;
+        }
+    }
+    return 0;
+}
+
+qint64 LadderBook::lastTick() const
+{
+    for (qint64 t = m_highTick; m_levelCount > 0 && t >= m_lowTick; --t) {
+        if (hasLiquidity(m_levels[static_cast<std::size_t>(t - m_baseTick)])) {
+            return t;
+        }
+    }
+    return 0;
+}
+
+LadderBook::Entry LadderBook::level(qint64 tick) const
+{
+    if (!storageHolds(tick)) {
+        return {};
+    }
+    return m_levels[static_cast<std::size_t>(tick - m_baseTick)];
+}
+
+bool LadderBook::update(qint64 tick, bool hasBid, double bid, bool hasAsk, double ask)
+{
+    if (!hasBid && !hasAsk) {
+        return true;
+    }
+    if (!storageHolds(tick) && !reserveTick(tick)) {
+        return false;
+    }
+    Entry &e = m_levels[static_cast<std::size_t>(tick - m_baseTick)];
+    const Entry before = e;
+    if (hasBid) {
+        e.bidQty = cleanQty(bid);
+    }
+    if (hasAsk) {
+        e.askQty = cleanQty(ask);
+    }
+    applyChange(tick, before, e);
+    return true;
+}
+
+LadderBook::Entry LadderBook::remove(qint64 tick)
+{
+    if (!storageHolds(tick)) {
+        return {};
+    }
+    Entry &e = m_levels[static_cast<std::size_t>(tick - m_baseTick)];
+    const Entry before = e;
+    e = Entry{};
+    applyChange(tick, before, e);
+    return before;
+}
+
+void LadderBook::retain(qint64 minTick, qint64 maxTick, QSet<qint64> *dirtyBuckets)
+{
+    if (m_levelCount == 0) {
+        return;
+    }
+    auto drop = [&](qint64 from, qint64 to) {
+        for (qint64 t = from; t <= to; ++t) {
+            Entry &e = m_levels[static_cast<std::size_t>(t - m_baseTick)];
+            if (!hasLiquidity(e)) {
+                continue;
+            }
+            const Entry before = e;
+            e = Entry{};
+            applyChange(t, before, e);
+            if (dirtyBuckets) {
+                const qint64 c = activeGrid().compression;
+                if (before.bidQty > 0.0) {
+                    dirtyBuckets->insert(floorBucket(t, c));
+                }
+                if (before.askQty > 0.0) {
+                    dirtyBuckets->insert(ceilBucket(t, c));
+                }
+            }
+        }
+    };
+    const qint64 low = m_lowTick;
+    const qint64 high = m_highTick;
+    drop(low, std::min(high, minTick - 1));
+    drop(std::max(low, maxTick + 1), high);
+    if (m_levelCount > 0) {
+        m_lowTick = std::max(m_lowTick, minTick);
+        m_highTick = std::min(m_highTick, maxTick);
+    }
+}
+
+void LadderBook::erase(qint64 fromTick, qint64 toTick)
+{
+    if (m_levelCount == 0) {
+        return;
+    }
+    const qint64 from = std::max(fromTick, m_lowTick);
+    const qint64 to = std::min(toTick, m_highTick);
+    for (qint64 t = from; t <= to; ++t) {
+        Entry &e = m_levels[static_cast<std::size_t>(t - m_baseTick)];
+        if (!hasLiquidity(e)) {
+            continue;
+        }
+        const Entry before = e;
+        e = Entry{};
+        applyChange(t, before, e);
+    }
+}
+
+void LadderBook::setCompression(qint64 compression)
+{
+    compression = std::max<qint64>(1, compression);
+    std::size_t index = 0;
+    while (index < m_grids.size() && m_grids[index].compression != compression) {
+        ++index;
+    }
+    if (index == m_grids.size()) {
+        // Not a pyramid factor: the least recently picked odd factor makes room.
+        if (m_grids.size() >= kPyramidFactors.size() + kMaxExtraGrids) {
+            m_grids.erase(m_grids.begin() + static_cast<std::ptrdiff_t>(kPyramidFactors.size()));
+        }
+        Grid grid;
+        grid.compression = compression;
+        m_grids.push_back(std::move(grid));
+        index = m_grids.size() - 1;
+        rebuildGrid(m_grids[index]);
+    } else if (index >= kPyramidFactors.size() && index + 1 < m_grids.size()) {
+        std::rotate(m_grids.begin() + static_cast<std::ptrdiff_t>(index),
+                    m_grids.begin() + static_cast<std::ptrdiff_t>(index) + 1,
+                    m_grids.end());
+        index = m_grids.size() - 1;
+    }
+    if (m_grids[index].sanitized) {
+        rebuildGrid(m_grids[index]);
+    }
+    m_activeGrid = index;
+}
+
+LadderBook::Entry LadderBook::bucket(qint64 bucketTick) const
+{
+    const Grid &grid = activeGrid();
+    if (grid.buckets.empty() || bucketTick < grid.baseTick) {
+        return {};
+    }
+    const qint64 offset = bucketTick - grid.baseTick;
+    if (offset % grid.compression != 0) {
+        return {};
+    }
+    const auto i = static_cast<std::size_t>(offset / grid.compression);
+    return i < grid.buckets.size() ? grid.buckets[i] : Entry{};
+}
+
+bool LadderBook::bestBuckets(qint64 &bidBucket, qint64 &askBucket) const
+{
+    const Grid &grid = activeGrid();
+    const qint64 c = grid.compression;
+    bidBucket = grid.bestBid != kNoBucket ? grid.baseTick + static_cast<qint64>(grid.bestBid) * c : 0;
+    askBucket = grid.bestAsk != kNoBucket ? grid.baseTick + static_cast<qint64>(grid.bestAsk) * c : 0;
+    return grid.bestBid != kNoBucket && grid.bestAsk != kNoBucket;
+}
+
+void LadderBook::sanitizeBuckets(qint64 bestBidBucket, qint64 bestAskBucket, QSet<qint64> *dirtyBuckets)
+{
+    Grid &grid = m_grids[m_activeGrid];
+    if (m_levelCount == 0 || grid.buckets.empty() || (bestBidBucket == 0 && bestAskBucket == 0)) {
+        return;
+    }
+    const bool spreadOpen = bestBidBucket != 0 && bestAskBucket != 0 && bestBidBucket < bestAskBucket;
+    // Asks below the grid's best ask and bids above its best bid don't exist, so anything to
+    // clear lies between the given buckets and the grid's best ones.
+    const qint64 c = grid.compression;
+    const auto lastIndex = static_cast<qint64>(grid.buckets.size() - 1);
+    std::size_t from = grid.buckets.size();
+    std::size_t to = 0;
+    auto cover = [&](std::size_t i) {
+        from = std::min(from, i);
+        to = std::max(to, i);
+    };
+    auto coverTick = [&](qint64 bucketTick) {
+        const qint64 offset = bucketTick - grid.baseTick;
+        cover(static_cast<std::size_t>(offset < 0 ? 0 : std::min(offset / c, lastIndex)));
+    };
+    if (bestBidBucket != 0) {
+        coverTick(bestBidBucket);
+    }
+    if (bestAskBucket != 0) {
+        coverTick(bestAskBucket);
+    }
+    if (grid.bestBid != kNoBucket) {
+        cover(grid.bestBid);
+    }
+    if (grid.bestAsk != kNoBucket) {
+        cover(grid.bestAsk);
+    }
+    for (std::size_t i = from; i <= to && i < grid.buckets.size(); ++i) {
+        Entry &e = grid.buckets[i];
+        if (!hasLiquidity(e)) {
+            continue;
+        }
+        const Entry before = e;
+        const qint64 tick = grid.baseTick + static_cast<qint64>(i) * c;
+        bool changed = false;
+        if (bestBidBucket != 0 && tick <= bestBidBucket && e.askQty > 0.0) {
+            e.askQty = 0.0;
+            changed = true;
+        }
+        if (bestAskBucket != 0 && tick >= bestAskBucket && e.bidQty > 0.0) {
+            e.bidQty = 0.0;
+            changed = true;
+        }
+        if (spreadOpen && tick > bestBidBucket && tick < bestAskBucket && hasLiquidity(e)) {
+            e = Entry{};
+            changed = true;
+        }
+        if (changed) {
+            trackBest(grid, i, before);
+            grid.sanitized = true;
+            if (dirtyBuckets) {
+                dirtyBuckets->insert(tick);
+            }
+        }
+    }
+}
+
+bool LadderBook::reserveTick(qint64 tick)
+{
+    qint64 low = tick;
+    qint64 high = tick;
+    if (m_levelCount > 0) {
+        low = std::min(low, m_lowTick);
+        high = std::max(high, m_highTick);
+    }
+    const qint64 span = high - low + 1;
+    if (span > kMaxSpanTicks) {
+        return false;
+    }
+    const qint64 headroom = std::min(std::max(kMinHeadroomTicks, span / 2), (kMaxSpanTicks - span) / 2);
+    const qint64 base = low - headroom;
+    std::vector<Entry> levels(static_cast<std::size_t>(span + 2 * headroom));
+    if (m_levelCount > 0) {
+        std::copy(m_levels.begin() + static_cast<std::ptrdiff_t>(m_lowTick - m_baseTick),
+                  m_levels.begin() + static_cast<std::ptrdiff_t>(m_highTick - m_baseTick + 1),
+                  levels.begin() + static_cast<std::ptrdiff_t>(m_lowTick - base));
+    }
+    m_levels = std::move(levels);
+    m_baseTick = base;
+    for (Grid &grid : m_grids) {
+        rebuildGrid(grid);
+    }
+    return true;
+}
+
+void LadderBook::rebuildGrid(Grid &grid) const
+{
+    grid.sanitized = false;
+    grid.bestBid = kNoBucket;
+    grid.bestAsk = kNoBucket;
+    if (m_levels.empty()) {
+        grid.buckets.clear();
+        return;
+    }
+    const qint64 c = grid.compression;
+    const qint64 lastTick = m_baseTick + static_cast<qint64>(m_levels.size()) - 1;
+    grid.baseTick = floorBucket(m_baseTick, c);
+    const qint64 count = (ceilBucket(lastTick, c) - grid.baseTick) / c + 1;
+    grid.buckets.assign(static_cast<std::size_t>(count), Entry{});
+    for (qint64 t = m_lowTick; m_levelCount > 0 && t <= m_highTick; ++t) {
+        const Entry &e = m_levels[static_cast<std::size_t>(t - m_baseTick)];
+        addToBucket(grid, floorBucket(t, c), e.bidQty, 0.0);
+        addToBucket(grid, ceilBucket(t, c), 0.0, e.askQty);
+    }
+}
+
+void LadderBook::applyChange(qint64 tick, const Entry &before, const Entry &after)
+{
+    const bool had = hasLiquidity(before);
+    const bool has = hasLiquidity(after);
+    if (has && !had) {
+        if (m_levelCount == 0) {
+            m_lowTick = tick;
+            m_highTick = tick;
+        } else {
+            m_lowTick = std::min(m_lowTick, tick);
+            m_highTick = std::max(m_highTick, tick);
+        }
+        ++m_levelCount;
+    } else if (had && !has) {
+        --m_levelCount;
+    }
+    const double bidDelta = after.bidQty - before.bidQty;
+    const double askDelta = after.askQty - before.askQty;
+    for (Grid &grid : m_grids) {
+        addToBucket(grid, floorBucket(tick, grid.compression), bidDelta, 0.0);
+        addToBucket(grid, ceilBucket(tick, grid.compression), 0.0, askDelta);
+    }
+}
+
+void LadderBook::addToBucket(Grid &grid, qint64 bucketTick, double bidDelta, double askDelta)
+{
+    if (bidDelta == 0.0 && askDelta == 0.0) {
+        return;
+    }
+    const auto i = static_cast<std::size_t>((bucketTick - grid.baseTick) / grid.compression);
+    Entry &e = grid.buckets[i];
+    const Entry before = e;
+    e.bidQty = cleanQty(e.bidQty + bidDelta);
+    e.askQty = cleanQty(e.askQty + askDelta);
+    trackBest(grid, i, before);
+}
+
+void LadderBook::trackBest(Grid &grid, std::size_t i, const Entry &before)
+{
+    const Entry &e = grid.buckets[i];
+    if (e.bidQty > 0.0) {
+        if (grid.bestBid == kNoBucket || i > grid.bestBid) {
+            grid.bestBid = i;
+        }
+    } else if (before.bidQty > 0.0 && i == grid.bestBid) {
+        grid.bestBid = kNoBucket;
+        for (std::size_t j = i; j-- > 0;) {
+            if (grid.buckets[j].bidQty > 0.0) {
+                grid.bestBid = j;
+                break;
+            }
+        }
+    }
+    if (e.askQty > 0.0) {
+        if (grid.bestAsk == kNoBucket || i < grid.bestAsk) {
+            grid.bestAsk = i;
+        }
+    } else if (before.askQty > 0.0 && i == grid.bestAsk) {
+        grid.bestAsk = kNoBucket;
+        for (std::size_t j = i + 1; j < grid.buckets.size(); ++j) {
+            if (grid.buckets[j].askQty > 0.0) {
+                grid.bestAsk = j;
+                break;
+            }
+        }
+    }
+}
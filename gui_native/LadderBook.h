@@ -0,0 +1,130 @@
+// Flat tick-indexed order book used by LadderClient for the live window and paged depth.
+
+#pragma once
+
+#include <QSet>
+#include <QtGlobal>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// Levels of one contiguous tick span kept in flat arrays: raw quantities indexed from an
+// anchor tick, plus per-bucket aggregates (bids are floored into their bucket, asks ceiled).
+// Reading a viewport is a straight walk over a bucket array instead of one hash lookup per
+// row. Storage is re-anchored only when a level lands outside it, so steady-state updates
+// never allocate.
+//
+// Aggregates are kept for every factor in kPyramidFactors at once and patched on each level
+// change, so switching between those compressions is just picking another grid.
+class LadderBook {
+public:
+    struct Entry {
+        double bidQty = 0.0;
+        double askQty = 0.0;
+    };
+
+    // Widest span of ticks one book stores; levels further out are dropped.
+    static constexpr qint64 kMaxSpanTicks = qint64(1) << 21;
+    // Compressions maintained incrementally; any other factor gets an extra grid on demand.
+    static constexpr std::array<qint64, 7> kPyramidFactors = {1, 2, 5, 10, 25, 50, 100};
+    // Extra grids kept at once, so views of one book at different odd factors don't rebuild
+    // theirs on every switch.
+    static constexpr std::size_t kMaxExtraGrids = 4;
+
+    LadderBook();
+
+    static qint64 floorBucket(qint64 tick, qint64 compression);
+    static qint64 ceilBucket(qint64 tick, qint64 compression);
+
+    void clear();
+    bool isEmpty() const { return m_levelCount == 0; }
+    // Lowest / highest tick holding a level; 0 when empty.
+    qint64 firstTick() const;
+    qint64 lastTick() const;
+    Entry level(qint64 tick) const;
+
+    // Writes the flagged sides of `tick`; quantities below 1e-9 clear a side. False when the
+    // tick is too far from the rest of the book to be stored.
+    bool update(qint64 tick, bool hasBid, double bid, bool hasAsk, double ask);
+    // Drops the level at `tick` and returns what it held.
+    Entry remove(qint64 tick);
+    // Drops every level outside [minTick, maxTick]; the buckets that lost liquidity are added
+    // to `dirtyBuckets`.
+    void retain(qint64 minTick, qint64 maxTick, QSet<qint64> *dirtyBuckets = nullptr);
+    // Drops every level inside [fromTick, toTick].
+    void erase(qint64 fromTick, qint64 toTick);
+
+    qint64 compression() const { return activeGrid().compression; }
+    void setCompression(qint64 compression);
+    Entry bucket(qint64 bucketTick) const;
+    // Highest bucket holding bids and lowest holding asks (0 when a side is missing); true
+    // when both exist. Tracked as buckets change, so this is O(1).
+    bool bestBuckets(qint64 &bidBucket, qint64 &askBucket) const;
+    // Clears bucket liquidity on the wrong side of the given spread buckets or strictly
+    // inside it, so stale aggregates can't show as impossible levels. Only buckets between
+    // the given ones and the grid's own best buckets can hold such liquidity, and only those
+    // are visited. Only the active grid is touched; it is rebuilt from the levels if it is
+    // picked again later.
+    void sanitizeBuckets(qint64 bestBidBucket, qint64 bestAskBucket, QSet<qint64> *dirtyBuckets = nullptr);
+
+    // Calls fn(bucketTick, entry) for every stored bucket in [fromBucket, toBucket], ascending.
+    template <typename Fn>
+    void forEachBucket(qint64 fromBucket, qint64 toBucket, Fn &&fn) const
+    {
+        const Grid &grid = activeGrid();
+        if (grid.buckets.empty() || fromBucket > toBucket) {
+            return;
+        }
+        const qint64 c = grid.compression;
+        const qint64 lastBucket = grid.baseTick + static_cast<qint64>(grid.buckets.size() - 1) * c;
+        qint64 first = std::max(fromBucket, grid.baseTick);
+        first = grid.baseTick + (first - grid.baseTick + c - 1) / c * c;
+        const qint64 last = std::min(toBucket, lastBucket);
+        if (first > last) {
+            return;
+        }
+        std::size_t i = static_cast<std::size_t>((first - grid.baseTick) / c);
+        for (qint64 t = first; t <= last; t += c, ++i) {
+            fn(t, grid.buckets[i]);
+        }
+    }
+
+private:
+    static constexpr std::size_t kNoBucket = static_cast<std::size_t>(-1);
+
+    struct Grid {
+        qint64 compression = 1;
+        qint64 baseTick = 0; // bucket tick of buckets[0]
+        std::vector<Entry> buckets;
+        bool sanitized = false; // trimmed by sanitizeBuckets, so no longer the levels' sums
+        // Index of the highest bucket holding bids and of the lowest holding asks.
+        std::size_t bestBid = kNoBucket;
+        std::size_t bestAsk = kNoBucket;
+    };
+
+    const Grid &activeGrid() const { return m_grids[m_activeGrid]; }
+    bool storageHolds(qint64 tick) const
+    {
+        return !m_levels.empty() && tick >= m_baseTick
+               && tick - m_baseTick < static_cast<qint64>(m_levels.size());
+    }
+    bool reserveTick(qint64 tick);
+    void rebuildGrid(Grid &grid) const;
+    void applyChange(qint64 tick, const Entry &before, const Entry &after);
+    static void addToBucket(Grid &grid, qint64 bucketTick, double bidDelta, double askDelta);
+    // Moves the grid's best buckets after buckets[i] changed from `before`; scans for the next
+    // one only when the best bucket of a side empties.
+    static void trackBest(Grid &grid, std::size_t i, const Entry &before);
+
+    qint64 m_baseTick = 0; // tick of m_levels[0]
+    std::vector<Entry> m_levels;
+    // Bounds of the occupied ticks; may be loose after removals.
+    qint64 m_lowTick = 0;
+    qint64 m_highTick = 0;
+    int m_levelCount = 0;
+
+    std::vector<Grid> m_grids; // kPyramidFactors in order, then other factors, least recently picked first
+    std::size_t m_activeGrid = 0;
+};
@@ -0,0 +1,1066 @@
+#include "LadderBookModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Dirty sets kept for a reader that stopped rendering; beyond this every row counts as dirty.
+constexpr std::size_t kMaxDirtyHistory = 256;
+
+} // namespace
+
+void LadderBookModel::addView(quint64 view)
+{
+    m_views[view] = View{};
+}
+
+void LadderBookModel::removeView(quint64 view)
+{
+    if (m_views.erase(view) > 0) {
+        updateCacheLevels();
+    }
+}
+
+void LadderBookModel::resetBook()
+{
+    m_book.clear();
+    m_bufferMinTick = 0;
+    m_bufferMaxTick = 0;
+    m_centerTick = 0;
+    m_tickSize = 0.0;
+    m_hasBook = false;
+    m_bestBid = 0.0;
+    m_bestAsk = 0.0;
+    clearStableBuckets();
+    ++m_revision;
+    ++m_rangeRevision;
+    markAllDirty();
+}
+
+void LadderBookModel::resetView(quint64 view, quint64 epoch)
+{
+    const auto it = m_views.find(view);
+    if (it == m_views.end()) {
+        return;
+    }
+    View &v = it->second;
+    v.epoch = epoch;
+    v.pageBook.clear();
+    v.hasPages = false;
+    v.pageMinTick = 0;
+    v.pageMaxTick = 0;
+    v.pageTickSize = 0.0;
+    ++v.revision;
+    ++v.rangeRevision;
+    v.dirtyHistory.clear();
+    markAllDirty(v);
+}
+
+void LadderBookModel::setCompression(quint64 view, int factor)
+{
+    const auto it = m_views.find(view);
+    const int c = std::max(1, factor);
+    if (it == m_views.end() || c == it->second.compression) {
+        return;
+    }
+    View &v = it->second;
+    v.compression = c;
+    v.pageBook.setCompression(c);
+    // Dirty buckets recorded so far are on the old grid; a reader that skipped frames back to
+    // the same compression would take them for rows of its own.
+    markAllDirty(v);
+    if (!m_book.isEmpty()) {
+        ++v.revision;
+        if (m_hasBook) {
+            ++v.rangeRevision;
+        }
+    }
+}
+
+void LadderBookModel::setCacheLevels(quint64 view, int levels)
+{
+    const auto it = m_views.find(view);
+    if (it != m_views.end()) {
+        it->second.cacheLevels = levels;
+        updateCacheLevels();
+    }
+}
+
+void LadderBookModel::updateCacheLevels()
+{
+    m_cacheLevels = 0;
+    for (const auto &entry : m_views) {
+        m_cacheLevels = std::max(m_cacheLevels, entry.second.cacheLevels);
+    }
+}
+
+void LadderBookModel::setView(quint64 view, qint64 minTick, qint64 maxTick)
+{
+    const auto it = m_views.find(view);
+    if (it == m_views.end()) {
+        return;
+    }
+    if (minTick > maxTick) {
+        std::swap(minTick, maxTick);
+    }
+    View &v = it->second;
+    v.hasView = true;
+    v.viewMinTick = minTick;
+    v.viewMaxTick = maxTick;
+}
+
+void LadderBookModel::noteAck(quint64 id)
+{
+    m_ack = std::max(m_ack, id);
+}
+
+qint64 LadderBookModel::priceToRawTick(double price, bool nudge) const
+{
+    if (!(price > 0.0) || !(m_tickSize > 0.0) || !std::isfinite(price) || !std::isfinite(m_tickSize)) {
+        return 0;
+    }
+    const double scaled = price / m_tickSize;
+    if (!std::isfinite(scaled)) {
+        return 0;
+    }
+    if (nudge) {
+        return static_cast<qint64>(std::llround(scaled + (scaled >= 0.0 ? 1e-9 : -1e-9)));
+    }
+    return static_cast<qint64>(std::llround(scaled));
+}
+
+void LadderBookModel::applyFull(const ParsedLadderFull &msg)
+{
+    const bool wasReady = m_hasBook;
+    const qint64 prevMin = m_bufferMinTick;
+    const qint64 prevMax = m_bufferMaxTick;
+    const qint64 prevCenter = m_centerTick;
+    const double prevTick = m_tickSize;
+
+    m_bestBid = msg.bestBid;
+    m_bestAsk = msg.bestAsk;
+    if (msg.tickSize > 0.0) {
+        m_tickSize = msg.tickSize;
+    }
+
+    m_book.clear();
+    if (!msg.rows.isEmpty() && m_tickSize > 0.0) {
+        for (const auto &row : msg.rows) {
+            m_book.update(row.tick, true, row.hasBid ? row.bid : 0.0, true, row.hasAsk ? row.ask : 0.0);
+        }
+    }
+    // A full resync can drop levels by omission (not included in `rows`), anywhere in the book.
+    markAllDirty();
+
+    qint64 minTick = msg.windowMinTick;
+    qint64 maxTick = msg.windowMaxTick;
+    if (minTick == 0 && maxTick == 0) {
+        minTick = m_book.firstTick();
+        maxTick = m_book.lastTick();
+    }
+    m_hasBook = (m_tickSize > 0.0 && minTick <= maxTick);
+    if (!m_hasBook) {
+        m_bufferMinTick = 0;
+        m_bufferMaxTick = 0;
+        m_centerTick = 0;
+        m_book.clear();
+        clearStableBuckets();
+        return;
+    }
+
+    m_bufferMinTick = minTick;
+    m_bufferMaxTick = maxTick;
+    m_centerTick = (msg.centerTick != 0) ? msg.centerTick : (m_bufferMinTick + m_bufferMaxTick) / 2;
+    trimBookToWindow(m_bufferMinTick, m_bufferMaxTick);
+    bool crossed = false;
+    for (auto &entry : m_views) {
+        crossed = !sanitizeTopOfBook(entry.second, nullptr) || crossed;
+    }
+    if (crossed) {
+        // Crossed: treat as inconsistent; clear and resync.
+        clearStableBuckets();
+        m_book.clear();
+        m_bestBid = 0.0;
+        m_bestAsk = 0.0;
+        ++m_resyncRequests;
+    }
+
+    ++m_revision;
+    const bool windowChanged = !wasReady || prevMin != m_bufferMinTick || prevMax != m_bufferMaxTick
+                               || prevCenter != m_centerTick || std::abs(prevTick - m_tickSize) > 1e-12;
+    if (windowChanged) {
+        ++m_rangeRevision;
+    }
+    for (auto &entry : m_views) {
+        dropDetachedPages(entry.second);
+    }
+}
+
+void LadderBookModel::applyDelta(const ParsedLadderDelta &msg)
+{
+    if (!m_hasBook) {
+        ParsedLadderFull full;
+        full.bestBid = msg.bestBid;
+        full.bestAsk = msg.bestAsk;
+        full.tickSize = msg.tickSize;
+        full.windowMinTick = msg.windowMinTick;
+        full.windowMaxTick = msg.windowMaxTick;
+        full.centerTick = msg.centerTick;
+        full.timestampMs = msg.timestampMs;
+        applyFull(full);
+        return;
+    }
+
+    const qint64 prevMin = m_bufferMinTick;
+    const qint64 prevMax = m_bufferMaxTick;
+    const qint64 prevCenter = m_centerTick;
+    const double prevTick = m_tickSize;
+    const double prevBestBid = m_bestBid;
+    const double prevBestAsk = m_bestAsk;
+
+    if (msg.bestBid != 0.0) {
+        m_bestBid = msg.bestBid;
+    }
+    if (msg.bestAsk != 0.0) {
+        m_bestAsk = msg.bestAsk;
+    }
+    if (msg.tickSize > 0.0) {
+        m_tickSize = msg.tickSize;
+    }
+
+    // Raw ticks the delta touched: bids land in their floor bucket, asks in their ceil bucket,
+    // levels in both. Every view buckets them on its own grid below.
+    QVector<qint64> bidTicks;
+    QVector<qint64> askTicks;
+    // IMPORTANT: Some backends can update top-of-book (bestBid/bestAsk) without sending
+    // a depth delta for the corresponding tick in the same frame. Rows are resent by dirty
+    // bucket, so if best prices change the old+new best buckets must be marked dirty,
+    // otherwise stale "best" highlights can remain visible (looks like 2-3 asks/bids).
+    if (m_tickSize > 0.0) {
+        const qint64 prevBidTick = priceToRawTick(prevBestBid, true);
+        const qint64 prevAskTick = priceToRawTick(prevBestAsk, true);
+        const qint64 nextBidTick = priceToRawTick(m_bestBid, true);
+        const qint64 nextAskTick = priceToRawTick(m_bestAsk, true);
+        if (prevBidTick != 0) bidTicks.push_back(prevBidTick);
+        if (nextBidTick != 0) bidTicks.push_back(nextBidTick);
+        if (prevAskTick != 0) askTicks.push_back(prevAskTick);
+        if (nextAskTick != 0) askTicks.push_back(nextAskTick);
+    }
+    QVector<qint64> levelTicks;
+    if (!msg.updates.isEmpty() && m_tickSize > 0.0) {
+        levelTicks.reserve(msg.updates.size() + msg.removals.size());
+        for (const auto &row : msg.updates) {
+            const qint64 tick = row.tick;
+            if (tick == 0) {
+                continue;
+            }
+            m_book.update(tick, row.hasBid, row.bid, row.hasAsk, row.ask);
+            levelTicks.push_back(tick);
+        }
+    }
+    for (qint64 t : msg.removals) {
+        if (t == 0) {
+            continue;
+        }
+        m_book.remove(t);
+        levelTicks.push_back(t);
+    }
+
+    std::vector<QSet<qint64>> dirtyBuckets(m_views.size());
+    auto bucketTicks = [](QSet<qint64> &buckets, const QVector<qint64> &ticks, qint64 c, bool bid, bool ask) {
+        buckets.reserve(buckets.size() + ticks.size() * ((bid && ask) ? 2 : 1));
+        for (qint64 t : ticks) {
+            if (bid) buckets.insert(LadderBook::floorBucket(t, c));
+            if (ask) buckets.insert(LadderBook::ceilBucket(t, c));
+        }
+    };
+
+    // If the book becomes crossed (bid >= ask) due to out-of-order bursts on volatile symbols,
+    // a full ladder resync is requested from the backend (without changing manual center).
+    // Keep going though: every row is resent for this frame so the view recovers at once.
+    // Each view checks its own grid; the book is one, so it is cleared for all of them.
+    bool inconsistentFrame = false;
+    bool crossed = false;
+    std::vector<std::pair<qint64, qint64>> prevStable;
+    prevStable.reserve(m_views.size());
+    {
+        std::size_t i = 0;
+        for (auto &entry : m_views) {
+            const View &v = entry.second;
+            const qint64 c = std::max(1, v.compression);
+            QSet<qint64> &buckets = dirtyBuckets[i++];
+            bucketTicks(buckets, bidTicks, c, true, false);
+            bucketTicks(buckets, askTicks, c, false, true);
+            bucketTicks(buckets, levelTicks, c, true, true);
+            prevStable.emplace_back(v.stableBidBucket, v.stableAskBucket);
+
+            // Robust crossed detection: dirty-bucket heuristics can miss cases where the crossing is
+            // caused by stale buckets outside the delta set. Always verify the aggregated top-of-book.
+            m_book.setCompression(c);
+            qint64 bidBucket = 0;
+            qint64 askBucket = 0;
+            const bool haveTop = m_book.bestBuckets(bidBucket, askBucket);
+            const bool viewCrossed = haveTop && bidBucket > askBucket;
+            crossed = crossed || viewCrossed;
+            inconsistentFrame = inconsistentFrame || viewCrossed || crossedBookLikely(buckets, c);
+        }
+    }
+    if (inconsistentFrame) {
+        ++m_crossedDeltas;
+        if (crossed) {
+            // Fail-safe: clear local state so ghosts cannot persist; the next frame renders
+            // an empty ladder until the resync arrives.
+            m_book.clear();
+            m_bestBid = 0.0;
+            m_bestAsk = 0.0;
+            clearStableBuckets();
+        }
+    }
+
+    const bool hasWindow = (msg.windowMinTick != 0 || msg.windowMaxTick != 0);
+    const qint64 minTick = hasWindow ? msg.windowMinTick : m_bufferMinTick;
+    const qint64 maxTick = hasWindow ? msg.windowMaxTick : m_bufferMaxTick;
+    if (minTick <= maxTick) {
+        m_bufferMinTick = minTick;
+        m_bufferMaxTick = maxTick;
+    }
+    if (msg.centerTick != 0) {
+        m_centerTick = msg.centerTick;
+    }
+    QSet<qint64> trimmedTicks;
+    trimBookToWindow(m_bufferMinTick, m_bufferMaxTick, &trimmedTicks);
+
+    m_hasBook = (m_tickSize > 0.0 && m_bufferMinTick <= m_bufferMaxTick);
+    if (!m_hasBook) {
+        m_bufferMinTick = 0;
+        m_bufferMaxTick = 0;
+        m_centerTick = 0;
+        m_book.clear();
+        clearStableBuckets();
+        return;
+    }
+
+    ++m_revision;
+    std::size_t i = 0;
+    for (auto &entry : m_views) {
+        View &v = entry.second;
+        const qint64 c = std::max(1, v.compression);
+        QSet<qint64> &buckets = dirtyBuckets[i];
+        const auto [prevStableBid, prevStableAsk] = prevStable[i++];
+        for (qint64 t : std::as_const(trimmedTicks)) {
+            buckets.insert(LadderBook::floorBucket(t, c));
+            buckets.insert(LadderBook::ceilBucket(t, c));
+        }
+        m_book.setCompression(c);
+        sanitizeTopOfBook(v, &buckets);
+        // If top-of-book buckets moved, mark the affected range dirty so the rows re-evaluate the
+        // spread guard logic (prevents stale "wrong side" levels from sticking).
+        bool resendAll = inconsistentFrame;
+        auto markRange = [&](qint64 a, qint64 b) {
+            if (a > b) {
+                std::swap(a, b);
+            }
+            if ((b - a) / c + 1 > kMaxDirty) {
+                resendAll = true;
+                return;
+            }
+            for (qint64 t = a; t <= b; t += c) {
+                buckets.insert(t);
+            }
+        };
+        auto markMove = [&](qint64 prev, qint64 next) {
+            if (prev == next) {
+                return;
+            }
+            if (prev != 0 && next != 0) {
+                markRange(prev, next);
+            } else {
+                buckets.insert(prev != 0 ? prev : next);
+            }
+        };
+        markMove(prevStableBid, v.stableBidBucket);
+        markMove(prevStableAsk, v.stableAskBucket);
+        if (resendAll) {
+            markAllDirty(v);
+        } else {
+            markDirty(v, buckets);
+        }
+        dropDetachedPages(v);
+    }
+    const bool windowChanged = prevMin != m_bufferMinTick || prevMax != m_bufferMaxTick
+                               || prevCenter != m_centerTick || std::abs(prevTick - m_tickSize) > 1e-12;
+    if (windowChanged) {
+        ++m_rangeRevision;
+    }
+}
+
+void LadderBookModel::applyPage(quint64 view,
+                                const QVector<ParsedLadderRow> &rows,
+                                double tickSize,
+                                qint64 fromTick,
+                                qint64 toTick,
+                                bool backendBookKnown)
+{
+    const auto it = m_views.find(view);
+    if (it == m_views.end()) {
+        return;
+    }
+    View &v = it->second;
+    // Announced either way: that also answers the view's pending extension.
+    ++v.rangeRevision;
+    const bool usable = m_hasBook && backendBookKnown && fromTick <= toTick && tickSize > 0.0
+                        && std::abs(tickSize - m_tickSize) <= 1e-12;
+    if (!usable) {
+        return;
+    }
+
+    auto connects = [](qint64 aMin, qint64 aMax, qint64 bMin, qint64 bMax) {
+        return aMin <= bMax + 1 && bMin <= aMax + 1;
+    };
+    const bool merge =
+        v.hasPages && std::abs(v.pageTickSize - tickSize) <= 1e-12
+        && (connects(fromTick, toTick, v.pageMinTick, v.pageMaxTick)
+            || (connects(fromTick, toTick, m_bufferMinTick, m_bufferMaxTick)
+                && connects(v.pageMinTick, v.pageMaxTick, m_bufferMinTick, m_bufferMaxTick)));
+    if (merge) {
+        v.pageBook.erase(fromTick, toTick);
+        v.pageMinTick = std::min(v.pageMinTick, fromTick);
+        v.pageMaxTick = std::max(v.pageMaxTick, toTick);
+    } else {
+        v.pageBook.clear();
+        v.pageMinTick = fromTick;
+        v.pageMaxTick = toTick;
+    }
+    for (const auto &row : rows) {
+        if (row.tick < fromTick || row.tick > toTick) {
+            continue;
+        }
+        v.pageBook.update(row.tick, true, row.hasBid ? row.bid : 0.0, true, row.hasAsk ? row.ask : 0.0);
+    }
+    v.hasPages = true;
+    v.pageTickSize = tickSize;
+
+    ++v.revision;
+    // A page can touch any number of buckets.
+    markAllDirty(v);
+}
+
+void LadderBookModel::clearPages(quint64 view)
+{
+    const auto it = m_views.find(view);
+    if (it == m_views.end() || !it->second.hasPages) {
+        return;
+    }
+    View &v = it->second;
+    v.pageBook.clear();
+    v.hasPages = false;
+    v.pageMinTick = 0;
+    v.pageMaxTick = 0;
+    v.pageTickSize = 0.0;
+    ++v.revision;
+    ++v.rangeRevision;
+}
+
+bool LadderBookModel::pagesConnected(const View &view) const
+{
+    return view.hasPages && m_hasBook && view.pageMinTick <= m_bufferMaxTick + 1
+           && m_bufferMinTick <= view.pageMaxTick + 1;
+}
+
+void LadderBookModel::dropDetachedPages(View &view)
+{
+    if (view.hasPages && (!pagesConnected(view) || std::abs(view.pageTickSize - m_tickSize) > 1e-12)) {
+        // The live window moved away (or the tick size changed); the pages no longer extend it.
+        view.pageBook.clear();
+        view.hasPages = false;
+        view.pageMinTick = 0;
+        view.pageMaxTick = 0;
+        view.pageTickSize = 0.0;
+        ++view.revision;
+        ++view.rangeRevision;
+    }
+}
+
+bool LadderBookModel::crossedBookLikely(const QSet<qint64> &dirtyBuckets, qint64 compression) const
+{
+    if (!(m_tickSize > 0.0) || !std::isfinite(m_tickSize)) {
+        return false;
+    }
+    if (!(m_bestBid > 0.0) || !(m_bestAsk > 0.0)) {
+        return false;
+    }
+    const qint64 bidBucket = LadderBook::floorBucket(priceToRawTick(m_bestBid, false), compression);
+    const qint64 askBucket = LadderBook::ceilBucket(priceToRawTick(m_bestAsk, false), compression);
+    if (bidBucket > askBucket) {
+        return true;
+    }
+    const bool hasTop = (bidBucket != 0 && askBucket != 0);
+    for (qint64 t : dirtyBuckets) {
+        const LadderBook::Entry bucket = m_book.bucket(t);
+        if (bucket.bidQty > 0.0 && bucket.askQty > 0.0) {
+            if (!hasTop) {
+                return true;
+            }
+            if (bidBucket < askBucket) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void LadderBookModel::trimBookToWindow(qint64 minTick, qint64 maxTick, QSet<qint64> *dirtyTicks)
+{
+    if (m_tickSize <= 0.0) {
+        return;
+    }
+    // Keep book coverage anchored around the current best price so cumulative
+    // volume does not change when the user scrolls the visible window.
+    qint64 bestTick = 0;
+    if (m_bestBid > 0.0) {
+        bestTick = priceToRawTick(m_bestBid, false);
+    }
+    if (bestTick == 0 && m_bestAsk > 0.0) {
+        bestTick = priceToRawTick(m_bestAsk, false);
+    }
+    if (bestTick != 0 && m_cacheLevels > 0) {
+        const qint64 span = static_cast<qint64>(m_cacheLevels);
+        minTick = bestTick - span;
+        maxTick = bestTick + span;
+    }
+    if (minTick > maxTick) {
+        return;
+    }
+    // On the raw grid the buckets it reports are the ticks themselves.
+    m_book.setCompression(1);
+    m_book.retain(minTick, maxTick, dirtyTicks);
+}
+
+bool LadderBookModel::sanitizeTopOfBook(View &view, QSet<qint64> *dirtyBuckets)
+{
+    m_book.setCompression(view.compression);
+    qint64 bidBucket = 0;
+    qint64 askBucket = 0;
+    if (!m_book.bestBuckets(bidBucket, askBucket)) {
+        return true;
+    }
+    if (bidBucket > askBucket) {
+        return false;
+    }
+    if (bidBucket == askBucket) {
+        // Locked spread: keep the bucket as-is to avoid blanking the DOM.
+        view.stableBidBucket = bidBucket;
+        view.stableAskBucket = askBucket;
+        return true;
+    }
+    m_book.sanitizeBuckets(bidBucket, askBucket, dirtyBuckets);
+    qint64 bid2 = 0;
+    qint64 ask2 = 0;
+    if (m_book.bestBuckets(bid2, ask2) && bid2 < ask2) {
+        view.stableBidBucket = bid2;
+        view.stableAskBucket = ask2;
+    } else {
+        view.stableBidBucket = bidBucket;
+        view.stableAskBucket = askBucket;
+    }
+    return true;
+}
+
+void LadderBookModel::clearStableBuckets()
+{
+    for (auto &entry : m_views) {
+        entry.second.stableBidBucket = 0;
+        entry.second.stableAskBucket = 0;
+    }
+}
+
+void LadderBookModel::markDirty(View &view, const QSet<qint64> &buckets)
+{
+    if (view.dirtyAll) {
+        return;
+    }
+    for (qint64 t : buckets) {
+        view.dirty.insert(t);
+    }
+    if (view.dirty.size() > kMaxDirty) {
+        markAllDirty(view);
+    }
+}
+
+void LadderBookModel::markAllDirty(View &view)
+{
+    view.dirtyAll = true;
+    view.dirty.clear();
+}
+
+void LadderBookModel::markAllDirty()
+{
+    for (auto &entry : m_views) {
+        markAllDirty(entry.second);
+    }
+}
+
+std::shared_ptr<const LadderBookFrame> LadderBookModel::publish(quint64 view, quint64 consumedVersion)
+{
+    const auto it = m_views.find(view);
+    if (it == m_views.end()) {
+        return nullptr;
+    }
+    View &v = it->second;
+    m_book.setCompression(v.compression);
+    auto frame = std::make_shared<LadderBookFrame>();
+    frame->epoch = v.epoch;
+    frame->version = ++v.version;
+    frame->ack = m_ack;
+    frame->revision = m_revision + v.revision;
+    frame->rangeRevision = m_rangeRevision + v.rangeRevision;
+    frame->resyncRequests = m_resyncRequests;
+    frame->crossedDeltas = m_crossedDeltas;
+    frame->hasBook = m_hasBook;
+    frame->tickSize = m_tickSize;
+    frame->bestBid = m_bestBid;
+    frame->bestAsk = m_bestAsk;
+    frame->bufferMinTick = m_bufferMinTick;
+    frame->bufferMaxTick = m_bufferMaxTick;
+    frame->centerTick = m_centerTick;
+    frame->hasPages = v.hasPages;
+    frame->pagesConnected = pagesConnected(v);
+    frame->pageMinTick = v.pageMinTick;
+    frame->pageMaxTick = v.pageMaxTick;
+    frame->pageTickSize = v.pageTickSize;
+    buildRegion(v, *frame);
+    buildCumulativeNotional(v, *frame);
+    collectDirty(v, *frame, consumedVersion);
+    return frame;
+}
+
+void LadderBookModel::buildRegion(const View &view, LadderBookFrame &frame) const
+{
+    const qint64 c = std::max(1, view.compression);
+    frame.compression = c;
+    frame.spreadStable = view.stableBidBucket != 0 && view.stableAskBucket != 0;
+
+    QVector<DomLevel> buckets; // ascending
+    // Align compressed buckets so bids are floored and asks are ceiled. This prevents the
+    // ask side from "shifting down" by up to (compression-1) ticks compared to other ladders.
+    const qint64 viewMin = LadderBook::floorBucket(view.viewMinTick, c);
+    const qint64 viewMax = LadderBook::ceilBucket(view.viewMaxTick, c);
+    const qint64 viewRows = (viewMax - viewMin) / c + 1;
+    const qint64 margin = std::clamp(viewRows / 2, kMinRegionMargin, kMaxRegionMargin);
+    if (m_hasBook && m_tickSize > 0.0 && view.hasView && viewRows > 0 && viewRows + 2 * margin <= 2000000) {
+        frame.viewMinTick = viewMin;
+        frame.viewMaxTick = viewMax;
+        frame.regionMinTick = viewMin - margin * c;
+        frame.regionMaxTick = viewMax + margin * c;
+        const qint64 regionMin = frame.regionMinTick;
+        const qint64 regionMax = frame.regionMaxTick;
+        buckets.resize(static_cast<int>(viewRows + 2 * margin));
+        for (int i = 0; i < buckets.size(); ++i) {
+            const qint64 bucketTick = regionMin + static_cast<qint64>(i) * c;
+            buckets[i].tick = bucketTick;
+            buckets[i].price = static_cast<double>(bucketTick) * m_tickSize;
+        }
+
+        // Both books use the same bucket grid, so each source is one contiguous slice of the range.
+        auto copyBuckets = [&](const LadderBook &source, qint64 fromBucket, qint64 toBucket, bool overwrite) {
+            fromBucket = std::max(fromBucket, regionMin);
+            toBucket = std::min(toBucket, regionMax);
+            for (qint64 t = fromBucket; overwrite && t <= toBucket; t += c) {
+                DomLevel &lvl = buckets[static_cast<int>((t - regionMin) / c)];
+                lvl.bidQty = 0.0;
+                lvl.askQty = 0.0;
+            }
+            source.forEachBucket(fromBucket, toBucket, [&](qint64 bucketTick, const LadderBook::Entry &e) {
+                DomLevel &lvl = buckets[static_cast<int>((bucketTick - regionMin) / c)];
+                lvl.bidQty = e.bidQty;
+                lvl.askQty = e.askQty;
+            });
+        };
+        copyBuckets(m_book, regionMin, regionMax, false);
+        // Outside the live window, paged depth is fresher than whatever the live book still holds.
+        if (pagesConnected(view)) {
+            const qint64 liveMin = LadderBook::floorBucket(m_bufferMinTick, c);
+            const qint64 liveMax = LadderBook::ceilBucket(m_bufferMaxTick, c);
+            copyBuckets(view.pageBook, LadderBook::floorBucket(view.pageMinTick, c), liveMin - c, true);
+            copyBuckets(view.pageBook, liveMax + c, LadderBook::ceilBucket(view.pageMaxTick, c), true);
+        }
+    }
+
+    snapshotSpread(view, &buckets, c, frame.spread);
+    frame.region.reserve(buckets.size());
+    for (int i = buckets.size() - 1; i >= 0; --i) {
+        clampToSpread(buckets[i], frame.spread);
+        frame.region.push_back(buckets[i]);
+    }
+}
+
+bool LadderBookModel::snapshotSpread(const View &view,
+                                     const QVector<DomLevel> *buckets,
+                                     qint64 compression,
+                                     LadderSpreadBuckets &spread) const
+{
+    qint64 backendBidBucket = 0;
+    qint64 backendAskBucket = 0;
+    bool backendHasBid = false;
+    bool backendHasAsk = false;
+    if (m_bestBid > 0.0) {
+        const qint64 bestBidTick = priceToRawTick(m_bestBid, true);
+        if (bestBidTick != 0) {
+            backendBidBucket = LadderBook::floorBucket(bestBidTick, compression);
+            backendHasBid = true;
+        }
+    }
+    if (m_bestAsk > 0.0) {
+        const qint64 bestAskTick = priceToRawTick(m_bestAsk, true);
+        if (bestAskTick != 0) {
+            backendAskBucket = LadderBook::ceilBucket(bestAskTick, compression);
+            backendHasAsk = true;
+        }
+    }
+    const bool backendOk = backendHasBid && backendHasAsk && backendBidBucket < backendAskBucket;
+
+    // Sanitize: never show asks at/below best bid bucket, and never show bids at/above best ask bucket.
+    // Under volatile / out-of-order frames, aggregated buckets can momentarily contain stale side data
+    // that would look "impossible" in the UI. This keeps rendering sane until the next resync.
+    spread = LadderSpreadBuckets();
+    spread.bid = view.stableBidBucket;
+    spread.ask = view.stableAskBucket;
+    spread.haveBid = (spread.bid != 0);
+    spread.haveAsk = (spread.ask != 0);
+
+    if (!spread.haveBid || !spread.haveAsk) {
+        if (!buckets) {
+            return false;
+        }
+        // Fallback: derive from the rows at hand.
+        spread = LadderSpreadBuckets();
+        for (const auto &lvl : *buckets) {
+            if (lvl.tick == 0) continue;
+            if (lvl.bidQty > 0.0) {
+                if (!spread.haveBid || lvl.tick > spread.bid) {
+                    spread.bid = lvl.tick;
+                    spread.haveBid = true;
+                }
+            }
+            if (lvl.askQty > 0.0) {
+                if (!spread.haveAsk || lvl.tick < spread.ask) {
+                    spread.ask = lvl.tick;
+                    spread.haveAsk = true;
+                }
+            }
+        }
+    }
+
+    if (!spread.haveBid || !spread.haveAsk) {
+        if (!spread.haveBid && backendHasBid) {
+            spread.bid = backendBidBucket;
+            spread.haveBid = true;
+        }
+        if (!spread.haveAsk && backendHasAsk) {
+            spread.ask = backendAskBucket;
+            spread.haveAsk = true;
+        }
+    }
+
+    // If buckets are inconsistent, fall back to backend best-bid/ask buckets when available.
+    if (spread.haveBid && spread.haveAsk && spread.bid >= spread.ask && backendOk) {
+        spread.bid = backendBidBucket;
+        spread.ask = backendAskBucket;
+    }
+    return true;
+}
+
+void LadderBookModel::clampToSpread(DomLevel &lvl, const LadderSpreadBuckets &spread)
+{
+    const bool lockedSpread = spread.haveBid && spread.haveAsk && spread.bid == spread.ask;
+    if (spread.haveBid) {
+        if (lockedSpread) {
+            if (lvl.tick < spread.bid) {
+                lvl.askQty = 0.0;
+            }
+        } else if (lvl.tick <= spread.bid) {
+            lvl.askQty = 0.0;
+        }
+    }
+    if (spread.haveAsk) {
+        if (lockedSpread) {
+            if (lvl.tick > spread.ask) {
+                lvl.bidQty = 0.0;
+            }
+        } else if (lvl.tick >= spread.ask) {
+            lvl.bidQty = 0.0;
+        }
+    }
+
+    // Strong invariant: there must be no liquidity strictly inside the spread range.
+    // If a transient out-of-order delta makes us aggregate stale bid+ask into interior buckets,
+    // clear them so "impossible" levels can't remain visible until the next resync.
+    if (spread.haveBid && spread.haveAsk && spread.bid < spread.ask && lvl.tick > spread.bid
+        && lvl.tick < spread.ask) {
+        lvl.bidQty = 0.0;
+        lvl.askQty = 0.0;
+    }
+}
+
+void LadderBookModel::buildCumulativeNotional(const View &view, LadderBookFrame &frame) const
+{
+    // Measured from the stable top of book; without one, from the cached bucket book (stable
+    // across scrolling either way).
+    qint64 bidBucket = view.stableBidBucket;
+    qint64 askBucket = view.stableAskBucket;
+    if (bidBucket == 0 || askBucket == 0) {
+        bidBucket = 0;
+        askBucket = 0;
+        m_book.bestBuckets(bidBucket, askBucket);
+    }
+    frame.notionalBidBucket = bidBucket;
+    frame.notionalAskBucket = askBucket;
+    if (!(m_tickSize > 0.0)) {
+        return;
+    }
+    const double tickSize = m_tickSize;
+    auto notional = [tickSize](qint64 t, double qty) {
+        return qty > 0.0 ? qty * std::abs(static_cast<double>(t) * tickSize) : 0.0;
+    };
+    const qint64 c = frame.compression;
+    const qint64 top = frame.regionMaxTick;
+    const qint64 bottom = frame.regionMinTick;
+    if (bidBucket != 0) {
+        frame.notionalAtBid = notional(bidBucket, m_book.bucket(bidBucket).bidQty);
+    }
+    if (askBucket != 0) {
+        frame.notionalAtAsk = notional(askBucket, m_book.bucket(askBucket).askQty);
+    }
+    const int rows = frame.region.size();
+    if (rows == 0) {
+        return;
+    }
+
+    QVector<LadderBook::Entry> live(rows); // top-down, live book only
+    m_book.forEachBucket(bottom, top, [&](qint64 t, const LadderBook::Entry &e) {
+        live[static_cast<int>((top - t) / c)] = e;
+    });
+    if (bidBucket != 0) {
+        double total = 0.0;
+        m_book.forEachBucket(top + c, bidBucket, [&](qint64 t, const LadderBook::Entry &e) {
+            total += notional(t, e.bidQty);
+        });
+        frame.cumBid.resize(rows);
+        for (int i = 0; i < rows; ++i) {
+            const qint64 t = top - static_cast<qint64>(i) * c;
+            if (t > bidBucket) {
+                frame.cumBid[i] = frame.notionalAtBid;
+                continue;
+            }
+            total += notional(t, live[i].bidQty);
+            frame.cumBid[i] = total;
+        }
+    }
+    if (askBucket != 0) {
+        double total = 0.0;
+        m_book.forEachBucket(askBucket, bottom - c, [&](qint64 t, const LadderBook::Entry &e) {
+            total += notional(t, e.askQty);
+        });
+        frame.cumAsk.resize(rows);
+        for (int i = rows - 1; i >= 0; --i) {
+            const qint64 t = top - static_cast<qint64>(i) * c;
+            if (t < askBucket) {
+                frame.cumAsk[i] = frame.notionalAtAsk;
+                continue;
+            }
+            total += notional(t, live[i].askQty);
+            frame.cumAsk[i] = total;
+        }
+    }
+}
+
+void LadderBookModel::collectDirty(View &view, LadderBookFrame &frame, quint64 consumedVersion)
+{
+    DirtyEntry entry;
+    entry.version = frame.version;
+    entry.all = view.dirtyAll;
+    if (!entry.all) {
+        entry.ticks.reserve(view.dirty.size());
+        for (qint64 t : std::as_const(view.dirty)) {
+            entry.ticks.push_back(t);
+        }
+    }
+    view.dirty.clear();
+    view.dirtyAll = false;
+    while (!view.dirtyHistory.empty() && view.dirtyHistory.front().version <= consumedVersion) {
+        view.dirtyHistory.pop_front();
+    }
+    view.dirtyHistory.push_back(std::move(entry));
+
+    // Everything the reader has not rendered yet, as one set.
+    frame.dirtyBase = consumedVersion;
+    bool all = view.dirtyHistory.size() > kMaxDirtyHistory;
+    QSet<qint64> ticks;
+    for (auto it = view.dirtyHistory.cbegin(); !all && it != view.dirtyHistory.cend(); ++it) {
+        all = it->all;
+        for (qint64 t : it->ticks) {
+            ticks.insert(t);
+        }
+        all = all || ticks.size() > kMaxDirty;
+    }
+    frame.dirtyAll = all;
+    if (all) {
+        // Nothing older can narrow this down any more; keep one entry standing for it.
+        view.dirtyHistory.clear();
+        DirtyEntry collapsed;
+        collapsed.version = frame.version;
+        collapsed.all = true;
+        view.dirtyHistory.push_back(std::move(collapsed));
+        return;
+    }
+    frame.dirty.reserve(ticks.size());
+    for (qint64 t : std::as_const(ticks)) {
+        frame.dirty.push_back(t);
+    }
+    std::sort(frame.dirty.begin(), frame.dirty.end());
+}
+
+LadderFrameSlicer::Cursor LadderFrameSlicer::sources(const LadderBookFrame &frame, qint64 minTick, qint64 maxTick)
+{
+    Cursor sources;
+    if (minTick > maxTick) {
+        std::swap(minTick, maxTick);
+    }
+    const qint64 compression = frame.compression;
+    sources.version = frame.version;
+    sources.tickSize = frame.tickSize;
+    sources.compression = compression;
+    // Align compressed buckets so bids are floored and asks are ceiled. This prevents the
+    // ask side from "shifting down" by up to (compression-1) ticks compared to other ladders.
+    sources.minTick = LadderBook::floorBucket(minTick, compression);
+    sources.maxTick = LadderBook::ceilBucket(maxTick, compression);
+    // Outside the live window, paged depth is fresher than whatever the live book still holds.
+    sources.usePages = frame.pagesConnected;
+    sources.liveMinBucket = LadderBook::floorBucket(frame.bufferMinTick, compression);
+    sources.liveMaxBucket = LadderBook::ceilBucket(frame.bufferMaxTick, compression);
+    sources.pageMinBucket = LadderBook::floorBucket(frame.pageMinTick, compression);
+    sources.pageMaxBucket = LadderBook::ceilBucket(frame.pageMaxTick, compression);
+    sources.spread = frame.spread;
+    return sources;
+}
+
+DomLevel LadderFrameSlicer::level(const LadderBookFrame &frame, qint64 bucketTick)
+{
+    if (bucketTick >= frame.regionMinTick && bucketTick <= frame.regionMaxTick) {
+        return frame.region[static_cast<int>((frame.regionMaxTick - bucketTick) / frame.compression)];
+    }
+    DomLevel lvl;
+    lvl.tick = bucketTick;
+    lvl.price = static_cast<double>(bucketTick) * frame.tickSize;
+    return lvl;
+}
+
+DomSnapshot LadderFrameSlicer::snapshot(const LadderBookFrame &frame, const Cursor &sources)
+{
+    DomSnapshot snap;
+    snap.tickSize = frame.tickSize;
+    snap.compression = sources.compression;
+    snap.minTick = sources.minTick;
+    snap.maxTick = sources.maxTick;
+    // Keep displayed best prices consistent with sanitized buckets when possible.
+    snap.bestBid = sources.spread.haveBid ? static_cast<double>(sources.spread.bid) * frame.tickSize : frame.bestBid;
+    snap.bestAsk = sources.spread.haveAsk ? static_cast<double>(sources.spread.ask) * frame.tickSize : frame.bestAsk;
+    const qint64 bucketCount = (sources.maxTick - sources.minTick) / sources.compression + 1;
+    if (bucketCount <= 0 || bucketCount > kMaxRows) {
+        return snap;
+    }
+    snap.levels.reserve(static_cast<int>(bucketCount));
+    for (qint64 t = sources.maxTick; t >= sources.minTick; t -= sources.compression) {
+        snap.levels.push_back(level(frame, t));
+    }
+    return snap;
+}
+
+DomSnapshotDelta LadderFrameSlicer::delta(const LadderBookFrame &frame, qint64 minTick, qint64 maxTick, bool forceFull)
+{
+    DomSnapshotDelta delta;
+    const Cursor prev = std::exchange(m_cursor, Cursor());
+    Cursor next = sources(frame, minTick, maxTick);
+    const qint64 c = next.compression;
+    const qint64 rowCount = (next.maxTick - next.minTick) / c + 1;
+    m_covered = rowCount > 0 && next.minTick >= frame.regionMinTick && next.maxTick <= frame.regionMaxTick;
+    // Rows changed between the two frames are known unless the book thread lost track.
+    const bool dirtyKnown = prev.version == frame.version || (frame.dirtyBase <= prev.version && !frame.dirtyAll);
+    bool incremental = !forceFull && prev.valid && m_covered && dirtyKnown && rowCount <= kMaxRows
+                       && prev.tickSize == next.tickSize && prev.compression == c
+                       && (prev.maxTick - prev.minTick) / c + 1 == rowCount && prev.usePages == next.usePages
+                       // Without pages every row reads the live book, whose trims are in `dirty`.
+                       && (!next.usePages
+                           || (prev.liveMinBucket == next.liveMinBucket && prev.liveMaxBucket == next.liveMaxBucket
+                               && prev.pageMinBucket == next.pageMinBucket
+                               && prev.pageMaxBucket == next.pageMaxBucket))
+                       && frame.spreadStable && next.spread.haveBid && next.spread.haveAsk;
+    const qint64 shift = incremental ? (next.maxTick - prev.maxTick) / c : 0;
+    incremental = incremental && std::abs(shift) < rowCount;
+
+    // Rows to resend: buckets the book touched, rows the window scrolled into view, and the
+    // rows whose spread clamping changed because the top of book moved.
+    QVector<qint64> ticks;
+    if (incremental) {
+        if (prev.version != frame.version) {
+            ticks.reserve(frame.dirty.size() + 16);
+            for (qint64 t : frame.dirty) {
+                if (t >= next.minTick && t <= next.maxTick && (t - next.minTick) % c == 0) {
+                    ticks.push_back(t);
+                }
+            }
+        }
+        const qint64 exposed = std::min<qint64>(std::abs(shift), rowCount);
+        for (qint64 i = 0; i < exposed; ++i) {
+            ticks.push_back(shift > 0 ? next.maxTick - i * c : next.minTick + i * c);
+        }
+        if (!(prev.spread == next.spread)) {
+            const qint64 lo = std::max(next.minTick,
+                                       std::min({prev.spread.bid, prev.spread.ask, next.spread.bid, next.spread.ask}));
+            const qint64 hi = std::min(next.maxTick,
+                                       std::max({prev.spread.bid, prev.spread.ask, next.spread.bid, next.spread.ask}));
+            if (hi >= lo && (hi - lo) / c >= kMaxDeltaRows) {
+                incremental = false;
+            }
+            for (qint64 t = LadderBook::floorBucket(lo, c); incremental && t <= hi; t += c) {
+                ticks.push_back(t);
+            }
+        }
+        if (ticks.size() > kMaxDeltaRows) {
+            incremental = false;
+        }
+    }
+
+    if (!incremental) {
+        delta.snapshot = snapshot(frame, next);
+        delta.rowCount = delta.snapshot.levels.size();
+        next.valid = m_covered && delta.rowCount > 0 && next.spread.haveBid && next.spread.haveAsk;
+        m_cursor = next;
+        return delta;
+    }
+
+    std::sort(ticks.begin(), ticks.end());
+    ticks.erase(std::unique(ticks.begin(), ticks.end()), ticks.end());
+    delta.full = false;
+    delta.rowCount = static_cast<int>(rowCount);
+    delta.shiftRows = static_cast<int>(shift);
+    delta.snapshot.tickSize = next.tickSize;
+    delta.snapshot.bestBid = static_cast<double>(next.spread.bid) * next.tickSize;
+    delta.snapshot.bestAsk = static_cast<double>(next.spread.ask) * next.tickSize;
+    delta.snapshot.minTick = next.minTick;
+    delta.snapshot.maxTick = next.maxTick;
+    delta.snapshot.compression = c;
+    delta.indices.reserve(ticks.size());
+    delta.levels.reserve(ticks.size());
+    for (qint64 t : std::as_const(ticks)) {
+        delta.indices.push_back(static_cast<int>((next.maxTick - t) / c));
+        delta.levels.push_back(level(frame, t));
+    }
+    next.valid = true;
+    m_cursor = next;
+    return delta;
+}
@@ -0,0 +1,252 @@
+// Book state behind the ladders of one backend feed, maintained off the GUI thread and read
+// through frames.
+
+#pragma once
+
+#include "BackendFrameDecoder.h"
+#include "DomTypes.h"
+#include "LadderBook.h"
+
+#include <QSet>
+#include <QVector>
+#include <QtGlobal>
+
+#include <deque>
+#include <map>
+#include <memory>
+
+// Buckets viewport rows are clamped against: no asks at or below the bid, no bids at or above
+// the ask, nothing strictly between them.
+struct LadderSpreadBuckets {
+    qint64 bid = 0;
+    qint64 ask = 0;
+    bool haveBid = false;
+    bool haveAsk = false;
+
+    bool operator==(const LadderSpreadBuckets &o) const
+    {
+        return bid == o.bid && ask == o.ask && haveBid == o.haveBid && haveAsk == o.haveAsk;
+    }
+};
+
+// Immutable state of one view of a LadderBookModel after a batch of backend messages. The
+// book thread never touches a frame once it is published, so the GUI reads it without locking
+// for as long as it holds the pointer; it just swaps in the newest one when it gets to it.
+struct LadderBookFrame {
+    quint64 epoch = 0;   // LadderBookModel::resetView() generation; frames of an older epoch are stale
+    quint64 version = 0; // +1 per published frame
+    quint64 ack = 0;     // newest control command id among the messages applied
+    // Counters the GUI compares with the frame it took before.
+    quint64 revision = 0;       // book contents changed
+    quint64 rangeRevision = 0;  // buffer bounds, center or tick size changed, or a page was answered
+    quint64 resyncRequests = 0; // a full ladder came in crossed and was dropped
+    quint64 crossedDeltas = 0;  // deltas left the book crossed (or about to be)
+
+    bool hasBook = false;
+    double tickSize = 0.0;
+    double bestBid = 0.0; // as sent by the backend
+    double bestAsk = 0.0;
+    qint64 bufferMinTick = 0; // live window
+    qint64 bufferMaxTick = 0;
+    qint64 centerTick = 0;
+    bool hasPages = false;
+    bool pagesConnected = false; // pages extend the live window (see LadderClient::bufferMinTick)
+    qint64 pageMinTick = 0;
+    qint64 pageMaxTick = 0;
+    double pageTickSize = 0.0;
+    qint64 compression = 1;
+
+    // Rows around the view given to LadderBookModel::setView(), top-down like DomSnapshot::levels
+    // and already clamped to `spread`. Bounds are bucketized; the region is empty when
+    // regionMaxTick < regionMinTick.
+    qint64 viewMinTick = 0;
+    qint64 viewMaxTick = -1;
+    qint64 regionMinTick = 0;
+    qint64 regionMaxTick = -1;
+    QVector<DomLevel> region;
+    LadderSpreadBuckets spread;
+    bool spreadStable = false; // `spread` is the stable top of book rather than read off `region`
+
+    // Live-book notional summed from the best bucket out to each region row, per side; rows on
+    // the other side of the spread hold the best bucket alone (see cumulativeNotionalForPrice).
+    qint64 notionalBidBucket = 0; // 0 when the side is missing
+    qint64 notionalAskBucket = 0;
+    double notionalAtBid = 0.0;
+    double notionalAtAsk = 0.0;
+    QVector<double> cumBid;
+    QVector<double> cumAsk;
+
+    // Buckets whose rows changed after frame `dirtyBase`; every row when `dirtyAll`.
+    quint64 dirtyBase = 0;
+    bool dirtyAll = true;
+    QVector<qint64> dirty;
+};
+
+// The live window, paged depth and top-of-book tracking LadderClient used to keep on the GUI
+// thread: messages are applied, trimmed and sanitized here, and publish() renders the result
+// into a LadderBookFrame. One model holds the book of one backend feed; every ladder showing
+// that feed is a view of it with its own compression, view window and pages, so a delta is
+// applied once however many ladders show it. Not thread-safe; one thread owns a model.
+class LadderBookModel {
+public:
+    // Rows the frame region extends past each side of the view: half the view, within bounds.
+    static constexpr qint64 kMinRegionMargin = 128;
+    static constexpr qint64 kMaxRegionMargin = 2048;
+    // Dirty buckets handed out at most; more means "every row".
+    static constexpr int kMaxDirty = 4096;
+
+    // Views are named by the caller; calls naming a view that was never added are ignored.
+    void addView(quint64 view);
+    void removeView(quint64 view);
+    // Drops the book every view reads.
+    void resetBook();
+    // Drops the pages of `view`; its frames published afterwards carry `epoch`.
+    void resetView(quint64 view, quint64 epoch);
+    void setCompression(quint64 view, int factor);
+    // The book keeps the depth the widest view asks for.
+    void setCacheLevels(quint64 view, int levels);
+    // Raw tick range the view shows; its frames carry the rows around it.
+    void setView(quint64 view, qint64 minTick, qint64 maxTick);
+    void noteAck(quint64 id);
+    void applyFull(const ParsedLadderFull &msg);
+    void applyDelta(const ParsedLadderDelta &msg);
+    // Levels of a "range" reply `view` asked for; [fromTick, toTick] is the span it covers,
+    // already clipped to what the backend holds.
+    void applyPage(quint64 view,
+                   const QVector<ParsedLadderRow> &rows,
+                   double tickSize,
+                   qint64 fromTick,
+                   qint64 toTick,
+                   bool backendBookKnown);
+    void clearPages(quint64 view);
+
+    // Frame of the current state as `view` shows it (nullptr for an unknown view). Dirty rows
+    // are reported since frame `consumedVersion`, the newest one its reader has rendered.
+    std::shared_ptr<const LadderBookFrame> publish(quint64 view, quint64 consumedVersion);
+
+private:
+    struct DirtyEntry {
+        quint64 version = 0;
+        bool all = false;
+        QVector<qint64> ticks;
+    };
+
+    // What one ladder adds on top of the shared book.
+    struct View {
+        int compression = 1;
+        int cacheLevels = 0;
+        bool hasView = false;
+        qint64 viewMinTick = 0;
+        qint64 viewMaxTick = 0;
+        // Depth paged in with LadderClient::requestRange() outside the live window; one
+        // contiguous span [pageMinTick, pageMaxTick] (possibly straddling the live window).
+        LadderBook pageBook;
+        bool hasPages = false;
+        qint64 pageMinTick = 0;
+        qint64 pageMaxTick = 0;
+        double pageTickSize = 0.0;
+        // Last stable top-of-book buckets on this view's grid.
+        // Used to keep DOM sanitization/highlighting consistent during transient out-of-order frames.
+        qint64 stableBidBucket = 0;
+        qint64 stableAskBucket = 0;
+
+        quint64 epoch = 0;
+        quint64 version = 0;
+        // Added to the book's counters of the same name.
+        quint64 revision = 0;
+        quint64 rangeRevision = 0;
+        // Buckets changed since the last publish(), and per frame since the reader's last one.
+        QSet<qint64> dirty;
+        bool dirtyAll = true;
+        std::deque<DirtyEntry> dirtyHistory;
+    };
+
+    qint64 priceToRawTick(double price, bool nudge) const;
+    // On the active grid, which has to be the one of `compression`.
+    bool crossedBookLikely(const QSet<qint64> &dirtyBuckets, qint64 compression) const;
+    void updateCacheLevels();
+    // Trimmed ticks are reported raw, whatever the views' grids.
+    void trimBookToWindow(qint64 minTick, qint64 maxTick, QSet<qint64> *dirtyTicks = nullptr);
+    // Sanitizes the grid of `view` against the top of book and records its stable buckets;
+    // false when the book is crossed on that grid.
+    bool sanitizeTopOfBook(View &view, QSet<qint64> *dirtyBuckets);
+    void clearStableBuckets();
+    bool pagesConnected(const View &view) const;
+    // After a live frame: pages that no longer extend the live window are dropped.
+    void dropDetachedPages(View &view);
+    static void markDirty(View &view, const QSet<qint64> &buckets);
+    static void markAllDirty(View &view);
+    void markAllDirty();
+    void buildRegion(const View &view, LadderBookFrame &frame) const;
+    bool snapshotSpread(const View &view,
+                        const QVector<DomLevel> *buckets,
+                        qint64 compression,
+                        LadderSpreadBuckets &spread) const;
+    static void clampToSpread(DomLevel &level, const LadderSpreadBuckets &spread);
+    void buildCumulativeNotional(const View &view, LadderBookFrame &frame) const;
+    static void collectDirty(View &view, LadderBookFrame &frame, quint64 consumedVersion);
+
+    // Live window, plus depth kept around the best price (see trimBookToWindow). Its active
+    // grid follows the view being worked on.
+    LadderBook m_book;
+    qint64 m_bufferMinTick = 0; // live window of the backend ladder
+    qint64 m_bufferMaxTick = 0;
+    qint64 m_centerTick = 0;
+    double m_tickSize = 0.0;
+    bool m_hasBook = false;
+    double m_bestBid = 0.0;
+    double m_bestAsk = 0.0;
+    int m_cacheLevels = 0; // widest of the views
+
+    quint64 m_ack = 0;
+    quint64 m_revision = 0;
+    quint64 m_rangeRevision = 0;
+    quint64 m_resyncRequests = 0;
+    quint64 m_crossedDeltas = 0;
+    std::map<quint64, View> m_views;
+};
+
+// Cuts the DOM snapshots of one view out of published frames, and the rows that changed
+// between two of them. Owned by the reader (LadderClient); frames are only read.
+class LadderFrameSlicer {
+public:
+    // What the last delta() handed out; the next one is diffed against it.
+    struct Cursor {
+        bool valid = false;
+        quint64 version = 0; // frame it was read from
+        double tickSize = 0.0;
+        qint64 compression = 1;
+        qint64 minTick = 0; // bucketized, like DomSnapshot
+        qint64 maxTick = 0;
+        bool usePages = false;
+        qint64 liveMinBucket = 0;
+        qint64 liveMaxBucket = 0;
+        qint64 pageMinBucket = 0;
+        qint64 pageMaxBucket = 0;
+        LadderSpreadBuckets spread;
+    };
+
+    // Rows handed out at most per snapshot; a wider view gets an empty one.
+    static constexpr qint64 kMaxRows = 2000000;
+    // Changed rows sent as a delta at most; more goes out as a full snapshot.
+    static constexpr int kMaxDeltaRows = 4096;
+
+    static Cursor sources(const LadderBookFrame &frame, qint64 minTick, qint64 maxTick);
+    // Row `bucketTick` of the frame region; empty outside it.
+    static DomLevel level(const LadderBookFrame &frame, qint64 bucketTick);
+    static DomSnapshot snapshot(const LadderBookFrame &frame, const Cursor &sources);
+
+    // The rows of snapshot() for [minTick, maxTick] that changed since the previous call, or
+    // the whole snapshot when the grid, the page/live split or too much of the book moved (or
+    // `forceFull`). The frame has to report its dirty rows since the one passed last.
+    DomSnapshotDelta delta(const LadderBookFrame &frame, qint64 minTick, qint64 maxTick, bool forceFull);
+    // The next delta() is a full snapshot.
+    void invalidate() { m_cursor.valid = false; }
+    const Cursor &cursor() const { return m_cursor; }
+    // The view of the last delta() lay within the frame region; rows outside it went out empty.
+    bool covered() const { return m_covered; }
+
+private:
+    Cursor m_cursor;
+    bool m_covered = false;
+};
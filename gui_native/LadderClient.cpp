@@ -1,4 +1,7 @@
 #include "LadderClient.h"
+#include "BackendProcessPool.h"
+#include "LadderDeltaCoalescer.h"
+#include "MarketDataHub.h"
 #include "PrintsWidget.h"
 
 #include <QDateTime>
@@ -14,11 +17,15 @@
 #include <QNetworkProxyQuery>
 #include <QUrl>
 #include <QMetaType>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QThread>
 #include <QSet>
 #include <QTimer>
 
 #include <json.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <limits>
@@ -27,6 +34,15 @@
 
 using json = nlohmann::json;
 
+struct LadderBookChannel {
+    QMutex mutex;
+    std::shared_ptr<const LadderBookFrame> latest;
+    bool closed = false; // the client is gone; guarded by `mutex`
+    std::atomic<bool> notifyPending{false};
+    // Newest frame the client rendered from; dirty rows are reported relative to it.
+    std::atomic<quint64> consumedVersion{0};
+};
+
 namespace {
 static QString safeFileComponent(QString s)
 {
@@ -216,6 +232,29 @@ static bool parseTickValue(const json &value, qint64 &outTick)
     return false;
 }
 
+static quint64 parseGeneration(const json &j)
+{
+    const auto it = j.find("gen");
+    if (it != j.end() && it->is_number_unsigned()) {
+        return static_cast<quint64>(it->get<std::uint64_t>());
+    }
+    return 0;
+}
+
+static BackendStatSummary parseStatSummary(const json &j, const char *key)
+{
+    BackendStatSummary out;
+    const auto it = j.find(key);
+    if (it == j.end() || !it->is_object()) {
+        return out;
+    }
+    out.valid = it->value("n", 0ULL) > 0;
+    out.p50 = it->value("p50", 0.0);
+    out.p99 = it->value("p99", 0.0);
+    out.max = it->value("max", 0.0);
+    return out;
+}
+
 class BackendParseWorker final : public QObject {
 public:
     explicit BackendParseWorker(LadderClient *owner, QObject *parent = nullptr)
@@ -223,20 +262,37 @@ public:
     {
     }
 
-    void parseLines(const QVector<QByteArray> &lines)
+    void parseLines(const BackendLineBatch &lines)
     {
         QVector<ParsedTradeEvent> tradeBatch;
-        QVector<ParsedLadderDelta> deltaBatch;
+        QVector<ParsedWallEvent> wallBatch;
         ParsedLadderFull lastFull;
         bool haveFull = false;
-        for (const QByteArray &line : lines) {
-            if (line.trimmed().isEmpty()) {
+        BackendStats lastStats;
+        bool haveStats = false;
+        for (int lineIndex = 0; lineIndex < lines.size(); ++lineIndex) {
+            const char *line = lines.lineData(lineIndex);
+            const char *lineEnd = line + lines.lineSize(lineIndex);
+            ParsedLadderFull full;
+            ParsedLadderDelta delta;
+            switch (m_decoder.decode(line, lineEnd, full, delta, tradeBatch)) {
+            case BackendFrameDecoder::Kind::Ladder:
+                m_deltas.supersede(full.generation);
+                lastFull = std::move(full);
+                haveFull = true;
+                continue;
+            case BackendFrameDecoder::Kind::LadderDelta:
+                m_deltas.add(std::move(delta));
+                continue;
+            case BackendFrameDecoder::Kind::Trades:
                 continue;
+            case BackendFrameDecoder::Kind::Other:
+                break;
             }
 
             json j;
             try {
-                j = json::parse(line.constData(), line.constData() + line.size());
+                j = json::parse(line, lineEnd);
             } catch (...) {
                 continue;
             }
@@ -257,6 +313,39 @@ public:
             }
 
             if (type == "trades") {
+                const quint64 generation = parseGeneration(j);
+                // Columnar batch: parallel arrays, one entry per (possibly aggregated) print.
+                const auto priceIt = j.find("price");
+                const auto qtyIt = j.find("qty");
+                if (priceIt != j.end() && priceIt->is_array() && qtyIt != j.end() && qtyIt->is_array()) {
+                    const auto tickIt = j.find("tick");
+                    const auto sideIt = j.find("side");
+                    const bool haveTicks = tickIt != j.end() && tickIt->is_array();
+                    const bool haveSides = sideIt != j.end() && sideIt->is_array();
+                    const std::size_t n = std::min(priceIt->size(), qtyIt->size());
+                    tradeBatch.reserve(tradeBatch.size() + static_cast<int>(n));
+                    for (std::size_t i = 0; i < n; ++i) {
+                        const json &p = (*priceIt)[i];
+                        const json &q = (*qtyIt)[i];
+                        if (!p.is_number() || !q.is_number()) {
+                            continue;
+                        }
+                        ParsedTradeEvent ev;
+                        ev.generation = generation;
+                        ev.price = p.get<double>();
+                        ev.qtyBase = q.get<double>();
+                        if (haveSides && i < sideIt->size()) {
+                            const json &s = (*sideIt)[i];
+                            ev.buy = s.is_number() ? (s.get<int>() != 0) : (s.is_string() && s.get<std::string>() != "sell");
+                        }
+                        qint64 tick = 0;
+                        if (haveTicks && i < tickIt->size() && parseTickValue((*tickIt)[i], tick)) {
+                            ev.tick = tick;
+                        }
+                        tradeBatch.push_back(ev);
+                    }
+                    continue;
+                }
                 auto eventsIt = j.find("events");
                 if (eventsIt != j.end() && eventsIt->is_array()) {
                     tradeBatch.reserve(tradeBatch.size() + static_cast<int>(eventsIt->size()));
@@ -265,6 +354,7 @@ public:
                             continue;
                         }
                         ParsedTradeEvent ev;
+                        ev.generation = generation;
                         ev.price = e.value("price", 0.0);
                         ev.qtyBase = e.value("qty", 0.0);
                         const std::string side = e.value("side", std::string("buy"));
@@ -281,6 +371,8 @@ public:
 
             if (type == "ladder") {
                 ParsedLadderFull out;
+                out.generation = parseGeneration(j);
+                out.ack = j.value("ack", 0ULL);
                 out.bestBid = j.value("bestBid", 0.0);
                 out.bestAsk = j.value("bestAsk", 0.0);
                 out.tickSize = j.value("tickSize", 0.0);
@@ -308,6 +400,7 @@ public:
                         out.rows.push_back(r);
                     }
                 }
+                m_deltas.supersede(out.generation);
                 lastFull = std::move(out);
                 haveFull = true;
                 continue;
@@ -315,6 +408,8 @@ public:
 
             if (type == "ladder_delta") {
                 ParsedLadderDelta out;
+                out.generation = parseGeneration(j);
+                out.ack = j.value("ack", 0ULL);
                 out.bestBid = j.value("bestBid", 0.0);
                 out.bestAsk = j.value("bestAsk", 0.0);
                 out.tickSize = j.value("tickSize", 0.0);
@@ -352,10 +447,115 @@ public:
                         }
                     }
                 }
-                deltaBatch.push_back(std::move(out));
+                m_deltas.add(std::move(out));
+                continue;
+            }
+
+            if (type == "wall_add" || type == "wall_update" || type == "wall_remove") {
+                ParsedWallEvent ev;
+                ev.kind = (type == "wall_add")      ? ParsedWallEvent::Kind::Add
+                          : (type == "wall_remove") ? ParsedWallEvent::Kind::Remove
+                                                    : ParsedWallEvent::Kind::Update;
+                ev.generation = parseGeneration(j);
+                qint64 tick = 0;
+                if (!j.contains("tick") || !parseTickValue(j["tick"], tick)) {
+                    continue;
+                }
+                ev.wall.id = j.value("id", 0ULL);
+                ev.wall.tick = tick;
+                ev.wall.bid = j.value("side", std::string("bid")) != "ask";
+                ev.wall.qty = j.value("qty", 0.0);
+                ev.wall.added = j.value("added", 0.0);
+                ev.wall.pulled = j.value("pulled", 0.0);
+                ev.wall.traded = j.value("traded", 0.0);
+                ev.wall.moves = j.value("moves", 0);
+                ev.wall.firstSeenMs =
+                    QDateTime::currentMSecsSinceEpoch() - std::max<qint64>(0, j.value("ageMs", qint64(0)));
+                wallBatch.push_back(ev);
+                continue;
+            }
+
+            if (type == "ladder_page") {
+                ParsedLadderPage page;
+                page.generation = parseGeneration(j);
+                page.id = j.value("id", 0ULL);
+                page.fromTick = j.value("from", qint64(0));
+                page.toTick = j.value("to", qint64(0));
+                page.bookMinTick = j.value("bookMinTick", qint64(0));
+                page.bookMaxTick = j.value("bookMaxTick", qint64(0));
+                page.tickSize = j.value("tickSize", 0.0);
+                auto rowsIt = j.find("rows");
+                if (rowsIt != j.end() && rowsIt->is_array()) {
+                    page.rows.reserve(static_cast<int>(rowsIt->size()));
+                    for (const auto &row : *rowsIt) {
+                        ParsedLadderRow r;
+                        if (!row.contains("tick") || !parseTickValue(row["tick"], r.tick)) {
+                            continue;
+                        }
+                        r.hasBid = row.contains("bid");
+                        r.bid = row.value("bid", 0.0);
+                        r.hasAsk = row.contains("ask");
+                        r.ask = row.value("ask", 0.0);
+                        page.rows.push_back(r);
+                    }
+                }
+                if (m_owner) {
+                    QMetaObject::invokeMethod(
+                        m_owner,
+                        [owner = m_owner, page = std::move(page)]() { owner->handleParsedLadderPage(page); },
+                        Qt::QueuedConnection);
+                }
+                continue;
+            }
+
+            if (type == "replay") {
+                ParsedReplayStatus status;
+                status.file = QString::fromStdString(j.value("file", std::string()));
+                const auto speedIt = j.find("speed");
+                if (speedIt != j.end() && speedIt->is_number()) {
+                    status.speed = QString::number(speedIt->get<double>(), 'g', 4) + QLatin1Char('x');
+                } else {
+                    status.speed = QStringLiteral("max");
+                }
+                status.positionMs = j.value("positionMs", qint64(0));
+                status.done = j.value("done", false);
+                if (m_owner) {
+                    QMetaObject::invokeMethod(
+                        m_owner,
+                        [owner = m_owner, status]() { owner->handleParsedReplayStatus(status); },
+                        Qt::QueuedConnection);
+                }
+                continue;
+            }
+
+            if (type == "stats") {
+                BackendStats stats;
+                stats.intervalMs = j.value("intervalMs", 0LL);
+                stats.framesPerSec = parseStatSummary(j, "framesPerSec");
+                stats.bytesPerSec = parseStatSummary(j, "bytesPerSec");
+                stats.parseUs = parseStatSummary(j, "parseUs");
+                stats.applyUs = parseStatSummary(j, "applyUs");
+                stats.emitUs = parseStatSummary(j, "emitUs");
+                stats.stdoutQueue = parseStatSummary(j, "stdoutQueue");
+                stats.feedLatencyMs = parseStatSummary(j, "feedLatencyMs");
+                stats.allocsPerSec = parseStatSummary(j, "allocsPerSec");
+                stats.frameAllocs = parseStatSummary(j, "frameAllocs");
+                const auto stdoutIt = j.find("stdout");
+                if (stdoutIt != j.end() && stdoutIt->is_object()) {
+                    stats.stdoutCoalesced = stdoutIt->value("coalesced", 0ULL);
+                    stats.stdoutDropped = stdoutIt->value("dropped", 0ULL);
+                }
+                lastStats = stats;
+                haveStats = true;
                 continue;
             }
         }
+        if (haveStats && m_owner) {
+            QMetaObject::invokeMethod(
+                m_owner,
+                [owner = m_owner, lastStats]() { owner->handleParsedStats(lastStats); },
+                Qt::QueuedConnection);
+        }
         if (!tradeBatch.isEmpty() && m_owner) {
             QMetaObject::invokeMethod(
                 m_owner,
@@ -368,16 +568,26 @@ public:
                 [owner = m_owner, lastFull]() { owner->handleParsedLadderFull(lastFull); },
                 Qt::QueuedConnection);
         }
+        // Usually a single net delta: one book apply per batch however long the burst was.
+        QVector<ParsedLadderDelta> deltaBatch = m_deltas.take();
         if (!deltaBatch.isEmpty() && m_owner) {
             QMetaObject::invokeMethod(
                 m_owner,
                 [owner = m_owner, deltaBatch = std::move(deltaBatch)]() { owner->handleParsedLadderDeltas(deltaBatch); },
                 Qt::QueuedConnection);
         }
+        if (!wallBatch.isEmpty() && m_owner) {
+            QMetaObject::invokeMethod(
+                m_owner,
+                [owner = m_owner, wallBatch = std::move(wallBatch)]() { owner->handleParsedWallEvents(wallBatch); },
+                Qt::QueuedConnection);
+        }
     }
 
 private:
     LadderClient *m_owner = nullptr;
+    BackendFrameDecoder m_decoder; // hot line types; everything else is parsed into a DOM below
+    LadderDeltaCoalescer m_deltas; // drained at the end of every parseLines()
 };
 
 static qint64 pow10i(int exp)
@@ -567,6 +777,95 @@ static QThread *sharedBackendParseThread()
     return t;
 }
 
+static QThread *sharedLadderBookThread()
+{
+    static QThread *t = []() -> QThread * {
+        auto *thread = new QThread(QCoreApplication::instance());
+        thread->setObjectName(QStringLiteral("LadderBookThread"));
+        thread->start();
+        return thread;
+    }();
+    return t;
+}
+
+// Owns the LadderBookModel of one backend feed on the book thread; every client showing the
+// feed is a view of it with a channel of its own. Tasks posted by the clients run in order; a
+// frame is published once per burst of them for each view they touched, so a backlog costs one
+// render per view, not one per message.
+class LadderBookWorker final : public QObject {
+public:
+    void addView(quint64 view, LadderClient *owner, std::shared_ptr<LadderBookChannel> channel)
+    {
+        m_views.insert(view, Subscriber{owner, std::move(channel)});
+        m_model.addView(view);
+    }
+
+    void removeView(quint64 view)
+    {
+        m_views.remove(view);
+        m_pendingViews.remove(view);
+        m_model.removeView(view);
+    }
+
+    // `view` is the only view `task` changes; 0 when it changes the book they all read.
+    void run(const std::function<void(LadderBookModel &)> &task, quint64 view)
+    {
+        task(m_model);
+        if (view == 0) {
+            m_publishAll = true;
+        } else {
+            m_pendingViews.insert(view);
+        }
+        if (m_publishScheduled) {
+            return;
+        }
+        m_publishScheduled = true;
+        QMetaObject::invokeMethod(this, [this]() { publish(); }, Qt::QueuedConnection);
+    }
+
+private:
+    struct Subscriber {
+        LadderClient *owner = nullptr;
+        std::shared_ptr<LadderBookChannel> channel;
+    };
+
+    void publish()
+    {
+        m_publishScheduled = false;
+        for (auto it = m_views.cbegin(); it != m_views.cend(); ++it) {
+            if (!m_publishAll && !m_pendingViews.contains(it.key())) {
+                continue;
+            }
+            const Subscriber &sub = it.value();
+            std::shared_ptr<const LadderBookFrame> frame =
+                m_model.publish(it.key(), sub.channel->consumedVersion.load());
+            QMutexLocker locker(&sub.channel->mutex);
+            sub.channel->latest = std::move(frame);
+            if (sub.channel->closed || sub.channel->notifyPending.exchange(true)) {
+                continue;
+            }
+            QMetaObject::invokeMethod(
+                sub.owner, [owner = sub.owner]() { owner->handleBookFrame(); }, Qt::QueuedConnection);
+        }
+        m_publishAll = false;
+        m_pendingViews.clear();
+    }
+
+    LadderBookModel m_model;
+    QHash<quint64, Subscriber> m_views;
+    QSet<quint64> m_pendingViews;
+    bool m_publishAll = false;
+    bool m_publishScheduled = false;
+};
+
+// A worker for a feed of its own; it goes away with the last client holding it.
+static std::shared_ptr<QObject> newLadderBookWorker()
+{
+    auto *worker = new LadderBookWorker();
+    worker->moveToThread(sharedLadderBookThread());
+    return std::shared_ptr<QObject>(worker, [](QObject *w) { w->deleteLater(); });
+}
+
 static QThread *sharedBackendLogThread()
 {
     static QThread *t = []() -> QThread * {
@@ -607,11 +906,15 @@ LadderClient::LadderClient(const QString &backendPath,
     , m_prints(prints)
 {
     m_cacheLevels = std::max(m_levels, 10000);
-    qRegisterMetaType<QVector<QByteArray>>("QVector<QByteArray>");
+    qRegisterMetaType<BackendLineBatch>("BackendLineBatch");
     qRegisterMetaType<ParsedTradeEvent>("ParsedTradeEvent");
     qRegisterMetaType<ParsedLadderRow>("ParsedLadderRow");
     qRegisterMetaType<ParsedLadderFull>("ParsedLadderFull");
     qRegisterMetaType<ParsedLadderDelta>("ParsedLadderDelta");
+    qRegisterMetaType<BackendStats>("BackendStats");
+    qRegisterMetaType<ParsedWallEvent>("ParsedWallEvent");
+    qRegisterMetaType<ParsedReplayStatus>("ParsedReplayStatus");
+    qRegisterMetaType<ParsedLadderPage>("ParsedLadderPage");
 
     auto *worker = new BackendParseWorker(this);
     worker->moveToThread(sharedBackendParseThread());
@@ -619,31 +922,24 @@ LadderClient::LadderClient(const QString &backendPath,
     connect(this, &LadderClient::parseLinesRequested, worker, &BackendParseWorker::parseLines, Qt::QueuedConnection);
     m_parseWorker = worker;
 
-    m_process.setProgram(m_backendPath);
+    m_bookChannel = std::make_shared<LadderBookChannel>();
+    static quint64 viewSeq = 0;
+    m_bookView = ++viewSeq;
+    moveBookView(newLadderBookWorker());
+
+    m_process = new QProcess(this);
+    m_process->setProgram(m_backendPath);
     if (!QFileInfo::exists(m_backendPath)) {
         const QString fallback = QDir(QCoreApplication::applicationDirPath())
                                      .filePath(QFileInfo(m_backendPath).fileName());
         if (QFileInfo::exists(fallback)) {
             m_backendPath = fallback;
-            m_process.setProgram(m_backendPath);
+            m_process->setProgram(m_backendPath);
         }
     }
-    m_process.setWorkingDirectory(QCoreApplication::applicationDirPath());
-    m_process.setProcessChannelMode(QProcess::SeparateChannels);
-
-    connect(&m_process, &QProcess::readyReadStandardOutput, this, &LadderClient::handleReadyRead);
-    connect(&m_process,
-            &QProcess::errorOccurred,
-            this,
-            &LadderClient::handleErrorOccurred);
-    connect(&m_process,
-            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this,
-            &LadderClient::handleFinished);
-    connect(&m_process,
-            &QProcess::readyReadStandardError,
-            this,
-            &LadderClient::handleReadyReadStderr);
+    m_process->setWorkingDirectory(QCoreApplication::applicationDirPath());
+    m_process->setProcessChannelMode(QProcess::SeparateChannels);
+    connectProcess();
 
     m_watchdogTimer.setSingleShot(true);
     connect(&m_watchdogTimer, &QTimer::timeout, this, &LadderClient::handleWatchdogTimeout);
@@ -654,6 +950,9 @@ LadderClient::LadderClient(const QString &backendPath,
 LadderClient::~LadderClient()
 {
     stop();
+    moveBookView(nullptr);
+    QMutexLocker locker(&m_bookChannel->mutex);
+    m_bookChannel->closed = true;
 }
 
 QString LadderClient::formatBackendPrefix() const
@@ -662,131 +961,6 @@ QString LadderClient::formatBackendPrefix() const
     return QStringLiteral("[%1 %2]").arg(ex, m_symbol);
 }
 
-static void bucketAggAdd(QHash<qint64, LadderClient::BookEntry> &buckets, qint64 bucketTick, double bidDelta, double askDelta)
-{
-    if (!(bidDelta != 0.0 || askDelta != 0.0)) {
-        return;
-    }
-    static constexpr double kEps = 1e-9;
-    LadderClient::BookEntry &e = buckets[bucketTick];
-    e.bidQty += bidDelta;
-    e.askQty += askDelta;
-    if (!std::isfinite(e.bidQty)) {
-        e.bidQty = 0.0;
-    }
-    if (!std::isfinite(e.askQty)) {
-        e.askQty = 0.0;
-    }
-    if (e.bidQty < kEps) {
-        e.bidQty = 0.0;
-    }
-    if (e.askQty < kEps) {
-        e.askQty = 0.0;
-    }
-    if (e.bidQty <= 0.0 && e.askQty <= 0.0) {
-        buckets.remove(bucketTick);
-    }
-}
-
-static void rebuildBucketBook(QHash<qint64, LadderClient::BookEntry> &out,
-                              const QMap<qint64, LadderClient::BookEntry> &book,
-                              qint64 compression)
-{
-    out.clear();
-    const qint64 c = std::max<qint64>(1, compression);
-    for (auto it = book.constBegin(); it != book.constEnd(); ++it) {
-        const qint64 tick = it.key();
-        const double bid = it->bidQty;
-        const double ask = it->askQty;
-        if (bid > 0.0) {
-            bucketAggAdd(out, floorBucketTickSigned(tick, c), bid, 0.0);
-        }
-        if (ask > 0.0) {
-            bucketAggAdd(out, ceilBucketTickSigned(tick, c), 0.0, ask);
-        }
-    }
-}
-
-static bool computeBestBuckets(const QHash<qint64, LadderClient::BookEntry> &buckets,
-                               qint64 &outBestBidBucket,
-                               qint64 &outBestAskBucket)
-{
-    outBestBidBucket = 0;
-    outBestAskBucket = 0;
-    bool hasBid = false;
-    bool hasAsk = false;
-    for (auto it = buckets.constBegin(); it != buckets.constEnd(); ++it) {
-        const qint64 tick = it.key();
-        if (it->bidQty > 0.0) {
-            if (!hasBid || tick > outBestBidBucket) {
-                outBestBidBucket = tick;
-                hasBid = true;
-            }
-        }
-        if (it->askQty > 0.0) {
-            if (!hasAsk || tick < outBestAskBucket) {
-                outBestAskBucket = tick;
-                hasAsk = true;
-            }
-        }
-    }
-    return hasBid && hasAsk;
-}
-
-static void sanitizeBucketBook(QHash<qint64, LadderClient::BookEntry> &buckets,
-                               qint64 bestBidBucketTick,
-                               qint64 bestAskBucketTick,
-                               QSet<qint64> *dirtyBuckets = nullptr)
-{
-    if (buckets.isEmpty()) {
-        return;
-    }
-    if (bestBidBucketTick == 0 && bestAskBucketTick == 0) {
-        return;
-    }
-
-    // Remove any liquidity that would be "impossible" relative to the spread buckets.
-    // This prevents stale aggregated buckets from sticking in GPU incremental mode.
-    auto it = buckets.begin();
-    while (it != buckets.end()) {
-        const qint64 tick = it.key();
-        auto &e = it.value();
-        bool changed = false;
-
-        if (bestBidBucketTick != 0 && tick <= bestBidBucketTick && e.askQty > 0.0) {
-            e.askQty = 0.0;
-            changed = true;
-        }
-        if (bestAskBucketTick != 0 && tick >= bestAskBucketTick && e.bidQty > 0.0) {
-            e.bidQty = 0.0;
-            changed = true;
-        }
-        if (bestBidBucketTick != 0
-            && bestAskBucketTick != 0
-            && bestBidBucketTick < bestAskBucketTick
-            && tick > bestBidBucketTick
-            && tick < bestAskBucketTick
-            && (e.bidQty > 0.0 || e.askQty > 0.0)) {
-            e.bidQty = 0.0;
-            e.askQty = 0.0;
-            changed = true;
-        }
-
-        if (changed && dirtyBuckets) {
-            dirtyBuckets->insert(tick);
-        }
-
-        static constexpr double kEps = 1e-9;
-        if (e.bidQty < kEps) e.bidQty = 0.0;
-        if (e.askQty < kEps) e.askQty = 0.0;
-        if (e.bidQty <= 0.0 && e.askQty <= 0.0) {
-            it = buckets.erase(it);
-        } else {
-            ++it;
-        }
-    }
-}
-
 QString LadderClient::backendLogPath() const
 {
     return fusionLogFilePath();
@@ -836,36 +1010,214 @@ QString LadderClient::formatCrashSummary(int exitCode, QProcess::ExitStatus stat
 
 void LadderClient::restart(const QString &symbol, int levels, const QString &exchange)
 {
-    m_restartInProgress = true;
-    // Treat any termination that happens during restart() as expected; otherwise
-    // we end up with "Process crashed" spam during startup (we restart once more
-    // after applying compression/account settings).
+    const QString key = MarketDataHub::keyFor(m_backendPath,
+                                              exchange.isEmpty() ? m_exchange : exchange,
+                                              symbol,
+                                              m_proxyType,
+                                              m_proxy);
+    // A source staying on its market keeps its followers; anything else leaves its feed first.
+    if (m_feedSource || m_followers.isEmpty() || key != m_feedKey) {
+        leaveSharedFeed();
+        if (attachToSharedFeed(key, symbol, levels, exchange)) {
+            return;
+        }
+    }
+    if (!reconfigureRunningBackend(symbol, levels, exchange)) {
+        respawnBackend(symbol, levels, exchange);
+    }
+    if (m_feedKey.isEmpty() && !key.isEmpty()) {
+        m_feedKey = key;
+        MarketDataHub::instance().setSource(key, this);
+    }
+}
+
+bool LadderClient::attachToSharedFeed(const QString &key, const QString &symbol, int levels, const QString &exchange)
+{
+    LadderClient *source = key.isEmpty() ? nullptr : MarketDataHub::instance().source(key);
+    if (!source || source == this) {
+        return false;
+    }
     m_stopRequested = true;
+    m_watchdogTimer.stop();
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished(2000);
+    }
+    m_lineSplitter.clear();
     m_symbol = symbol;
-    m_levels = levels;
     if (!exchange.isEmpty()) {
         m_exchange = exchange;
     }
+    m_feedKey = key;
+    m_feedSource = source;
+    source->m_followers.push_back(this);
+    // The book of the feed is already there; this client becomes one more view of it.
+    moveBookView(source->m_bookWorker);
+    applyLevelPolicy(levels);
+    resetBookState();
+    m_generation = source->m_generation;
+    m_ackedControlId = std::max(m_ackedControlId, m_controlSeq);
+    m_forceFullId = 0;
+
+    // Walls and venue attribution only arrive as changes; start from what the source holds.
+    m_walls = source->m_walls;
+    if (!m_walls.isEmpty()) {
+        emit wallMarkersChanged(m_walls.values());
+    }
+    // A window the source pinned while it was alone would hold every view off the market;
+    // from here on each view scrolls by its own pages.
+    json center;
+    center["cmd"] = "center_auto";
+    center["id"] = source->nextControlId();
+    source->writeControl(center.dump());
+    // A wider view resizes the shared window; otherwise the book is shown as it is.
+    source->resizeFeedWindow();
+
+    emitStatus(QStringLiteral("Sharing the backend of another %1 ladder").arg(m_symbol));
+    logBackendEvent(QStringLiteral("attach shared feed views=%1").arg(source->m_followers.size() + 1));
+    return true;
+}
+
+void LadderClient::leaveSharedFeed()
+{
+    if (m_feedSource) {
+        m_feedSource->m_followers.removeAll(this);
+        m_feedSource = nullptr;
+        m_feedKey.clear();
+        moveBookView(newLadderBookWorker());
+        return;
+    }
+    if (m_feedKey.isEmpty()) {
+        return;
+    }
+    const QString key = m_feedKey;
+    m_feedKey.clear();
+    MarketDataHub::instance().release(key, this);
+    if (m_followers.isEmpty()) {
+        return;
+    }
+    if (MarketDataHub::instance().shuttingDown()) {
+        // Every view is going away with the app; nobody should start a process for the others.
+        for (LadderClient *view : std::as_const(m_followers)) {
+            view->m_feedSource = nullptr;
+            view->m_feedKey.clear();
+        }
+        m_followers.clear();
+        return;
+    }
+    // The process goes with this client: the first follower starts its own and takes the rest,
+    // along with the book they show.
+    moveBookView(newLadderBookWorker());
+    QVector<LadderClient *> followers;
+    followers.swap(m_followers);
+    LadderClient *heir = followers.takeFirst();
+    heir->m_feedSource = nullptr;
+    heir->m_feedKey = key;
+    heir->m_followers = followers;
+    for (LadderClient *view : std::as_const(followers)) {
+        view->m_feedSource = heir;
+    }
+    MarketDataHub::instance().setSource(key, heir);
+    heir->logBackendEvent(QStringLiteral("take over shared feed views=%1").arg(followers.size() + 1));
+    heir->respawnBackend(heir->m_symbol, heir->m_levels, heir->m_exchange);
+}
+
+void LadderClient::syncFollowers(bool processReplaced)
+{
+    for (LadderClient *view : std::as_const(m_followers)) {
+        view->m_generation = m_generation;
+        if (processReplaced) {
+            view->resetBookState();
+            view->m_ackedControlId = std::max(view->m_ackedControlId, view->m_controlSeq);
+            view->m_forceFullId = 0;
+        }
+    }
+}
+
+template <typename Fn>
+void LadderClient::forEachFollower(Fn &&fn) const
+{
+    if (m_followers.isEmpty()) {
+        return;
+    }
+    // A view may leave the feed from a slot it triggers; iterate a copy.
+    const QVector<LadderClient *> views = m_followers;
+    for (LadderClient *view : views) {
+        if (view->m_feedSource == this) {
+            fn(view);
+        }
+    }
+}
+
+int LadderClient::feedLevels() const
+{
+    int levels = m_levels;
+    for (const LadderClient *view : m_followers) {
+        levels = std::max(levels, view->m_levels);
+    }
+    return levels;
+}
+
+int LadderClient::feedCacheLevels() const
+{
+    int cacheLevels = m_cacheLevels;
+    for (const LadderClient *view : m_followers) {
+        cacheLevels = std::max(cacheLevels, view->m_cacheLevels);
+    }
+    return cacheLevels;
+}
+
+void LadderClient::applyLevelPolicy(int levels)
+{
+    m_levels = levels;
     if (m_exchange == QStringLiteral("mexc") || m_exchange == QStringLiteral("mexc_futures")) {
         // Prevent huge startup ladders (e.g. 4500) that generate multi‑MB JSON and stall parsing/painting.
         // MEXC streams are already heavy; cap visible levels for stability/performance.
         m_levels = std::min(m_levels, 1500);
     }
     if (m_exchange == QStringLiteral("mexc") || m_exchange == QStringLiteral("mexc_futures")) {
+        // MEXC depth streams can be very chatty; keeping an enormous cache window increases
+        // CPU/memory pressure for both backend and GUI without much benefit.
         m_cacheLevels = std::max(m_levels, 6000);
     } else {
         m_cacheLevels = std::max(m_levels, 10000);
     }
+    postViewTask([view = m_bookView, cacheLevels = m_cacheLevels](LadderBookModel &book) {
+        book.setCacheLevels(view, cacheLevels);
+    });
+}
+
+void LadderClient::resetBookState()
+{
     m_lastTickSize = 0.0;
     m_bestBid = 0.0;
     m_bestAsk = 0.0;
-    m_book.clear();
-    m_bucketBook.clear();
+    if (!m_walls.isEmpty()) {
+        m_walls.clear();
+        emit wallMarkersChanged(QVector<DomWidget::WallMarker>());
+    }
     m_bufferMinTick = 0;
     m_bufferMaxTick = 0;
     m_centerTick = 0;
     m_hasBook = false;
+    m_hasPages = false;
+    m_pagesConnected = false;
+    m_pageMinTick = 0;
+    m_pageMaxTick = 0;
+    m_pageTickSize = 0.0;
+    m_pagesFetchedMs = 0;
+    m_slicer.invalidate();
+    // Frames still in flight belong to the old book; the reset task starts a new epoch. The book
+    // itself belongs to whoever runs the process; a view of a shared feed only drops its pages.
+    if (!m_feedSource) {
+        postBookTask([](LadderBookModel &book) { book.resetBook(); });
+    }
+    const quint64 epoch = ++m_bookEpoch;
+    postViewTask([view = m_bookView, epoch](LadderBookModel &book) { book.resetView(view, epoch); });
+    m_pageRequestIds.clear();
+    m_backendBookKnown = false;
     m_printBuffer.clear();
+    m_pendingPrintItems.clear();
     if (m_prints) {
         QVector<PrintItem> emptyPrints;
         m_prints->setPrints(emptyPrints);
@@ -875,20 +1227,12 @@ void LadderClient::restart(const QString &symbol, int levels, const QString &exc
         QVector<LocalOrderMarker> emptyOrders;
         m_prints->setLocalOrders(emptyOrders);
     }
+}
 
-    if (m_process.state() != QProcess::NotRunning) {
-        m_process.kill();
-        m_process.waitForFinished(2000);
-    }
-    m_recentStderr.clear();
-    m_lastExitCode = 0;
-    m_lastExitStatus = QProcess::NormalExit;
-    m_lastProcessError = QProcess::UnknownError;
-    m_lastProcessErrorString.clear();
-    m_stopRequested = false;
-
+QString LadderClient::wireSymbolFor(const QString &symbol) const
+{
     // Map UI symbol to exchange-specific wire format.
-    QString wireSymbol = m_symbol;
+    QString wireSymbol = symbol;
     if (m_exchange == QStringLiteral("uzxspot"))
     {
         if (!wireSymbol.contains(QLatin1Char('-')))
@@ -924,51 +1268,232 @@ void LadderClient::restart(const QString &symbol, int levels, const QString &exc
         wireSymbol = wireSymbol.replace(QStringLiteral("_"), QString());
         wireSymbol = wireSymbol.replace(QStringLiteral("-"), QString());
     }
+    return wireSymbol;
+}
 
-    QStringList args;
-    int fullDepthLevels = std::max(m_levels, 10000);
-    if (m_exchange == QStringLiteral("mexc") || m_exchange == QStringLiteral("mexc_futures")) {
-        // MEXC depth streams can be very chatty; keeping an enormous cache window increases
-        // CPU/memory pressure for both backend and GUI without much benefit.
-        fullDepthLevels = std::max(m_levels, 6000);
-    }
-    args << "--symbol" << wireSymbol
-         << "--ladder-levels" << QString::number(m_levels)
-         << "--cache-levels" << QString::number(fullDepthLevels);
-
-    // Reduce backend stdout churn for heavy exchanges (prevents parse backlog and watchdog restarts).
-    // MEXC sends frequent depth updates; emitting a full ladder too often overwhelms the GUI.
-    if (m_exchange == QStringLiteral("mexc") || m_exchange == QStringLiteral("mexc_futures")) {
-        args << "--throttle-ms" << QString::number(150);
-    }
-    if (m_exchange == QStringLiteral("mexc")) {
-        // MEXC spot WS is protobuf-only; keep REST polling as an optional fallback.
-        args << "--mexc-spot-mode" << QStringLiteral("pbws");
-        args << "--mexc-interval-ms" << QString::number(100);
-        args << "--mexc-spot-poll-ms" << QString::number(250);
+bool LadderClient::reconfigureRunningBackend(const QString &symbol, int levels, const QString &exchange)
+{
+    // Same venue and proxy on a healthy process: re-target it over the control channel
+    // instead of paying for a new process, TLS handshakes and a cold book.
+    if (m_process->state() != QProcess::Running || !m_hasBook || m_stopRequested) {
+        return false;
     }
-    if (!m_exchange.isEmpty()) {
-        args << "--exchange" << m_exchange;
+    if (!exchange.isEmpty() && exchange != m_exchange) {
+        return false;
     }
-    QString proxyRaw = m_proxy.trimmed();
-    QString type = m_proxyType.trimmed().toLower();
-    bool systemProxyResolved = false;
-    const bool forceNoProxy =
-        (type == QStringLiteral("none") || type == QStringLiteral("direct") || type == QStringLiteral("no"));
-    if (proxyRaw.isEmpty()) {
-        // Match GUI behavior: empty field => use Windows system proxy settings.
-        // Backend can't consume "system", so we resolve it into host:port here.
-        const QUrl queryUrl =
-            (m_exchange.trimmed().toLower().contains(QStringLiteral("lighter")))
-                ? QUrl(QStringLiteral("https://mainnet.zklighter.elliot.ai/"))
-                : QUrl(QStringLiteral("https://www.google.com/generate_204"));
-        if (!forceNoProxy) {
-            systemProxyResolved = resolveSystemProxyForUrl(queryUrl, type, proxyRaw);
-        }
+    if (m_spawnProxyKey != m_proxyType + QLatin1Char('|') + m_proxy) {
+        return false;
     }
 
-    if (forceNoProxy) {
-        args << "--no-proxy";
+    const bool symbolChanged = symbol != m_symbol;
+    m_symbol = symbol;
+    applyLevelPolicy(levels);
+    resetBookState();
+    const quint64 generation = ++m_generation;
+    syncFollowers(false);
+
+    // Subscribe goes first: the backend then applies the levels without re-emitting the old book.
+    if (symbolChanged) {
+        json sub;
+        sub["cmd"] = "subscribe";
+        sub["symbol"] = wireSymbolFor(m_symbol).toStdString();
+        sub["gen"] = generation;
+        sub["id"] = nextControlId();
+        writeControl(sub.dump());
+    }
+    json levelsCmd;
+    levelsCmd["cmd"] = "set_levels";
+    m_processLevels = feedLevels();
+    m_processCacheLevels = feedCacheLevels();
+    levelsCmd["ladderLevels"] = m_processLevels;
+    levelsCmd["cacheLevels"] = m_processCacheLevels;
+    levelsCmd["gen"] = generation;
+    levelsCmd["id"] = nextControlId();
+    writeControl(levelsCmd.dump());
+
+    emitStatus(QStringLiteral("Switching backend to %1 (%2 levels)...").arg(m_symbol).arg(m_levels));
+    logBackendEvent(QStringLiteral("reconfigure symbol=%1 levels=%2 gen=%3")
+                        .arg(m_symbol)
+                        .arg(m_levels)
+                        .arg(generation));
+    m_switchStartedMs = QDateTime::currentMSecsSinceEpoch();
+    m_switchPath = QStringLiteral("reconfigure");
+    armWatchdog();
+    return true;
+}
+
+quint64 LadderClient::setLevels(int levels)
+{
+    applyLevelPolicy(levels);
+    const quint64 id = (m_feedSource ? m_feedSource : this)->resizeFeedWindow();
+    if (id == 0 && m_feedSource) {
+        // The shared window already covers this view; the answer to a page of its span lays it
+        // out again instead.
+        return requestRange(bufferMinTick(), bufferMaxTick());
+    }
+    return id;
+}
+
+quint64 LadderClient::resizeFeedWindow()
+{
+    const int levels = feedLevels();
+    const int cacheLevels = feedCacheLevels();
+    if ((levels == m_processLevels && cacheLevels == m_processCacheLevels)
+        || m_process->state() != QProcess::Running) {
+        return 0;
+    }
+    m_processLevels = levels;
+    m_processCacheLevels = cacheLevels;
+    // New generation: deltas against the old window are dropped until the resized ladder lands.
+    const quint64 generation = ++m_generation;
+    syncFollowers(false);
+    const quint64 id = nextControlId();
+    json cmd;
+    cmd["cmd"] = "set_levels";
+    cmd["ladderLevels"] = levels;
+    cmd["cacheLevels"] = cacheLevels;
+    cmd["gen"] = generation;
+    cmd["id"] = id;
+    writeControl(cmd.dump());
+    logBackendEvent(QStringLiteral("set_levels levels=%1 gen=%2").arg(levels).arg(generation));
+    return id;
+}
+
+void LadderClient::connectProcess()
+{
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &LadderClient::handleReadyRead);
+    connect(m_process,
+            &QProcess::errorOccurred,
+            this,
+            &LadderClient::handleErrorOccurred);
+    connect(m_process,
+            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this,
+            &LadderClient::handleFinished);
+    connect(m_process,
+            &QProcess::readyReadStandardError,
+            this,
+            &LadderClient::handleReadyReadStderr);
+}
+
+bool LadderClient::adoptWarmBackend(const QStringList &poolArgs)
+{
+    QProcess *warm = BackendProcessPool::instance().take(m_backendPath, poolArgs);
+    if (!warm) {
+        return false;
+    }
+    // The old process already exited above; nothing of it is pending any more.
+    disconnect(m_process, nullptr, this, nullptr);
+    m_process->deleteLater();
+    m_process = warm;
+    m_process->setParent(this);
+    connectProcess();
+
+    // A standby backend has its levels from the command line and waits only for the symbol.
+    json sub;
+    sub["cmd"] = "subscribe";
+    sub["symbol"] = wireSymbolFor(m_symbol).toStdString();
+    sub["gen"] = m_generation;
+    sub["id"] = nextControlId();
+    writeControl(sub.dump());
+    logBackendEvent(QStringLiteral("adopted warm backend symbol=%1").arg(m_symbol));
+    return true;
+}
+
+void LadderClient::respawnBackend(const QString &symbol, int levels, const QString &exchange)
+{
+    m_switchStartedMs = QDateTime::currentMSecsSinceEpoch();
+    m_restartInProgress = true;
+    // Treat any termination that happens during restart() as expected; otherwise
+    // we end up with "Process crashed" spam during startup (we restart once more
+    // after applying compression/account settings).
+    m_stopRequested = true;
+    m_symbol = symbol;
+    if (!exchange.isEmpty()) {
+        m_exchange = exchange;
+    }
+    applyLevelPolicy(levels);
+    resetBookState();
+
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished(2000);
+    }
+    m_recentStderr.clear();
+    // A killed process may leave half a line behind; it must not prefix the new one's output.
+    m_lineSplitter.clear();
+    m_lastExitCode = 0;
+    m_lastExitStatus = QProcess::NormalExit;
+    m_lastProcessError = QProcess::UnknownError;
+    m_lastProcessErrorString.clear();
+    m_stopRequested = false;
+    // A fresh process starts counting generations from zero again, and will never answer
+    // what was sent to the old one.
+    m_generation = 0;
+    m_ackedControlId = std::max(m_ackedControlId, m_controlSeq);
+    m_forceFullId = 0;
+    syncFollowers(true);
+    m_spawnProxyKey = m_proxyType + QLatin1Char('|') + m_proxy;
+
+    const QString wireSymbol = wireSymbolFor(m_symbol);
+
+    m_processLevels = feedLevels();
+    m_processCacheLevels = feedCacheLevels();
+    QStringList args;
+    args << "--symbol" << wireSymbol
+         << "--ladder-levels" << QString::number(m_processLevels)
+         << "--cache-levels" << QString::number(m_processCacheLevels);
+
+    // Reduce backend stdout churn for heavy exchanges (prevents parse backlog and watchdog restarts).
+    // MEXC sends frequent depth updates; emitting a full ladder too often overwhelms the GUI.
+    if (m_exchange == QStringLiteral("mexc") || m_exchange == QStringLiteral("mexc_futures")) {
+        args << "--throttle-ms" << QString::number(150);
+    }
+    if (m_exchange == QStringLiteral("mexc")) {
+        // MEXC spot WS is protobuf-only; keep REST polling as an optional fallback.
+        args << "--mexc-spot-mode" << QStringLiteral("pbws");
+        args << "--mexc-interval-ms" << QString::number(100);
+        args << "--mexc-spot-poll-ms" << QString::number(250);
+    }
+    const QString replayFile = qEnvironmentVariable("FUSION_REPLAY_FILE").trimmed();
+    if (!replayFile.isEmpty()) {
+        // Recorded session instead of a live feed; the backend streams it like a live one.
+        args << "--replay" << replayFile;
+        const QString from = qEnvironmentVariable("FUSION_REPLAY_FROM").trimmed();
+        if (!from.isEmpty()) {
+            args << "--from" << from;
+        }
+        const QString speed = qEnvironmentVariable("FUSION_REPLAY_SPEED").trimmed();
+        if (!speed.isEmpty()) {
+            args << "--speed" << speed;
+        }
+    } else if (!m_exchange.isEmpty()) {
+        args << "--exchange" << m_exchange;
+    }
+    // Wall tracking is opt-in: the threshold is symbol dependent (same units as volume highlight rules).
+    const double wallNotional = qEnvironmentVariable("FUSION_WALL_NOTIONAL").toDouble();
+    if (wallNotional > 0.0) {
+        args << "--wall-notional" << QString::number(wallNotional, 'f', 0);
+    }
+    QString proxyRaw = m_proxy.trimmed();
+    QString type = m_proxyType.trimmed().toLower();
+    bool systemProxyResolved = false;
+    const bool forceNoProxy =
+        (type == QStringLiteral("none") || type == QStringLiteral("direct") || type == QStringLiteral("no"));
+    if (proxyRaw.isEmpty()) {
+        // Match GUI behavior: empty field => use Windows system proxy settings.
+        // Backend can't consume "system", so we resolve it into host:port here.
+        const QUrl queryUrl =
+            (m_exchange.trimmed().toLower().contains(QStringLiteral("lighter")))
+                ? QUrl(QStringLiteral("https://mainnet.zklighter.elliot.ai/"))
+                : QUrl(QStringLiteral("https://www.google.com/generate_204"));
+        if (!forceNoProxy) {
+            systemProxyResolved = resolveSystemProxyForUrl(queryUrl, type, proxyRaw);
+        }
+    }
+
+    if (forceNoProxy) {
+        args << "--no-proxy";
     } else if (!proxyRaw.isEmpty()) {
         if (!type.isEmpty()) {
             args << "--proxy-type" << type;
@@ -1017,7 +1542,6 @@ void LadderClient::restart(const QString &symbol, int levels, const QString &exc
         const QString label = systemProxyResolved ? QStringLiteral("system") : summarize(type, proxyRaw);
         emitStatus(QStringLiteral("%1 Backend proxy: %2").arg(formatBackendPrefix(), label));
     }
-    m_process.setArguments(args);
 
     emitStatus(QStringLiteral("Starting backend (%1, %2 levels, %3)...")
                    .arg(m_symbol)
@@ -1031,7 +1555,25 @@ void LadderClient::restart(const QString &symbol, int levels, const QString &exc
     }
     qWarning() << "[LadderClient] starting backend with args" << argsForLog;
     logBackendEvent(QStringLiteral("start args=%1").arg(argsForLog.join(QLatin1Char(' '))));
-    m_process.start();
+
+    // Live single-venue feeds can start from a pooled standby backend: everything but the
+    // symbol is in its arguments. A replay backend needs the symbol at startup.
+    QStringList poolArgs;
+    const int symbolAt = args.indexOf(QStringLiteral("--symbol"));
+    if (replayFile.isEmpty() && symbolAt >= 0 && symbolAt + 1 < args.size()) {
+        poolArgs = args;
+        poolArgs.removeAt(symbolAt + 1);
+        poolArgs.removeAt(symbolAt);
+    }
+    const bool warm = !poolArgs.isEmpty() && adoptWarmBackend(poolArgs);
+    if (!warm) {
+        m_process->setArguments(args);
+        m_process->start();
+    }
+    m_switchPath = warm ? QStringLiteral("warm") : QStringLiteral("cold");
+    if (!poolArgs.isEmpty()) {
+        BackendProcessPool::instance().prime(m_backendPath, poolArgs);
+    }
     armWatchdog();
     m_restartInProgress = false;
 }
@@ -1044,10 +1586,11 @@ void LadderClient::setProxy(const QString &proxyType, const QString &proxy)
 
 void LadderClient::stop()
 {
+    leaveSharedFeed();
     m_stopRequested = true;
-    if (m_process.state() != QProcess::NotRunning) {
-        m_process.kill();
-        m_process.waitForFinished(2000);
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished(2000);
         emitStatus(QStringLiteral("Backend stopped"));
     }
     m_watchdogTimer.stop();
@@ -1055,7 +1598,10 @@ void LadderClient::stop()
 
 bool LadderClient::isRunning() const
 {
-    return m_process.state() != QProcess::NotRunning;
+    if (m_feedSource) {
+        return m_feedSource->isRunning();
+    }
+    return m_process->state() != QProcess::NotRunning;
 }
 
 void LadderClient::setCompression(int factor)
@@ -1065,124 +1611,285 @@ void LadderClient::setCompression(int factor)
         return;
     }
     m_tickCompression = v;
-    if (!m_book.isEmpty()) {
-        rebuildBucketBook(m_bucketBook, m_book, m_tickCompression);
-        ++m_bookRevision;
-        emit bookUpdated(m_bookRevision);
-        if (m_hasBook) {
-            emit bookRangeUpdated(m_bufferMinTick, m_bufferMaxTick, m_centerTick, m_lastTickSize);
-        }
-    }
+    postViewTask([view = m_bookView, v](LadderBookModel &book) { book.setCompression(view, v); });
 }
 
-void LadderClient::shiftWindowTicks(qint64 ticks)
+void LadderClient::writeControl(const std::string &payload)
 {
-    if (m_process.state() == QProcess::NotRunning) {
+    if (m_feedSource) {
+        m_feedSource->writeControl(payload);
         return;
     }
+    m_process->write(payload.c_str(), static_cast<int>(payload.size()));
+    m_process->write("\n", 1);
+}
+
+quint64 LadderClient::nextControlId()
+{
+    static quint64 seq = 0;
+    m_controlSeq = ++seq;
+    return m_controlSeq;
+}
+
+void LadderClient::noteControlAck(quint64 id)
+{
+    // Every frame carries the newest id applied so far; a lost or coalesced frame is simply
+    // covered by the next one.
+    m_ackedControlId = std::max(m_ackedControlId, id);
+}
+
+quint64 LadderClient::shiftWindowTicks(qint64 ticks)
+{
+    if (!isRunning() || sharesFeed()) {
+        return 0;
+    }
+    const quint64 id = nextControlId();
     json cmd;
     cmd["cmd"] = "shift";
     cmd["ticks"] = ticks;
-    const std::string payload = cmd.dump();
-    m_process.write(payload.c_str(), static_cast<int>(payload.size()));
-    m_process.write("\n", 1);
+    cmd["id"] = id;
+    writeControl(cmd.dump());
+    return id;
 }
 
-void LadderClient::resetManualCenter()
+quint64 LadderClient::requestRange(qint64 minTick, qint64 maxTick)
 {
-    if (m_process.state() == QProcess::NotRunning) {
-        return;
+    if (!isRunning() || !m_hasBook) {
+        return 0;
     }
+    if (minTick > maxTick) {
+        std::swap(minTick, maxTick);
+    }
+    if (m_backendBookKnown && (minTick > m_backendBookMaxTick || maxTick < m_backendBookMinTick)) {
+        return 0;
+    }
+    const quint64 id = nextControlId();
     json cmd;
-    cmd["cmd"] = "center_auto";
-    const std::string payload = cmd.dump();
-    m_process.write(payload.c_str(), static_cast<int>(payload.size()));
-    m_process.write("\n", 1);
+    cmd["cmd"] = "range";
+    cmd["from"] = minTick;
+    cmd["to"] = maxTick;
+    cmd["id"] = id;
+    writeControl(cmd.dump());
+    m_lastPageRequestId = id;
+    m_pageRequestIds.insert(id);
+    return id;
 }
 
-void LadderClient::requestForceFull()
+quint64 LadderClient::resetManualCenter()
 {
-    if (m_process.state() == QProcess::NotRunning) {
-        return;
+    if (!isRunning()) {
+        return 0;
+    }
+    // Back at the mid: stop keeping far depth pages fresh.
+    if (m_hasPages) {
+        postViewTask([view = m_bookView](LadderBookModel &book) { book.clearPages(view); });
     }
+    if (sharesFeed()) {
+        // The shared live window was never moved for this view; dropping its pages recenters it.
+        return 0;
+    }
+    const quint64 id = nextControlId();
     json cmd;
-    cmd["cmd"] = "force_full";
-    const std::string payload = cmd.dump();
-    m_process.write(payload.c_str(), static_cast<int>(payload.size()));
-    m_process.write("\n", 1);
+    cmd["cmd"] = "center_auto";
+    cmd["id"] = id;
+    writeControl(cmd.dump());
+    return id;
 }
 
-bool LadderClient::crossedBookLikely(const QSet<qint64> &dirtyBuckets) const
+bool LadderClient::requestForceFull()
 {
-    if (!(m_lastTickSize > 0.0) || !std::isfinite(m_lastTickSize)) {
+    if (!isRunning()) {
         return false;
     }
-    if (!(m_bestBid > 0.0) || !(m_bestAsk > 0.0)) {
+    if (!controlAcknowledged(m_forceFullId)) {
+        // A full frame is already on its way; frames before it can't fix the book anyway.
         return false;
     }
-    const qint64 bidTick = static_cast<qint64>(std::llround(m_bestBid / m_lastTickSize));
-    const qint64 askTick = static_cast<qint64>(std::llround(m_bestAsk / m_lastTickSize));
-    const qint64 bidBucket = floorBucketTickSigned(bidTick, m_tickCompression);
-    const qint64 askBucket = ceilBucketTickSigned(askTick, m_tickCompression);
-    if (bidBucket > askBucket) {
-        return true;
+    m_forceFullId = nextControlId();
+    json cmd;
+    cmd["cmd"] = "force_full";
+    cmd["id"] = m_forceFullId;
+    writeControl(cmd.dump());
+    return true;
+}
+
+const LadderBookFrame *LadderClient::currentFrame() const
+{
+    return m_frame && m_frame->epoch == m_bookEpoch ? m_frame.get() : nullptr;
+}
+
+void LadderClient::postBookTask(std::function<void(LadderBookModel &)> task)
+{
+    auto *worker = static_cast<LadderBookWorker *>(m_bookWorker.get());
+    QMetaObject::invokeMethod(
+        worker, [worker, task = std::move(task)]() { worker->run(task, 0); }, Qt::QueuedConnection);
+}
+
+void LadderClient::postViewTask(std::function<void(LadderBookModel &)> task)
+{
+    auto *worker = static_cast<LadderBookWorker *>(m_bookWorker.get());
+    QMetaObject::invokeMethod(
+        worker,
+        [worker, view = m_bookView, task = std::move(task)]() { worker->run(task, view); },
+        Qt::QueuedConnection);
+}
+
+void LadderClient::moveBookView(std::shared_ptr<QObject> worker)
+{
+    if (worker == m_bookWorker) {
+        return;
     }
-    const bool hasTop = (bidBucket != 0 && askBucket != 0);
-    for (qint64 t : dirtyBuckets) {
-        auto it = m_bucketBook.constFind(t);
-        if (it == m_bucketBook.constEnd()) {
-            continue;
-        }
-        if (it->bidQty > 0.0 && it->askQty > 0.0) {
-            if (!hasTop) {
-                return true;
-            }
-            if (bidBucket < askBucket) {
-                return true;
-            }
+    if (m_bookWorker) {
+        auto *old = static_cast<LadderBookWorker *>(m_bookWorker.get());
+        QMetaObject::invokeMethod(
+            old, [old, view = m_bookView]() { old->removeView(view); }, Qt::QueuedConnection);
+    }
+    // Released after the removal is queued: a worker left without views is deleted behind it.
+    m_bookWorker = std::move(worker);
+    if (!m_bookWorker) {
+        return;
+    }
+    auto *next = static_cast<LadderBookWorker *>(m_bookWorker.get());
+    QMetaObject::invokeMethod(
+        next,
+        [next, view = m_bookView, owner = this, channel = m_bookChannel]() { next->addView(view, owner, channel); },
+        Qt::QueuedConnection);
+    // Versions start over in the other model: nothing read so far can be patched by its frames.
+    m_bookChannel->consumedVersion.store(0);
+    m_postedViewMinTick = 0;
+    m_postedViewMaxTick = -1;
+    m_slicer.invalidate();
+    const quint64 epoch = ++m_bookEpoch;
+    const int compression = m_tickCompression;
+    const int cacheLevels = m_cacheLevels;
+    postViewTask([view = m_bookView, epoch, compression, cacheLevels](LadderBookModel &book) {
+        book.resetView(view, epoch);
+        book.setCompression(view, compression);
+        book.setCacheLevels(view, cacheLevels);
+    });
+}
+
+void LadderClient::handleBookFrame()
+{
+    // Cleared before the frame is read, so one published in between gets a call of its own.
+    m_bookChannel->notifyPending.store(false);
+    std::shared_ptr<const LadderBookFrame> frame;
+    {
+        QMutexLocker locker(&m_bookChannel->mutex);
+        frame = m_bookChannel->latest;
+    }
+    if (!frame || frame == m_frame) {
+        return;
+    }
+    const std::shared_ptr<const LadderBookFrame> prev = std::exchange(m_frame, frame);
+    // Before anything else: listeners of the range/book signals below check acknowledgements.
+    noteControlAck(frame->ack);
+    if (frame->epoch != m_bookEpoch) {
+        return;
+    }
+
+    m_hasBook = frame->hasBook;
+    m_lastTickSize = frame->tickSize;
+    m_bestBid = frame->bestBid;
+    m_bestAsk = frame->bestAsk;
+    m_bufferMinTick = frame->bufferMinTick;
+    m_bufferMaxTick = frame->bufferMaxTick;
+    m_centerTick = frame->centerTick;
+    m_hasPages = frame->hasPages;
+    m_pagesConnected = frame->pagesConnected;
+    m_pageMinTick = frame->pageMinTick;
+    m_pageMaxTick = frame->pageMaxTick;
+    m_pageTickSize = frame->pageTickSize;
+
+    if (!m_feedSource && prev
+        && (frame->resyncRequests != prev->resyncRequests || frame->crossedDeltas != prev->crossedDeltas)) {
+        // The book thread already dropped what it could not trust; get a full ladder. Views of a
+        // shared feed leave that to its source, which reads the same book.
+        if (requestForceFull() && frame->crossedDeltas != prev->crossedDeltas) {
+            emitStatus(QStringLiteral("%1 Crossed book detected; forcing full resync...").arg(formatBackendPrefix()));
+        }
+    }
+    if (!prev || frame->revision != prev->revision || std::exchange(m_viewUncovered, false)) {
+        ++m_bookRevision;
+        emit bookUpdated(m_bookRevision);
+    }
+    if (m_hasBook) {
+        if (!prev || frame->rangeRevision != prev->rangeRevision) {
+            emitBookRange();
         }
+        refreshRangePages();
     }
-    return false;
 }
 
 DomSnapshot LadderClient::snapshotForRange(qint64 minTick, qint64 maxTick) const
 {
-    if (!m_hasBook || m_lastTickSize <= 0.0) {
+    const LadderBookFrame *frame = currentFrame();
+    if (!frame || !frame->hasBook || frame->tickSize <= 0.0) {
         return DomSnapshot{};
     }
-    return buildSnapshot(minTick, maxTick);
+    return LadderFrameSlicer::snapshot(*frame, LadderFrameSlicer::sources(*frame, minTick, maxTick));
+}
+
+DomSnapshotDelta LadderClient::snapshotDeltaForRange(qint64 minTick, qint64 maxTick, bool forceFull)
+{
+    const LadderBookFrame *frame = currentFrame();
+    if (!frame || !frame->hasBook || frame->tickSize <= 0.0) {
+        m_slicer.invalidate();
+        return DomSnapshotDelta();
+    }
+
+    DomSnapshotDelta delta = m_slicer.delta(*frame, minTick, maxTick, forceFull);
+    requestView(*frame, m_slicer.cursor(), minTick, maxTick);
+    // The book thread reports dirty rows relative to the frame rendered last.
+    m_bookChannel->consumedVersion.store(frame->version);
+    if (delta.full) {
+        // Rows outside the frame region went out empty; resend everything once it covers them.
+        m_viewUncovered = !m_slicer.covered();
+    }
+    return delta;
+}
+
+void LadderClient::requestView(const LadderBookFrame &frame,
+                               const LadderFrameSlicer::Cursor &view,
+                               qint64 minTick,
+                               qint64 maxTick)
+{
+    // The region is re-centred once the view has used up half of its margin on either side,
+    // so scrolling reads rows the book thread has already rendered.
+    const qint64 c = view.compression;
+    const qint64 guard = std::max<qint64>(1, (frame.viewMinTick - frame.regionMinTick) / c / 2) * c;
+    const bool inside = frame.viewMaxTick - frame.viewMinTick == view.maxTick - view.minTick
+                        && view.minTick - frame.regionMinTick >= guard && frame.regionMaxTick - view.maxTick >= guard;
+    if (inside || (minTick == m_postedViewMinTick && maxTick == m_postedViewMaxTick)) {
+        return;
+    }
+    m_postedViewMinTick = minTick;
+    m_postedViewMaxTick = maxTick;
+    postViewTask([view = m_bookView, minTick, maxTick](LadderBookModel &book) {
+        book.setView(view, minTick, maxTick);
+    });
 }
 
 void LadderClient::handleReadyRead()
 {
-    const QByteArray chunk = m_process.readAllStandardOutput();
+    const QByteArray chunk = m_process->readAllStandardOutput();
     if (!chunk.isEmpty()) {
         // Treat raw backend output as liveness, even if parsing is still queued.
         // This prevents watchdog restart loops when a large ladder line (or a burst)
         // takes longer than the watchdog interval to parse on the GUI side.
         m_lastUpdateMs = QDateTime::currentMSecsSinceEpoch();
     }
-    m_buffer += chunk;
-    int idx = -1;
-    while ((idx = m_buffer.indexOf('\n')) != -1) {
-        QByteArray line = m_buffer.left(idx);
-        m_buffer.remove(0, idx + 1);
-        if (!line.trimmed().isEmpty()) {
-            m_pendingParseLines.push_back(line);
-        }
-    }
-    if (m_parseEmitScheduled || m_pendingParseLines.isEmpty()) {
+    m_lineSplitter.append(chunk);
+    if (m_parseEmitScheduled || !m_lineSplitter.hasLines()) {
         return;
     }
     m_parseEmitScheduled = true;
     QTimer::singleShot(0, this, [this]() {
         m_parseEmitScheduled = false;
-        if (m_pendingParseLines.isEmpty()) {
+        if (!m_lineSplitter.hasLines()) {
             return;
         }
-        QVector<QByteArray> lines;
-        lines.swap(m_pendingParseLines);
-        emit parseLinesRequested(lines);
+        emit parseLinesRequested(m_lineSplitter.takeBatch());
     });
 }
 
@@ -1193,7 +1900,7 @@ void LadderClient::handleReadyReadStderr()
         !qEnvironmentVariableIsSet("BACKEND_STDERR_DROP_SPAM")
         || qEnvironmentVariableIntValue("BACKEND_STDERR_DROP_SPAM") != 0;
 
-    const QByteArray raw = m_process.readAllStandardError();
+    const QByteArray raw = m_process->readAllStandardError();
     if (raw.isEmpty()) {
         return;
     }
@@ -1229,7 +1936,7 @@ void LadderClient::handleReadyReadStderr()
 void LadderClient::handleErrorOccurred(QProcess::ProcessError error)
 {
     m_lastProcessError = error;
-    m_lastProcessErrorString = m_process.errorString();
+    m_lastProcessErrorString = m_process->errorString();
     if (error == QProcess::Crashed && (m_restartInProgress || m_stopRequested)) {
         // QProcess reports CrashExit when we terminate the backend during restart/stop.
         // Treat that as expected and avoid noisy "crashed" logs.
@@ -1291,16 +1998,17 @@ void LadderClient::handleFinished(int exitCode, QProcess::ExitStatus status)
             if (m_stopRequested) {
                 return;
             }
-            if (m_process.state() != QProcess::NotRunning) {
+            if (m_process->state() != QProcess::NotRunning) {
                 return;
             }
-            restart(m_symbol, m_levels, m_exchange);
+            respawnBackend(m_symbol, m_levels, m_exchange);
         });
     }
 }
 
 void LadderClient::handleParsedTrade(const ParsedTradeEvent &ev)
 {
+    forEachFollower([&](LadderClient *view) { view->handleParsedTrade(ev); });
     armWatchdog();
     if (!m_prints) {
         return;
@@ -1361,6 +2069,7 @@ void LadderClient::handleParsedTrade(const ParsedTradeEvent &ev)
 
 void LadderClient::handleParsedTrades(const QVector<ParsedTradeEvent> &events)
 {
+    forEachFollower([&](LadderClient *view) { view->handleParsedTrades(events); });
     armWatchdog();
     if (!m_prints || events.isEmpty()) {
         return;
@@ -1379,6 +2088,9 @@ void LadderClient::handleParsedTrades(const QVector<ParsedTradeEvent> &events)
     const int start = (events.size() > maxPerBatch) ? (events.size() - maxPerBatch) : 0;
     for (int i = start; i < events.size(); ++i) {
         const auto &ev = events[i];
+        if (ev.generation < m_generation) {
+            continue;
+        }
         double price = ev.price;
         const double qtyBase = ev.qtyBase;
         if (price <= 0.0 || qtyBase <= 0.0) {
@@ -1438,20 +2150,49 @@ void LadderClient::handleParsedTrades(const QVector<ParsedTradeEvent> &events)
 
 void LadderClient::handleParsedLadderFull(const ParsedLadderFull &msg)
 {
+    forEachFollower([&](LadderClient *view) { view->handleParsedLadderFull(msg); });
     armWatchdog();
-    applyFullLadderMessage(msg);
-    if (msg.timestampMs > 0) {
+    // The ack goes along with the message: listeners of the resulting range/book signals check
+    // acknowledgements, and those only go out once the book thread has applied it. Views of a
+    // shared feed read the book its source applies.
+    const bool current = msg.generation >= m_generation;
+    if (!m_feedSource) {
+        postBookTask([msg, current](LadderBookModel &book) {
+            book.noteAck(msg.ack);
+            if (current) {
+                book.applyFull(msg);
+            }
+        });
+    }
+    if (current && msg.timestampMs > 0) {
         const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
         const int pingMs = static_cast<int>(std::max<qint64>(0, nowMs - msg.timestampMs));
         emit pingUpdated(pingMs);
     }
+    if (current && m_switchStartedMs > 0) {
+        // Time from the switch to the first book of the new symbol; the book thread and the
+        // repaint after it add a frame or two.
+        logBackendEvent(QStringLiteral("first ladder path=%1 ms=%2")
+                            .arg(m_switchPath)
+                            .arg(QDateTime::currentMSecsSinceEpoch() - m_switchStartedMs));
+        m_switchStartedMs = 0;
+    }
 }
 
 void LadderClient::handleParsedLadderDelta(const ParsedLadderDelta &msg)
 {
+    forEachFollower([&](LadderClient *view) { view->handleParsedLadderDelta(msg); });
     armWatchdog();
-    applyDeltaLadderMessage(msg);
-    if (msg.timestampMs > 0) {
+    const bool current = msg.generation >= m_generation;
+    if (!m_feedSource) {
+        postBookTask([msg, current](LadderBookModel &book) {
+            book.noteAck(msg.ack);
+            if (current) {
+                book.applyDelta(msg);
+            }
+        });
+    }
+    if (current && msg.timestampMs > 0) {
         const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
         const int pingMs = static_cast<int>(std::max<qint64>(0, nowMs - msg.timestampMs));
         emit pingUpdated(pingMs);
@@ -1460,578 +2201,141 @@ void LadderClient::handleParsedLadderDelta(const ParsedLadderDelta &msg)
 
 void LadderClient::handleParsedLadderDeltas(const QVector<ParsedLadderDelta> &msgs)
 {
+    forEachFollower([&](LadderClient *view) { view->handleParsedLadderDeltas(msgs); });
     if (msgs.isEmpty()) {
         return;
     }
     armWatchdog();
-    for (const auto &msg : msgs) {
-        applyDeltaLadderMessage(msg);
+    if (!m_feedSource) {
+        postBookTask([msgs, generation = m_generation](LadderBookModel &book) {
+            for (const auto &msg : msgs) {
+                book.noteAck(msg.ack);
+                if (msg.generation >= generation) {
+                    book.applyDelta(msg);
+                }
+            }
+        });
     }
     const ParsedLadderDelta &last = msgs.back();
-    if (last.timestampMs > 0) {
+    if (last.generation >= m_generation && last.timestampMs > 0) {
         const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
         const int pingMs = static_cast<int>(std::max<qint64>(0, nowMs - last.timestampMs));
         emit pingUpdated(pingMs);
     }
 }
 
-void LadderClient::applyFullLadderMessage(const ParsedLadderFull &msg)
+void LadderClient::handleParsedStats(const BackendStats &stats)
 {
-    const bool wasReady = m_hasBook;
-    const qint64 prevMin = m_bufferMinTick;
-    const qint64 prevMax = m_bufferMaxTick;
-    const qint64 prevCenter = m_centerTick;
-    const double prevTick = m_lastTickSize;
-
-    m_bestBid = msg.bestBid;
-    m_bestAsk = msg.bestAsk;
-    const double tickSize = msg.tickSize;
-    if (tickSize > 0.0) {
-        m_lastTickSize = tickSize;
-    }
-
-    m_book.clear();
-    m_bucketBook.clear();
-    if (!msg.rows.isEmpty() && m_lastTickSize > 0.0) {
-        static constexpr double kEps = 1e-9;
-        for (const auto &row : msg.rows) {
-            const double bidQty = row.hasBid ? std::max(0.0, row.bid) : 0.0;
-            const double askQty = row.hasAsk ? std::max(0.0, row.ask) : 0.0;
-            if (bidQty <= 0.0 && askQty <= 0.0) {
-                continue;
-            }
-            BookEntry &entry = m_book[row.tick];
-            entry.bidQty = (bidQty < kEps) ? 0.0 : bidQty;
-            entry.askQty = (askQty < kEps) ? 0.0 : askQty;
-        }
-    }
-
-    qint64 minTick = msg.windowMinTick;
-    qint64 maxTick = msg.windowMaxTick;
-    if (minTick == 0 && maxTick == 0) {
-        minTick = m_book.isEmpty() ? qint64(0) : m_book.firstKey();
-        maxTick = m_book.isEmpty() ? qint64(0) : m_book.lastKey();
-    }
-    const bool hasWindow = (m_lastTickSize > 0.0 && minTick <= maxTick);
-
-    m_hasBook = hasWindow;
-    if (m_hasBook) {
-        m_bufferMinTick = minTick;
-        m_bufferMaxTick = maxTick;
-        m_centerTick = (msg.centerTick != 0) ? msg.centerTick : (m_bufferMinTick + m_bufferMaxTick) / 2;
-        trimBookToWindow(m_bufferMinTick, m_bufferMaxTick);
-        rebuildBucketBook(m_bucketBook, m_book, m_tickCompression);
-
-        {
-            qint64 bidBucket = 0;
-            qint64 askBucket = 0;
-            if (computeBestBuckets(m_bucketBook, bidBucket, askBucket)) {
-                if (bidBucket < askBucket) {
-                    sanitizeBucketBook(m_bucketBook, bidBucket, askBucket);
-                    qint64 bid2 = 0;
-                    qint64 ask2 = 0;
-                    if (computeBestBuckets(m_bucketBook, bid2, ask2) && bid2 < ask2) {
-                        m_lastStableBestBidBucketTick = bid2;
-                        m_lastStableBestAskBucketTick = ask2;
-                    } else {
-                        m_lastStableBestBidBucketTick = bidBucket;
-                        m_lastStableBestAskBucketTick = askBucket;
-                    }
-                } else if (bidBucket == askBucket) {
-                    // Locked spread: keep the bucket as-is to avoid blanking the DOM.
-                    m_lastStableBestBidBucketTick = bidBucket;
-                    m_lastStableBestAskBucketTick = askBucket;
-                } else {
-                    // Crossed: treat as inconsistent; clear and resync.
-                    m_lastStableBestBidBucketTick = 0;
-                    m_lastStableBestAskBucketTick = 0;
-                    m_book.clear();
-                    m_bucketBook.clear();
-                    m_bestBid = 0.0;
-                    m_bestAsk = 0.0;
-                    requestForceFull();
-                }
-            }
-        }
-
-        ++m_bookRevision;
-        emit bookUpdated(m_bookRevision);
-        // IMPORTANT: A full resync can "drop" levels by omission (not included in `rows`).
-        // If we only mark buckets touched by `rows`, UI delegates can keep stale bid/ask values
-        // until the user scrolls (layout rebuild). Mark the whole window (and previous window)
-        // as dirty so empty buckets get cleared immediately.
-        {
-            static constexpr int kDirtyCap = 4096; // DomWidget forces full recalc above this
-            const qint64 c = std::max<qint64>(1, m_tickCompression);
-            auto floorBucket = [c](qint64 tick) -> qint64 {
-                if (c == 1) return tick;
-                if (tick >= 0) return (tick / c) * c;
-                const qint64 absTick = -tick;
-                const qint64 buckets = (absTick + c - 1) / c;
-                return -buckets * c;
-            };
-            auto ceilBucket = [c](qint64 tick) -> qint64 {
-                if (c == 1) return tick;
-                if (tick >= 0) return ((tick + c - 1) / c) * c;
-                const qint64 absTick = -tick;
-                const qint64 buckets = absTick / c;
-                return -buckets * c;
-            };
-
-            auto bucketCountForRange = [&](qint64 a, qint64 b) -> qint64 {
-                if (a == 0 && b == 0) return 0;
-                if (a > b) std::swap(a, b);
-                const qint64 bmin = floorBucket(a);
-                const qint64 bmax = ceilBucket(b);
-                if (bmax < bmin) return 0;
-                return (bmax - bmin) / c + 1;
-            };
-
-            qint64 estimated = 0;
-            if (wasReady && prevMin <= prevMax) {
-                estimated += bucketCountForRange(prevMin, prevMax);
-            }
-            if (m_bufferMinTick <= m_bufferMaxTick) {
-                estimated += bucketCountForRange(m_bufferMinTick, m_bufferMaxTick);
-            }
+    forEachFollower([&](LadderClient *view) { view->handleParsedStats(stats); });
+    emit backendStatsUpdated(stats);
+}
 
-            if (estimated > kDirtyCap) {
-                QVector<qint64> ticks;
-                ticks.resize(kDirtyCap + 1);
-                for (int i = 0; i < ticks.size(); ++i) {
-                    ticks[i] = static_cast<qint64>(i + 1);
-                }
-                emit bucketTicksUpdated(ticks);
-            } else {
-                QSet<qint64> dirtyBuckets;
-                dirtyBuckets.reserve(static_cast<int>(std::max<qint64>(0, estimated)));
-                auto addRange = [&](qint64 a, qint64 b) {
-                    if (a == 0 && b == 0) return;
-                    if (a > b) std::swap(a, b);
-                    const qint64 bmin = floorBucket(a);
-                    const qint64 bmax = ceilBucket(b);
-                    if (bmax < bmin) return;
-                    for (qint64 t = bmin; t <= bmax; t += c) {
-                        dirtyBuckets.insert(t);
-                    }
-                };
-                if (wasReady && prevMin <= prevMax) {
-                    addRange(prevMin, prevMax);
-                }
-                addRange(m_bufferMinTick, m_bufferMaxTick);
+void LadderClient::handleParsedReplayStatus(const ParsedReplayStatus &status)
+{
+    forEachFollower([&](LadderClient *view) { view->handleParsedReplayStatus(status); });
+    emit replayStatusUpdated(status);
+}
 
-                if (!dirtyBuckets.isEmpty()) {
-                    QVector<qint64> ticks;
-                    ticks.reserve(dirtyBuckets.size());
-                    for (qint64 t : std::as_const(dirtyBuckets)) {
-                        ticks.push_back(t);
-                    }
-                    emit bucketTicksUpdated(ticks);
-                }
-            }
-        }
-        const bool windowChanged =
-            (!wasReady)
-            || (prevMin != m_bufferMinTick)
-            || (prevMax != m_bufferMaxTick)
-            || (prevCenter != m_centerTick)
-            || (std::abs(prevTick - m_lastTickSize) > 1e-12);
-        if (windowChanged) {
-            emit bookRangeUpdated(m_bufferMinTick, m_bufferMaxTick, m_centerTick, m_lastTickSize);
+void LadderClient::handleParsedLadderPage(const ParsedLadderPage &page)
+{
+    forEachFollower([&](LadderClient *view) { view->handleParsedLadderPage(page); });
+    // Commands are applied in order, so the reply also acknowledges everything sent before it,
+    // for every view of the feed; the source acknowledges it on the book they all read.
+    // Asked for by another view of a shared feed, or for a setup already left: only that.
+    if (!m_pageRequestIds.remove(page.id) || page.generation < m_generation) {
+        if (!m_feedSource) {
+            postBookTask([id = page.id](LadderBookModel &book) { book.noteAck(id); });
         }
-    } else {
-        m_bufferMinTick = 0;
-        m_bufferMaxTick = 0;
-        m_centerTick = 0;
-        m_book.clear();
-        m_bucketBook.clear();
-        m_lastStableBestBidBucketTick = 0;
-        m_lastStableBestAskBucketTick = 0;
-    }
-}
-
-void LadderClient::applyDeltaLadderMessage(const ParsedLadderDelta &msg)
-{
-    if (!m_hasBook) {
-        ParsedLadderFull full;
-        full.bestBid = msg.bestBid;
-        full.bestAsk = msg.bestAsk;
-        full.tickSize = msg.tickSize;
-        full.windowMinTick = msg.windowMinTick;
-        full.windowMaxTick = msg.windowMaxTick;
-        full.centerTick = msg.centerTick;
-        full.timestampMs = msg.timestampMs;
-        applyFullLadderMessage(full);
         return;
     }
-
-    const qint64 prevMin = m_bufferMinTick;
-    const qint64 prevMax = m_bufferMaxTick;
-    const qint64 prevCenter = m_centerTick;
-    const double prevTick = m_lastTickSize;
-    const double prevBestBid = m_bestBid;
-    const double prevBestAsk = m_bestAsk;
-
-    if (msg.bestBid != 0.0) {
-        m_bestBid = msg.bestBid;
-    }
-    if (msg.bestAsk != 0.0) {
-        m_bestAsk = msg.bestAsk;
-    }
-    const double tickSize = msg.tickSize;
-    if (tickSize > 0.0) {
-        m_lastTickSize = tickSize;
+    m_backendBookKnown = (page.bookMinTick != 0 || page.bookMaxTick != 0);
+    m_backendBookMinTick = page.bookMinTick;
+    m_backendBookMaxTick = page.bookMaxTick;
+
+    // Levels beyond what the backend holds are unknown, not empty; keep them out of the span.
+    qint64 fromTick = page.fromTick;
+    qint64 toTick = page.toTick;
+    if (m_backendBookKnown) {
+        fromTick = std::max(fromTick, m_backendBookMinTick);
+        toTick = std::min(toTick, m_backendBookMaxTick);
+    }
+    m_pagesFetchedMs = QDateTime::currentMSecsSinceEpoch();
+    postViewTask([view = m_bookView, page, fromTick, toTick, known = m_backendBookKnown](LadderBookModel &book) {
+        book.noteAck(page.id);
+        book.applyPage(view, page.rows, page.tickSize, fromTick, toTick, known);
+    });
+    if (!m_feedSource) {
+        // Behind the page, so the view that asked never sees the ack without it.
+        postBookTask([id = page.id](LadderBookModel &book) { book.noteAck(id); });
     }
+}
 
-    QSet<qint64> dirtyBuckets;
-    // IMPORTANT: Some backends can update top-of-book (bestBid/bestAsk) without sending
-    // a depth delta for the corresponding tick in the same frame. In GPU mode we do
-    // incremental updates by dirty buckets, so if best prices change we must mark the
-    // old+new best buckets dirty, otherwise stale "best" highlights can remain visible
-    // (looks like 2-3 asks/bids) until the user scrolls and forces a full rebuild.
-    if (m_lastTickSize > 0.0) {
-        auto priceToRawTick = [&](double price) -> qint64 {
-            if (!(price > 0.0) || !(m_lastTickSize > 0.0) || !std::isfinite(price) || !std::isfinite(m_lastTickSize)) {
-                return 0;
-            }
-            const double scaled = price / m_lastTickSize;
-            if (!std::isfinite(scaled)) {
-                return 0;
-            }
-            const double nudged = scaled + (scaled >= 0.0 ? 1e-9 : -1e-9);
-            return static_cast<qint64>(std::llround(nudged));
-        };
-        const qint64 c = std::max<qint64>(1, m_tickCompression);
-        auto floorBucketSigned = [c](qint64 tick) -> qint64 {
-            if (c == 1) return tick;
-            if (tick >= 0) return (tick / c) * c;
-            const qint64 absTick = -tick;
-            const qint64 buckets = (absTick + c - 1) / c;
-            return -buckets * c;
-        };
-        auto ceilBucketSigned = [c](qint64 tick) -> qint64 {
-            if (c == 1) return tick;
-            if (tick >= 0) return ((tick + c - 1) / c) * c;
-            const qint64 absTick = -tick;
-            const qint64 buckets = absTick / c;
-            return -buckets * c;
-        };
-
-        const qint64 prevBidTick = priceToRawTick(prevBestBid);
-        const qint64 prevAskTick = priceToRawTick(prevBestAsk);
-        const qint64 nextBidTick = priceToRawTick(m_bestBid);
-        const qint64 nextAskTick = priceToRawTick(m_bestAsk);
-        if (prevBidTick != 0) dirtyBuckets.insert(floorBucketSigned(prevBidTick));
-        if (nextBidTick != 0) dirtyBuckets.insert(floorBucketSigned(nextBidTick));
-        if (prevAskTick != 0) dirtyBuckets.insert(ceilBucketSigned(prevAskTick));
-        if (nextAskTick != 0) dirtyBuckets.insert(ceilBucketSigned(nextAskTick));
-    }
-    if (!msg.updates.isEmpty() && m_lastTickSize > 0.0) {
-        static constexpr double kEps = 1e-9;
-        dirtyBuckets.reserve(msg.updates.size() * 2);
-        for (const auto &row : msg.updates) {
-            const qint64 tick = row.tick;
-            if (tick == 0) {
-                continue;
-            }
-            double oldBid = 0.0;
-            double oldAsk = 0.0;
-            auto it = m_book.find(tick);
-            BookEntry entry;
-            if (it != m_book.end()) {
-                entry = it.value();
-                oldBid = entry.bidQty;
-                oldAsk = entry.askQty;
-            }
-
-            if (row.hasBid) {
-                const double v = std::max(0.0, row.bid);
-                entry.bidQty = (v < kEps) ? 0.0 : v;
-            }
-            if (row.hasAsk) {
-                const double v = std::max(0.0, row.ask);
-                entry.askQty = (v < kEps) ? 0.0 : v;
-            }
-
-            if (entry.bidQty <= 0.0 && entry.askQty <= 0.0) {
-                if (it != m_book.end()) {
-                    m_book.erase(it);
-                }
-            } else {
-                if (it != m_book.end()) {
-                    it.value() = entry;
-                } else {
-                    m_book.insert(tick, entry);
-                }
-            }
-
-            if (row.hasBid) {
-                bucketAggAdd(m_bucketBook,
-                             floorBucketTickSigned(tick, m_tickCompression),
-                             entry.bidQty - oldBid,
-                             0.0);
-            }
-            if (row.hasAsk) {
-                bucketAggAdd(m_bucketBook,
-                             ceilBucketTickSigned(tick, m_tickCompression),
-                             0.0,
-                             entry.askQty - oldAsk);
-            }
+qint64 LadderClient::bufferMinTick() const
+{
+    return m_pagesConnected ? std::min(m_bufferMinTick, m_pageMinTick) : m_bufferMinTick;
+}
 
-            dirtyBuckets.insert(floorBucketTickSigned(tick, m_tickCompression));
-            dirtyBuckets.insert(ceilBucketTickSigned(tick, m_tickCompression));
-        }
-    }
+qint64 LadderClient::bufferMaxTick() const
+{
+    return m_pagesConnected ? std::max(m_bufferMaxTick, m_pageMaxTick) : m_bufferMaxTick;
+}
 
-    if (!msg.removals.isEmpty()) {
-        dirtyBuckets.reserve(dirtyBuckets.size() + msg.removals.size() * 2);
-        for (qint64 t : msg.removals) {
-            if (t == 0) {
-                continue;
-            }
-            auto it = m_book.find(t);
-            if (it != m_book.end()) {
-                const double bidOld = it->bidQty;
-                const double askOld = it->askQty;
-                if (bidOld > 0.0) {
-                    bucketAggAdd(m_bucketBook, floorBucketTickSigned(t, m_tickCompression), -bidOld, 0.0);
-                }
-                if (askOld > 0.0) {
-                    bucketAggAdd(m_bucketBook, ceilBucketTickSigned(t, m_tickCompression), 0.0, -askOld);
-                }
-                m_book.erase(it);
-            }
-            dirtyBuckets.insert(floorBucketTickSigned(t, m_tickCompression));
-            dirtyBuckets.insert(ceilBucketTickSigned(t, m_tickCompression));
-        }
+// Called after every frame with a book: pages only mirror the backend cache at fetch time, so
+// the parts outside the live window are re-requested about once a second while they are in
+// use. Pages the live window moved away from are already gone (LadderBookModel).
+void LadderClient::refreshRangePages()
+{
+    static constexpr qint64 kPageRefreshMs = 1000;
+    if (!m_hasPages) {
+        return;
     }
-
-    // If the book becomes crossed (bid >= ask) due to out-of-order bursts on volatile symbols,
-    // request a full ladder resync from the backend (without changing manual center).
-    //
-    // IMPORTANT: In GPU mode the DOM updates incrementally from `bucketTicksUpdated` + `bookUpdated`.
-    // If we early-return here (old behavior), the UI can "freeze" on stale rows until the user scrolls,
-    // because no new snapshot pull is triggered. Instead, keep going and force a full DOM recalc for
-    // this frame (while still requesting a backend resync).
-    bool inconsistentFrame = false;
-    const qint64 prevStableBid = m_lastStableBestBidBucketTick;
-    const qint64 prevStableAsk = m_lastStableBestAskBucketTick;
-
-    if (m_hasBook) {
-        // Robust crossed detection: dirty-bucket heuristics can miss cases where the crossing is
-        // caused by stale buckets outside the delta set. Always verify the aggregated top-of-book.
-        qint64 bidBucket = 0;
-        qint64 askBucket = 0;
-        const bool haveTop = computeBestBuckets(m_bucketBook, bidBucket, askBucket);
-        const bool crossed = haveTop && bidBucket > askBucket;
-        const bool likelyCrossed = (!crossed && crossedBookLikely(dirtyBuckets));
-        if (crossed || likelyCrossed) {
-            inconsistentFrame = true;
-            const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
-            if (m_lastForceFullMs <= 0 || nowMs - m_lastForceFullMs > 500) {
-                m_lastForceFullMs = nowMs;
-                emitStatus(QStringLiteral("%1 Crossed book detected; forcing full resync...")
-                               .arg(formatBackendPrefix()));
-                requestForceFull();
-            }
-            if (crossed) {
-                // Fail-safe: clear local state so ghosts cannot persist; MainWindow will now
-                // push an empty snapshot to DomWidget to clear rendering immediately.
-                m_book.clear();
-                m_bucketBook.clear();
-                m_bestBid = 0.0;
-                m_bestAsk = 0.0;
-                m_lastStableBestBidBucketTick = 0;
-                m_lastStableBestAskBucketTick = 0;
-            }
-        }
+    if (!controlAcknowledged(m_lastPageRequestId)) {
+        return;
     }
-
-    const bool hasWindow = (msg.windowMinTick != 0 || msg.windowMaxTick != 0);
-    const qint64 minTick = hasWindow ? msg.windowMinTick : m_bufferMinTick;
-    const qint64 maxTick = hasWindow ? msg.windowMaxTick : m_bufferMaxTick;
-    if (minTick <= maxTick) {
-        m_bufferMinTick = minTick;
-        m_bufferMaxTick = maxTick;
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    if (nowMs - m_pagesFetchedMs < kPageRefreshMs) {
+        return;
     }
-    if (msg.centerTick != 0) {
-        m_centerTick = msg.centerTick;
+    m_pagesFetchedMs = nowMs;
+    if (m_pageMaxTick > m_bufferMaxTick) {
+        requestRange(m_bufferMaxTick + 1, m_pageMaxTick);
     }
-    trimBookToWindow(m_bufferMinTick, m_bufferMaxTick, &dirtyBuckets);
-
-    m_hasBook = (m_lastTickSize > 0.0 && m_bufferMinTick <= m_bufferMaxTick);
-    if (m_hasBook) {
-        {
-            qint64 bidBucket = 0;
-            qint64 askBucket = 0;
-            if (computeBestBuckets(m_bucketBook, bidBucket, askBucket)) {
-                if (bidBucket < askBucket) {
-                    sanitizeBucketBook(m_bucketBook, bidBucket, askBucket, &dirtyBuckets);
-                    qint64 bid2 = 0;
-                    qint64 ask2 = 0;
-                    if (computeBestBuckets(m_bucketBook, bid2, ask2) && bid2 < ask2) {
-                        m_lastStableBestBidBucketTick = bid2;
-                        m_lastStableBestAskBucketTick = ask2;
-                    } else {
-                        m_lastStableBestBidBucketTick = bidBucket;
-                        m_lastStableBestAskBucketTick = askBucket;
-                    }
-                } else if (bidBucket == askBucket) {
-                    // Locked spread: keep the bucket as-is to avoid blanking the DOM.
-                    m_lastStableBestBidBucketTick = bidBucket;
-                    m_lastStableBestAskBucketTick = askBucket;
-                }
-            }
-        }
-        // If top-of-book buckets moved, mark the affected range dirty so GPU rows re-evaluate
-        // the spread guard logic (prevents stale "wrong side" levels from sticking).
-        const qint64 compression = std::max<qint64>(1, m_tickCompression);
-        auto markRange = [&](qint64 a, qint64 b) {
-            if (a == 0 || b == 0) {
-                return;
-            }
-            if (a > b) {
-                std::swap(a, b);
-            }
-            const qint64 count = (b - a) / compression + 1;
-            if (count > 4096) {
-                // Force full recalc.
-                dirtyBuckets.clear();
-                dirtyBuckets.insert(1);
-                dirtyBuckets.insert(2);
-                dirtyBuckets.insert(3);
-                dirtyBuckets.insert(4);
-                dirtyBuckets.insert(5);
-                return;
-            }
-            for (qint64 t = a; t <= b; t += compression) {
-                dirtyBuckets.insert(t);
-            }
-        };
-        if (prevStableBid != m_lastStableBestBidBucketTick) {
-            if (prevStableBid != 0 && m_lastStableBestBidBucketTick != 0) {
-                markRange(prevStableBid, m_lastStableBestBidBucketTick);
-            } else if (m_lastStableBestBidBucketTick != 0) {
-                dirtyBuckets.insert(m_lastStableBestBidBucketTick);
-            } else if (prevStableBid != 0) {
-                dirtyBuckets.insert(prevStableBid);
-            }
-        }
-        if (prevStableAsk != m_lastStableBestAskBucketTick) {
-            if (prevStableAsk != 0 && m_lastStableBestAskBucketTick != 0) {
-                markRange(prevStableAsk, m_lastStableBestAskBucketTick);
-            } else if (m_lastStableBestAskBucketTick != 0) {
-                dirtyBuckets.insert(m_lastStableBestAskBucketTick);
-            } else if (prevStableAsk != 0) {
-                dirtyBuckets.insert(prevStableAsk);
-            }
-        }
-
-        ++m_bookRevision;
-        emit bookUpdated(m_bookRevision);
-        if (inconsistentFrame) {
-            // Force a full recalc in DomWidget for immediate visual recovery.
-            QVector<qint64> ticks;
-            ticks.resize(4097);
-            for (int i = 0; i < ticks.size(); ++i) {
-                ticks[i] = static_cast<qint64>(i + 1);
-            }
-            emit bucketTicksUpdated(ticks);
-        } else if (!dirtyBuckets.isEmpty()) {
-            // Too many dirty buckets => force a full recalc on the DOM side.
-            if (dirtyBuckets.size() > 4096) {
-                QVector<qint64> ticks;
-                ticks.resize(4097);
-                for (int i = 0; i < ticks.size(); ++i) {
-                    ticks[i] = static_cast<qint64>(i + 1);
-                }
-                emit bucketTicksUpdated(ticks);
-            } else {
-                QVector<qint64> ticks;
-                ticks.reserve(dirtyBuckets.size());
-                for (qint64 t : std::as_const(dirtyBuckets)) {
-                    ticks.push_back(t);
-                }
-                emit bucketTicksUpdated(ticks);
-            }
-        }
-        const bool windowChanged =
-            (prevMin != m_bufferMinTick)
-            || (prevMax != m_bufferMaxTick)
-            || (prevCenter != m_centerTick)
-            || (std::abs(prevTick - m_lastTickSize) > 1e-12);
-        if (windowChanged) {
-            emit bookRangeUpdated(m_bufferMinTick, m_bufferMaxTick, m_centerTick, m_lastTickSize);
-        }
-    } else {
-        m_bufferMinTick = 0;
-        m_bufferMaxTick = 0;
-        m_centerTick = 0;
-        m_book.clear();
-        m_lastStableBestBidBucketTick = 0;
-        m_lastStableBestAskBucketTick = 0;
+    if (m_pageMinTick < m_bufferMinTick) {
+        requestRange(m_pageMinTick, m_bufferMinTick - 1);
     }
 }
 
-void LadderClient::trimBookToWindow(qint64 minTick, qint64 maxTick, QSet<qint64> *dirtyBuckets)
+void LadderClient::emitBookRange()
 {
-    if (m_lastTickSize <= 0.0) {
-        return;
-    }
+    emit bookRangeUpdated(bufferMinTick(), bufferMaxTick(), m_centerTick, m_lastTickSize);
+}
 
-    // Keep book coverage anchored around the current best price so cumulative
-    // volume does not change when the user scrolls the visible window.
-    qint64 bestTick = 0;
-    auto priceToRawTick = [&](double price) -> qint64 {
-        if (!(price > 0.0) || !(m_lastTickSize > 0.0) || !std::isfinite(price) || !std::isfinite(m_lastTickSize)) {
-            return 0;
+void LadderClient::handleParsedWallEvents(const QVector<ParsedWallEvent> &events)
+{
+    forEachFollower([&](LadderClient *view) { view->handleParsedWallEvents(events); });
+    bool changed = false;
+    for (const auto &ev : events) {
+        if (ev.generation < m_generation) {
+            continue;
         }
-        const double scaled = price / m_lastTickSize;
-        if (!std::isfinite(scaled)) {
-            return 0;
+        if (ev.kind == ParsedWallEvent::Kind::Remove) {
+            changed = (m_walls.remove(ev.wall.id) > 0) || changed;
+            continue;
         }
-        return static_cast<qint64>(std::llround(scaled));
-    };
-    if (m_bestBid > 0.0) {
-        bestTick = priceToRawTick(m_bestBid);
-    }
-    if (bestTick == 0 && m_bestAsk > 0.0) {
-        bestTick = priceToRawTick(m_bestAsk);
-    }
-
-    if (bestTick != 0 && m_cacheLevels > 0) {
-        const qint64 span = static_cast<qint64>(m_cacheLevels);
-        minTick = bestTick - span;
-        maxTick = bestTick + span;
-    }
-
-    if (minTick > maxTick) {
-        return;
-    }
-    auto it = m_book.begin();
-    while (it != m_book.end()) {
-        if (it.key() < minTick || it.key() > maxTick) {
-            const qint64 tick = it.key();
-            const double bidOld = it->bidQty;
-            const double askOld = it->askQty;
-            if (bidOld > 0.0) {
-                bucketAggAdd(m_bucketBook, floorBucketTickSigned(tick, m_tickCompression), -bidOld, 0.0);
-                if (dirtyBuckets) {
-                    dirtyBuckets->insert(floorBucketTickSigned(tick, m_tickCompression));
-                }
-            }
-            if (askOld > 0.0) {
-                bucketAggAdd(m_bucketBook, ceilBucketTickSigned(tick, m_tickCompression), 0.0, -askOld);
-                if (dirtyBuckets) {
-                    dirtyBuckets->insert(ceilBucketTickSigned(tick, m_tickCompression));
-                }
-            }
-            it = m_book.erase(it);
-        } else {
-            ++it;
+        DomWidget::WallMarker wall = ev.wall;
+        const auto it = m_walls.constFind(wall.id);
+        if (it != m_walls.constEnd() && it->firstSeenMs > 0) {
+            // Keep the first estimate so the marker does not jitter with pipe latency.
+            wall.firstSeenMs = it->firstSeenMs;
         }
+        m_walls.insert(wall.id, wall);
+        changed = true;
+    }
+    if (changed) {
+        emit wallMarkersChanged(m_walls.values());
     }
 }
+
 void LadderClient::emitStatus(const QString &msg)
 {
     const QString symbol = m_symbol.toUpper();
@@ -2041,10 +2345,14 @@ void LadderClient::emitStatus(const QString &msg)
     }
     const QString decorated = QStringLiteral("[%1@%2] %3").arg(symbol, exchangeLabel, msg);
     emit statusMessage(decorated);
+    forEachFollower([&](LadderClient *view) { emit view->statusMessage(decorated); });
 }
 
 void LadderClient::armWatchdog()
 {
+    if (m_feedSource) {
+        return; // the source's watchdog covers the shared process
+    }
     m_lastUpdateMs = QDateTime::currentMSecsSinceEpoch();
     if (m_watchdogIntervalMs > 0) {
         m_watchdogTimer.start(m_watchdogIntervalMs);
@@ -2060,215 +2368,46 @@ void LadderClient::handleWatchdogTimeout()
     }
     emitStatus(QStringLiteral("No data received for %1s, restarting backend...")
                    .arg(m_watchdogIntervalMs / 1000));
-    restart(m_symbol, m_levels, m_exchange);
+    respawnBackend(m_symbol, m_levels, m_exchange);
 }
-DomSnapshot LadderClient::buildSnapshot(qint64 minTick, qint64 maxTick) const
+QString LadderClient::wallInfoForPrice(double price) const
 {
-    DomSnapshot snap;
-    if (minTick > maxTick) {
-        std::swap(minTick, maxTick);
-    }
-    snap.tickSize = m_lastTickSize;
-    snap.bestBid = m_bestBid;
-    snap.bestAsk = m_bestAsk;
-    if (m_lastTickSize <= 0.0) {
-        return snap;
+    if (m_walls.isEmpty() || !(m_lastTickSize > 0.0) || !std::isfinite(price) || !(price > 0.0)) {
+        return QString();
     }
-
     const qint64 compression = std::max<qint64>(1, m_tickCompression);
-    snap.compression = compression;
-    auto floorBucket = [compression](qint64 tick) -> qint64 {
-        if (compression == 1) {
-            return tick;
-        }
-        if (tick >= 0) {
-            return (tick / compression) * compression;
-        }
-        const qint64 absTick = -tick;
-        const qint64 buckets = (absTick + compression - 1) / compression;
-        return -buckets * compression;
-    };
-    auto ceilBucket = [compression](qint64 tick) -> qint64 {
-        if (compression == 1) {
-            return tick;
-        }
-        if (tick >= 0) {
-            return ((tick + compression - 1) / compression) * compression;
-        }
-        const qint64 absTick = -tick;
-        const qint64 buckets = absTick / compression;
-        return -buckets * compression;
-    };
-
-    // Align compressed buckets so bids are floored and asks are ceiled. This prevents the
-    // ask side from "shifting down" by up to (compression-1) ticks compared to other ladders.
-    const qint64 bucketMinTick = floorBucket(minTick);
-    const qint64 bucketMaxTick = ceilBucket(maxTick);
-    snap.minTick = bucketMinTick;
-    snap.maxTick = bucketMaxTick;
-    if (bucketMaxTick < bucketMinTick) {
-        return snap;
-    }
-    const qint64 bucketCount = (bucketMaxTick - bucketMinTick) / compression + 1;
-    if (bucketCount <= 0 || bucketCount > 2000000) {
-        return snap;
-    }
-
-    QVector<DomLevel> buckets;
-    buckets.resize(static_cast<int>(bucketCount));
-    for (qint64 i = 0; i < bucketCount; ++i) {
-        const qint64 bucketTick = bucketMinTick + i * compression;
-        buckets[static_cast<int>(i)].tick = bucketTick;
-        buckets[static_cast<int>(i)].price = static_cast<double>(bucketTick) * snap.tickSize;
-    }
-
-    for (qint64 i = 0; i < bucketCount; ++i) {
-        const qint64 bucketTick = bucketMinTick + i * compression;
-        auto it = m_bucketBook.constFind(bucketTick);
-        if (it == m_bucketBook.constEnd()) {
+    const qint64 bucket = floorBucketTickSigned(static_cast<qint64>(std::llround(price / m_lastTickSize)), compression);
+    const DomWidget::WallMarker *oldest = nullptr;
+    for (const auto &wall : m_walls) {
+        if (floorBucketTickSigned(wall.tick, compression) != bucket) {
             continue;
         }
-        buckets[static_cast<int>(i)].bidQty = it->bidQty;
-        buckets[static_cast<int>(i)].askQty = it->askQty;
-    }
-
-    auto priceToRawTick = [&](double price) -> qint64 {
-        if (!(price > 0.0) || !(snap.tickSize > 0.0) || !std::isfinite(price) || !std::isfinite(snap.tickSize)) {
-            return 0;
-        }
-        const double scaled = price / snap.tickSize;
-        if (!std::isfinite(scaled)) {
-            return 0;
-        }
-        const double nudged = scaled + (scaled >= 0.0 ? 1e-9 : -1e-9);
-        return static_cast<qint64>(std::llround(nudged));
-    };
-    qint64 backendBidBucket = 0;
-    qint64 backendAskBucket = 0;
-    bool backendHasBid = false;
-    bool backendHasAsk = false;
-    if (snap.bestBid > 0.0) {
-        const qint64 bestBidTick = priceToRawTick(snap.bestBid);
-        if (bestBidTick != 0) {
-            backendBidBucket = floorBucket(bestBidTick);
-            backendHasBid = true;
-        }
-    }
-    if (snap.bestAsk > 0.0) {
-        const qint64 bestAskTick = priceToRawTick(snap.bestAsk);
-        if (bestAskTick != 0) {
-            backendAskBucket = ceilBucket(bestAskTick);
-            backendHasAsk = true;
-        }
-    }
-    const bool backendOk =
-        backendHasBid && backendHasAsk && backendBidBucket < backendAskBucket;
-
-    // Sanitize: never show asks at/below best bid bucket, and never show bids at/above best ask bucket.
-    // Under volatile / out-of-order frames, aggregated buckets can momentarily contain stale side data
-    // that would look "impossible" in the UI. This keeps rendering sane until the next resync.
-    qint64 bestBidBucket = m_lastStableBestBidBucketTick;
-    qint64 bestAskBucket = m_lastStableBestAskBucketTick;
-    bool haveBid = (bestBidBucket != 0);
-    bool haveAsk = (bestAskBucket != 0);
-
-    if (!haveBid || !haveAsk) {
-        // Fallback: derive from the current snapshot rows.
-        bestBidBucket = 0;
-        bestAskBucket = 0;
-        haveBid = false;
-        haveAsk = false;
-        for (const auto &lvl : buckets) {
-            if (lvl.tick == 0) continue;
-            if (lvl.bidQty > 0.0) {
-                if (!haveBid || lvl.tick > bestBidBucket) {
-                    bestBidBucket = lvl.tick;
-                    haveBid = true;
-                }
-            }
-            if (lvl.askQty > 0.0) {
-                if (!haveAsk || lvl.tick < bestAskBucket) {
-                    bestAskBucket = lvl.tick;
-                    haveAsk = true;
-                }
-            }
-        }
-    }
-
-    if (!haveBid || !haveAsk) {
-        if (!haveBid && backendHasBid) {
-            bestBidBucket = backendBidBucket;
-            haveBid = true;
-        }
-        if (!haveAsk && backendHasAsk) {
-            bestAskBucket = backendAskBucket;
-            haveAsk = true;
-        }
-    }
-
-    // If buckets are inconsistent, fall back to backend best-bid/ask buckets when available.
-    if (haveBid && haveAsk && bestBidBucket >= bestAskBucket && backendOk) {
-        bestBidBucket = backendBidBucket;
-        bestAskBucket = backendAskBucket;
-    }
-
-    const bool lockedSpread = haveBid && haveAsk && bestBidBucket == bestAskBucket;
-    if (haveBid || haveAsk) {
-        for (auto &lvl : buckets) {
-            if (haveBid) {
-                if (lockedSpread) {
-                    if (lvl.tick < bestBidBucket) {
-                        lvl.askQty = 0.0;
-                    }
-                } else if (lvl.tick <= bestBidBucket) {
-                    lvl.askQty = 0.0;
-                }
-            }
-            if (haveAsk) {
-                if (lockedSpread) {
-                    if (lvl.tick > bestAskBucket) {
-                        lvl.bidQty = 0.0;
-                    }
-                } else if (lvl.tick >= bestAskBucket) {
-                    lvl.bidQty = 0.0;
-                }
-            }
-        }
-    }
-
-    // Strong invariant: there must be no liquidity strictly inside the spread range.
-    // If a transient out-of-order delta makes us aggregate stale bid+ask into interior buckets,
-    // clear them so "impossible" levels can't remain visible until the next resync.
-    if (haveBid && haveAsk && bestBidBucket < bestAskBucket) {
-        for (auto &lvl : buckets) {
-            if (lvl.tick > bestBidBucket && lvl.tick < bestAskBucket) {
-                lvl.bidQty = 0.0;
-                lvl.askQty = 0.0;
-            }
+        if (!oldest || wall.firstSeenMs < oldest->firstSeenMs) {
+            oldest = &wall;
         }
     }
-
-    // Keep displayed best prices consistent with sanitized buckets when possible.
-    if (haveBid) {
-        snap.bestBid = static_cast<double>(bestBidBucket) * snap.tickSize;
-    }
-    if (haveAsk) {
-        snap.bestAsk = static_cast<double>(bestAskBucket) * snap.tickSize;
+    if (!oldest) {
+        return QString();
     }
-
-    snap.levels.reserve(buckets.size());
-    for (int i = buckets.size() - 1; i >= 0; --i) {
-        snap.levels.push_back(buckets[i]);
+    const qint64 ageSec = std::max<qint64>(0, QDateTime::currentMSecsSinceEpoch() - oldest->firstSeenMs) / 1000;
+    QString text = QStringLiteral("wall %1s +%2 -%3 traded %4")
+                       .arg(ageSec)
+                       .arg(oldest->added, 0, 'g', 4)
+                       .arg(oldest->pulled, 0, 'g', 4)
+                       .arg(oldest->traded, 0, 'g', 4);
+    if (oldest->moves > 0) {
+        text += QStringLiteral(" moved %1").arg(oldest->moves);
     }
-    return snap;
+    return text;
 }
 
 double LadderClient::cumulativeNotionalForPrice(double price) const
 {
-    if (!(m_lastTickSize > 0.0) || !std::isfinite(price) || !(price > 0.0)) {
+    const LadderBookFrame *frame = currentFrame();
+    if (!frame || !(m_lastTickSize > 0.0) || !std::isfinite(price) || !(price > 0.0)) {
         return 0.0;
     }
-    const qint64 compression = std::max<qint64>(1, m_tickCompression);
+    const qint64 compression = frame->compression;
 
     auto priceToRawTick = [&](double p) -> qint64 {
         if (!(p > 0.0) || !std::isfinite(p) || !(m_lastTickSize > 0.0) || !std::isfinite(m_lastTickSize)) {
@@ -2282,36 +2421,9 @@ double LadderClient::cumulativeNotionalForPrice(double price) const
         return static_cast<qint64>(std::llround(nudged));
     };
 
-    auto bestBuckets = [&]() -> std::pair<qint64, qint64> {
-        qint64 bid = m_lastStableBestBidBucketTick;
-        qint64 ask = m_lastStableBestAskBucketTick;
-        if (bid != 0 && ask != 0) {
-            return {bid, ask};
-        }
-        // Fallback: derive from the current cached bucket book (stable across scrolling).
-        qint64 bestBid = 0;
-        qint64 bestAsk = 0;
-        bool hasBid = false;
-        bool hasAsk = false;
-        for (auto it = m_bucketBook.constBegin(); it != m_bucketBook.constEnd(); ++it) {
-            const qint64 t = it.key();
-            if (it->bidQty > 0.0) {
-                if (!hasBid || t > bestBid) {
-                    bestBid = t;
-                    hasBid = true;
-                }
-            }
-            if (it->askQty > 0.0) {
-                if (!hasAsk || t < bestAsk) {
-                    bestAsk = t;
-                    hasAsk = true;
-                }
-            }
-        }
-        return {hasBid ? bestBid : 0, hasAsk ? bestAsk : 0};
-    };
-
-    const auto [bestBidBucket, bestAskBucket] = bestBuckets();
+    // The book thread picked them: the stable top of book, else the cached bucket book's.
+    const qint64 bestBidBucket = frame->notionalBidBucket;
+    const qint64 bestAskBucket = frame->notionalAskBucket;
     if (bestBidBucket == 0 && bestAskBucket == 0) {
         return 0.0;
     }
@@ -2347,49 +2459,26 @@ double LadderClient::cumulativeNotionalForPrice(double price) const
         }
     }
 
-    qint64 lo = 0;
-    qint64 hi = 0;
-    const bool useBidSide = (side == Side::Bid);
-    if (useBidSide) {
-        if (bestBidBucket == 0) {
-            return 0.0;
-        }
-        qint64 targetBucket = floorBucketTickSigned(targetTick, compression);
-        if (targetBucket > bestBidBucket) {
-            targetBucket = bestBidBucket; // inside-spread clamp
+    // The frame holds the sums out to every row of its region; rows past the best bucket sum
+    // that bucket alone (inside-spread clamp).
+    auto regionSum = [frame, compression](const QVector<double> &sums, qint64 bucket) -> double {
+        if (bucket < frame->regionMinTick || bucket > frame->regionMaxTick || sums.isEmpty()) {
+            return 0.0; // only while a fast scroll outruns the book thread
         }
-        lo = std::min(targetBucket, bestBidBucket);
-        hi = std::max(targetBucket, bestBidBucket);
-    } else {
-        if (bestAskBucket == 0) {
+        return sums[static_cast<int>((frame->regionMaxTick - bucket) / compression)];
+    };
+    if (side == Side::Bid) {
+        if (bestBidBucket == 0) {
             return 0.0;
         }
-        qint64 targetBucket = ceilBucketTickSigned(targetTick, compression);
-        if (targetBucket < bestAskBucket) {
-            targetBucket = bestAskBucket; // inside-spread clamp
-        }
-        lo = std::min(bestAskBucket, targetBucket);
-        hi = std::max(bestAskBucket, targetBucket);
+        const qint64 targetBucket = floorBucketTickSigned(targetTick, compression);
+        return targetBucket >= bestBidBucket ? frame->notionalAtBid : regionSum(frame->cumBid, targetBucket);
     }
-
-    double total = 0.0;
-    for (auto it = m_bucketBook.constBegin(); it != m_bucketBook.constEnd(); ++it) {
-        const qint64 t = it.key();
-        if (t < lo || t > hi) {
-            continue;
-        }
-        const double p = std::abs(static_cast<double>(t) * m_lastTickSize);
-        if (useBidSide) {
-            if (it->bidQty > 0.0) {
-                total += it->bidQty * p;
-            }
-        } else {
-            if (it->askQty > 0.0) {
-                total += it->askQty * p;
-            }
-        }
+    if (bestAskBucket == 0) {
+        return 0.0;
     }
-    return total;
+    const qint64 targetBucket = ceilBucketTickSigned(targetTick, compression);
+    return targetBucket <= bestAskBucket ? frame->notionalAtAsk : regionSum(frame->cumAsk, targetBucket);
 }
 
 #include "LadderClient.moc"
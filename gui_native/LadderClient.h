@@ -2,69 +2,90 @@
 
 #pragma once
 
+#include "BackendFrameDecoder.h"
+#include "BackendLineSplitter.h"
 #include "DomWidget.h"
+#include "LadderBookModel.h"
 #include "PrintsWidget.h"
 
 #include <QByteArray>
 #include <QObject>
 #include <QProcess>
 #include <QString>
+#include <QStringList>
 #include <QTimer>
 #include <QVector>
 #include <QMap>
 #include <QHash>
+#include <QSet>
 
-struct ParsedLadderRow {
-    qint64 tick = 0;
-    bool hasBid = false;
-    double bid = 0.0;
-    bool hasAsk = false;
-    double ask = 0.0;
-};
-Q_DECLARE_METATYPE(ParsedLadderRow)
+#include <functional>
+#include <memory>
+#include <string>
 
-struct ParsedTradeEvent {
-    double price = 0.0;
-    double qtyBase = 0.0;
-    bool buy = true;
-    qint64 tick = 0; // 0 means "unknown"
+// One "wall_add" / "wall_update" / "wall_remove" event of the backend wall tracker.
+struct ParsedWallEvent {
+    enum class Kind { Add, Update, Remove };
+    Kind kind = Kind::Update;
+    quint64 generation = 0;
+    DomWidget::WallMarker wall;
 };
-Q_DECLARE_METATYPE(ParsedTradeEvent)
+Q_DECLARE_METATYPE(ParsedWallEvent)
 
-struct ParsedLadderFull {
-    double bestBid = 0.0;
-    double bestAsk = 0.0;
+// Reply to a "range" control command: the backend's cached levels in [fromTick, toTick].
+// bookMin/MaxTick bound what the backend holds at all (both 0 when it has no book yet).
+struct ParsedLadderPage {
+    quint64 generation = 0;
+    quint64 id = 0; // id of the "range" command answered
+    qint64 fromTick = 0;
+    qint64 toTick = 0;
+    qint64 bookMinTick = 0;
+    qint64 bookMaxTick = 0;
     double tickSize = 0.0;
-    qint64 windowMinTick = 0;
-    qint64 windowMaxTick = 0;
-    qint64 centerTick = 0;
-    qint64 timestampMs = 0; // 0 means "missing"
     QVector<ParsedLadderRow> rows;
 };
-Q_DECLARE_METATYPE(ParsedLadderFull)
+Q_DECLARE_METATYPE(ParsedLadderPage)
 
-struct ParsedLadderDelta {
-    double bestBid = 0.0;
-    double bestAsk = 0.0;
-    double tickSize = 0.0;
-    qint64 windowMinTick = 0;
-    qint64 windowMaxTick = 0;
-    qint64 centerTick = 0;
-    qint64 timestampMs = 0; // 0 means "missing"
-    QVector<ParsedLadderRow> updates;
-    QVector<qint64> removals;
+// Newest LadderBookFrame of a client's book worker, shared between the two threads.
+struct LadderBookChannel;
+
+// Progress of a backend started with --replay ("replay" messages).
+struct ParsedReplayStatus {
+    QString file;
+    QString speed; // factor, or "max"
+    qint64 positionMs = 0;
+    bool done = false;
+};
+Q_DECLARE_METATYPE(ParsedReplayStatus)
+
+// Interval summary of one backend pipeline stage, as reported in "stats" messages.
+struct BackendStatSummary {
+    bool valid = false;
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double max = 0.0;
 };
-Q_DECLARE_METATYPE(ParsedLadderDelta)
+
+struct BackendStats {
+    qint64 intervalMs = 0;
+    BackendStatSummary framesPerSec;
+    BackendStatSummary bytesPerSec;
+    BackendStatSummary parseUs;
+    BackendStatSummary applyUs;
+    BackendStatSummary emitUs;
+    BackendStatSummary stdoutQueue;
+    BackendStatSummary feedLatencyMs;
+    BackendStatSummary allocsPerSec;
+    BackendStatSummary frameAllocs; // heap allocations while parsing one frame
+    quint64 stdoutCoalesced = 0;
+    quint64 stdoutDropped = 0;
+};
+Q_DECLARE_METATYPE(BackendStats)
 
 class LadderClient : public QObject {
     Q_OBJECT
 
 public:
-    struct BookEntry {
-        double bidQty = 0.0;
-        double askQty = 0.0;
-    };
-
     explicit LadderClient(const QString &backendPath,
                           const QString &symbol,
                           int levels,
@@ -75,21 +96,42 @@ public:
                           const QString &proxy = QString());
     ~LadderClient() override;
 
+    // Attaches to the running backend of another ladder on the same market when there is one
+    // (MarketDataHub); otherwise re-targets or starts this client's own process.
     void restart(const QString &symbol, int levels, const QString &exchange = QString());
+    // Resizes the window of the running backend in place; the current book stays up until the
+    // resized ladder replaces it. Returns the command id, 0 when nothing was sent. A shared
+    // backend is sized for the widest of its views; a view it already covers re-pages its span.
+    quint64 setLevels(int levels);
     void stop();
     bool isRunning() const;
     void setProxy(const QString &proxyType, const QString &proxy);
     void setCompression(int factor);
     int compression() const { return m_tickCompression; }
-    void shiftWindowTicks(qint64 ticks);
-    void resetManualCenter();
+    // Control commands return the id they were sent with (0 when nothing was sent); see
+    // controlAcknowledged(). On a shared feed the live window belongs to every view, so neither
+    // moves it: a view of one scrolls by its own pages (requestRange) alone.
+    quint64 shiftWindowTicks(qint64 ticks);
+    // Pages the levels in [minTick, maxTick] in from the backend cache without moving its live
+    // window; once the reply connects to the buffer, bufferMinTick()/bufferMaxTick() grow to
+    // cover it. 0 when the backend book is known not to reach there (or no book yet).
+    quint64 requestRange(qint64 minTick, qint64 maxTick);
+    quint64 resetManualCenter();
+    // True once the backend has applied command `id` and the book state handed out since
+    // reflects it. Commands sent to an earlier backend process count as acknowledged.
+    bool controlAcknowledged(quint64 id) const { return id <= m_ackedControlId; }
     DomSnapshot snapshotForRange(qint64 minTick, qint64 maxTick) const;
-    qint64 bufferMinTick() const { return m_bufferMinTick; }
-    qint64 bufferMaxTick() const { return m_bufferMaxTick; }
+    // The rows of snapshotForRange() that changed since the previous call, or the whole
+    // snapshot when the grid, the page/live split or too much of the book moved (or `forceFull`).
+    DomSnapshotDelta snapshotDeltaForRange(qint64 minTick, qint64 maxTick, bool forceFull = false);
+    qint64 bufferMinTick() const;
+    qint64 bufferMaxTick() const;
     qint64 centerTick() const { return m_centerTick; }
     double tickSize() const { return m_lastTickSize; }
     bool hasBook() const { return m_hasBook; }
     double cumulativeNotionalForPrice(double price) const;
+    // Age and add/pull/trade history of the tracked wall at `price`, if any.
+    QString wallInfoForPrice(double price) const;
     quint64 bookRevision() const { return m_bookRevision; }
     double bestBid() const { return m_bestBid; }
     double bestAsk() const { return m_bestAsk; }
@@ -107,18 +149,36 @@ public slots:
     void handleParsedLadderFull(const ParsedLadderFull &msg);
     void handleParsedLadderDelta(const ParsedLadderDelta &msg);
     void handleParsedLadderDeltas(const QVector<ParsedLadderDelta> &msgs);
+    void handleParsedStats(const BackendStats &stats);
+    void handleParsedWallEvents(const QVector<ParsedWallEvent> &events);
+    void handleParsedReplayStatus(const ParsedReplayStatus &status);
+    void handleParsedLadderPage(const ParsedLadderPage &page);
+    // Picks up the newest frame the book thread published.
+    void handleBookFrame();
 
 signals:
     void statusMessage(const QString &message);
     void pingUpdated(int milliseconds);
+    void backendStatsUpdated(const BackendStats &stats);
+    void wallMarkersChanged(const QVector<DomWidget::WallMarker> &walls);
+    void replayStatusUpdated(const ParsedReplayStatus &status);
     void bookRangeUpdated(qint64 minTick, qint64 maxTick, qint64 centerTick, double tickSize);
     void bookUpdated(quint64 revision);
-    void bucketTicksUpdated(const QVector<qint64> &bucketTicks);
-    void parseLinesRequested(const QVector<QByteArray> &lines);
+    void parseLinesRequested(const BackendLineBatch &lines);
 
 private:
-    void requestForceFull();
-    bool crossedBookLikely(const QSet<qint64> &dirtyBuckets) const;
+    bool reconfigureRunningBackend(const QString &symbol, int levels, const QString &exchange);
+    void respawnBackend(const QString &symbol, int levels, const QString &exchange);
+    void connectProcess();
+    // Swaps in a standby backend from BackendProcessPool and subscribes it to m_symbol.
+    bool adoptWarmBackend(const QStringList &poolArgs);
+    void applyLevelPolicy(int levels);
+    void resetBookState();
+    QString wireSymbolFor(const QString &symbol) const;
+    void writeControl(const std::string &payload);
+    quint64 nextControlId();
+    void noteControlAck(quint64 id);
+    bool requestForceFull();
     void emitStatus(const QString &msg);
     void armWatchdog();
     void logBackendLine(const QString &line);
@@ -126,11 +186,37 @@ private:
     QString backendLogPath() const;
     QString formatBackendPrefix() const;
     QString formatCrashSummary(int exitCode, QProcess::ExitStatus status) const;
-    void applyFullLadderMessage(const ParsedLadderFull &msg);
-    void applyDeltaLadderMessage(const ParsedLadderDelta &msg);
-    void trimBookToWindow(qint64 minTick, qint64 maxTick, QSet<qint64> *dirtyBuckets = nullptr);
+    // Runs `task` on the book thread against the LadderBookModel of this client's feed, which
+    // changes the book every view reads; each view gets a frame.
+    void postBookTask(std::function<void(LadderBookModel &)> task);
+    // Same, for a task that only changes this client's view (m_bookView); only it gets a frame.
+    void postViewTask(std::function<void(LadderBookModel &)> task);
+    // Makes this client a view of the model `worker` holds (none when null), leaving the one it
+    // read before; the next frame starts a new epoch.
+    void moveBookView(std::shared_ptr<QObject> worker);
+    // The frame of the current book epoch, or nullptr while a reset is on its way.
+    const LadderBookFrame *currentFrame() const;
+    void refreshRangePages();
+    void emitBookRange();
+    bool attachToSharedFeed(const QString &key, const QString &symbol, int levels, const QString &exchange);
+    void leaveSharedFeed();
+    // Carries a generation change of this source over to its followers; `processReplaced` also
+    // resets their books and settles what they sent to the old process.
+    void syncFollowers(bool processReplaced);
+    template <typename Fn>
+    void forEachFollower(Fn &&fn) const;
+    bool sharesFeed() const { return m_feedSource || !m_followers.isEmpty(); }
+    // Process side: sends set_levels when the widest view of the feed no longer matches the
+    // window the process has; returns its id, 0 when nothing was sent.
+    quint64 resizeFeedWindow();
+    int feedLevels() const;
+    int feedCacheLevels() const;
 
-    DomSnapshot buildSnapshot(qint64 minTick, qint64 maxTick) const;
+    // Asks the book thread to re-centre the frame region once `view` nears its edge.
+    void requestView(const LadderBookFrame &frame,
+                     const LadderFrameSlicer::Cursor &view,
+                     qint64 minTick,
+                     qint64 maxTick);
 
     QString m_backendPath;
     QString m_symbol;
@@ -138,9 +224,8 @@ private:
     QString m_exchange;
     QString m_proxyType;
     QString m_proxy;
-    QProcess m_process;
-    QByteArray m_buffer;
-    QVector<QByteArray> m_pendingParseLines;
+    QProcess *m_process = nullptr; // owned; swapped for a warm one from BackendProcessPool
+    BackendLineSplitter m_lineSplitter;
     bool m_parseEmitScheduled = false;
     class PrintsWidget *m_prints;
     QVector<PrintItem> m_printBuffer;
@@ -151,10 +236,22 @@ private:
     qint64 m_lastUpdateMs = 0;
     const int m_watchdogIntervalMs = 15000;
     int m_tickCompression = 1;
-    QMap<qint64, BookEntry> m_book; // ascending ticks
-    QHash<qint64, BookEntry> m_bucketBook; // aggregated per bucket tick
-    qint64 m_bufferMinTick = 0;
+    QHash<quint64, DomWidget::WallMarker> m_walls; // live walls by backend id
+    // The book itself lives on the book thread (LadderBookModel); these mirror the newest frame.
+    qint64 m_bufferMinTick = 0; // live window of the backend ladder
     qint64 m_bufferMaxTick = 0;
+    // Depth paged in with requestRange() outside the live window; one contiguous span
+    // [m_pageMinTick, m_pageMaxTick] (possibly straddling the live window).
+    bool m_hasPages = false;
+    bool m_pagesConnected = false;
+    qint64 m_pageMinTick = 0;
+    qint64 m_pageMaxTick = 0;
+    double m_pageTickSize = 0.0;
+    qint64 m_pagesFetchedMs = 0;
+    quint64 m_lastPageRequestId = 0;
+    bool m_backendBookKnown = false;
+    qint64 m_backendBookMinTick = 0;
+    qint64 m_backendBookMaxTick = 0;
     qint64 m_centerTick = 0;
     double m_lastTickSize = 0.0;
     bool m_hasBook = false;
@@ -163,13 +260,20 @@ private:
     double m_bestAsk = 0.0;
     bool m_stopRequested = false;
     quint64 m_bookRevision = 0;
+    LadderFrameSlicer m_slicer;
 
     QObject *m_parseWorker = nullptr;
-
-    // Last stable top-of-book buckets (computed from aggregated bucket book).
-    // Used to keep DOM sanitization/highlighting consistent during transient out-of-order frames.
-    qint64 m_lastStableBestBidBucketTick = 0;
-    qint64 m_lastStableBestAskBucketTick = 0;
+    // Holds the LadderBookModel of the feed; shared with the source and the other followers.
+    std::shared_ptr<QObject> m_bookWorker;
+    quint64 m_bookView = 0; // this client's view of that model
+    std::shared_ptr<LadderBookChannel> m_bookChannel;
+    std::shared_ptr<const LadderBookFrame> m_frame; // newest frame taken from m_bookChannel
+    quint64 m_bookEpoch = 0;                        // resetBookState() count; see LadderBookFrame::epoch
+    // Last view sent to the book thread, and whether a snapshot had to leave rows out for lack
+    // of a frame covering it.
+    qint64 m_postedViewMinTick = 0;
+    qint64 m_postedViewMaxTick = -1;
+    bool m_viewUncovered = false;
 
     QStringList m_recentStderr;
     int m_lastExitCode = 0;
@@ -177,5 +281,27 @@ private:
     QProcess::ProcessError m_lastProcessError = QProcess::UnknownError;
     QString m_lastProcessErrorString;
     bool m_restartInProgress = false;
-    qint64 m_lastForceFullMs = 0;
+    // Restart or reconfigure in flight and how it went ("cold", "warm" or "reconfigure"); the
+    // first ladder after it logs the time taken.
+    qint64 m_switchStartedMs = 0;
+    QString m_switchPath;
+    // Control command ids come from one sequence shared by every client (never reset, so ids of
+    // a replaced or shared process can't be confused with new ones) and are echoed back as ladder
+    // "ack" / page "id". m_controlSeq is the newest id this client sent.
+    quint64 m_controlSeq = 0;
+    quint64 m_ackedControlId = 0;
+    quint64 m_forceFullId = 0; // newest force_full sent; no other is sent until it is acked
+    // Frames stamped with an older generation belong to a symbol/levels setup we already left.
+    quint64 m_generation = 0;
+    QString m_spawnProxyKey;
+    // Window the process of this client was last started or resized with (feedLevels()).
+    int m_processLevels = 0;
+    int m_processCacheLevels = 0;
+    QSet<quint64> m_pageRequestIds; // range commands of this client not answered yet
+
+    // Shared feed (MarketDataHub). A follower runs no process of its own: its source forwards
+    // every parsed frame to it and writes its control commands to the shared backend.
+    QString m_feedKey; // key registered as source or attached to; empty when not sharing
+    LadderClient *m_feedSource = nullptr;
+    QVector<LadderClient *> m_followers;
 };
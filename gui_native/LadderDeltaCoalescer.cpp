@@ -0,0 +1,122 @@
+#include "LadderDeltaCoalescer.h"
+
+#include <algorithm>
+#include <utility>
+
+void LadderDeltaCoalescer::add(ParsedLadderDelta &&delta)
+{
+    if (m_open && delta.generation != m_net.generation) {
+        close();
+    }
+    if (!m_open) {
+        m_net = ParsedLadderDelta();
+        m_net.generation = delta.generation;
+        m_open = true;
+    }
+
+    // Same acceptance rules as LadderBookModel::applyDelta.
+    if (delta.bestBid != 0.0) {
+        m_net.bestBid = delta.bestBid;
+    }
+    if (delta.bestAsk != 0.0) {
+        m_net.bestAsk = delta.bestAsk;
+    }
+    if (delta.tickSize > 0.0) {
+        m_net.tickSize = delta.tickSize;
+    }
+    const bool hasWindow = (delta.windowMinTick != 0 || delta.windowMaxTick != 0);
+    if (hasWindow && delta.windowMinTick <= delta.windowMaxTick) {
+        m_net.windowMinTick = delta.windowMinTick;
+        m_net.windowMaxTick = delta.windowMaxTick;
+    }
+    if (delta.centerTick != 0) {
+        m_net.centerTick = delta.centerTick;
+    }
+    if (delta.timestampMs > 0) {
+        m_net.timestampMs = delta.timestampMs;
+    }
+    m_net.ack = std::max(m_net.ack, delta.ack);
+
+    // Within one frame updates are applied before removals; keep that order here.
+    for (const ParsedLadderRow &row : std::as_const(delta.updates)) {
+        if (row.tick == 0 || (!row.hasBid && !row.hasAsk)) {
+            continue;
+        }
+        Slot &slot = m_slots[row.tick];
+        if (slot.update >= 0) {
+            ParsedLadderRow &net = m_net.updates[slot.update];
+            if (row.hasBid) {
+                net.hasBid = true;
+                net.bid = row.bid;
+            }
+            if (row.hasAsk) {
+                net.hasAsk = true;
+                net.ask = row.ask;
+            }
+            continue;
+        }
+        ParsedLadderRow net = row;
+        if (slot.removal >= 0) {
+            m_net.removals[slot.removal] = 0;
+            slot.removal = -1;
+            net.hasBid = true;
+            net.bid = row.hasBid ? row.bid : 0.0;
+            net.hasAsk = true;
+            net.ask = row.hasAsk ? row.ask : 0.0;
+        }
+        slot.update = m_net.updates.size();
+        m_net.updates.push_back(net);
+    }
+    for (qint64 tick : std::as_const(delta.removals)) {
+        if (tick == 0) {
+            continue;
+        }
+        Slot &slot = m_slots[tick];
+        if (slot.update >= 0) {
+            m_net.updates[slot.update].tick = 0;
+            slot.update = -1;
+        }
+        if (slot.removal < 0) {
+            slot.removal = m_net.removals.size();
+            m_net.removals.push_back(tick);
+        }
+    }
+}
+
+void LadderDeltaCoalescer::supersede(quint64 generation)
+{
+    m_done.erase(std::remove_if(m_done.begin(),
+                                m_done.end(),
+                                [generation](const ParsedLadderDelta &d) { return d.generation <= generation; }),
+                 m_done.end());
+    if (m_open && m_net.generation <= generation) {
+        m_open = false;
+        m_net = ParsedLadderDelta();
+        m_slots.clear();
+    }
+}
+
+QVector<ParsedLadderDelta> LadderDeltaCoalescer::take()
+{
+    if (m_open) {
+        close();
+    }
+    QVector<ParsedLadderDelta> out;
+    out.swap(m_done);
+    return out;
+}
+
+void LadderDeltaCoalescer::close()
+{
+    // Tick 0 marks rows cancelled by a later row of the same tick.
+    m_net.updates.erase(std::remove_if(m_net.updates.begin(),
+                                       m_net.updates.end(),
+                                       [](const ParsedLadderRow &r) { return r.tick == 0; }),
+                        m_net.updates.end());
+    m_net.removals.erase(std::remove(m_net.removals.begin(), m_net.removals.end(), qint64(0)),
+                         m_net.removals.end());
+    m_done.push_back(std::move(m_net));
+    m_net = ParsedLadderDelta();
+    m_open = false;
+    m_slots.clear();
+}
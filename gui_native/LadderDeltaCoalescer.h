@@ -0,0 +1,39 @@
+// Folds the ladder_delta frames of one parse batch into a net delta per generation.
+
+#pragma once
+
+#include "BackendFrameDecoder.h"
+
+#include <QHash>
+#include <QVector>
+
+// The GUI thread applies each queued delta separately (book, bucket grids, dirty sets, range
+// signals), so a backend burst of N frames used to cost N applies. Folding them here leaves
+// one apply per generation per batch:
+//  - rows are last-write-wins per tick and per side, as LadderBook::update would leave them;
+//  - a removal drops earlier updates of its tick, and an update after a removal is sent as a
+//    full row (missing side zero) so it still clears what the removal would have;
+//  - header fields keep the last value the apply would have taken (non-zero BBO / center,
+//    positive tick size, the last valid window, the newest timestamp) and the highest ack.
+// Frames of different generations are never merged: the GUI drops stale ones per frame.
+class LadderDeltaCoalescer {
+public:
+    void add(ParsedLadderDelta &&delta);
+    // A full ladder replaces the book, so pending deltas no newer than it are obsolete.
+    void supersede(quint64 generation);
+    // Net deltas in arrival order; the coalescer is left empty for the next batch.
+    QVector<ParsedLadderDelta> take();
+
+private:
+    struct Slot {
+        int update = -1;  // index into m_net.updates
+        int removal = -1; // index into m_net.removals
+    };
+
+    void close();
+
+    QVector<ParsedLadderDelta> m_done;
+    ParsedLadderDelta m_net;
+    bool m_open = false;
+    QHash<qint64, Slot> m_slots; // ticks already present in m_net
+};
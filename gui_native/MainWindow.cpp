@@ -823,6 +823,13 @@ constexpr double kDepthExtendThreshold = 0.18;
 constexpr int kGuiLevelsPerSide = 3000;
 constexpr int kBackgroundMarginLevels = 1500;
 constexpr double kDisplayPrefetchGuardRatio = 0.35;
+// Scroll-ahead: keep as much depth buffered in the scroll direction as the viewport covers in
+// this long at its current speed, between the screen bounds below.
+constexpr double kScrollAheadHorizonMs = 600.0;
+constexpr qint64 kScrollAheadMinScreens = 2;
+constexpr qint64 kScrollAheadMaxScreens = 12;
+// Scroll events further apart than this start a new gesture (velocity back to zero).
+constexpr qint64 kScrollVelocityResetMs = 250;
 
 qint64 depthChunkTicks(int tickCompression,
                        const QScrollBar *scrollBar,
@@ -2598,18 +2605,34 @@ void MainWindow::updatePerfOverlay(DomColumn &col)
         }
     };
 
-    const QString pingText =
+    QString pingText =
         (col.lastPingMs >= 0) ? QStringLiteral("Ping: %1 ms").arg(col.lastPingMs)
                               : QStringLiteral("Ping: -");
+    if (col.backendFeedP99Ms >= 0.0) {
+        pingText += QStringLiteral(" | feed p99 %1 ms").arg(col.backendFeedP99Ms, 0, 'f', 0);
+    }
     const QString ordersText =
         (col.lastOrderPingMs >= 0) ? QStringLiteral("Orders: %1 ms").arg(col.lastOrderPingMs)
                                    : QStringLiteral("Orders: -");
     const QString fpsText =
         (m_lastUiFps > 0.0) ? QStringLiteral("FPS: %1").arg(m_lastUiFps, 0, 'f', 1)
                             : QStringLiteral("FPS: -");
-    const QString domText =
+    QString domText =
         (col.lastFpsHz > 0.0) ? QStringLiteral("DOM Hz: %1").arg(col.lastFpsHz, 0, 'f', 1)
                               : QStringLiteral("DOM Hz: -");
+    if (col.backendFramesPerSec >= 0.0) {
+        domText += QStringLiteral(" | in %1/s").arg(col.backendFramesPerSec, 0, 'f', 0);
+    }
+    if (col.backendParseP99Us >= 0.0 || col.backendApplyP99Us >= 0.0 || col.backendEmitP99Us >= 0.0) {
+        auto us = [](double v) {
+            return v >= 0.0 ? QString::number(v, 'f', 0) : QStringLiteral("-");
+        };
+        domText += QStringLiteral(" | p99 us %1/%2/%3")
+                       .arg(us(col.backendParseP99Us), us(col.backendApplyP99Us), us(col.backendEmitP99Us));
+    }
+    if (col.backendFrameAllocsP99 >= 0.0) {
+        domText += QStringLiteral(" | allocs/frame %1").arg(col.backendFrameAllocsP99, 0, 'f', 0);
+    }
 
     setText(col.perfPingLabel, pingText);
     setText(col.perfOrderPingLabel, ordersText);
@@ -3893,6 +3916,21 @@ MainWindow::DomColumn MainWindow::createDomColumn(const QString &symbol,
     hLayout->addWidget(readOnly);
     result.readOnlyLabel = readOnly;
 
+    auto *replay = new PillLabel(header);
+    replay->setObjectName(QStringLiteral("ReplayBadge"));
+    replay->setFixedSize(16, 16);
+    replay->setAlignment(Qt::AlignCenter);
+    replay->setText(QStringLiteral("R"));
+    {
+        QFont f = replay->font();
+        f.setWeight(QFont::Black);
+        f.setPixelSize(10);
+        replay->setFont(f);
+    }
+    replay->setVisible(false);
+    hLayout->addWidget(replay);
+    result.replayLabel = replay;
+
     auto *compressionButton = new PillToolButton(header);
     compressionButton->setObjectName(QStringLiteral("DomHeaderCompressionButton"));
     compressionButton->setAutoRaise(true);
@@ -4581,6 +4619,28 @@ MainWindow::DomColumn MainWindow::createDomColumn(const QString &symbol,
             this,
             &MainWindow::handleLadderStatusMessage);
     connect(client, &LadderClient::pingUpdated, this, &MainWindow::handleLadderPingUpdated);
+    connect(client, &LadderClient::backendStatsUpdated, this, &MainWindow::handleLadderBackendStats);
+    connect(client, &LadderClient::wallMarkersChanged, dom, &DomWidget::setWallMarkers);
+    connect(client,
+            &LadderClient::replayStatusUpdated,
+            this,
+            [this, columnGuard](const ParsedReplayStatus &status) {
+                if (!columnGuard) {
+                    return;
+                }
+                WorkspaceTab *tab = nullptr;
+                DomColumn *colPtr = nullptr;
+                int idx = -1;
+                if (!locateColumn(columnGuard.data(), tab, colPtr, idx) || !colPtr || !colPtr->replayLabel) {
+                    return;
+                }
+                const QString position =
+                    QDateTime::fromMSecsSinceEpoch(status.positionMs).toString(QStringLiteral("yyyy-MM-dd HH:mm:ss"));
+                colPtr->replayLabel->setToolTip(
+                    tr("Replay %1 (%2)%3\n%4")
+                        .arg(status.speed, position, status.done ? tr(", finished") : QString(), status.file));
+                colPtr->replayLabel->setVisible(true);
+            });
     connect(client,
             &LadderClient::bookRangeUpdated,
             this,
@@ -4639,11 +4699,6 @@ MainWindow::DomColumn MainWindow::createDomColumn(const QString &symbol,
                     flushPendingColumnViewport(*col2);
                 });
             });
-    connect(client,
-            &LadderClient::bucketTicksUpdated,
-            dom,
-            &DomWidget::notifyBucketTicksUpdated);
-
     connect(dom,
             &DomWidget::rowClicked,
             this,
@@ -4740,6 +4795,10 @@ MainWindow::DomColumn MainWindow::createDomColumn(const QString &symbol,
                 } else if (notional > 0.0) {
                     parts << formatValueShort(notional);
                 }
+                const QString wall = client ? client->wallInfoForPrice(price) : QString();
+                if (!wall.isEmpty()) {
+                    parts << wall;
+                }
                 prints->setHoverInfo(row, price, parts.join(QStringLiteral(" | ")));
             });
     connect(dom, &DomWidget::infoAreaHeightChanged, prints, &PrintsWidget::setDomInfoAreaHeight);
@@ -5250,6 +5309,30 @@ void MainWindow::handleLadderPingUpdated(int ms)
     }
 }
 
+void MainWindow::handleLadderBackendStats(const BackendStats &stats)
+{
+    auto *client = qobject_cast<LadderClient *>(sender());
+    if (!client) {
+        return;
+    }
+    auto p99 = [](const BackendStatSummary &s) { return s.valid ? s.p99 : -1.0; };
+    for (auto &tab : m_tabs) {
+        for (auto &col : tab.columnsData) {
+            if (col.client != client) {
+                continue;
+            }
+            col.backendFeedP99Ms = p99(stats.feedLatencyMs);
+            col.backendFramesPerSec = stats.framesPerSec.valid ? stats.framesPerSec.p50 : -1.0;
+            col.backendParseP99Us = p99(stats.parseUs);
+            col.backendApplyP99Us = p99(stats.applyUs);
+            col.backendEmitP99Us = p99(stats.emitUs);
+            col.backendFrameAllocsP99 = p99(stats.frameAllocs);
+            updatePerfOverlay(col);
+            return;
+        }
+    }
+}
+
 void MainWindow::handleDomRowClicked(Qt::MouseButton button,
                                      int row,
                                      double price,
@@ -6909,10 +6992,20 @@ void MainWindow::applyCompressionForColumn(QWidget *columnContainer, int compres
         col->compressionButton->setText(QStringLiteral("%1x").arg(clamped));
     }
     if (col->client) {
+        // A live client re-buckets the book it holds at once; only the backend window is
+        // resized, and the view is laid out again when that answer arrives.
+        const bool live = col->client->isRunning() && col->client->hasBook();
+        if (live) {
+            resetColumnViewState(*col);
+        }
         col->client->setCompression(clamped);
         col->client->resetManualCenter();
         col->backendManualPinned = false;
-        restartColumnClient(*col);
+        if (live) {
+            col->levelsRequestId = col->client->setLevels(effectiveLevelsForColumn(*col));
+        } else {
+            restartColumnClient(*col);
+        }
     }
     saveUserSettings();
     statusBar()->showMessage(tr("Compression set to %1x").arg(clamped), 1200);
@@ -12409,14 +12502,20 @@ bool MainWindow::pullSnapshotForColumn(DomColumn &col, qint64 bottomTick, qint64
     if (!col.client || !col.dom) {
         return false;
     }
-    DomSnapshot snap = col.client->snapshotForRange(bottomTick, topTick);
+    // Only the rows that changed since the last pull, unless the grid or window jumped.
+    DomSnapshotDelta delta = col.client->snapshotDeltaForRange(bottomTick, topTick);
+    // Always push the snapshot to the DOM widget, even if empty.
+    // Otherwise the GPU DOM can keep stale rows visible until user scroll triggers a rebuild.
+    if (!col.dom->updateSnapshot(delta)) {
+        // The widget doesn't hold what the delta continues (e.g. it was just rebuilt).
+        delta = col.client->snapshotDeltaForRange(bottomTick, topTick, true);
+        col.dom->updateSnapshot(delta);
+    }
+    const DomSnapshot &snap = delta.snapshot;
     if (snap.tickSize > 0.0) {
         col.bufferTickSize = snap.tickSize;
     }
-    // Always push the snapshot to the DOM widget, even if empty.
-    // Otherwise the GPU DOM can keep stale rows visible until user scroll triggers a rebuild.
-    col.dom->updateSnapshot(snap);
-    const bool hasLevels = !snap.levels.isEmpty();
+    const bool hasLevels = delta.rowCount > 0;
     // We do not use QScrollArea's native pixel scroll (we render a fixed window in ticks).
     // If it ever drifts (e.g. due to geometry changes), it can create a persistent 1-row offset.
     if (col.scrollArea) {
@@ -12456,15 +12555,17 @@ bool MainWindow::pullSnapshotForColumn(DomColumn &col, qint64 bottomTick, qint64
             snap.minTick != col.lastPrintsBottomTick || snap.maxTick != col.lastPrintsTopTick
             || rowHeight != col.lastPrintsRowHeight || compression != col.lastPrintsCompression
             || std::abs(tickForPrints - col.lastPrintsTick) > 1e-12
-            || snap.levels.size() != col.lastPrintsRowCount;
+            || delta.rowCount != col.lastPrintsRowCount;
         if (mappingChanged) {
+            // Rows are the snapshot's bucket grid, top-down; a delta carries no full level list.
             QVector<double> prices;
-            prices.reserve(snap.levels.size());
+            prices.reserve(delta.rowCount);
             QVector<qint64> rowTicks;
-            rowTicks.reserve(snap.levels.size());
-            for (const auto &lvl : snap.levels) {
-                prices.push_back(lvl.price);
-                rowTicks.push_back(lvl.tick);
+            rowTicks.reserve(delta.rowCount);
+            for (int i = 0; i < delta.rowCount; ++i) {
+                const qint64 rowTick = snap.maxTick - static_cast<qint64>(i) * snap.compression;
+                prices.push_back(static_cast<double>(rowTick) * snap.tickSize);
+                rowTicks.push_back(rowTick);
             }
             if (col.clusters) {
                 const int infoH = col.dom ? col.dom->infoAreaHeight() : 0;
@@ -12483,7 +12584,7 @@ bool MainWindow::pullSnapshotForColumn(DomColumn &col, qint64 bottomTick, qint64
             col.lastPrintsRowHeight = rowHeight;
             col.lastPrintsCompression = compression;
             col.lastPrintsTick = tickForPrints;
-            col.lastPrintsRowCount = snap.levels.size();
+            col.lastPrintsRowCount = delta.rowCount;
         }
 
         // Live-update the hover "ray" text even if the mouse doesn't move.
@@ -12890,18 +12991,93 @@ void MainWindow::maybePrefetchBuffer(DomColumn &col, bool upwards)
     if (upwards) {
         const qint64 headroom = col.bufferMaxTick - col.displayMaxTick;
         if (headroom <= guard && !col.pendingExtendUp) {
-            col.client->shiftWindowTicks(+chunk);
+            extendColumnBuffer(col, true, chunk);
             col.pendingExtendUp = true;
         }
         return;
     }
     const qint64 headroom = col.displayMinTick - col.bufferMinTick;
     if (headroom <= guard && !col.pendingExtendDown) {
-        col.client->shiftWindowTicks(-chunk);
+        extendColumnBuffer(col, false, chunk);
+        col.pendingExtendDown = true;
+    }
+}
+
+// Tracks how fast the viewport moves and, while it does, pages in enough depth past the buffer
+// edge it heads to that wheel or drag scrolling keeps landing on rows the backend already sent.
+void MainWindow::prefetchScrollAhead(DomColumn &col)
+{
+    if (!col.client || !col.hasBuffer || !col.pendingViewportUpdate) {
+        return;
+    }
+    const qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+    const qint64 topTick = col.pendingViewportTop;
+    const qint64 bottomTick = col.pendingViewportBottom;
+    const qint64 elapsedMs = nowMs - col.scrollSampleMs;
+    if (col.scrollSampleMs == 0 || elapsedMs > kScrollVelocityResetMs) {
+        col.scrollTicksPerMs = 0.0;
+    } else if (elapsedMs > 0) {
+        const double instant =
+            static_cast<double>(topTick - col.scrollSampleTopTick) / static_cast<double>(elapsedMs);
+        // Smooth within a gesture; a reversal takes effect at once.
+        col.scrollTicksPerMs = (instant * col.scrollTicksPerMs > 0.0)
+                                   ? 0.5 * (instant + col.scrollTicksPerMs)
+                                   : instant;
+    }
+    col.scrollSampleMs = nowMs;
+    col.scrollSampleTopTick = topTick;
+    if (col.scrollTicksPerMs == 0.0) {
+        return;
+    }
+
+    const bool upwards = col.scrollTicksPerMs > 0.0;
+    const qint64 screenTicks = std::max<qint64>(1, topTick - bottomTick + 1);
+    const double aheadTicks = std::abs(col.scrollTicksPerMs) * kScrollAheadHorizonMs;
+    const qint64 screens = std::clamp(static_cast<qint64>(std::ceil(aheadTicks / screenTicks)),
+                                      kScrollAheadMinScreens,
+                                      kScrollAheadMaxScreens);
+    const qint64 margin = screens * screenTicks;
+    const qint64 headroom = upwards ? col.bufferMaxTick - topTick : bottomTick - col.bufferMinTick;
+    if (headroom >= margin || (upwards ? col.pendingExtendUp : col.pendingExtendDown)) {
+        return;
+    }
+    // Ask for twice the margin so a steady scroll does not re-request on every event.
+    const qint64 chunk = depthChunkTicks(col.tickCompression,
+                                        col.scrollBar,
+                                        col.hasBuffer,
+                                        col.bufferMinTick,
+                                        col.bufferMaxTick);
+    const qint64 maxTicks = maxQueuedShiftTicks(col.tickCompression,
+                                               col.scrollBar,
+                                               col.hasBuffer,
+                                               col.bufferMinTick,
+                                               col.bufferMaxTick);
+    const qint64 ticks = std::clamp(2 * margin - headroom, chunk, maxTicks);
+    extendColumnBuffer(col, upwards, ticks);
+    if (upwards) {
+        col.pendingExtendUp = true;
+    } else {
         col.pendingExtendDown = true;
     }
 }
 
+// Pages the next `ticks` of depth beyond the buffer edge in from the backend cache, leaving the
+// live window where it is; moves the live window only when the backend book ends before there.
+void MainWindow::extendColumnBuffer(DomColumn &col, bool upwards, qint64 ticks)
+{
+    if (!col.client || ticks <= 0) {
+        return;
+    }
+    quint64 id = upwards ? col.client->requestRange(col.bufferMaxTick + 1, col.bufferMaxTick + ticks)
+                         : col.client->requestRange(col.bufferMinTick - ticks, col.bufferMinTick - 1);
+    if (id == 0) {
+        id = col.client->shiftWindowTicks(upwards ? ticks : -ticks);
+    }
+    if (id != 0) {
+        col.extendRequestId = id;
+    }
+}
+
 void MainWindow::queueColumnDepthShift(DomColumn &col, bool upwards, double multiplier)
 {
     if (!col.client) {
@@ -12923,7 +13099,7 @@ void MainWindow::queueColumnDepthShift(DomColumn &col, bool upwards, double mult
                                                 col.bufferMaxTick);
     if (upwards) {
         if (!col.pendingExtendUp) {
-            col.client->shiftWindowTicks(+shift);
+            extendColumnBuffer(col, true, shift);
             col.pendingExtendUp = true;
         } else {
             col.extendQueuedShiftUp =
@@ -12934,7 +13110,7 @@ void MainWindow::queueColumnDepthShift(DomColumn &col, bool upwards, double mult
         return;
     }
     if (!col.pendingExtendDown) {
-        col.client->shiftWindowTicks(-shift);
+        extendColumnBuffer(col, false, shift);
         col.pendingExtendDown = true;
     } else {
         col.extendQueuedShiftDown =
@@ -13137,8 +13313,16 @@ void MainWindow::handleColumnBufferRange(QWidget *container,
     const qint64 prevDisplayMin = col->displayMinTick;
     const qint64 prevDisplayMax = col->displayMaxTick;
     const int prevScrollValue = col->scrollBar ? col->scrollBar->value() : 0;
-    const bool wasPendingUp = col->pendingExtendUp;
-    const bool wasPendingDown = col->pendingExtendDown;
+    // Live frames move the range too; only the one acknowledging the newest extension
+    // answers it.
+    const bool extendAnswered = !col->client || col->client->controlAcknowledged(col->extendRequestId);
+    const bool wasPendingUp = col->pendingExtendUp && extendAnswered;
+    const bool wasPendingDown = col->pendingExtendDown && extendAnswered;
+    const bool levelsAnswered =
+        col->levelsRequestId != 0 && (!col->client || col->client->controlAcknowledged(col->levelsRequestId));
+    if (levelsAnswered) {
+        col->levelsRequestId = 0;
+    }
 
     bool preserveViewport = false;
     qint64 shiftDeltaTicks = 0;
@@ -13166,7 +13350,7 @@ void MainWindow::handleColumnBufferRange(QWidget *container,
     const qint64 targetSpan = std::max<qint64>(1, targetDisplaySpanTicks(*col));
     const qint64 span = std::min(bufferSpan, targetSpan);
     if (span > 0) {
-        if (firstBuffer || col->displayMaxTick <= col->displayMinTick) {
+        if (firstBuffer || levelsAnswered || col->displayMaxTick <= col->displayMinTick) {
             qint64 center = std::clamp(centerTick, col->bufferMinTick, col->bufferMaxTick);
             qint64 half = span / 2;
             qint64 minDisplay = center - half;
@@ -13201,8 +13385,10 @@ void MainWindow::handleColumnBufferRange(QWidget *container,
         col->displayMaxTick = col->bufferMaxTick;
     }
     col->hasBuffer = true;
-    col->pendingExtendUp = false;
-    col->pendingExtendDown = false;
+    if (extendAnswered) {
+        col->pendingExtendUp = false;
+        col->pendingExtendDown = false;
+    }
     ++col->bufferRevision;
     updateColumnScrollRange(*col);
     if (preserveViewport && col->scrollBar)
@@ -13215,7 +13401,7 @@ void MainWindow::handleColumnBufferRange(QWidget *container,
         col->scrollValueValid = false;
         col->lastScrollBarValue = clamped;
     }
-    if (firstBuffer || col->pendingAutoCenter) {
+    if (firstBuffer || levelsAnswered || col->pendingAutoCenter) {
         col->pendingAutoCenter = false;
         const qint64 tick =
             col->pendingAutoCenterTickValid ? col->pendingAutoCenterTick : centerTick;
@@ -13226,16 +13412,16 @@ void MainWindow::handleColumnBufferRange(QWidget *container,
         updateColumnViewport(*col, false);
     }
 
-    if (col->extendQueuedShiftUp > 0) {
+    if (col->extendQueuedShiftUp > 0 && !col->pendingExtendUp) {
         const qint64 queued = col->extendQueuedShiftUp;
         col->extendQueuedShiftUp = 0;
-        col->client->shiftWindowTicks(+queued);
+        extendColumnBuffer(*col, true, queued);
         col->pendingExtendUp = true;
     }
-    if (col->extendQueuedShiftDown > 0) {
+    if (col->extendQueuedShiftDown > 0 && !col->pendingExtendDown) {
         const qint64 queued = col->extendQueuedShiftDown;
         col->extendQueuedShiftDown = 0;
-        col->client->shiftWindowTicks(-queued);
+        extendColumnBuffer(*col, false, queued);
         col->pendingExtendDown = true;
     }
 }
@@ -13313,6 +13499,7 @@ void MainWindow::handleDomScroll(QWidget *columnContainer, int value)
     if (!col->client || !col->scrollBar) {
         return;
     }
+    prefetchScrollAhead(*col);
     const int minValue = col->scrollBar->minimum();
     const int maxValue = col->scrollBar->maximum();
     const int current = col->scrollBar->value();
@@ -13433,6 +13620,12 @@ void MainWindow::restartColumnClient(DomColumn &col)
         col.client->setProxy(proxyType, proxyRaw);
     }
     const int effectiveLevels = effectiveLevelsForColumn(col);
+    resetColumnViewState(col);
+    col.client->restart(col.symbol, effectiveLevels, exch);
+}
+
+void MainWindow::resetColumnViewState(DomColumn &col)
+{
     col.hasBuffer = false;
     col.bufferMinTick = 0;
     col.bufferMaxTick = 0;
@@ -13442,6 +13635,8 @@ void MainWindow::restartColumnClient(DomColumn &col)
     col.userScrolling = false;
     col.pendingExtendUp = false;
     col.pendingExtendDown = false;
+    col.extendRequestId = 0;
+    col.levelsRequestId = 0;
     col.pendingViewportUpdate = false;
     col.pendingViewportBottom = 0;
     col.pendingViewportTop = 0;
@@ -13454,7 +13649,9 @@ void MainWindow::restartColumnClient(DomColumn &col)
     col.bufferRevision = 0;
     col.scrollValueValid = false;
     col.lastScrollBarValue = 0;
-    col.client->restart(col.symbol, effectiveLevels, exch);
+    col.scrollTicksPerMs = 0.0;
+    col.scrollSampleMs = 0;
+    col.scrollSampleTopTick = 0;
 }
 
 QVector<VolumeHighlightRule> MainWindow::defaultVolumeHighlightRules() const
@@ -16238,6 +16435,9 @@ void MainWindow::applyHeaderAccent(DomColumn &col)
     if (auto *pill = dynamic_cast<PillToolButton *>(col.compressionButton)) {
         pill->setPillColors(badgeBg, badgeBorder, fg);
     }
+    if (auto *pill = dynamic_cast<PillLabel *>(col.replayLabel)) {
+        pill->setPillColors(QColor("#3d7bd9"), QColor("#2f62b0"), QColor("#ffffff"));
+    }
 }
 
 #include "MainWindow.moc"
@@ -45,6 +45,7 @@ class QScrollBar;
 class QDialog;
 class DomWidget;
 class LadderClient;
+struct BackendStats;
 class PrintsWidget;
 class PluginsWindow;
 class ConnectionStore;
@@ -97,6 +98,7 @@ private slots:
     void handleNewLadderRequested();
     void handleLadderStatusMessage(const QString &msg);
     void handleLadderPingUpdated(int ms);
+    void handleLadderBackendStats(const BackendStats &stats);
     void handleDomRowClicked(Qt::MouseButton button,
                              int row,
                              double price,
@@ -182,6 +184,7 @@ private:
         QLabel *venueIconLabel = nullptr;
         QLabel *marketTypeLabel = nullptr;
         QLabel *readOnlyLabel = nullptr;
+        QLabel *replayLabel = nullptr;
         QLabel *tickerLabel = nullptr;
         QLabel *statusLabel = nullptr;
         bool isFloating = false;
@@ -238,6 +241,13 @@ private:
         QLabel *perfDomHzLabel = nullptr;
         qint64 lastPingMs = -1;
         qint64 lastOrderPingMs = -1;
+        // Latest backend self-telemetry (p99 over the backend stats interval); negative when unknown.
+        double backendFeedP99Ms = -1.0;
+        double backendFramesPerSec = -1.0;
+        double backendParseP99Us = -1.0;
+        double backendApplyP99Us = -1.0;
+        double backendEmitP99Us = -1.0;
+        double backendFrameAllocsP99 = -1.0;
         ChatWindow *chatWindow = nullptr;
         QString accountName;
         QColor accountColor;
@@ -252,6 +262,8 @@ private:
         bool userScrolling = false;
         bool pendingExtendUp = false;
         bool pendingExtendDown = false;
+        quint64 extendRequestId = 0; // newest extension sent (LadderClient control id)
+        quint64 levelsRequestId = 0; // window resize sent by a compression change
         bool pendingAutoCenter = false;
         bool pendingAutoCenterTickValid = false;
         qint64 pendingAutoCenterTick = 0;
@@ -279,6 +291,11 @@ private:
         qint64 extendQueuedShiftDown = 0;
         int lastScrollBarValue = 0;
         bool scrollValueValid = false;
+        // Smoothed viewport velocity (ticks/ms, positive = towards higher prices) driving
+        // prefetchScrollAhead(); sampled from the viewport top on every scroll.
+        double scrollTicksPerMs = 0.0;
+        qint64 scrollSampleMs = 0;
+        qint64 scrollSampleTopTick = 0;
         bool backendManualPinned = false;
         bool hoverRayActive = false;
         double hoverRayPrice = 0.0;
@@ -414,10 +431,13 @@ private:
     qint64 smoothSlideStepTicks(const DomColumn &col) const;
     bool slideDisplayWindow(DomColumn &col, int direction, qint64 overrideStep = 0);
     void maybePrefetchBuffer(DomColumn &col, bool upwards);
+    void prefetchScrollAhead(DomColumn &col);
+    void extendColumnBuffer(DomColumn &col, bool upwards, qint64 ticks);
     void queueColumnDepthShift(DomColumn &col, bool upwards, double multiplier);
     void recenterDisplayWindow(DomColumn &col, qint64 centerTick);
     void handleDomScroll(QWidget *columnContainer, int value);
     void restartColumnClient(DomColumn &col);
+    void resetColumnViewState(DomColumn &col);
     void updateColumnViewport(DomColumn &col, bool forceCenter = false);
     void flushPendingColumnViewport(DomColumn &col);
     void updateColumnScrollRange(DomColumn &col);
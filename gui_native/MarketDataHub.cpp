@@ -0,0 +1,49 @@
+#include "MarketDataHub.h"
+
+#include <QCoreApplication>
+#include <QtGlobal>
+
+MarketDataHub &MarketDataHub::instance()
+{
+    static MarketDataHub hub;
+    return hub;
+}
+
+MarketDataHub::MarketDataHub()
+{
+    if (QCoreApplication *app = QCoreApplication::instance()) {
+        QObject::connect(app, &QCoreApplication::aboutToQuit, [this]() { m_shuttingDown = true; });
+    }
+}
+
+QString MarketDataHub::keyFor(const QString &backendPath,
+                              const QString &exchange,
+                              const QString &symbol,
+                              const QString &proxyType,
+                              const QString &proxy)
+{
+    static const bool enabled =
+        !qEnvironmentVariableIsSet("FUSION_SHARED_FEEDS") || qEnvironmentVariableIntValue("FUSION_SHARED_FEEDS") != 0;
+    if (!enabled || symbol.isEmpty()) {
+        return QString();
+    }
+    const QChar sep = QLatin1Char('|');
+    return backendPath + sep + exchange.toLower() + sep + symbol.toUpper() + sep + proxyType.trimmed().toLower()
+           + sep + proxy.trimmed();
+}
+
+void MarketDataHub::setSource(const QString &key, LadderClient *client)
+{
+    if (key.isEmpty() || !client) {
+        return;
+    }
+    m_sources.insert(key, client);
+}
+
+void MarketDataHub::release(const QString &key, const LadderClient *client)
+{
+    const auto it = m_sources.constFind(key);
+    if (it != m_sources.constEnd() && it.value() == client) {
+        m_sources.erase(it);
+    }
+}
@@ -0,0 +1,42 @@
+// Registry of the backend feeds LadderClient instances are streaming, one per market.
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+
+class LadderClient;
+
+// Ladders on the same (backend, exchange, symbol, proxy) share one backend process: the first
+// client to start registers here as the source, later ones attach to it as followers and are
+// fed the frames it parses (see LadderClient::restart). They also read the book model the source
+// keeps on the book thread, each as a view with its own compression, view window and pages; the
+// source applies the messages to it once for all of them. The source holds the references to
+// its followers, and when it leaves, one of them starts a process and takes the others over.
+//
+// Set FUSION_SHARED_FEEDS=0 to give every ladder its own backend again.
+class MarketDataHub {
+public:
+    static MarketDataHub &instance();
+
+    // Empty when sharing is disabled.
+    static QString keyFor(const QString &backendPath,
+                          const QString &exchange,
+                          const QString &symbol,
+                          const QString &proxyType,
+                          const QString &proxy);
+
+    LadderClient *source(const QString &key) const { return m_sources.value(key, nullptr); }
+    void setSource(const QString &key, LadderClient *client);
+    // Forgets `client` as the source of `key`; a no-op if another client took it over.
+    void release(const QString &key, const LadderClient *client);
+    // Set once the application is about to quit: the ladders are torn down one by one then, and
+    // none of them should take over the feed of another.
+    bool shuttingDown() const { return m_shuttingDown; }
+
+private:
+    MarketDataHub();
+
+    QHash<QString, LadderClient *> m_sources;
+    bool m_shuttingDown = false;
+};
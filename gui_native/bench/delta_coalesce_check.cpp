@@ -0,0 +1,319 @@
+// LadderDeltaCoalescer against applying every ladder_delta in turn.
+//
+//   delta_coalesce_check [--batches N] [--seed S]
+//
+// Builds N (default 20000) random parse batches of 1..12 ladder_delta frames over a small tick
+// range, with generation bumps, repeated ticks, per-side updates, removals, missing header
+// fields and now and then a full ladder in between. Each batch is applied to a reference book
+// frame by frame, the way LadderBookModel::applyDelta takes them, and separately as
+// BackendParseWorker hands it on: the last full ladder, then the coalesced net deltas. The
+// books and header state must match, and no two net deltas in a row may share a generation.
+// Window trimming, which runs on the final window either way, is left out. Exits non-zero on
+// the first mismatch.
+
+#include "../LadderDeltaCoalescer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    struct Level
+    {
+        double bid = 0.0;
+        double ask = 0.0;
+
+        bool operator==(const Level& o) const { return bid == o.bid && ask == o.ask; }
+    };
+
+    // The book and header fields LadderBookModel keeps from full and delta ladders.
+    struct ReferenceBook
+    {
+        std::map<qint64, Level> levels;
+        double bestBid = 0.0;
+        double bestAsk = 0.0;
+        double tickSize = 0.0;
+        qint64 windowMinTick = 0;
+        qint64 windowMaxTick = 0;
+        qint64 centerTick = 0;
+        qint64 timestampMs = 0;
+        quint64 ack = 0;
+
+        void applyFull(const ParsedLadderFull& msg)
+        {
+            levels.clear();
+            for (const ParsedLadderRow& row : msg.rows)
+            {
+                setRow(row);
+            }
+            bestBid = msg.bestBid;
+            bestAsk = msg.bestAsk;
+            tickSize = msg.tickSize;
+            windowMinTick = msg.windowMinTick;
+            windowMaxTick = msg.windowMaxTick;
+            centerTick = msg.centerTick;
+            timestampMs = msg.timestampMs;
+            ack = std::max(ack, msg.ack);
+        }
+
+        void applyDelta(const ParsedLadderDelta& msg)
+        {
+            if (msg.bestBid != 0.0)
+            {
+                bestBid = msg.bestBid;
+            }
+            if (msg.bestAsk != 0.0)
+            {
+                bestAsk = msg.bestAsk;
+            }
+            if (msg.tickSize > 0.0)
+            {
+                tickSize = msg.tickSize;
+            }
+            for (const ParsedLadderRow& row : msg.updates)
+            {
+                setRow(row);
+            }
+            for (const qint64 tick : msg.removals)
+            {
+                levels.erase(tick);
+            }
+            const bool hasWindow = msg.windowMinTick != 0 || msg.windowMaxTick != 0;
+            if (hasWindow && msg.windowMinTick <= msg.windowMaxTick)
+            {
+                windowMinTick = msg.windowMinTick;
+                windowMaxTick = msg.windowMaxTick;
+            }
+            if (msg.centerTick != 0)
+            {
+                centerTick = msg.centerTick;
+            }
+            if (msg.timestampMs > 0)
+            {
+                timestampMs = msg.timestampMs;
+            }
+            ack = std::max(ack, msg.ack);
+        }
+
+        // LadderBook::update: a side is written only when present; an empty level is gone.
+        void setRow(const ParsedLadderRow& row)
+        {
+            if (row.tick == 0 || (!row.hasBid && !row.hasAsk))
+            {
+                return;
+            }
+            Level& level = levels[row.tick];
+            if (row.hasBid)
+            {
+                level.bid = row.bid;
+            }
+            if (row.hasAsk)
+            {
+                level.ask = row.ask;
+            }
+            if (level == Level{})
+            {
+                levels.erase(row.tick);
+            }
+        }
+
+        bool operator==(const ReferenceBook& o) const
+        {
+            return levels == o.levels && bestBid == o.bestBid && bestAsk == o.bestAsk && tickSize == o.tickSize
+                   && windowMinTick == o.windowMinTick && windowMaxTick == o.windowMaxTick
+                   && centerTick == o.centerTick && timestampMs == o.timestampMs && ack == o.ack;
+        }
+    };
+
+    // One parse batch: frames in arrival order, with generations never going back.
+    struct Frame
+    {
+        bool full = false;
+        ParsedLadderFull ladder;
+        ParsedLadderDelta delta;
+    };
+
+    class BatchGenerator
+    {
+    public:
+        explicit BatchGenerator(unsigned seed) : m_rng(seed) {}
+
+        ReferenceBook startBook()
+        {
+            ReferenceBook book;
+            ParsedLadderFull full;
+            full.tickSize = 0.01;
+            full.windowMinTick = 1;
+            full.windowMaxTick = 11;
+            full.rows = rows(11);
+            book.applyFull(full);
+            return book;
+        }
+
+        std::vector<Frame> batch()
+        {
+            std::vector<Frame> out;
+            const unsigned n = 1 + pick(12);
+            for (unsigned i = 0; i < n; ++i)
+            {
+                if (pick(8) == 0)
+                {
+                    ++m_generation;
+                }
+                Frame f;
+                f.full = pick(10) == 0;
+                if (f.full)
+                {
+                    f.ladder.generation = m_generation;
+                    header(f.ladder);
+                    f.ladder.tickSize = 0.01;
+                    f.ladder.rows = rows(pick(11));
+                }
+                else
+                {
+                    f.delta.generation = m_generation;
+                    header(f.delta);
+                    f.delta.updates = rows(pick(8));
+                    const unsigned removals = pick(4);
+                    for (unsigned k = 0; k < removals; ++k)
+                    {
+                        f.delta.removals.push_back(static_cast<qint64>(pick(12)));
+                    }
+                }
+                out.push_back(std::move(f));
+            }
+            return out;
+        }
+
+    private:
+        unsigned pick(unsigned n) { return static_cast<unsigned>(m_rng() % n); }
+
+        template <typename Header>
+        void header(Header& h)
+        {
+            h.bestBid = pick(3) ? 100.0 + pick(5) : 0.0;
+            h.bestAsk = pick(3) ? 200.0 + pick(5) : 0.0;
+            h.tickSize = pick(4) ? 0.01 : 0.0;
+            if (pick(3))
+            {
+                h.windowMinTick = pick(50);
+                h.windowMaxTick = pick(60);
+            }
+            h.centerTick = pick(2) ? pick(40) : 0;
+            // Acks only grow: a superseded delta never acknowledges more than the full after it.
+            m_ack += pick(3);
+            h.ack = m_ack;
+            h.timestampMs = pick(2) ? 1000 + pick(1000) : 0;
+        }
+
+        // Ticks 0..11: tick 0 and rows with neither side are skipped by the apply.
+        QVector<ParsedLadderRow> rows(unsigned n)
+        {
+            QVector<ParsedLadderRow> out;
+            for (unsigned k = 0; k < n; ++k)
+            {
+                ParsedLadderRow r;
+                r.tick = pick(12);
+                r.hasBid = pick(2);
+                r.bid = pick(3);
+                r.hasAsk = pick(2);
+                r.ask = pick(3);
+                out.push_back(r);
+            }
+            return out;
+        }
+
+        std::mt19937 m_rng;
+        quint64 m_generation = 0;
+        quint64 m_ack = 0;
+    };
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int batchCount = 20000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--batches" && i + 1 < argc)
+        {
+            batchCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "usage: delta_coalesce_check [--batches N] [--seed S]" << std::endl;
+            return 2;
+        }
+    }
+
+    BatchGenerator gen(seed);
+    LadderDeltaCoalescer coalescer;
+    std::uint64_t frames = 0;
+    std::uint64_t applies = 0;
+    for (int b = 0; b < batchCount; ++b)
+    {
+        const ReferenceBook start = gen.startBook();
+        const std::vector<Frame> batch = gen.batch();
+
+        ReferenceBook sequential = start;
+        const ParsedLadderFull* lastFull = nullptr;
+        for (const Frame& f : batch)
+        {
+            if (f.full)
+            {
+                sequential.applyFull(f.ladder);
+                coalescer.supersede(f.ladder.generation);
+                lastFull = &f.ladder;
+            }
+            else
+            {
+                sequential.applyDelta(f.delta);
+                coalescer.add(ParsedLadderDelta(f.delta));
+            }
+        }
+        frames += batch.size();
+
+        ReferenceBook coalesced = start;
+        if (lastFull)
+        {
+            coalesced.applyFull(*lastFull);
+            ++applies;
+        }
+        const QVector<ParsedLadderDelta> net = coalescer.take();
+        for (int i = 0; i < net.size(); ++i)
+        {
+            if (i > 0 && net[i].generation == net[i - 1].generation)
+            {
+                std::printf("FAIL batch %d: two net deltas of generation %llu in a row\n",
+                            b,
+                            static_cast<unsigned long long>(net[i].generation));
+                return 1;
+            }
+            coalesced.applyDelta(net[i]);
+        }
+        applies += static_cast<std::uint64_t>(net.size());
+
+        if (!(coalesced == sequential))
+        {
+            std::printf("FAIL batch %d: %zu frames, the coalesced apply leaves a different book\n", b, batch.size());
+            return 1;
+        }
+    }
+    std::printf("%d batches, %llu frames: %llu applies after coalescing, books identical\n",
+                batchCount,
+                static_cast<unsigned long long>(frames),
+                static_cast<unsigned long long>(applies));
+    return 0;
+}
@@ -0,0 +1,645 @@
+// BackendFrameDecoder against the nlohmann::json DOM extraction BackendParseWorker keeps for
+// the lines the decoder passes on.
+//
+//   frame_decoder_check [--lines N] [--seed S] [--ms N]
+//
+// Generates N (default 20000) random "ladder", "ladder_delta", "trade" and "trades" lines,
+// plus types the decoder must leave alone, with tick strings, float ticks, whitespace, escaped
+// strings and odd member kinds mixed in. Every line the decoder accepts must decode exactly as
+// the DOM path would; a line it declines must leave its outputs untouched. Then times both on
+// a 20-row delta, a 2000-row ladder and an 8-print trades batch for about N ms each (default
+// 500). Exits non-zero on the first mismatch.
+
+#include "../BackendFrameDecoder.h"
+
+#include <json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    using json = nlohmann::json;
+    using Clock = std::chrono::steady_clock;
+
+    // --- Reference: the DOM extraction of BackendParseWorker::parseLines ---
+
+    bool parseTickValue(const json& value, qint64& outTick)
+    {
+        try
+        {
+            if (value.is_number_integer())
+            {
+                outTick = static_cast<qint64>(value.get<std::int64_t>());
+                return true;
+            }
+            if (value.is_number_float())
+            {
+                const double d = value.get<double>();
+                if (!std::isfinite(d))
+                {
+                    return false;
+                }
+                outTick = static_cast<qint64>(std::llround(d));
+                return true;
+            }
+            if (value.is_string())
+            {
+                const std::string s = value.get<std::string>();
+                if (s.empty())
+                {
+                    return false;
+                }
+                std::size_t idx = 0;
+                const long long v = std::stoll(s, &idx, 10);
+                if (idx == 0)
+                {
+                    return false;
+                }
+                outTick = static_cast<qint64>(v);
+                return true;
+            }
+        }
+        catch (...)
+        {
+            return false;
+        }
+        return false;
+    }
+
+    quint64 parseGeneration(const json& j)
+    {
+        const auto it = j.find("gen");
+        if (it != j.end() && it->is_number_unsigned())
+        {
+            return static_cast<quint64>(it->get<std::uint64_t>());
+        }
+        return 0;
+    }
+
+    template <typename Header>
+    void readHeader(const json& j, Header& out)
+    {
+        out.generation = parseGeneration(j);
+        out.ack = j.value("ack", 0ULL);
+        out.bestBid = j.value("bestBid", 0.0);
+        out.bestAsk = j.value("bestAsk", 0.0);
+        out.tickSize = j.value("tickSize", 0.0);
+        out.windowMinTick = j.value("windowMinTick", qint64(0));
+        out.windowMaxTick = j.value("windowMaxTick", qint64(0));
+        out.centerTick = j.value("centerTick", qint64(0));
+        const auto tsIt = j.find("timestamp");
+        if (tsIt != j.end() && tsIt->is_number_integer())
+        {
+            out.timestampMs = static_cast<qint64>(tsIt->get<std::int64_t>());
+        }
+    }
+
+    void readRows(const json& j, const char* key, QVector<ParsedLadderRow>& out)
+    {
+        const auto it = j.find(key);
+        if (it == j.end() || !it->is_array())
+        {
+            return;
+        }
+        for (const auto& row : *it)
+        {
+            ParsedLadderRow r;
+            qint64 tick = 0;
+            if (row.contains("tick") && parseTickValue(row["tick"], tick))
+            {
+                r.tick = tick;
+            }
+            r.hasBid = row.contains("bid");
+            r.bid = row.value("bid", 0.0);
+            r.hasAsk = row.contains("ask");
+            r.ask = row.value("ask", 0.0);
+            out.push_back(r);
+        }
+    }
+
+    void readTrades(const json& j, QVector<ParsedTradeEvent>& out)
+    {
+        const quint64 generation = parseGeneration(j);
+        const auto priceIt = j.find("price");
+        const auto qtyIt = j.find("qty");
+        if (priceIt != j.end() && priceIt->is_array() && qtyIt != j.end() && qtyIt->is_array())
+        {
+            const auto tickIt = j.find("tick");
+            const auto sideIt = j.find("side");
+            const bool haveTicks = tickIt != j.end() && tickIt->is_array();
+            const bool haveSides = sideIt != j.end() && sideIt->is_array();
+            const std::size_t n = std::min(priceIt->size(), qtyIt->size());
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const json& p = (*priceIt)[i];
+                const json& q = (*qtyIt)[i];
+                if (!p.is_number() || !q.is_number())
+                {
+                    continue;
+                }
+                ParsedTradeEvent ev;
+                ev.generation = generation;
+                ev.price = p.get<double>();
+                ev.qtyBase = q.get<double>();
+                if (haveSides && i < sideIt->size())
+                {
+                    const json& s = (*sideIt)[i];
+                    ev.buy = s.is_number() ? (s.get<int>() != 0) : (s.is_string() && s.get<std::string>() != "sell");
+                }
+                qint64 tick = 0;
+                if (haveTicks && i < tickIt->size() && parseTickValue((*tickIt)[i], tick))
+                {
+                    ev.tick = tick;
+                }
+                out.push_back(ev);
+            }
+            return;
+        }
+        const auto eventsIt = j.find("events");
+        if (eventsIt == j.end() || !eventsIt->is_array())
+        {
+            return;
+        }
+        for (const auto& e : *eventsIt)
+        {
+            if (!e.is_object())
+            {
+                continue;
+            }
+            ParsedTradeEvent ev;
+            ev.generation = generation;
+            ev.price = e.value("price", 0.0);
+            ev.qtyBase = e.value("qty", 0.0);
+            ev.buy = e.value("side", std::string("buy")) != "sell";
+            qint64 tick = 0;
+            if (e.contains("tick") && parseTickValue(e["tick"], tick))
+            {
+                ev.tick = tick;
+            }
+            out.push_back(ev);
+        }
+    }
+
+    BackendFrameDecoder::Kind domDecode(const std::string& line,
+                                        ParsedLadderFull& full,
+                                        ParsedLadderDelta& delta,
+                                        QVector<ParsedTradeEvent>& trades)
+    {
+        using Kind = BackendFrameDecoder::Kind;
+        json j;
+        try
+        {
+            j = json::parse(line);
+        }
+        catch (...)
+        {
+            return Kind::Other;
+        }
+        const std::string type = j.value("type", std::string());
+        if (type == "trade")
+        {
+            ParsedTradeEvent ev;
+            ev.price = j.value("price", 0.0);
+            ev.qtyBase = j.value("qty", 0.0);
+            ev.buy = j.value("side", std::string("buy")) != "sell";
+            qint64 tick = 0;
+            if (j.contains("tick") && parseTickValue(j["tick"], tick))
+            {
+                ev.tick = tick;
+            }
+            trades.push_back(ev);
+            return Kind::Trades;
+        }
+        if (type == "trades")
+        {
+            readTrades(j, trades);
+            return Kind::Trades;
+        }
+        if (type == "ladder")
+        {
+            readHeader(j, full);
+            readRows(j, "rows", full.rows);
+            return Kind::Ladder;
+        }
+        if (type == "ladder_delta")
+        {
+            readHeader(j, delta);
+            readRows(j, "updates", delta.updates);
+            const auto it = j.find("removals");
+            if (it != j.end() && it->is_array())
+            {
+                for (const auto& v : *it)
+                {
+                    if (v.is_number_integer())
+                    {
+                        delta.removals.push_back(static_cast<qint64>(v.get<std::int64_t>()));
+                    }
+                }
+            }
+            return Kind::LadderDelta;
+        }
+        return Kind::Other;
+    }
+
+    // --- Comparison ---
+
+    bool sameRows(const QVector<ParsedLadderRow>& a, const QVector<ParsedLadderRow>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (int i = 0; i < a.size(); ++i)
+        {
+            if (a[i].tick != b[i].tick || a[i].hasBid != b[i].hasBid || a[i].bid != b[i].bid
+                || a[i].hasAsk != b[i].hasAsk || a[i].ask != b[i].ask)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename Header>
+    bool sameHeader(const Header& a, const Header& b)
+    {
+        return a.generation == b.generation && a.ack == b.ack && a.bestBid == b.bestBid && a.bestAsk == b.bestAsk
+               && a.tickSize == b.tickSize && a.windowMinTick == b.windowMinTick
+               && a.windowMaxTick == b.windowMaxTick && a.centerTick == b.centerTick
+               && a.timestampMs == b.timestampMs;
+    }
+
+    bool sameTrades(const QVector<ParsedTradeEvent>& a, const QVector<ParsedTradeEvent>& b)
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (int i = 0; i < a.size(); ++i)
+        {
+            if (a[i].price != b[i].price || a[i].qtyBase != b[i].qtyBase || a[i].buy != b[i].buy
+                || a[i].tick != b[i].tick || a[i].generation != b[i].generation)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // --- Generated lines ---
+
+    class LineGenerator
+    {
+    public:
+        explicit LineGenerator(unsigned seed) : m_rng(seed) {}
+
+        std::string next()
+        {
+            json out;
+            switch (pick(7))
+            {
+            case 0:
+                out = ladder("ladder", "rows");
+                break;
+            case 1:
+            case 2:
+                out = ladder("ladder_delta", "updates");
+                out["removals"] = removals();
+                break;
+            case 3:
+                out["type"] = "trade";
+                out["price"] = 64250.5;
+                out["qty"] = quantity();
+                out["side"] = pick(2) ? "buy" : "sell";
+                if (pick(2))
+                {
+                    out["tick"] = tickValue(6425050);
+                }
+                break;
+            case 4:
+                out = columnarTrades();
+                break;
+            case 5:
+                out = eventTrades();
+                break;
+            default:
+                // Types the decoder must hand to the DOM path.
+                out["type"] = pick(2) ? "wall_add" : "ladder_page";
+                out["tick"] = json::array({1, 2});
+                out["rows"] = json::array({json::array({1.0, 2.0})});
+                out["gen"] = 1;
+                break;
+            }
+            std::string line = out.dump();
+            if (pick(10) == 0)
+            {
+                std::string spaced = " ";
+                for (const char c : line)
+                {
+                    spaced += c;
+                    if (c == ',' || c == ':')
+                    {
+                        spaced += ' ';
+                    }
+                }
+                line = spaced + " ";
+            }
+            return line;
+        }
+
+    private:
+        unsigned pick(unsigned n) { return static_cast<unsigned>(m_rng() % n); }
+
+        double quantity() { return pick(3) == 0 ? 0.0 : static_cast<double>(m_rng() % 100000) / (1 + pick(1000)); }
+
+        json tickValue(long long tick)
+        {
+            switch (pick(6))
+            {
+            case 0:
+                return std::to_string(tick);
+            case 1:
+                return static_cast<double>(tick) + 0.4;
+            default:
+                return tick;
+            }
+        }
+
+        void header(json& o)
+        {
+            o["symbol"] = pick(5) ? "BTCUSDT" : "BTC\"USDT";
+            o["timestamp"] = pick(4) ? json(1760000000000LL + static_cast<long long>(pick(1000))) : json(1.5);
+            o["bestBid"] = 64250.01;
+            o["bestAsk"] = 64250.02;
+            o["tickSize"] = 0.01;
+            o["windowMinTick"] = static_cast<long long>(pick(1000000)) - 500000;
+            o["windowMaxTick"] = 6426000;
+            o["centerTick"] = 6425000;
+            o["gen"] = pick(5) ? json(pick(10)) : json(-1);
+            o["ack"] = pick(100);
+            o["sparse"] = true;
+        }
+
+        json ladder(const char* type, const char* rowsKey)
+        {
+            json out;
+            out["type"] = type;
+            json rows = json::array();
+            const unsigned n = pick(30);
+            for (unsigned i = 0; i < n; ++i)
+            {
+                json r;
+                r["tick"] = tickValue(6425000 + i);
+                if (pick(2))
+                {
+                    r["bid"] = quantity();
+                }
+                if (pick(2))
+                {
+                    r["ask"] = quantity();
+                }
+                rows.push_back(r);
+            }
+            out[rowsKey] = rows;
+            header(out);
+            return out;
+        }
+
+        json removals()
+        {
+            json out = json::array();
+            const unsigned n = pick(5);
+            for (unsigned i = 0; i < n; ++i)
+            {
+                out.push_back(pick(4) ? json(6424000 + i) : json(1.5));
+            }
+            return out;
+        }
+
+        json columnarTrades()
+        {
+            json out;
+            out["type"] = "trades";
+            out["symbol"] = "BTCUSDT";
+            out["gen"] = pick(9);
+            json tick = json::array(), price = json::array(), qty = json::array(), side = json::array(),
+                 ts = json::array();
+            const unsigned n = 1 + pick(10);
+            for (unsigned i = 0; i < n; ++i)
+            {
+                tick.push_back(pick(3) ? json(6425000 + i) : json(0));
+                price.push_back(64250.0 + i * 0.01);
+                qty.push_back(quantity());
+                side.push_back(pick(2));
+                ts.push_back(1760000000000LL);
+            }
+            out["tick"] = tick;
+            out["price"] = price;
+            out["qty"] = qty;
+            out["side"] = side;
+            out["ts"] = ts;
+            return out;
+        }
+
+        json eventTrades()
+        {
+            json out;
+            out["type"] = "trades";
+            out["gen"] = pick(9);
+            json events = json::array();
+            const unsigned n = 1 + pick(5);
+            for (unsigned i = 0; i < n; ++i)
+            {
+                json e;
+                e["price"] = 64250.0 + i;
+                e["qty"] = quantity();
+                e["side"] = pick(2) ? "sell" : "buy";
+                e["tick"] = 6425000 + i;
+                events.push_back(e);
+            }
+            out["events"] = events;
+            return out;
+        }
+
+        std::mt19937_64 m_rng;
+    };
+
+    // --- Timing ---
+
+    template <typename Decode>
+    double nsPerLine(std::chrono::milliseconds budget, Decode&& decode)
+    {
+        std::uint64_t lines = 0;
+        const auto start = Clock::now();
+        do
+        {
+            for (int i = 0; i < 64; ++i)
+            {
+                decode();
+            }
+            lines += 64;
+        } while (Clock::now() - start < budget);
+        return std::chrono::duration<double>(Clock::now() - start).count() * 1e9 / static_cast<double>(lines);
+    }
+
+    void timeLine(const char* name, const std::string& line, std::chrono::milliseconds budget)
+    {
+        BackendFrameDecoder decoder;
+        const double dom = nsPerLine(budget, [&]() {
+            ParsedLadderFull full;
+            ParsedLadderDelta delta;
+            QVector<ParsedTradeEvent> trades;
+            domDecode(line, full, delta, trades);
+        });
+        const double direct = nsPerLine(budget, [&]() {
+            ParsedLadderFull full;
+            ParsedLadderDelta delta;
+            QVector<ParsedTradeEvent> trades;
+            decoder.decode(line.data(), line.data() + line.size(), full, delta, trades);
+        });
+        std::printf("%-16s %10.0f %10.0f %8.1fx\n", name, dom, direct, dom / direct);
+    }
+
+    std::string benchDelta(const char* type, int rows)
+    {
+        json d;
+        d["type"] = type;
+        json r = json::array();
+        for (int i = 0; i < rows; ++i)
+        {
+            json row;
+            row["tick"] = 6424000 + i;
+            row[i < rows / 2 ? "bid" : "ask"] = 0.25 * (i + 1);
+            r.push_back(row);
+        }
+        d[std::string(type) == "ladder" ? "rows" : "updates"] = r;
+        if (std::string(type) == "ladder_delta")
+        {
+            d["removals"] = json::array({6423990});
+        }
+        d["symbol"] = "BTCUSDT";
+        d["timestamp"] = 1760000000000LL;
+        d["bestBid"] = 64250.01;
+        d["bestAsk"] = 64250.02;
+        d["tickSize"] = 0.01;
+        d["windowMinTick"] = 6424000;
+        d["windowMaxTick"] = 6426000;
+        d["centerTick"] = 6425000;
+        d["gen"] = 3;
+        d["ack"] = 7;
+        return d.dump();
+    }
+
+    std::string benchTrades(int prints)
+    {
+        json t;
+        t["type"] = "trades";
+        t["gen"] = 3;
+        t["symbol"] = "BTCUSDT";
+        json tick = json::array(), price = json::array(), qty = json::array(), side = json::array(),
+             ts = json::array();
+        for (int i = 0; i < prints; ++i)
+        {
+            tick.push_back(6425000 + i);
+            price.push_back(64250.0 + i * 0.01);
+            qty.push_back(0.123 * i);
+            side.push_back(i % 2);
+            ts.push_back(1760000000000LL);
+        }
+        t["tick"] = tick;
+        t["price"] = price;
+        t["qty"] = qty;
+        t["side"] = side;
+        t["ts"] = ts;
+        return t.dump();
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int lineCount = 20000;
+    unsigned seed = 5;
+    std::chrono::milliseconds budget{500};
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--lines" && i + 1 < argc)
+        {
+            lineCount = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--ms" && i + 1 < argc)
+        {
+            budget = std::chrono::milliseconds(std::max(10, std::atoi(argv[++i])));
+        }
+        else
+        {
+            std::cerr << "usage: frame_decoder_check [--lines N] [--seed S] [--ms N]" << std::endl;
+            return 2;
+        }
+    }
+
+    using Kind = BackendFrameDecoder::Kind;
+    LineGenerator gen(seed);
+    BackendFrameDecoder decoder;
+    int decoded = 0;
+    int passedOn = 0;
+    for (int n = 0; n < lineCount; ++n)
+    {
+        const std::string line = gen.next();
+        ParsedLadderFull domFull, full;
+        ParsedLadderDelta domDelta, delta;
+        QVector<ParsedTradeEvent> domTrades, trades;
+        const Kind expected = domDecode(line, domFull, domDelta, domTrades);
+        const Kind kind = decoder.decode(line.data(), line.data() + line.size(), full, delta, trades);
+        if (kind == Kind::Other)
+        {
+            // Declined: the DOM path gets the line, so nothing may have been written.
+            if (!trades.isEmpty() || !full.rows.isEmpty() || !delta.updates.isEmpty() || !delta.removals.isEmpty())
+            {
+                std::printf("FAIL outputs written for a declined line: %s\n", line.c_str());
+                return 1;
+            }
+            ++passedOn;
+            continue;
+        }
+        ++decoded;
+        bool same = kind == expected;
+        if (same && kind == Kind::Ladder)
+        {
+            same = sameHeader(full, domFull) && sameRows(full.rows, domFull.rows);
+        }
+        else if (same && kind == Kind::LadderDelta)
+        {
+            same = sameHeader(delta, domDelta) && sameRows(delta.updates, domDelta.updates)
+                   && delta.removals == domDelta.removals;
+        }
+        else if (same)
+        {
+            same = sameTrades(trades, domTrades);
+        }
+        if (!same)
+        {
+            std::printf("FAIL line %d decodes differently from the DOM path: %s\n", n, line.c_str());
+            return 1;
+        }
+    }
+    std::printf("%d lines: %d decoded identically, %d passed on to the DOM path\n\n", lineCount, decoded, passedOn);
+
+    std::printf("%-16s %10s %10s %9s\n", "case", "dom ns", "direct ns", "speedup");
+    timeLine("ladder_delta 20", benchDelta("ladder_delta", 20), budget);
+    timeLine("ladder 2000", benchDelta("ladder", 2000), budget);
+    timeLine("trades 8", benchTrades(8), budget);
+    return 0;
+}
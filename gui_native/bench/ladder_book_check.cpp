@@ -0,0 +1,868 @@
+// LadderBookModel frames against the book LadderClient used to keep on the GUI thread.
+//
+//   ladder_book_check [--steps N] [--seed S]
+//
+// ReferenceBook below is the message handling LadderClient did before LadderBookModel took it
+// over (full and delta ladders, trimming, crossed-book detection, top-of-book sanitizing,
+// pages, snapshot building and cumulative notional), minus the signals and dirty-row
+// publishing. Both are fed the same N (default 200000) random steps: deltas around a wandering
+// mid price, window moves, cache trims, full ladders, pages, compression changes, view moves
+// and books crossed now and then, with the resync that follows. After every step the published
+// frame must match the reference: header fields, resync requests, the region rows against a
+// snapshot of the same range, the spread they are clamped to, and the cumulative notional of
+// a few rows. Exits non-zero on the first mismatch.
+
+#include "../LadderBookModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+    constexpr double kTickSize = 0.01;
+
+    class ReferenceBook
+    {
+    public:
+        LadderBook book;
+        LadderBook pageBook;
+        int compression = 1;
+        int cacheLevels = 0;
+        double tickSize = 0.0;
+        double bestBid = 0.0;
+        double bestAsk = 0.0;
+        bool hasBook = false;
+        qint64 bufferMinTick = 0;
+        qint64 bufferMaxTick = 0;
+        qint64 centerTick = 0;
+        bool hasPages = false;
+        qint64 pageMinTick = 0;
+        qint64 pageMaxTick = 0;
+        double pageTickSize = 0.0;
+        qint64 stableBid = 0;
+        qint64 stableAsk = 0;
+        quint64 resyncs = 0; // requestForceFull() calls
+
+        void setCompression(int factor)
+        {
+            compression = std::max(1, factor);
+            pageBook.setCompression(compression);
+            book.setCompression(compression);
+        }
+
+        void applyFull(const ParsedLadderFull& msg)
+        {
+            bestBid = msg.bestBid;
+            bestAsk = msg.bestAsk;
+            if (msg.tickSize > 0.0)
+            {
+                tickSize = msg.tickSize;
+            }
+            book.clear();
+            if (!msg.rows.isEmpty() && tickSize > 0.0)
+            {
+                for (const auto& row : msg.rows)
+                {
+                    book.update(row.tick, true, row.hasBid ? row.bid : 0.0, true, row.hasAsk ? row.ask : 0.0);
+                }
+            }
+            qint64 minTick = msg.windowMinTick;
+            qint64 maxTick = msg.windowMaxTick;
+            if (minTick == 0 && maxTick == 0)
+            {
+                minTick = book.firstTick();
+                maxTick = book.lastTick();
+            }
+            hasBook = tickSize > 0.0 && minTick <= maxTick;
+            if (!hasBook)
+            {
+                dropBook();
+                return;
+            }
+            bufferMinTick = minTick;
+            bufferMaxTick = maxTick;
+            centerTick = msg.centerTick != 0 ? msg.centerTick : (bufferMinTick + bufferMaxTick) / 2;
+            trimBookToWindow(bufferMinTick, bufferMaxTick, nullptr);
+            qint64 bidBucket = 0;
+            qint64 askBucket = 0;
+            if (book.bestBuckets(bidBucket, askBucket))
+            {
+                if (bidBucket < askBucket)
+                {
+                    sanitize(bidBucket, askBucket, nullptr);
+                }
+                else if (bidBucket == askBucket)
+                {
+                    stableBid = bidBucket;
+                    stableAsk = askBucket;
+                }
+                else
+                {
+                    stableBid = 0;
+                    stableAsk = 0;
+                    book.clear();
+                    bestBid = 0.0;
+                    bestAsk = 0.0;
+                    ++resyncs;
+                }
+            }
+            refreshRangePages();
+        }
+
+        void applyDelta(const ParsedLadderDelta& msg)
+        {
+            if (!hasBook)
+            {
+                ParsedLadderFull full;
+                full.bestBid = msg.bestBid;
+                full.bestAsk = msg.bestAsk;
+                full.tickSize = msg.tickSize;
+                full.windowMinTick = msg.windowMinTick;
+                full.windowMaxTick = msg.windowMaxTick;
+                full.centerTick = msg.centerTick;
+                applyFull(full);
+                return;
+            }
+            const double prevBestBid = bestBid;
+            const double prevBestAsk = bestAsk;
+            if (msg.bestBid != 0.0)
+            {
+                bestBid = msg.bestBid;
+            }
+            if (msg.bestAsk != 0.0)
+            {
+                bestAsk = msg.bestAsk;
+            }
+            if (msg.tickSize > 0.0)
+            {
+                tickSize = msg.tickSize;
+            }
+
+            // Only the crossed-book check reads these.
+            QSet<qint64> dirtyBuckets;
+            if (tickSize > 0.0)
+            {
+                const qint64 prevBidTick = priceToRawTick(prevBestBid, true);
+                const qint64 prevAskTick = priceToRawTick(prevBestAsk, true);
+                const qint64 nextBidTick = priceToRawTick(bestBid, true);
+                const qint64 nextAskTick = priceToRawTick(bestAsk, true);
+                if (prevBidTick != 0) dirtyBuckets.insert(LadderBook::floorBucket(prevBidTick, compression));
+                if (nextBidTick != 0) dirtyBuckets.insert(LadderBook::floorBucket(nextBidTick, compression));
+                if (prevAskTick != 0) dirtyBuckets.insert(LadderBook::ceilBucket(prevAskTick, compression));
+                if (nextAskTick != 0) dirtyBuckets.insert(LadderBook::ceilBucket(nextAskTick, compression));
+            }
+            if (!msg.updates.isEmpty() && tickSize > 0.0)
+            {
+                for (const auto& row : msg.updates)
+                {
+                    if (row.tick == 0)
+                    {
+                        continue;
+                    }
+                    book.update(row.tick, row.hasBid, row.bid, row.hasAsk, row.ask);
+                    dirtyBuckets.insert(LadderBook::floorBucket(row.tick, compression));
+                    dirtyBuckets.insert(LadderBook::ceilBucket(row.tick, compression));
+                }
+            }
+            for (qint64 t : msg.removals)
+            {
+                if (t == 0)
+                {
+                    continue;
+                }
+                book.remove(t);
+                dirtyBuckets.insert(LadderBook::floorBucket(t, compression));
+                dirtyBuckets.insert(LadderBook::ceilBucket(t, compression));
+            }
+
+            qint64 bidBucket = 0;
+            qint64 askBucket = 0;
+            const bool haveTop = book.bestBuckets(bidBucket, askBucket);
+            const bool crossed = haveTop && bidBucket > askBucket;
+            if (crossed || crossedBookLikely(dirtyBuckets))
+            {
+                ++resyncs;
+                if (crossed)
+                {
+                    book.clear();
+                    bestBid = 0.0;
+                    bestAsk = 0.0;
+                    stableBid = 0;
+                    stableAsk = 0;
+                }
+            }
+
+            const bool hasWindow = msg.windowMinTick != 0 || msg.windowMaxTick != 0;
+            const qint64 minTick = hasWindow ? msg.windowMinTick : bufferMinTick;
+            const qint64 maxTick = hasWindow ? msg.windowMaxTick : bufferMaxTick;
+            if (minTick <= maxTick)
+            {
+                bufferMinTick = minTick;
+                bufferMaxTick = maxTick;
+            }
+            if (msg.centerTick != 0)
+            {
+                centerTick = msg.centerTick;
+            }
+            trimBookToWindow(bufferMinTick, bufferMaxTick, &dirtyBuckets);
+
+            hasBook = tickSize > 0.0 && bufferMinTick <= bufferMaxTick;
+            if (!hasBook)
+            {
+                dropBook();
+                return;
+            }
+            if (book.bestBuckets(bidBucket, askBucket))
+            {
+                if (bidBucket < askBucket)
+                {
+                    sanitize(bidBucket, askBucket, &dirtyBuckets);
+                }
+                else if (bidBucket == askBucket)
+                {
+                    stableBid = bidBucket;
+                    stableAsk = askBucket;
+                }
+            }
+            refreshRangePages();
+        }
+
+        // LadderClient::handleParsedLadderPage once the span is clipped to the backend book.
+        void applyPage(const QVector<ParsedLadderRow>& rows, double pageTick, qint64 fromTick, qint64 toTick)
+        {
+            const bool usable =
+                hasBook && fromTick <= toTick && pageTick > 0.0 && std::abs(pageTick - tickSize) <= 1e-12;
+            if (!usable)
+            {
+                return;
+            }
+            auto connects = [](qint64 aMin, qint64 aMax, qint64 bMin, qint64 bMax)
+            {
+                return aMin <= bMax + 1 && bMin <= aMax + 1;
+            };
+            const bool merge = hasPages && std::abs(pageTickSize - pageTick) <= 1e-12
+                               && (connects(fromTick, toTick, pageMinTick, pageMaxTick)
+                                   || (connects(fromTick, toTick, bufferMinTick, bufferMaxTick)
+                                       && connects(pageMinTick, pageMaxTick, bufferMinTick, bufferMaxTick)));
+            if (merge)
+            {
+                pageBook.erase(fromTick, toTick);
+                pageMinTick = std::min(pageMinTick, fromTick);
+                pageMaxTick = std::max(pageMaxTick, toTick);
+            }
+            else
+            {
+                pageBook.clear();
+                pageMinTick = fromTick;
+                pageMaxTick = toTick;
+            }
+            for (const auto& row : rows)
+            {
+                if (row.tick < fromTick || row.tick > toTick)
+                {
+                    continue;
+                }
+                pageBook.update(row.tick, true, row.hasBid ? row.bid : 0.0, true, row.hasAsk ? row.ask : 0.0);
+            }
+            hasPages = true;
+            pageTickSize = pageTick;
+        }
+
+        void clearRangePages()
+        {
+            pageBook.clear();
+            hasPages = false;
+            pageMinTick = 0;
+            pageMaxTick = 0;
+            pageTickSize = 0.0;
+        }
+
+        bool pagesConnected() const
+        {
+            return hasPages && hasBook && pageMinTick <= bufferMaxTick + 1 && bufferMinTick <= pageMaxTick + 1;
+        }
+
+        // Rows of [minTick, maxTick] as LadderClient::buildSnapshot returned them, and the spread
+        // they were clamped to.
+        DomSnapshot buildSnapshot(qint64 minTick, qint64 maxTick, LadderSpreadBuckets& spread) const
+        {
+            DomSnapshot snap;
+            snap.tickSize = tickSize;
+            const qint64 c = compression;
+            snap.compression = c;
+            snap.minTick = LadderBook::floorBucket(minTick, c);
+            snap.maxTick = LadderBook::ceilBucket(maxTick, c);
+            QVector<DomLevel> buckets;
+            const qint64 bucketCount = (snap.maxTick - snap.minTick) / c + 1;
+            if (bucketCount > 0)
+            {
+                buckets.resize(static_cast<int>(bucketCount));
+            }
+            for (int i = 0; i < buckets.size(); ++i)
+            {
+                buckets[i].tick = snap.minTick + static_cast<qint64>(i) * c;
+                buckets[i].price = static_cast<double>(buckets[i].tick) * tickSize;
+            }
+            auto copyBuckets = [&](const LadderBook& source, qint64 fromBucket, qint64 toBucket, bool overwrite)
+            {
+                fromBucket = std::max(fromBucket, snap.minTick);
+                toBucket = std::min(toBucket, snap.maxTick);
+                for (qint64 t = fromBucket; overwrite && t <= toBucket; t += c)
+                {
+                    DomLevel& lvl = buckets[static_cast<int>((t - snap.minTick) / c)];
+                    lvl.bidQty = 0.0;
+                    lvl.askQty = 0.0;
+                }
+                source.forEachBucket(fromBucket,
+                                     toBucket,
+                                     [&](qint64 bucketTick, const LadderBook::Entry& e)
+                                     {
+                                         DomLevel& lvl = buckets[static_cast<int>((bucketTick - snap.minTick) / c)];
+                                         lvl.bidQty = e.bidQty;
+                                         lvl.askQty = e.askQty;
+                                     });
+            };
+            copyBuckets(book, snap.minTick, snap.maxTick, false);
+            if (pagesConnected())
+            {
+                const qint64 liveMin = LadderBook::floorBucket(bufferMinTick, c);
+                const qint64 liveMax = LadderBook::ceilBucket(bufferMaxTick, c);
+                copyBuckets(pageBook, LadderBook::floorBucket(pageMinTick, c), liveMin - c, true);
+                copyBuckets(pageBook, liveMax + c, LadderBook::ceilBucket(pageMaxTick, c), true);
+            }
+            snapshotSpread(buckets, spread);
+            for (int i = buckets.size() - 1; i >= 0; --i)
+            {
+                clampToSpread(buckets[i], spread);
+                snap.levels.push_back(buckets[i]);
+            }
+            return snap;
+        }
+
+        // Top-of-book buckets cumulativeNotionalForPrice measured from.
+        std::pair<qint64, qint64> notionalBuckets() const
+        {
+            if (stableBid != 0 && stableAsk != 0)
+            {
+                return {stableBid, stableAsk};
+            }
+            qint64 bid = 0;
+            qint64 ask = 0;
+            book.bestBuckets(bid, ask);
+            return {bid, ask};
+        }
+
+        // LadderClient::cumulativeNotionalForPrice for a bucket on the side given.
+        double cumulativeNotional(qint64 bucketTick, bool bidSide) const
+        {
+            const auto [bidBucket, askBucket] = notionalBuckets();
+            qint64 lo = 0;
+            qint64 hi = 0;
+            if (bidSide)
+            {
+                const qint64 target = std::min(bucketTick, bidBucket);
+                lo = std::min(target, bidBucket);
+                hi = std::max(target, bidBucket);
+            }
+            else
+            {
+                const qint64 target = std::max(bucketTick, askBucket);
+                lo = std::min(askBucket, target);
+                hi = std::max(askBucket, target);
+            }
+            double total = 0.0;
+            book.forEachBucket(lo,
+                               hi,
+                               [&](qint64 t, const LadderBook::Entry& e)
+                               {
+                                   const double p = std::abs(static_cast<double>(t) * tickSize);
+                                   const double qty = bidSide ? e.bidQty : e.askQty;
+                                   if (qty > 0.0)
+                                   {
+                                       total += qty * p;
+                                   }
+                               });
+            return total;
+        }
+
+    private:
+        qint64 priceToRawTick(double price, bool nudge) const
+        {
+            if (!(price > 0.0) || !(tickSize > 0.0) || !std::isfinite(price) || !std::isfinite(tickSize))
+            {
+                return 0;
+            }
+            const double scaled = price / tickSize;
+            if (!std::isfinite(scaled))
+            {
+                return 0;
+            }
+            return static_cast<qint64>(std::llround(nudge ? scaled + (scaled >= 0.0 ? 1e-9 : -1e-9) : scaled));
+        }
+
+        void dropBook()
+        {
+            bufferMinTick = 0;
+            bufferMaxTick = 0;
+            centerTick = 0;
+            book.clear();
+            stableBid = 0;
+            stableAsk = 0;
+        }
+
+        void sanitize(qint64 bidBucket, qint64 askBucket, QSet<qint64>* dirtyBuckets)
+        {
+            book.sanitizeBuckets(bidBucket, askBucket, dirtyBuckets);
+            qint64 bid2 = 0;
+            qint64 ask2 = 0;
+            if (book.bestBuckets(bid2, ask2) && bid2 < ask2)
+            {
+                stableBid = bid2;
+                stableAsk = ask2;
+            }
+            else
+            {
+                stableBid = bidBucket;
+                stableAsk = askBucket;
+            }
+        }
+
+        void refreshRangePages()
+        {
+            if (hasPages && (!pagesConnected() || std::abs(pageTickSize - tickSize) > 1e-12))
+            {
+                clearRangePages();
+            }
+        }
+
+        void trimBookToWindow(qint64 minTick, qint64 maxTick, QSet<qint64>* dirtyBuckets)
+        {
+            if (tickSize <= 0.0)
+            {
+                return;
+            }
+            qint64 bestTick = bestBid > 0.0 ? priceToRawTick(bestBid, false) : 0;
+            if (bestTick == 0 && bestAsk > 0.0)
+            {
+                bestTick = priceToRawTick(bestAsk, false);
+            }
+            if (bestTick != 0 && cacheLevels > 0)
+            {
+                minTick = bestTick - cacheLevels;
+                maxTick = bestTick + cacheLevels;
+            }
+            if (minTick <= maxTick)
+            {
+                book.retain(minTick, maxTick, dirtyBuckets);
+            }
+        }
+
+        bool crossedBookLikely(const QSet<qint64>& dirtyBuckets) const
+        {
+            if (!(tickSize > 0.0) || !(bestBid > 0.0) || !(bestAsk > 0.0))
+            {
+                return false;
+            }
+            const qint64 bidBucket = LadderBook::floorBucket(priceToRawTick(bestBid, false), compression);
+            const qint64 askBucket = LadderBook::ceilBucket(priceToRawTick(bestAsk, false), compression);
+            if (bidBucket > askBucket)
+            {
+                return true;
+            }
+            const bool hasTop = bidBucket != 0 && askBucket != 0;
+            for (qint64 t : dirtyBuckets)
+            {
+                const LadderBook::Entry bucket = book.bucket(t);
+                if (bucket.bidQty > 0.0 && bucket.askQty > 0.0 && (!hasTop || bidBucket < askBucket))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void snapshotSpread(const QVector<DomLevel>& buckets, LadderSpreadBuckets& spread) const
+        {
+            const qint64 bidTick = bestBid > 0.0 ? priceToRawTick(bestBid, true) : 0;
+            const qint64 askTick = bestAsk > 0.0 ? priceToRawTick(bestAsk, true) : 0;
+            const qint64 backendBid = LadderBook::floorBucket(bidTick, compression);
+            const qint64 backendAsk = LadderBook::ceilBucket(askTick, compression);
+            const bool backendOk = bidTick != 0 && askTick != 0 && backendBid < backendAsk;
+
+            spread = LadderSpreadBuckets();
+            spread.bid = stableBid;
+            spread.ask = stableAsk;
+            spread.haveBid = stableBid != 0;
+            spread.haveAsk = stableAsk != 0;
+            if (!spread.haveBid || !spread.haveAsk)
+            {
+                spread = LadderSpreadBuckets();
+                for (const auto& lvl : buckets)
+                {
+                    if (lvl.tick == 0)
+                    {
+                        continue;
+                    }
+                    if (lvl.bidQty > 0.0 && (!spread.haveBid || lvl.tick > spread.bid))
+                    {
+                        spread.bid = lvl.tick;
+                        spread.haveBid = true;
+                    }
+                    if (lvl.askQty > 0.0 && (!spread.haveAsk || lvl.tick < spread.ask))
+                    {
+                        spread.ask = lvl.tick;
+                        spread.haveAsk = true;
+                    }
+                }
+            }
+            if (!spread.haveBid && bidTick != 0)
+            {
+                spread.bid = backendBid;
+                spread.haveBid = true;
+            }
+            if (!spread.haveAsk && askTick != 0)
+            {
+                spread.ask = backendAsk;
+                spread.haveAsk = true;
+            }
+            if (spread.haveBid && spread.haveAsk && spread.bid >= spread.ask && backendOk)
+            {
+                spread.bid = backendBid;
+                spread.ask = backendAsk;
+            }
+        }
+
+        static void clampToSpread(DomLevel& lvl, const LadderSpreadBuckets& spread)
+        {
+            const bool locked = spread.haveBid && spread.haveAsk && spread.bid == spread.ask;
+            if (spread.haveBid && (locked ? lvl.tick < spread.bid : lvl.tick <= spread.bid))
+            {
+                lvl.askQty = 0.0;
+            }
+            if (spread.haveAsk && (locked ? lvl.tick > spread.ask : lvl.tick >= spread.ask))
+            {
+                lvl.bidQty = 0.0;
+            }
+            if (spread.haveBid && spread.haveAsk && spread.bid < spread.ask && lvl.tick > spread.bid
+                && lvl.tick < spread.ask)
+            {
+                lvl.bidQty = 0.0;
+                lvl.askQty = 0.0;
+            }
+        }
+    };
+
+    class MessageGenerator
+    {
+    public:
+        explicit MessageGenerator(unsigned seed) : m_rng(seed) {}
+
+        qint64 range(qint64 lo, qint64 hi) { return std::uniform_int_distribution<qint64>(lo, hi)(m_rng); }
+        bool chance(int percent) { return range(0, 99) < percent; }
+
+        qint64 mid() const { return m_mid; }
+        qint64 windowMin() const { return m_windowMin; }
+        qint64 windowMax() const { return m_windowMax; }
+
+        ParsedLadderFull full()
+        {
+            ParsedLadderFull msg;
+            msg.tickSize = kTickSize;
+            msg.bestBid = static_cast<double>(m_mid - 1) * kTickSize;
+            msg.bestAsk = static_cast<double>(m_mid + 1) * kTickSize;
+            msg.windowMinTick = m_windowMin;
+            msg.windowMaxTick = m_windowMax;
+            msg.centerTick = chance(80) ? m_mid : 0;
+            for (qint64 t = m_mid - 200; t <= m_mid + 200; ++t)
+            {
+                if (t != m_mid && chance(60))
+                {
+                    msg.rows.push_back(row(t, false));
+                }
+            }
+            return msg;
+        }
+
+        ParsedLadderDelta delta()
+        {
+            ParsedLadderDelta msg;
+            const qint64 was = m_mid;
+            m_mid += chance(2) ? range(-30, 30) : range(-2, 2);
+            for (qint64 t = std::min(was, m_mid); t < std::max(was, m_mid); ++t)
+            {
+                msg.removals.push_back(t);
+            }
+            if (chance(8))
+            {
+                m_windowMin = m_mid - 400 + range(-40, 40);
+                m_windowMax = m_windowMin + 800;
+                msg.windowMinTick = m_windowMin;
+                msg.windowMaxTick = m_windowMax;
+                msg.centerTick = chance(50) ? m_mid : 0;
+            }
+            if (chance(85))
+            {
+                msg.bestBid = static_cast<double>(m_mid - range(0, 3)) * kTickSize;
+                msg.bestAsk = static_cast<double>(m_mid + range(0, 3)) * kTickSize;
+            }
+            const qint64 n = range(0, 12);
+            for (qint64 k = 0; k < n; ++k)
+            {
+                const qint64 t = m_mid + range(-100, 100);
+                if (chance(20))
+                {
+                    msg.removals.push_back(t);
+                }
+                else
+                {
+                    msg.updates.push_back(row(t, range(0, 299) == 0));
+                }
+            }
+            return msg;
+        }
+
+        QVector<ParsedLadderRow> page(qint64& fromTick, qint64& toTick)
+        {
+            fromTick = chance(50) ? m_windowMax + 1 - range(0, 10) : m_windowMin - range(30, 400);
+            toTick = fromTick + range(20, 300);
+            QVector<ParsedLadderRow> rows;
+            for (qint64 t = fromTick; t <= toTick; ++t)
+            {
+                if (chance(30))
+                {
+                    rows.push_back(row(t, false));
+                }
+            }
+            return rows;
+        }
+
+    private:
+        // Bids below the mid, asks above; the other side is sent as zero now and then.
+        ParsedLadderRow row(qint64 tick, bool wrongSide)
+        {
+            ParsedLadderRow r;
+            r.tick = tick;
+            const bool bidSide = wrongSide ? tick >= m_mid : tick < m_mid;
+            r.hasBid = bidSide || chance(10);
+            r.bid = bidSide ? static_cast<double>(range(0, 40)) : 0.0;
+            r.hasAsk = !bidSide || chance(10);
+            r.ask = bidSide ? 0.0 : static_cast<double>(range(0, 40));
+            return r;
+        }
+
+        std::mt19937_64 m_rng;
+        qint64 m_mid = 100000;
+        qint64 m_windowMin = 99600;
+        qint64 m_windowMax = 100400;
+    };
+
+    bool near(double a, double b)
+    {
+        return std::abs(a - b) <= 1e-9 * std::max(1.0, std::max(std::abs(a), std::abs(b)));
+    }
+
+    // Empty when the frame matches, else what differs first.
+    const char* compare(const LadderBookFrame& frame, const ReferenceBook& ref, MessageGenerator& gen)
+    {
+        if (frame.hasBook != ref.hasBook || frame.tickSize != ref.tickSize || frame.bestBid != ref.bestBid
+            || frame.bestAsk != ref.bestAsk)
+        {
+            return "book header";
+        }
+        if (frame.resyncRequests + frame.crossedDeltas != ref.resyncs)
+        {
+            return "resync requests";
+        }
+        if (!frame.hasBook)
+        {
+            return "";
+        }
+        if (frame.bufferMinTick != ref.bufferMinTick || frame.bufferMaxTick != ref.bufferMaxTick
+            || frame.centerTick != ref.centerTick || frame.compression != ref.compression)
+        {
+            return "live window";
+        }
+        if (frame.hasPages != ref.hasPages || frame.pagesConnected != ref.pagesConnected()
+            || (ref.hasPages && (frame.pageMinTick != ref.pageMinTick || frame.pageMaxTick != ref.pageMaxTick)))
+        {
+            return "pages";
+        }
+        if (frame.spreadStable != (ref.stableBid != 0 && ref.stableAsk != 0))
+        {
+            return "stable spread";
+        }
+        if (frame.regionMaxTick < frame.regionMinTick)
+        {
+            return "empty region";
+        }
+
+        LadderSpreadBuckets spread;
+        const DomSnapshot snap = ref.buildSnapshot(frame.regionMinTick, frame.regionMaxTick, spread);
+        if (!(frame.spread == spread))
+        {
+            return "spread";
+        }
+        if (snap.levels.size() != frame.region.size())
+        {
+            return "region size";
+        }
+        for (int i = 0; i < snap.levels.size(); ++i)
+        {
+            const DomLevel& a = frame.region[i];
+            const DomLevel& b = snap.levels[i];
+            if (a.tick != b.tick || a.price != b.price || a.bidQty != b.bidQty || a.askQty != b.askQty)
+            {
+                return "region row";
+            }
+        }
+
+        const auto [bidBucket, askBucket] = ref.notionalBuckets();
+        if (frame.notionalBidBucket != bidBucket || frame.notionalAskBucket != askBucket)
+        {
+            return "notional buckets";
+        }
+        // The reference sums from the best bucket every time; a few rows per frame will do.
+        for (int k = 0; k < 4; ++k)
+        {
+            const int i = static_cast<int>(gen.range(0, frame.region.size() - 1));
+            const qint64 t = frame.region[i].tick;
+            if (bidBucket != 0 && t <= bidBucket && !near(frame.cumBid[i], ref.cumulativeNotional(t, true)))
+            {
+                return "cumulative bid notional";
+            }
+            if (askBucket != 0 && t >= askBucket && !near(frame.cumAsk[i], ref.cumulativeNotional(t, false)))
+            {
+                return "cumulative ask notional";
+            }
+        }
+        return "";
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int steps = 200000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--steps" && i + 1 < argc)
+        {
+            steps = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "usage: ladder_book_check [--steps N] [--seed S]" << std::endl;
+            return 2;
+        }
+    }
+
+    MessageGenerator gen(seed);
+    constexpr quint64 kView = 1;
+    LadderBookModel model;
+    model.addView(kView);
+    model.resetView(kView, 1);
+    ReferenceBook ref;
+    qint64 viewMin = gen.mid() - 60;
+    qint64 viewMax = gen.mid() + 60;
+    model.setView(kView, viewMin, viewMax);
+    quint64 resyncsSeen = 0;
+    std::uint64_t crossings = 0;
+    std::uint64_t pagedFrames = 0;
+    const int compressions[] = {1, 1, 1, 2, 3, 5, 10};
+
+    for (int step = 0; step < steps; ++step)
+    {
+        const qint64 op = gen.range(0, 99);
+        if (ref.resyncs != resyncsSeen)
+        {
+            // The client answers a crossed book with a full ladder.
+            resyncsSeen = ref.resyncs;
+            ++crossings;
+            const ParsedLadderFull full = gen.full();
+            ref.applyFull(full);
+            model.applyFull(full);
+        }
+        else if (op < 72)
+        {
+            const ParsedLadderDelta delta = gen.delta();
+            ref.applyDelta(delta);
+            model.applyDelta(delta);
+        }
+        else if (op < 75)
+        {
+            const ParsedLadderFull full = gen.full();
+            ref.applyFull(full);
+            model.applyFull(full);
+        }
+        else if (op < 79)
+        {
+            qint64 from = 0;
+            qint64 to = 0;
+            const QVector<ParsedLadderRow> rows = gen.page(from, to);
+            ref.applyPage(rows, kTickSize, from, to);
+            model.applyPage(kView, rows, kTickSize, from, to, true);
+        }
+        else if (op < 80)
+        {
+            ref.clearRangePages();
+            model.clearPages(kView);
+        }
+        else if (op < 82)
+        {
+            const int c = compressions[gen.range(0, 6)];
+            ref.setCompression(c);
+            model.setCompression(kView, c);
+        }
+        else if (op < 83)
+        {
+            const int levels = gen.chance(50) ? 0 : static_cast<int>(gen.range(100, 400));
+            ref.cacheLevels = levels;
+            model.setCacheLevels(kView, levels);
+        }
+        else
+        {
+            const qint64 s = gen.chance(10) ? gen.range(-500, 500) : gen.range(-5, 5);
+            viewMin += s;
+            viewMax += s;
+            if (gen.chance(5))
+            {
+                viewMax = viewMin + gen.range(10, 400);
+            }
+            model.setView(kView, viewMin, viewMax);
+        }
+
+        const std::shared_ptr<const LadderBookFrame> frame = model.publish(kView, 0);
+        if (frame->pagesConnected)
+        {
+            ++pagedFrames;
+        }
+        const char* diff = compare(*frame, ref, gen);
+        if (*diff)
+        {
+            std::printf("FAIL step %d (op %lld, frame %llu): %s differs\n",
+                        step,
+                        static_cast<long long>(op),
+                        static_cast<unsigned long long>(frame->version),
+                        diff);
+            return 1;
+        }
+    }
+    std::printf("%d steps: %llu crossed books resynced, %llu frames with pages; frames identical\n",
+                steps,
+                static_cast<unsigned long long>(crossings),
+                static_cast<unsigned long long>(pagedFrames));
+    return 0;
+}
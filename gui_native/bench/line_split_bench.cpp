@@ -0,0 +1,204 @@
+// Backend stdout -> parse-worker batches: the old front-removal splitter in
+// LadderClient::handleReadyRead against BackendLineSplitter.
+//
+//   line_split_bench [--ms N] [--read BYTES]
+//
+// Each case builds a burst of backend output (ladder_delta lines, optionally behind one large
+// full ladder line), feeds it in pipe reads of BYTES (default 65536) and loops for about N ms
+// (default 1000). Reports MB/s and ns per line for each splitter.
+
+#include "../BackendLineSplitter.h"
+
+#include <QByteArray>
+#include <QVector>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Case
+    {
+        const char* name;
+        int deltaLines;
+        int fullLevels; // 0: no full ladder line in the burst
+    };
+
+    QByteArray deltaLine(int i)
+    {
+        const long long tick = 6425000 + (i * 7919) % 400 - 200;
+        std::string line = R"({"type":"ladder_delta","gen":3,"ack":12,"ts":1760000000)" + std::to_string(i % 1000)
+                           + R"(,"bestBid":64249.99,"bestAsk":64250.0,"windowMin":6424000,"windowMax":6426000,"updates":[)";
+        for (int k = 0; k < 4; ++k)
+        {
+            if (k > 0)
+            {
+                line += ',';
+            }
+            line += "[" + std::to_string(tick + k) + "," + std::to_string((i + k) % 97) + ".125,0]";
+        }
+        line += R"(],"removals":[)" + std::to_string(tick - 9) + "]}\n";
+        return QByteArray(line.data(), static_cast<int>(line.size()));
+    }
+
+    QByteArray fullLine(int levels)
+    {
+        std::string line = R"({"type":"ladder","gen":3,"ack":12,"tickSize":0.01,"rows":[)";
+        for (int i = 0; i < levels; ++i)
+        {
+            if (i > 0)
+            {
+                line += ',';
+            }
+            line += "[" + std::to_string(6424000 + i) + "," + std::to_string(i % 131) + ".5," + std::to_string(i % 17)
+                    + ".25]";
+        }
+        line += "]}\n";
+        return QByteArray(line.data(), static_cast<int>(line.size()));
+    }
+
+    QByteArray burst(const Case& c)
+    {
+        QByteArray out;
+        if (c.fullLevels > 0)
+        {
+            out += fullLine(c.fullLevels);
+        }
+        for (int i = 0; i < c.deltaLines; ++i)
+        {
+            out += deltaLine(i);
+        }
+        return out;
+    }
+
+    // The splitter LadderClient used before: append, then cut lines off the front.
+    std::size_t legacySplit(QByteArray& buffer, const QByteArray& chunk, QVector<QByteArray>& pending)
+    {
+        buffer += chunk;
+        int idx = -1;
+        std::size_t n = 0;
+        while ((idx = buffer.indexOf('\n')) != -1)
+        {
+            QByteArray line = buffer.left(idx);
+            buffer.remove(0, idx + 1);
+            if (!line.trimmed().isEmpty())
+            {
+                pending.push_back(line);
+                ++n;
+            }
+        }
+        return n;
+    }
+
+    struct Result
+    {
+        std::uint64_t lines{0};
+        std::uint64_t bytes{0};
+        double seconds{0.0};
+    };
+
+    template <typename Feed>
+    Result run(const std::vector<QByteArray>& reads, std::chrono::milliseconds budget, Feed&& feed)
+    {
+        Result r;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const auto start = Clock::now();
+            const auto deadline = start + (pass == 0 ? std::chrono::milliseconds(50) : budget);
+            Result current;
+            do
+            {
+                for (const QByteArray& read : reads)
+                {
+                    current.bytes += static_cast<std::uint64_t>(read.size());
+                }
+                current.lines += feed();
+            } while (Clock::now() < deadline);
+            current.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            r = current;
+        }
+        return r;
+    }
+
+    void report(const char* name, const char* splitter, const Result& r)
+    {
+        const double lines = static_cast<double>(std::max<std::uint64_t>(1, r.lines));
+        std::printf("%-26s %-8s %10.1f %10.0f %12.0f\n",
+                    name,
+                    splitter,
+                    static_cast<double>(r.bytes) / r.seconds / (1024.0 * 1024.0),
+                    r.seconds * 1e9 / lines,
+                    lines / r.seconds);
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::chrono::milliseconds budget{1000};
+    int readSize = 65536;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--ms" && i + 1 < argc)
+        {
+            budget = std::chrono::milliseconds(std::max(10, std::atoi(argv[++i])));
+        }
+        else if (arg == "--read" && i + 1 < argc)
+        {
+            readSize = std::max(64, std::atoi(argv[++i]));
+        }
+        else
+        {
+            std::cerr << "usage: line_split_bench [--ms N] [--read BYTES]" << std::endl;
+            return 2;
+        }
+    }
+
+    const Case cases[] = {
+        {"delta burst 2k", 2000, 0},
+        {"delta burst 20k", 20000, 0},
+        {"full 20k lvls + 2k delta", 2000, 20000},
+    };
+
+    std::printf("%-26s %-8s %10s %10s %12s\n", "case", "splitter", "MB/s", "ns/line", "lines/s");
+    for (const Case& c : cases)
+    {
+        const QByteArray all = burst(c);
+        std::vector<QByteArray> reads;
+        for (int off = 0; off < all.size(); off += readSize)
+        {
+            reads.push_back(all.mid(off, readSize));
+        }
+
+        const Result legacy = run(reads, budget, [&]() {
+            QByteArray buffer;
+            QVector<QByteArray> pending;
+            std::size_t n = 0;
+            for (const QByteArray& read : reads)
+            {
+                n += legacySplit(buffer, read, pending);
+            }
+            return n;
+        });
+        report(c.name, "legacy", legacy);
+
+        const Result chunked = run(reads, budget, [&]() {
+            BackendLineSplitter splitter;
+            for (const QByteArray& read : reads)
+            {
+                splitter.append(read);
+            }
+            return static_cast<std::size_t>(splitter.takeBatch().size());
+        });
+        report(c.name, "chunked", chunked);
+    }
+    return 0;
+}
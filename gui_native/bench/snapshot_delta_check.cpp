@@ -0,0 +1,414 @@
+// LadderFrameSlicer deltas against fresh snapshots of the same frames.
+//
+//   snapshot_delta_check [--steps N] [--seed S]
+//
+// Drives a LadderBookModel with two views of its book through N (default 200000) random steps:
+// ladder deltas around a wandering mid price, window moves, full ladders, crossed books and the
+// resync after them for the book, and per view cache trims, connected and detached pages and
+// compression changes. Every step publishes a frame per view, against a consumed version that
+// may lag, and only some are read. Each view scrolls by a few rows or jumps on its own, and its
+// frame region follows it one frame late, the way LadderClient::requestView posts it. Each read
+// patches a ladder with LadderFrameSlicer::delta() the way DomWidget::updateSnapshot does (a
+// refused delta is resent full, as MainWindow does) and compares it with
+// LadderFrameSlicer::snapshot() of the same frame. Exits non-zero on the first mismatch.
+
+#include "../LadderBookModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string_view>
+
+namespace
+{
+    constexpr double kTickSize = 0.01;
+
+    // DomWidget::updateSnapshot(const DomSnapshotDelta &) without the widget.
+    bool patch(DomSnapshot& target, const DomSnapshotDelta& delta)
+    {
+        if (delta.full)
+        {
+            target = delta.snapshot;
+            return true;
+        }
+        const DomSnapshot& next = delta.snapshot;
+        const qint64 compression = std::max<qint64>(1, next.compression);
+        if (target.levels.size() != delta.rowCount || target.compression != next.compression
+            || std::abs(target.tickSize - next.tickSize) > 1e-12
+            || target.maxTick != next.maxTick - delta.shiftRows * compression
+            || std::abs(delta.shiftRows) >= delta.rowCount)
+        {
+            return false;
+        }
+        auto& levels = target.levels;
+        if (delta.shiftRows > 0)
+        {
+            std::move_backward(levels.begin(), levels.end() - delta.shiftRows, levels.end());
+        }
+        else if (delta.shiftRows < 0)
+        {
+            std::move(levels.begin() - delta.shiftRows, levels.end(), levels.begin());
+        }
+        for (int i = 0; i < delta.indices.size(); ++i)
+        {
+            levels[delta.indices[i]] = delta.levels[i];
+        }
+        target.bestBid = next.bestBid;
+        target.bestAsk = next.bestAsk;
+        target.minTick = next.minTick;
+        target.maxTick = next.maxTick;
+        return true;
+    }
+
+    // Index of the first differing row, -1 for a header mismatch, levels.size() when equal.
+    int compare(const DomSnapshot& got, const DomSnapshot& want)
+    {
+        if (got.levels.size() != want.levels.size() || got.minTick != want.minTick || got.maxTick != want.maxTick
+            || got.compression != want.compression || got.tickSize != want.tickSize || got.bestBid != want.bestBid
+            || got.bestAsk != want.bestAsk)
+        {
+            return -1;
+        }
+        for (int i = 0; i < want.levels.size(); ++i)
+        {
+            const DomLevel& a = got.levels[i];
+            const DomLevel& b = want.levels[i];
+            if (a.tick != b.tick || a.price != b.price || a.bidQty != b.bidQty || a.askQty != b.askQty)
+            {
+                return i;
+            }
+        }
+        return want.levels.size();
+    }
+
+    class BookGenerator
+    {
+    public:
+        explicit BookGenerator(unsigned seed) : m_rng(seed) {}
+
+        qint64 range(qint64 lo, qint64 hi) { return std::uniform_int_distribution<qint64>(lo, hi)(m_rng); }
+        bool chance(int percent) { return range(0, 99) < percent; }
+
+        qint64 mid() const { return m_mid; }
+
+        ParsedLadderFull full()
+        {
+            ParsedLadderFull msg;
+            msg.tickSize = kTickSize;
+            top(msg);
+            msg.windowMinTick = m_windowMin;
+            msg.windowMaxTick = m_windowMax;
+            msg.centerTick = m_mid;
+            for (qint64 t = std::max(m_windowMin, m_mid - 300); t <= std::min(m_windowMax, m_mid + 300); ++t)
+            {
+                if (chance(70))
+                {
+                    msg.rows.push_back(row(t, false));
+                }
+            }
+            return msg;
+        }
+
+        ParsedLadderDelta delta()
+        {
+            ParsedLadderDelta msg;
+            const qint64 was = m_mid;
+            m_mid += chance(3) ? range(-40, 40) : range(-2, 2);
+            // Levels the mid moved over change sides; the feed clears them.
+            for (qint64 t = std::min(was, m_mid); t < std::max(was, m_mid); ++t)
+            {
+                msg.removals.push_back(t);
+            }
+            if (chance(5))
+            {
+                // The backend re-centres its window on the mid, give or take.
+                m_windowMin = m_mid - 500 + range(-60, 60);
+                m_windowMax = m_windowMin + 1000;
+                msg.windowMinTick = m_windowMin;
+                msg.windowMaxTick = m_windowMax;
+                msg.centerTick = (m_windowMin + m_windowMax) / 2;
+            }
+            if (chance(80))
+            {
+                top(msg);
+            }
+            const qint64 n = range(0, 12);
+            for (qint64 k = 0; k < n; ++k)
+            {
+                const qint64 t = m_mid + range(-80, 80);
+                if (chance(20))
+                {
+                    msg.removals.push_back(t);
+                }
+                else
+                {
+                    msg.updates.push_back(row(t, range(0, 499) == 0));
+                }
+            }
+            return msg;
+        }
+
+        // A "range" reply next to (or, now and then, away from) the live window.
+        QVector<ParsedLadderRow> page(qint64& fromTick, qint64& toTick)
+        {
+            if (chance(20))
+            {
+                fromTick = m_windowMax + range(50, 400);
+            }
+            else if (chance(50))
+            {
+                fromTick = m_windowMax + 1 - range(0, 20);
+            }
+            else
+            {
+                fromTick = m_windowMin - range(100, 400);
+            }
+            toTick = fromTick + range(50, 400);
+            QVector<ParsedLadderRow> rows;
+            for (qint64 t = fromTick; t <= toTick; ++t)
+            {
+                if (chance(40))
+                {
+                    rows.push_back(row(t, false));
+                }
+            }
+            return rows;
+        }
+
+    private:
+        // Bids below the mid, asks above, unless the row is to cross the book.
+        ParsedLadderRow row(qint64 tick, bool wrongSide)
+        {
+            ParsedLadderRow r;
+            r.tick = tick;
+            const bool bidSide = wrongSide ? tick >= m_mid : tick < m_mid;
+            if (bidSide || chance(10))
+            {
+                r.hasBid = true;
+                r.bid = bidSide ? static_cast<double>(range(0, 50)) : 0.0;
+            }
+            if (!bidSide || chance(10))
+            {
+                r.hasAsk = true;
+                r.ask = bidSide ? 0.0 : static_cast<double>(range(0, 50));
+            }
+            return r;
+        }
+
+        template <typename Header>
+        void top(Header& h)
+        {
+            h.bestBid = static_cast<double>(m_mid - range(1, 3)) * kTickSize;
+            h.bestAsk = static_cast<double>(m_mid + range(0, 2)) * kTickSize;
+        }
+
+        std::mt19937_64 m_rng;
+        qint64 m_mid = 100000;
+        qint64 m_windowMin = 99500;
+        qint64 m_windowMax = 100500;
+    };
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int steps = 200000;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--steps" && i + 1 < argc)
+        {
+            steps = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else
+        {
+            std::cerr << "usage: snapshot_delta_check [--steps N] [--seed S]" << std::endl;
+            return 2;
+        }
+    }
+
+    BookGenerator gen(seed);
+    LadderBookModel model;
+    // One ladder of the feed and its state on the GUI side.
+    struct Reader
+    {
+        quint64 view = 0;
+        LadderFrameSlicer slicer;
+        DomSnapshot shown;
+        std::shared_ptr<const LadderBookFrame> frame;
+        quint64 consumed = 0;
+        quint64 seenConsumed = 0;
+        qint64 viewMin = 0;
+        qint64 viewMax = 0;
+        bool postView = true;
+    };
+    Reader readers[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        Reader& r = readers[i];
+        r.view = static_cast<quint64>(i + 1);
+        r.viewMin = gen.mid() - 60 - 40 * i;
+        r.viewMax = gen.mid() + 60;
+        model.addView(r.view);
+        model.resetView(r.view, 1);
+    }
+    std::shared_ptr<const LadderBookFrame> prev;
+    bool resync = true;
+    std::uint64_t reads = 0;
+    std::uint64_t fulls = 0;
+    std::uint64_t refused = 0;
+    std::uint64_t patchedRows = 0;
+    const int compressions[] = {1, 1, 1, 2, 3, 5, 10};
+
+    for (int step = 0; step < steps; ++step)
+    {
+        for (Reader& r : readers)
+        {
+            if (r.postView)
+            {
+                model.setView(r.view, r.viewMin, r.viewMax);
+                r.postView = false;
+            }
+        }
+        if (resync)
+        {
+            model.applyFull(gen.full());
+            resync = false;
+        }
+        // Book messages reach every view; the rest belong to one of them.
+        Reader& target = readers[gen.range(0, 1)];
+        const qint64 op = gen.range(0, 99);
+        if (op < 70)
+        {
+            model.applyDelta(gen.delta());
+        }
+        else if (op < 73)
+        {
+            model.applyFull(gen.full());
+        }
+        else if (op < 76)
+        {
+            qint64 from = 0;
+            qint64 to = 0;
+            const QVector<ParsedLadderRow> rows = gen.page(from, to);
+            model.applyPage(target.view, rows, kTickSize, from, to, true);
+        }
+        else if (op < 77)
+        {
+            model.clearPages(target.view);
+        }
+        else if (op < 78)
+        {
+            model.setCompression(target.view, compressions[gen.range(0, 6)]);
+        }
+        else if (op < 79)
+        {
+            model.setCacheLevels(target.view, gen.chance(50) ? 0 : static_cast<int>(gen.range(100, 400)));
+        }
+        else if (op < 95)
+        {
+            const qint64 s = gen.chance(15) ? gen.range(-600, 600) : gen.range(-3, 3);
+            target.viewMin += s;
+            target.viewMax += s;
+            if (gen.chance(3))
+            {
+                target.viewMax = target.viewMin + gen.range(20, 300);
+            }
+        }
+        else if (gen.chance(10))
+        {
+            target.viewMin = gen.mid() - 60;
+            target.viewMax = gen.mid() + 60;
+        }
+
+        for (Reader& r : readers)
+        {
+            // The book thread reads the consumed version off an atomic and may see an older one.
+            if (gen.chance(80))
+            {
+                r.seenConsumed = r.consumed;
+            }
+            r.frame = model.publish(r.view, r.seenConsumed);
+        }
+        const std::shared_ptr<const LadderBookFrame>& frame0 = readers[0].frame;
+        // The client asks for a full ladder once the book thread dropped one as crossed.
+        resync = prev
+                 && (frame0->resyncRequests != prev->resyncRequests || frame0->crossedDeltas != prev->crossedDeltas);
+        prev = frame0;
+
+        for (Reader& r : readers)
+        {
+            const LadderBookFrame& frame = *r.frame;
+            if (gen.chance(30))
+            {
+                continue; // the GUI only takes the newest frame
+            }
+            if (!frame.hasBook || frame.tickSize <= 0.0)
+            {
+                r.slicer.invalidate();
+                r.shown = DomSnapshot();
+                continue;
+            }
+            ++reads;
+            DomSnapshotDelta delta = r.slicer.delta(frame, r.viewMin, r.viewMax, gen.chance(1));
+            if (!patch(r.shown, delta))
+            {
+                ++refused;
+                delta = r.slicer.delta(frame, r.viewMin, r.viewMax, true);
+                patch(r.shown, delta);
+            }
+            r.consumed = frame.version;
+            if (delta.full)
+            {
+                ++fulls;
+            }
+            else
+            {
+                patchedRows += static_cast<std::uint64_t>(delta.indices.size());
+            }
+            // LadderClient::requestView, coarsely: re-centre once the view leaves the region.
+            r.postView = !r.slicer.covered();
+
+            const DomSnapshot want =
+                LadderFrameSlicer::snapshot(frame, LadderFrameSlicer::sources(frame, r.viewMin, r.viewMax));
+            const int at = compare(r.shown, want);
+            if (at != want.levels.size())
+            {
+                std::printf("FAIL step %d (view %llu, frame %llu, %s, shift %d): ",
+                            step,
+                            static_cast<unsigned long long>(r.view),
+                            static_cast<unsigned long long>(frame.version),
+                            delta.full ? "full" : "delta",
+                            delta.shiftRows);
+                if (at < 0)
+                {
+                    std::printf("header differs\n");
+                }
+                else
+                {
+                    std::printf("row %d (tick %lld) differs\n", at, static_cast<long long>(want.levels[at].tick));
+                }
+                return 1;
+            }
+        }
+    }
+
+    const std::uint64_t deltas = reads - fulls;
+    std::printf("%d steps, %llu reads: %llu full, %llu incremental (%.1f rows each), %llu refused; ladders identical\n",
+                steps,
+                static_cast<unsigned long long>(reads),
+                static_cast<unsigned long long>(fulls),
+                static_cast<unsigned long long>(deltas),
+                deltas ? static_cast<double>(patchedRows) / static_cast<double>(deltas) : 0.0,
+                static_cast<unsigned long long>(refused));
+    return 0;
+}
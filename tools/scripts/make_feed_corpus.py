@@ -0,0 +1,224 @@
+"""Writes the frame corpus used by the feed_parse_bench target.
+
+One file per venue message kind under backend/bench/corpus: JSON frames one per line
+(.jsonl), MEXC protobuf frames hex-encoded one per line (.pbhex). Frames follow the venues'
+wire formats with a seeded random walk for prices, so runs are reproducible. Frames captured
+from a live session can be dropped in using the same layout.
+"""
+
+import argparse
+import json
+import random
+from pathlib import Path
+
+
+FRAMES_PER_FILE = 64
+
+
+class Walk:
+    def __init__(self, rng: random.Random, mid: float, tick: float, decimals: int) -> None:
+        self.rng = rng
+        self.mid = mid
+        self.tick = tick
+        self.decimals = decimals
+        self.ts = 1_760_000_000_000
+
+    def step(self) -> None:
+        self.mid = max(self.tick * 100, self.mid + self.rng.randint(-3, 3) * self.tick)
+        self.ts += self.rng.randint(5, 120)
+
+    def price(self, offset_ticks: int) -> str:
+        return f"{self.mid + offset_ticks * self.tick:.{self.decimals}f}"
+
+    def qty(self, zero_chance: float = 0.0) -> str:
+        if self.rng.random() < zero_chance:
+            return "0.00000000"
+        return f"{self.rng.lognormvariate(0.0, 1.4) * 10:.8f}"
+
+    def levels(self, count: int, bid: bool, zero_chance: float, spread: int = 40) -> list[tuple[str, str]]:
+        offsets = sorted(self.rng.sample(range(1, spread + count), count))
+        sign = -1 if bid else 1
+        return [(self.price(sign * o), self.qty(zero_chance)) for o in offsets]
+
+
+# --- protobuf encoding (just what PushDataV3ApiWrapper needs) ---
+
+def varint(v: int) -> bytes:
+    out = bytearray()
+    while True:
+        b = v & 0x7F
+        v >>= 7
+        if v:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+
+def field_bytes(num: int, payload: bytes) -> bytes:
+    return varint(num << 3 | 2) + varint(len(payload)) + payload
+
+
+def field_varint(num: int, v: int) -> bytes:
+    return varint(num << 3) + varint(v)
+
+
+def mexc_wrapper(channel: str, symbol: str, ts: int, body_field: int, body: bytes) -> bytes:
+    return (field_bytes(1, channel.encode()) + field_bytes(3, symbol.encode()) + field_varint(6, ts)
+            + field_bytes(body_field, body))
+
+
+def mexc_depth(w: Walk) -> bytes:
+    body = b""
+    for price, qty in w.levels(w.rng.randint(1, 12), False, 0.3):
+        body += field_bytes(1, field_bytes(1, price.encode()) + field_bytes(2, qty.encode()))
+    for price, qty in w.levels(w.rng.randint(1, 12), True, 0.3):
+        body += field_bytes(2, field_bytes(1, price.encode()) + field_bytes(2, qty.encode()))
+    body += field_bytes(3, b"spot@public.aggre.depth.v3.api.pb@100ms")
+    body += field_bytes(4, str(w.ts * 10).encode()) + field_bytes(5, str(w.ts * 10 + 3).encode())
+    return mexc_wrapper("spot@public.aggre.depth.v3.api.pb@100ms@BTCUSDT", "BTCUSDT", w.ts, 313, body)
+
+
+def mexc_deals(w: Walk) -> bytes:
+    body = b""
+    for _ in range(w.rng.randint(1, 6)):
+        deal = (field_bytes(1, w.price(w.rng.randint(-2, 2)).encode()) + field_bytes(2, w.qty().encode())
+                + field_varint(3, w.rng.choice([1, 2])) + field_varint(4, w.ts))
+        body += field_bytes(1, deal)
+    body += field_bytes(2, b"spot@public.aggre.deals.v3.api.pb@100ms")
+    return mexc_wrapper("spot@public.aggre.deals.v3.api.pb@100ms@BTCUSDT", "BTCUSDT", w.ts, 314, body)
+
+
+# --- JSON venues ---
+
+def binance_depth(w: Walk, update_id: list[int], futures: bool) -> dict:
+    first = update_id[0] + 1
+    update_id[0] += w.rng.randint(1, 40)
+    frame = {
+        "e": "depthUpdate", "E": w.ts, "s": "BTCUSDT", "U": first, "u": update_id[0],
+        "b": [list(l) for l in w.levels(w.rng.randint(5, 40), True, 0.25)],
+        "a": [list(l) for l in w.levels(w.rng.randint(5, 40), False, 0.25)],
+    }
+    if futures:
+        frame["T"] = w.ts - 2
+        frame["pu"] = first - 1
+    return frame
+
+
+def binance_agg_trade(w: Walk, trade_id: int) -> dict:
+    return {"e": "aggTrade", "E": w.ts, "s": "BTCUSDT", "a": trade_id, "p": w.price(w.rng.randint(-1, 1)),
+            "q": w.qty(), "f": trade_id * 3, "l": trade_id * 3 + 2, "T": w.ts - 1,
+            "m": w.rng.random() < 0.5, "M": True}
+
+
+def mexc_futures_depth(w: Walk, version: int) -> dict:
+    def rows(bid: bool):
+        return [[float(p), int(float(q) * 10), 1] for p, q in w.levels(w.rng.randint(1, 20), bid, 0.3)]
+    return {"channel": "push.depth", "data": {"asks": rows(False), "bids": rows(True), "version": version},
+            "symbol": "BTC_USDT", "ts": w.ts}
+
+
+def mexc_futures_deal(w: Walk) -> dict:
+    deals = [{"p": float(w.price(w.rng.randint(-1, 1))), "v": w.rng.randint(1, 500), "T": w.rng.choice([1, 2]),
+              "O": 3, "M": 2, "t": w.ts} for _ in range(w.rng.randint(1, 5))]
+    return {"channel": "push.deal", "data": deals, "symbol": "BTC_USDT", "ts": w.ts}
+
+
+def lighter_order_book(w: Walk, snapshot: bool) -> dict:
+    count = 100 if snapshot else w.rng.randint(1, 15)
+    book = {
+        "code": 0,
+        "asks": [{"price": p, "size": q} for p, q in w.levels(count, False, 0.0 if snapshot else 0.3)],
+        "bids": [{"price": p, "size": q} for p, q in w.levels(count, True, 0.0 if snapshot else 0.3)],
+        "offset": w.ts % 1_000_000,
+    }
+    kind = "subscribed/order_book" if snapshot else "update/order_book"
+    return {"channel": "order_book:1", "order_book": book, "type": kind}
+
+
+def lighter_trade(w: Walk, trade_id: int) -> dict:
+    trades = []
+    for i in range(w.rng.randint(1, 4)):
+        trades.append({"trade_id": trade_id + i, "tx_hash": f"{w.rng.getrandbits(128):032x}", "type": "trade",
+                       "market_id": 1, "size": w.qty(), "price": w.price(w.rng.randint(-1, 1)),
+                       "usd_amount": "0", "ask_id": trade_id * 7, "bid_id": trade_id * 7 + 1,
+                       "is_maker_ask": w.rng.random() < 0.5, "block_height": trade_id, "timestamp": w.ts})
+    return {"channel": "trade:1", "trades": trades, "type": "update/trade"}
+
+
+def paradex_order_book(w: Walk, seq: int) -> dict:
+    inserts = [{"side": "BUY", "price": p, "size": q} for p, q in w.levels(15, True, 0.0, 20)]
+    inserts += [{"side": "SELL", "price": p, "size": q} for p, q in w.levels(15, False, 0.0, 20)]
+    return {"jsonrpc": "2.0", "method": "subscription",
+            "params": {"channel": "order_book.BTC-USD-PERP.snapshot@15@50ms",
+                       "data": {"seq_no": seq, "market": "BTC-USD-PERP", "last_updated_at": w.ts,
+                                "update_type": "s", "inserts": inserts, "updates": [], "deletes": []}}}
+
+
+def paradex_trade(w: Walk, trade_id: int) -> dict:
+    return {"jsonrpc": "2.0", "method": "subscription",
+            "params": {"channel": "trades.BTC-USD-PERP",
+                       "data": {"id": str(trade_id), "market": "BTC-USD-PERP",
+                                "side": w.rng.choice(["BUY", "SELL"]), "size": w.qty(),
+                                "price": w.price(w.rng.randint(-1, 1)), "created_at": w.ts,
+                                "trade_type": "FILL"}}}
+
+
+def uzx_depth(w: Walk) -> dict:
+    return {"type": "spot.depth", "symbol": "BTC-USDT", "ts": w.ts,
+            "data": {"bids": [list(l) for l in w.levels(50, True, 0.0)],
+                     "asks": [list(l) for l in w.levels(50, False, 0.0)]}}
+
+
+def uzx_fills(w: Walk) -> dict:
+    fills = [{"price": w.price(w.rng.randint(-1, 1)), "vol": w.qty(), "direction": w.rng.choice(["buy", "sell"]),
+              "ts": w.ts} for _ in range(w.rng.randint(1, 5))]
+    return {"type": "spot.fills", "symbol": "BTC-USDT", "ts": w.ts, "data": {"data": fills}}
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--out", type=Path,
+                        default=Path(__file__).resolve().parents[2] / "backend" / "bench" / "corpus")
+    parser.add_argument("--seed", type=int, default=7)
+    args = parser.parse_args()
+    args.out.mkdir(parents=True, exist_ok=True)
+
+    def write(name: str, frames: list) -> None:
+        path = args.out / name
+        with path.open("w", newline="\n") as f:
+            for frame in frames:
+                if isinstance(frame, bytes):
+                    f.write(frame.hex() + "\n")
+                else:
+                    f.write(json.dumps(frame, separators=(",", ":")) + "\n")
+        print(f"[corpus] {path.name}: {len(frames)} frames")
+
+    def frames(fn) -> list:
+        rng = random.Random(args.seed)
+        w = Walk(rng, 64_250.0, 0.01, 2)
+        out = []
+        for i in range(FRAMES_PER_FILE):
+            w.step()
+            out.append(fn(w, i))
+        return out
+
+    binance_id = [9_000_000]
+    futures_id = [5_000_000]
+    write("binance_depth.jsonl", frames(lambda w, i: binance_depth(w, binance_id, False)))
+    write("binance_futures_depth.jsonl", frames(lambda w, i: binance_depth(w, futures_id, True)))
+    write("binance_aggtrade.jsonl", frames(lambda w, i: binance_agg_trade(w, 3_000_000 + i)))
+    write("mexc_depth.pbhex", frames(lambda w, i: mexc_depth(w)))
+    write("mexc_deals.pbhex", frames(lambda w, i: mexc_deals(w)))
+    write("mexc_futures_depth.jsonl", frames(lambda w, i: mexc_futures_depth(w, 70_000 + i)))
+    write("mexc_futures_deal.jsonl", frames(lambda w, i: mexc_futures_deal(w)))
+    write("lighter_order_book.jsonl", frames(lambda w, i: lighter_order_book(w, i % 16 == 0)))
+    write("lighter_trade.jsonl", frames(lambda w, i: lighter_trade(w, 800_000 + i * 4)))
+    write("paradex_order_book.jsonl", frames(lambda w, i: paradex_order_book(w, 1_000 + i)))
+    write("paradex_trades.jsonl", frames(lambda w, i: paradex_trade(w, 55_000 + i)))
+    write("uzx_depth.jsonl", frames(lambda w, i: uzx_depth(w)))
+    write("uzx_fills.jsonl", frames(lambda w, i: uzx_fills(w)))
+
+
+if __name__ == "__main__":
+    main()